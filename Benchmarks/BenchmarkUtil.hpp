@@ -0,0 +1,55 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+#include <fmt/format.h>
+
+// Helpers shared by the benchmark programs, each program prints one table to stdout.
+namespace bench {
+
+inline auto Median(std::vector<double> samples) -> double {
+    std::ranges::sort(samples);
+    return samples[samples.size() / 2];
+}
+
+// wall time of one call in milliseconds, for phases that can not be repeated in isolation
+template<typename Function>
+auto TimeMilliseconds(Function &&function) -> double {
+    auto beginTime = std::chrono::steady_clock::now();
+    function();
+    auto endTime = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(endTime - beginTime).count();
+}
+
+// runs function once to warm up, then repeatCount times and returns the median wall time in milliseconds
+template<typename Function>
+auto MeasureMilliseconds(size_t repeatCount, Function &&function) -> double {
+    function();
+    std::vector<double> samples;
+    samples.reserve(repeatCount);
+    for (size_t i = 0; i < repeatCount; ++i) {
+        samples.push_back(TimeMilliseconds(function));
+    }
+    return Median(std::move(samples));
+}
+
+// "--quick" shrinks the problem sizes so a run finishes in seconds, used to smoke test the programs
+inline bool IsQuickRun(int argc, char **argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::string_view(argv[i]) == "--quick") {
+            return true;
+        }
+    }
+    return false;
+}
+
+// keeps the optimizer from removing a result that is otherwise unused
+template<typename T>
+void DoNotOptimize(const T &value) {
+    static volatile const void *sSink;
+    sSink = &value;
+}
+
+}    // namespace bench
@@ -0,0 +1,82 @@
+#include "BenchmarkUtil.hpp"
+#include "Components/Transform.h"
+#include "Foundation/Memory/GarbageCollection.h"
+#include "Foundation/Memory/PoolAllocator.h"
+#include "Object/GameObject.h"
+
+// Creates, walks and destroys a batch of GameObjects (each with its Transform) once with the type pools
+// and once with the pools forwarding to the global heap. Destroy includes draining the GarbageCollection.
+
+struct PhaseTimes {
+    double createMilliseconds = 0.0;
+    double traverseMilliseconds = 0.0;
+    double destroyMilliseconds = 0.0;
+};
+
+static auto RunPhases(size_t objectCount, size_t repeatCount) -> PhaseTimes {
+    GarbageCollection *pGarbageCollection = GarbageCollection::GetInstance();
+    std::vector<SharedPtr<GameObject>> gameObjects;
+    gameObjects.reserve(objectCount);
+
+    std::vector<double> createSamples, traverseSamples, destroySamples;
+    // the first round warms up the heap and the pools and is not recorded
+    for (size_t round = 0; round <= repeatCount; ++round) {
+        double createMilliseconds = bench::TimeMilliseconds([&]() {
+            for (size_t i = 0; i < objectCount; ++i) {
+                gameObjects.push_back(GameObject::Create());
+            }
+        });
+
+        float sum = 0.f;
+        double traverseMilliseconds = bench::TimeMilliseconds([&]() {
+            for (const SharedPtr<GameObject> &pGameObject : gameObjects) {
+                sum += pGameObject->GetTransform()->GetLocalPosition().x + float(pGameObject->GetComponentMask());
+            }
+        });
+        bench::DoNotOptimize(sum);
+
+        double destroyMilliseconds = bench::TimeMilliseconds([&]() {
+            gameObjects.clear();
+            pGarbageCollection->OnDestroy();
+            pGarbageCollection->OnCreate();
+        });
+
+        if (round > 0) {
+            createSamples.push_back(createMilliseconds);
+            traverseSamples.push_back(traverseMilliseconds);
+            destroySamples.push_back(destroyMilliseconds);
+        }
+    }
+
+    PhaseTimes times;
+    times.createMilliseconds = bench::Median(std::move(createSamples));
+    times.traverseMilliseconds = bench::Median(std::move(traverseSamples));
+    times.destroyMilliseconds = bench::Median(std::move(destroySamples));
+    return times;
+}
+
+int main(int argc, char **argv) {
+    bool quick = bench::IsQuickRun(argc, argv);
+    size_t objectCount = quick ? 10 * 1000 : 100 * 1000;
+    size_t repeatCount = quick ? 3 : 7;
+
+    GarbageCollection::OnInstanceCreate();
+    GarbageCollection::GetInstance()->OnCreate();
+
+    fmt::print("GameObject + Transform, {} objects\n", objectCount);
+    fmt::print("{:>8} {:>12} {:>14} {:>12}\n", "pool", "create ms", "traverse ms", "destroy ms");
+    for (bool enablePool : {true, false}) {
+        PoolAllocator::SetEnabled(enablePool);
+        PhaseTimes times = RunPhases(objectCount, repeatCount);
+        fmt::print("{:>8} {:>12.2f} {:>14.3f} {:>12.2f}\n",
+            enablePool ? "on" : "off",
+            times.createMilliseconds,
+            times.traverseMilliseconds,
+            times.destroyMilliseconds);
+    }
+    PoolAllocator::SetEnabled(true);
+
+    GarbageCollection::GetInstance()->OnDestroy();
+    GarbageCollection::OnInstanceDestroy();
+    return 0;
+}
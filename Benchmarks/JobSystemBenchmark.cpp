@@ -0,0 +1,75 @@
+#include <cmath>
+#include <thread>
+#include "BenchmarkUtil.hpp"
+#include "Foundation/JobSystem.h"
+
+// Scaling of the JobSystem from 0 workers (everything inline on the calling thread) up to one worker per core.
+// ParallelFor: a fixed amount of arithmetic split into chunks, measures the speedup.
+// Schedule: many tiny independent jobs signalling one counter, measures the per job overhead.
+
+static constexpr size_t kGrainSize = 256;
+
+static auto Work(size_t index) -> float {
+    float value = static_cast<float>(index);
+    for (size_t i = 0; i < 64; ++i) {
+        value = std::sqrt(value * 1.0001f + 1.f);
+    }
+    return value;
+}
+
+int main(int argc, char **argv) {
+    bool quick = bench::IsQuickRun(argc, argv);
+    size_t itemCount = quick ? 64 * 1024 : 4 * 1024 * 1024;
+    size_t tinyJobCount = quick ? 4 * 1024 : 256 * 1024;
+    size_t repeatCount = quick ? 3 : 7;
+    size_t maxWorkerCount = std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1;
+
+    std::vector<float> results(itemCount);
+    JobSystem::OnInstanceCreate();
+    JobSystem *pJobSystem = JobSystem::GetInstance();
+
+    fmt::print("JobSystem: ParallelFor over {} items, grain {}, {} tiny jobs\n", itemCount, kGrainSize, tinyJobCount);
+    fmt::print("{:>8} {:>16} {:>10} {:>18}\n", "workers", "ParallelFor ms", "speedup", "Schedule ns/job");
+
+    // 0, 1, 2, 4 ... and the worker count of the machine
+    std::vector<size_t> workerCounts = {0};
+    for (size_t workerCount = 1; workerCount < maxWorkerCount; workerCount *= 2) {
+        workerCounts.push_back(workerCount);
+    }
+    workerCounts.push_back(maxWorkerCount);
+
+    double baseMilliseconds = 0.0;
+    for (size_t workerCount : workerCounts) {
+        pJobSystem->OnCreate(workerCount);
+        double parallelForMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+            pJobSystem->ParallelFor(0, itemCount, kGrainSize, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    results[i] = Work(i);
+                }
+            });
+        });
+
+        std::atomic<size_t> executedCount = 0;
+        double scheduleMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+            JobCounter counter;
+            for (size_t i = 0; i < tinyJobCount; ++i) {
+                pJobSystem->Schedule([&]() { executedCount.fetch_add(1, std::memory_order_relaxed); }, &counter);
+            }
+            pJobSystem->Wait(counter);
+        });
+        pJobSystem->OnDestroy();
+
+        if (workerCount == 0) {
+            baseMilliseconds = parallelForMilliseconds;
+        }
+        fmt::print("{:>8} {:>16.2f} {:>9.2f}x {:>18.1f}\n",
+            workerCount,
+            parallelForMilliseconds,
+            baseMilliseconds / parallelForMilliseconds,
+            scheduleMilliseconds * 1e6 / static_cast<double>(tinyJobCount));
+        bench::DoNotOptimize(results);
+    }
+
+    JobSystem::OnInstanceDestroy();
+    return 0;
+}
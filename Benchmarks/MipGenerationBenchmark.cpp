@@ -0,0 +1,120 @@
+#include <random>
+#include <thread>
+#include "BenchmarkUtil.hpp"
+#include "Foundation/JobSystem.h"
+#include "TextureObject/MipChainGenerator.h"
+
+// Building the full mip chain of a 4K and an 8K RGBA8 texture.
+// legacy box: the former WICLoader::MipImage, a scalar 2x2 box filter in gamma space that halves the image in place.
+// The MipChainGenerator columns filter sRGB color in linear space, first on the calling thread,
+// then with the rows of every level split across the JobSystem workers.
+
+static auto BuildImage(uint32_t size) -> std::vector<uint32_t> {
+    std::mt19937 random(21);
+    std::vector<uint32_t> image(size_t(size) * size);
+    // smooth gradients with noise on top, so the filters do not work on constant data
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            uint32_t noise = random() & 0x0f0f0f0f;
+            uint32_t r = (x * 255 / size) & 0xf0;
+            uint32_t g = (y * 255 / size) & 0xf0;
+            uint32_t b = ((x ^ y) & 0xff) & 0xf0;
+            image[size_t(y) * size + x] = ((0xf0u << 24) | (b << 16) | (g << 8) | r) + noise;
+        }
+    }
+    return image;
+}
+
+static void LegacyMipImage(uint32_t *pImage, uint32_t width, uint32_t height) {
+    static constexpr uint32_t kOffsetsX[] = {0, 1, 0, 1};
+    static constexpr uint32_t kOffsetsY[] = {0, 0, 1, 1};
+    for (uint32_t y = 0; y < height; y += 2) {
+        for (uint32_t x = 0; x < width; x += 2) {
+            uint32_t color = 0;
+            for (uint32_t c = 0; c < 4; ++c) {
+                uint32_t sum = 0;
+                for (uint32_t i = 0; i < 4; ++i) {
+                    uint32_t pixel = pImage[(x + kOffsetsX[i]) + (y + kOffsetsY[i]) * width];
+                    sum += (pixel >> (8 * (3 - c))) & 0xff;
+                }
+                color = (color << 8) | (sum / 4);
+            }
+            pImage[x / 2 + y / 2 * width / 2] = color;
+        }
+    }
+}
+
+static void LegacyMipChain(std::vector<uint32_t> &image, uint32_t size) {
+    for (uint32_t mipSize = size; mipSize > 1; mipSize /= 2) {
+        LegacyMipImage(image.data(), mipSize, mipSize);
+    }
+}
+
+static auto ToMegapixelsPerSecond(uint32_t size, double milliseconds) -> double {
+    return double(size) * size / (milliseconds * 1000.0);
+}
+
+int main(int argc, char **argv) {
+    bool quick = bench::IsQuickRun(argc, argv);
+    std::vector<uint32_t> sizes = quick ? std::vector<uint32_t>{1024, 2048} : std::vector<uint32_t>{4096, 8192};
+    size_t repeatCount = quick ? 3 : 7;
+    size_t workerCount = std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1;
+
+    struct Column {
+        const char *name;
+        MipChainGenerator::Filter filter;
+    };
+    static constexpr Column kColumns[] = {
+        {"box", MipChainGenerator::Filter::eBox},
+        {"kaiser", MipChainGenerator::Filter::eKaiser},
+        {"lanczos", MipChainGenerator::Filter::eLanczos},
+    };
+
+    fmt::print("Full mip chain of a RGBA8 sRGB texture, {} workers, ms (Mpixel/s of level 0)\n", workerCount);
+    fmt::print("{:>6} {:>9} {:>20} {:>20} {:>20}\n", "size", "filter", "legacy box", "1 thread", "job system");
+    MipChainGenerator generator;
+    for (uint32_t size : sizes) {
+        std::vector<uint32_t> image = BuildImage(size);
+        std::vector<uint32_t> legacyImage;
+        double legacyMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+            legacyImage = image;
+            LegacyMipChain(legacyImage, size);
+        });
+        bench::DoNotOptimize(legacyImage);
+
+        for (const Column &column : kColumns) {
+            MipChainGenerator::Settings settings;
+            settings.format = MipChainGenerator::Format::eRGBA8;
+            settings.filter = column.filter;
+            settings.sRGB = true;
+
+            // the generator runs on the calling thread while there is no JobSystem
+            double serialMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+                generator.Generate(image.data(), size, size, settings);
+            });
+            JobSystem::OnInstanceCreate();
+            JobSystem::GetInstance()->OnCreate(workerCount);
+            double parallelMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+                generator.Generate(image.data(), size, size, settings);
+            });
+            JobSystem::GetInstance()->OnDestroy();
+            JobSystem::OnInstanceDestroy();
+            bench::DoNotOptimize(generator.GetData());
+
+            std::string legacyColumn = column.filter == MipChainGenerator::Filter::eBox
+                                           ? fmt::format("{:.1f} ({:.0f})",
+                                                 legacyMilliseconds,
+                                                 ToMegapixelsPerSecond(size, legacyMilliseconds))
+                                           : std::string("-");
+            fmt::print("{:>6} {:>9} {:>20} {:>20} {:>20}\n",
+                size,
+                column.name,
+                legacyColumn,
+                fmt::format("{:.1f} ({:.0f})", serialMilliseconds, ToMegapixelsPerSecond(size, serialMilliseconds)),
+                fmt::format("{:.1f} ({:.0f})",
+                    parallelMilliseconds,
+                    ToMegapixelsPerSecond(size, parallelMilliseconds)));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include <compare>
+#include <random>
+#include <thread>
+#include "BenchmarkUtil.hpp"
+#include "Foundation/JobSystem.h"
+#include "Foundation/RadixSort.hpp"
+#include "RenderObject/RenderGroup.hpp"
+#include "SceneObject/SceneRenderObjectManager.h"
+
+// Building the render queues of a frame from 1k to 1M objects.
+// stable_sort: the former path, every bucket rescans all objects and sorts a 128 bit key
+// (state, then the depth as a double) with std::ranges::stable_sort.
+// radix: one pass partitions the objects into the buckets, each bucket is radix sorted by its packed 64 bit key.
+// The submit columns walk the sorted queues like the passes record their draws and count the state changes.
+
+enum Bucket : uint8_t { eOpaque, eAlphaTest, eTransparent, eBucketCount };
+
+struct SceneObject {
+    RenderObjectKey key;
+    glm::vec3 position;
+    Bucket bucket;
+};
+
+struct LegacyKey {
+    uint64_t key1;
+    double key2;
+    friend auto operator<=>(const LegacyKey &, const LegacyKey &) = default;
+};
+
+struct LegacyItem {
+    LegacyKey key;
+    const SceneObject *pObject;
+};
+
+struct SortItem {
+    uint64_t key;
+    const SceneObject *pObject;
+};
+
+static auto BuildObjects(size_t objectCount) -> std::vector<SceneObject> {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> position(-500.f, 500.f);
+    std::vector<SceneObject> objects(objectCount);
+    for (SceneObject &object : objects) {
+        uint32_t kind = random() % 100;
+        object.bucket = kind < 70 ? eOpaque : (kind < 85 ? eAlphaTest : eTransparent);
+        uint16_t renderGroup = object.bucket == eOpaque ? RenderGroup::eOpaque
+                               : object.bucket == eAlphaTest ? RenderGroup::eAlphaTest
+                                                             : RenderGroup::eTransparent;
+        object.key.SetRenderGroup(renderGroup);
+        object.key.SetPipelineID(random() % 64);
+        object.key.SetMaterialID(random() % 1024);
+        object.position = glm::vec3(position(random), position(random), position(random));
+    }
+    return objects;
+}
+
+static auto DepthSqr(const SceneObject &object, const glm::vec3 &cameraPos) -> float {
+    glm::vec3 vector = cameraPos - object.position;
+    return dot(vector, vector);
+}
+
+static void SortLegacy(const std::vector<SceneObject> &objects,
+    const glm::vec3 &cameraPos,
+    std::array<std::vector<const SceneObject *>, eBucketCount> &queues) {
+    std::vector<LegacyItem> items;
+    for (size_t bucket = 0; bucket < eBucketCount; ++bucket) {
+        items.clear();
+        for (const SceneObject &object : objects) {
+            if (object.bucket != bucket) {
+                continue;
+            }
+            uint64_t key1 = (uint64_t(object.key.GetRenderGroup()) << 48) |
+                            (uint64_t(object.key.GetPriority()) << 32) | object.key.GetPipelineID();
+            items.push_back(LegacyItem{LegacyKey{key1, DepthSqr(object, cameraPos)}, &object});
+        }
+        std::ranges::stable_sort(items, {}, &LegacyItem::key);
+        queues[bucket].clear();
+        for (const LegacyItem &item : items) {
+            queues[bucket].push_back(item.pObject);
+        }
+    }
+}
+
+static void SortRadix(const std::vector<SceneObject> &objects,
+    const glm::vec3 &cameraPos,
+    std::array<std::vector<const SceneObject *>, eBucketCount> &queues) {
+    std::array<FrameVector<SortItem>, eBucketCount> bucketItems;
+    for (const SceneObject &object : objects) {
+        bucketItems[object.bucket].push_back(SortItem{object.key.Pack(DepthSqr(object, cameraPos)), &object});
+    }
+    for (size_t bucket = 0; bucket < eBucketCount; ++bucket) {
+        FrameVector<SortItem> &items = bucketItems[bucket];
+        FrameVector<SortItem> scratch(items.size());
+        RadixSort::ParallelSort(std::span(items), std::span(scratch), [](const SortItem &item) { return item.key; });
+        queues[bucket].clear();
+        for (const SortItem &item : items) {
+            queues[bucket].push_back(item.pObject);
+        }
+    }
+}
+
+// a pipeline or material switch between two consecutive draws of a queue
+static auto Submit(const std::array<std::vector<const SceneObject *>, eBucketCount> &queues) -> size_t {
+    size_t stateChangeCount = 0;
+    for (const std::vector<const SceneObject *> &queue : queues) {
+        const SceneObject *pPrevious = nullptr;
+        for (const SceneObject *pObject : queue) {
+            if (pPrevious == nullptr || pPrevious->key.GetPipelineID() != pObject->key.GetPipelineID() ||
+                pPrevious->key.GetMaterialID() != pObject->key.GetMaterialID()) {
+                ++stateChangeCount;
+            }
+            pPrevious = pObject;
+        }
+    }
+    return stateChangeCount;
+}
+
+int main(int argc, char **argv) {
+    bool quick = bench::IsQuickRun(argc, argv);
+    size_t maxObjectCount = quick ? 100 * 1000 : 1000 * 1000;
+    size_t repeatCount = quick ? 3 : 11;
+
+    JobSystem::OnInstanceCreate();
+    JobSystem::GetInstance()->OnCreate(std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1);
+
+    fmt::print("Render queue sort, 70% opaque, 15% alpha test, 15% transparent\n");
+    fmt::print("{:>9} {:>16} {:>10} {:>9} {:>19} {:>13}\n",
+        "objects",
+        "stable_sort ms",
+        "radix ms",
+        "speedup",
+        "stable_sort states",
+        "radix states");
+    glm::vec3 cameraPos(0.f);
+    std::array<std::vector<const SceneObject *>, eBucketCount> legacyQueues;
+    std::array<std::vector<const SceneObject *>, eBucketCount> radixQueues;
+    for (size_t objectCount = 1000; objectCount <= maxObjectCount; objectCount *= 10) {
+        std::vector<SceneObject> objects = BuildObjects(objectCount);
+        double legacyMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+            cameraPos.x += 1.f;
+            SortLegacy(objects, cameraPos, legacyQueues);
+        });
+        double radixMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+            cameraPos.x += 1.f;
+            SortRadix(objects, cameraPos, radixQueues);
+            FrameArena::OnPostRender();
+        });
+        fmt::print("{:>9} {:>16.3f} {:>10.3f} {:>8.2f}x {:>19} {:>13}\n",
+            objectCount,
+            legacyMilliseconds,
+            radixMilliseconds,
+            legacyMilliseconds / radixMilliseconds,
+            Submit(legacyQueues),
+            Submit(radixQueues));
+    }
+
+    JobSystem::GetInstance()->OnDestroy();
+    JobSystem::OnInstanceDestroy();
+    return 0;
+}
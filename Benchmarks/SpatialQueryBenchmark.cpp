@@ -0,0 +1,118 @@
+#include <random>
+#include "BenchmarkUtil.hpp"
+#include "Foundation/FrustumCulling.h"
+#include "SceneObject/DynamicAABBTree.h"
+
+// Visibility queries over a large world from 10k to 1M boxes, the linear tests against the DynamicAABBTree.
+// frustum: the batched linear FrustumCulling::Cull against DynamicAABBTree::QueryFrustum, about 1% is visible.
+// overlap: a linear AABB overlap scan against DynamicAABBTree::QueryAABB with a box of 50 units.
+// visible is the linear count and the tree count, the tree tests the fat boxes and is slightly conservative.
+
+static constexpr float kWorldExtent = 1000.f;
+static constexpr float kQueryExtent = 25.f;
+
+static auto MakeBoxes(size_t count) -> std::vector<AABB> {
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> position(-kWorldExtent, kWorldExtent);
+    std::uniform_real_distribution<float> size(0.5f, 4.f);
+    std::vector<AABB> boxes(count);
+    for (AABB &bounds : boxes) {
+        glm::vec3 center(position(random), position(random), position(random));
+        glm::vec3 extents(size(random), size(random), size(random));
+        bounds = AABB{center - extents, center + extents};
+    }
+    return boxes;
+}
+
+static auto MakeFrustum(float yaw) -> Frustum {
+    glm::vec3 target(std::sin(yaw), 0.f, std::cos(yaw));
+    glm::mat4x4 matView = glm::lookAt(glm::vec3(0.f), target, glm::vec3(0.f, 1.f, 0.f));
+    glm::mat4x4 matProj = glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 500.f);
+    return Frustum::FromMatrix(matProj * matView);
+}
+
+static bool Overlaps(const AABB &lhs, const AABB &rhs) {
+    return all(lessThanEqual(lhs.min, rhs.max)) && all(lessThanEqual(rhs.min, lhs.max));
+}
+
+int main(int argc, char **argv) {
+    bool quick = bench::IsQuickRun(argc, argv);
+    size_t maxBoxCount = quick ? 100 * 1000 : 1000 * 1000;
+    size_t repeatCount = quick ? 5 : 21;
+
+    fmt::print("Spatial queries, boxes in a {} unit cube\n", 2.f * kWorldExtent);
+    fmt::print("{:>9} {:>13} {:>12} {:>10} {:>9} {:>13} {:>10} {:>9}\n",
+        "boxes",
+        "visible",
+        "linear ms",
+        "tree ms",
+        "speedup",
+        "overlap lin",
+        "tree ms",
+        "speedup");
+    for (size_t boxCount = 10 * 1000; boxCount <= maxBoxCount; boxCount *= 10) {
+        std::vector<AABB> boxes = MakeBoxes(boxCount);
+        AABBSoA soa;
+        soa.Resize(boxCount);
+        DynamicAABBTree tree;
+        for (size_t i = 0; i < boxCount; ++i) {
+            soa.Set(i, boxes[i]);
+            tree.CreateProxy(boxes[i], nullptr);
+        }
+        tree.Rebuild();
+
+        std::vector<uint8_t> visible(boxCount);
+        size_t queryIndex = 0;
+        size_t linearVisibleCount = 0;
+        size_t treeVisibleCount = 0;
+        double linearFrustumMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+            Frustum frustum = MakeFrustum(0.1f * float(++queryIndex));
+            linearVisibleCount = FrustumCulling::Cull(frustum, soa, visible.data());
+        });
+        queryIndex = 0;
+        double treeFrustumMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+            Frustum frustum = MakeFrustum(0.1f * float(++queryIndex));
+            treeVisibleCount = 0;
+            tree.QueryFrustum(frustum, [&](int32_t) {
+                ++treeVisibleCount;
+                return true;
+            });
+            FrameArena::OnPostRender();
+        });
+
+        std::mt19937 random(5);
+        std::uniform_real_distribution<float> position(-kWorldExtent, kWorldExtent);
+        std::vector<AABB> queries(64);
+        for (AABB &query : queries) {
+            glm::vec3 center(position(random), position(random), position(random));
+            query = AABB{center - glm::vec3(kQueryExtent), center + glm::vec3(kQueryExtent)};
+        }
+        size_t overlapCount = 0;
+        double linearOverlapMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+            const AABB &query = queries[++queryIndex % queries.size()];
+            for (const AABB &bounds : boxes) {
+                overlapCount += static_cast<size_t>(Overlaps(query, bounds));
+            }
+        });
+        double treeOverlapMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+            const AABB &query = queries[++queryIndex % queries.size()];
+            tree.QueryAABB(query, [&](int32_t) {
+                ++overlapCount;
+                return true;
+            });
+            FrameArena::OnPostRender();
+        });
+        bench::DoNotOptimize(overlapCount);
+
+        fmt::print("{:>9} {:>13} {:>12.3f} {:>10.3f} {:>8.2f}x {:>13.3f} {:>10.3f} {:>8.2f}x\n",
+            boxCount,
+            fmt::format("{}/{}", linearVisibleCount, treeVisibleCount),
+            linearFrustumMilliseconds,
+            treeFrustumMilliseconds,
+            linearFrustumMilliseconds / treeFrustumMilliseconds,
+            linearOverlapMilliseconds,
+            treeOverlapMilliseconds,
+            linearOverlapMilliseconds / treeOverlapMilliseconds);
+    }
+    return 0;
+}
@@ -0,0 +1,286 @@
+#include <random>
+#include "BenchmarkUtil.hpp"
+#include "Foundation/FrustumCulling.h"
+#include "SceneObject/StaticBatcher.h"
+
+// CPU submit time of a plant like scene, every piece drawn on its own against the static batches.
+// The pieces are grouped into batches like StaticBatcher::Build does: by material, ordered along a z-order curve and
+// split at StaticBatcher::kMaxBatchVertexCount vertices, every piece becomes one sub mesh of its batch.
+// per object: the pieces are frustum culled with FrustumCulling::Cull and every visible piece records its draw.
+// batched: the batches are culled, then their sub meshes, the contiguous visible ranges are merged and every range
+// records one draw. "world" transforms every sub mesh box into world space and tests it on its own, the former
+// MeshRenderer::CullSubMeshes. "object" moves the frustum into object space and tests the boxes with
+// FrustumCulling::Cull, the current one.
+// A draw records the root constants, the vertex and index buffer and the draw call like GBufferPass into a command
+// buffer. The D3D12 command list adds its own cost per call on top, which scales with the commands column.
+
+static constexpr size_t kMaterialCount = 48;
+static constexpr size_t kPieceVertexCount = 400;
+static constexpr size_t kPieceIndexCount = 600;
+static constexpr float kWorldExtent = 400.f;
+
+struct Piece {
+    AABB bounds;
+    uint32_t material;
+    uint32_t mortonCode;
+};
+
+struct Range {
+    size_t baseIndex;
+    size_t indexCount;
+    AABB bounds;
+};
+
+struct Batch {
+    uint32_t material;
+    // the pieces relative to the origin of the batch, back to back in the index buffer
+    std::vector<Range> subMeshes;
+    AABBSoA subMeshBounds;
+    glm::mat4x4 matWorld;
+    AABB worldBounds;
+};
+
+// root constants, vertex buffer, index buffer, draw
+struct Command {
+    uint32_t type;
+    uint32_t args[8];
+};
+
+class CommandRecorder {
+public:
+    void Reset() {
+        _commands.clear();
+        _drawCount = 0;
+    }
+    void RecordDraw(uint32_t objectIndex, uint32_t material, size_t baseIndex, size_t indexCount) {
+        _commands.push_back(Command{0, {objectIndex, 0, material, material + 1, material + 2, material + 3, 0, 0}});
+        _commands.push_back(Command{1, {objectIndex, kPieceVertexCount, 0, 0, 0, 0, 0, 0}});
+        _commands.push_back(Command{2, {objectIndex, 0, 0, 0, 0, 0, 0, 0}});
+        _commands.push_back(
+            Command{3, {static_cast<uint32_t>(indexCount), 1, static_cast<uint32_t>(baseIndex), 0, 0, 0, 0, 0}});
+        ++_drawCount;
+    }
+    void RecordRange(size_t baseIndex, size_t indexCount) {
+        _commands.push_back(
+            Command{3, {static_cast<uint32_t>(indexCount), 1, static_cast<uint32_t>(baseIndex), 0, 0, 0, 0, 0}});
+        ++_drawCount;
+    }
+    auto GetCommandCount() const -> size_t {
+        return _commands.size();
+    }
+    auto GetDrawCount() const -> size_t {
+        return _drawCount;
+    }
+private:
+    std::vector<Command> _commands;
+    size_t _drawCount = 0;
+};
+
+static auto ExpandBits(uint32_t value) -> uint32_t {
+    value = (value * 0x00010001u) & 0xFF0000FFu;
+    value = (value * 0x00000101u) & 0x0F00F00Fu;
+    value = (value * 0x00000011u) & 0xC30C30C3u;
+    value = (value * 0x00000005u) & 0x49249249u;
+    return value;
+}
+
+static auto MortonCode(const glm::vec3 &point) -> uint32_t {
+    glm::vec3 coord = glm::clamp((point + kWorldExtent) / (2.f * kWorldExtent), glm::vec3(0.f), glm::vec3(1.f)) *
+                      1023.f;
+    return (ExpandBits(static_cast<uint32_t>(coord.x)) << 2) | (ExpandBits(static_cast<uint32_t>(coord.y)) << 1) |
+           ExpandBits(static_cast<uint32_t>(coord.z));
+}
+
+static auto BuildPieces(size_t pieceCount) -> std::vector<Piece> {
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> position(-kWorldExtent, kWorldExtent);
+    std::uniform_real_distribution<float> height(0.f, 60.f);
+    std::uniform_real_distribution<float> size(0.5f, 3.f);
+    std::vector<Piece> pieces(pieceCount);
+    for (Piece &piece : pieces) {
+        glm::vec3 center(position(random), height(random), position(random));
+        glm::vec3 extents(size(random), size(random), size(random));
+        piece.bounds = AABB{center - extents, center + extents};
+        piece.material = static_cast<uint32_t>(random() % kMaterialCount);
+        piece.mortonCode = MortonCode(center);
+    }
+    return pieces;
+}
+
+static auto BuildBatches(std::vector<Piece> pieces) -> std::vector<Batch> {
+    std::ranges::sort(pieces, [](const Piece &lhs, const Piece &rhs) {
+        return lhs.material != rhs.material ? lhs.material < rhs.material : lhs.mortonCode < rhs.mortonCode;
+    });
+    std::vector<Batch> batches;
+    size_t vertexCount = 0;
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        const Piece &piece = pieces[i];
+        if (i == 0 || piece.material != batches.back().material ||
+            vertexCount + kPieceVertexCount > StaticBatcher::kMaxBatchVertexCount) {
+            batches.push_back(Batch{piece.material, {}, {}, glm::identity<glm::mat4x4>(), AABB{}});
+            vertexCount = 0;
+        }
+        Batch &batch = batches.back();
+        batch.subMeshes.push_back(Range{batch.subMeshes.size() * kPieceIndexCount, kPieceIndexCount, piece.bounds});
+        batch.worldBounds.Merge(piece.bounds);
+        vertexCount += kPieceVertexCount;
+    }
+    // the batch is placed at the center of its pieces, the sub mesh bounds are relative to it
+    for (Batch &batch : batches) {
+        glm::vec3 origin = batch.worldBounds.GetCenter();
+        batch.matWorld = glm::translate(glm::identity<glm::mat4x4>(), origin);
+        batch.subMeshBounds.Resize(batch.subMeshes.size());
+        for (size_t i = 0; i < batch.subMeshes.size(); ++i) {
+            Range &subMesh = batch.subMeshes[i];
+            subMesh.bounds = AABB{subMesh.bounds.min - origin, subMesh.bounds.max - origin};
+            batch.subMeshBounds.Set(i, subMesh.bounds);
+        }
+    }
+    return batches;
+}
+
+static auto MakeFrustum(float yaw) -> Frustum {
+    glm::vec3 eye(0.f, 20.f, 0.f);
+    glm::vec3 target = eye + glm::vec3(std::sin(yaw), -0.2f, std::cos(yaw));
+    glm::mat4x4 matView = glm::lookAt(eye, target, glm::vec3(0.f, 1.f, 0.f));
+    glm::mat4x4 matProj = glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 2.f * kWorldExtent);
+    return Frustum::FromMatrix(matProj * matView);
+}
+
+static void SubmitPerObject(const Frustum &frustum,
+    const std::vector<Piece> &pieces,
+    const AABBSoA &soa,
+    std::vector<uint8_t> &visible,
+    CommandRecorder &recorder) {
+    FrustumCulling::Cull(frustum, soa, visible.data());
+    for (size_t i = 0; i < pieces.size(); ++i) {
+        if (visible[i] != 0) {
+            recorder.RecordDraw(static_cast<uint32_t>(i), pieces[i].material, 0, kPieceIndexCount);
+        }
+    }
+}
+
+static void AddRange(std::vector<Range> &visibleRanges, const Range &subMesh) {
+    if (!visibleRanges.empty()) {
+        Range &last = visibleRanges.back();
+        if (last.baseIndex + last.indexCount == subMesh.baseIndex) {
+            last.indexCount += subMesh.indexCount;
+            last.bounds.Merge(subMesh.bounds);
+            return;
+        }
+    }
+    visibleRanges.push_back(subMesh);
+}
+
+struct BatchCullContext {
+    std::vector<uint8_t> visible;
+    std::vector<uint8_t> subMeshVisible;
+    std::vector<Range> visibleRanges;
+};
+
+template<bool kObjectSpace>
+static void SubmitBatched(const Frustum &frustum,
+    const std::vector<Batch> &batches,
+    const AABBSoA &soa,
+    BatchCullContext &context,
+    CommandRecorder &recorder) {
+    FrustumCulling::Cull(frustum, soa, context.visible.data());
+    std::vector<Range> &visibleRanges = context.visibleRanges;
+    for (size_t i = 0; i < batches.size(); ++i) {
+        if (context.visible[i] == 0) {
+            continue;
+        }
+        const Batch &batch = batches[i];
+        visibleRanges.clear();
+        if constexpr (kObjectSpace) {
+            context.subMeshVisible.resize(batch.subMeshes.size());
+            FrustumCulling::Cull(frustum.Transform(batch.matWorld), batch.subMeshBounds, context.subMeshVisible.data());
+            for (size_t s = 0; s < batch.subMeshes.size(); ++s) {
+                if (context.subMeshVisible[s] != 0) {
+                    AddRange(visibleRanges, batch.subMeshes[s]);
+                }
+            }
+        } else {
+            for (const Range &subMesh : batch.subMeshes) {
+                if (frustum.Intersects(subMesh.bounds.Transform(batch.matWorld))) {
+                    AddRange(visibleRanges, subMesh);
+                }
+            }
+        }
+        if (visibleRanges.empty()) {
+            continue;
+        }
+        const Range &first = visibleRanges.front();
+        recorder.RecordDraw(static_cast<uint32_t>(i), batch.material, first.baseIndex, first.indexCount);
+        for (size_t r = 1; r < visibleRanges.size(); ++r) {
+            recorder.RecordRange(visibleRanges[r].baseIndex, visibleRanges[r].indexCount);
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    bool quick = bench::IsQuickRun(argc, argv);
+    size_t maxPieceCount = quick ? 10 * 1000 : 100 * 1000;
+    size_t repeatCount = quick ? 5 : 21;
+
+    fmt::print("Static batch submit, {} materials, {} vertices per piece\n", kMaterialCount, kPieceVertexCount);
+    fmt::print("{:>8} {:>8} {:>13} {:>10} {:>11} {:>12} {:>10} {:>10} {:>11} {:>9}\n",
+        "pieces",
+        "batches",
+        "object draws",
+        "commands",
+        "object ms",
+        "batch draws",
+        "commands",
+        "world ms",
+        "object ms",
+        "speedup");
+    for (size_t pieceCount = 1000; pieceCount <= maxPieceCount; pieceCount *= 10) {
+        std::vector<Piece> pieces = BuildPieces(pieceCount);
+        std::vector<Batch> batches = BuildBatches(pieces);
+        AABBSoA pieceSoA;
+        pieceSoA.Resize(pieces.size());
+        for (size_t i = 0; i < pieces.size(); ++i) {
+            pieceSoA.Set(i, pieces[i].bounds);
+        }
+        AABBSoA batchSoA;
+        batchSoA.Resize(batches.size());
+        for (size_t i = 0; i < batches.size(); ++i) {
+            batchSoA.Set(i, batches[i].worldBounds);
+        }
+
+        std::vector<uint8_t> visible(pieces.size());
+        BatchCullContext context;
+        context.visible.resize(batches.size());
+        CommandRecorder objectRecorder;
+        CommandRecorder worldRecorder;
+        CommandRecorder batchRecorder;
+        size_t viewIndex = 0;
+        double objectMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+            objectRecorder.Reset();
+            SubmitPerObject(MakeFrustum(0.3f * float(++viewIndex)), pieces, pieceSoA, visible, objectRecorder);
+        });
+        viewIndex = 0;
+        double worldMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+            worldRecorder.Reset();
+            SubmitBatched<false>(MakeFrustum(0.3f * float(++viewIndex)), batches, batchSoA, context, worldRecorder);
+        });
+        viewIndex = 0;
+        double batchMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+            batchRecorder.Reset();
+            SubmitBatched<true>(MakeFrustum(0.3f * float(++viewIndex)), batches, batchSoA, context, batchRecorder);
+        });
+        fmt::print("{:>8} {:>8} {:>13} {:>10} {:>11.3f} {:>12} {:>10} {:>10.3f} {:>11.3f} {:>8.2f}x\n",
+            pieceCount,
+            batches.size(),
+            objectRecorder.GetDrawCount(),
+            objectRecorder.GetCommandCount(),
+            objectMilliseconds,
+            batchRecorder.GetDrawCount(),
+            batchRecorder.GetCommandCount(),
+            worldMilliseconds,
+            batchMilliseconds,
+            objectMilliseconds / batchMilliseconds);
+    }
+    return 0;
+}
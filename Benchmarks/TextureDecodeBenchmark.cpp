@@ -0,0 +1,108 @@
+#include <dxgiformat.h>
+#include <random>
+#include <thread>
+#include "BenchmarkUtil.hpp"
+#include "D3d12/IImageLoader.h"
+#include "Foundation/JobSystem.h"
+#include "TextureObject/TextureLoader.h"
+
+// Decoding the textures of a 100 texture GLTF model like GLTFLoader::LoadTexturesAsync, one background job per texture,
+// from 0 workers (everything inline on the calling thread) up to one worker per core. The calling thread only waits,
+// like the main thread it does not run background jobs.
+// Every texture is imported cold through TextureLoader::ImportImage: the image is decoded, mipmapped and stored as
+// a TextureImportCache entry, the entries are deleted before every run. The upload on the main thread is not timed.
+
+static constexpr size_t kTextureCount = 100;
+
+// 32 bit uncompressed TGA, smooth gradients with noise
+static auto BuildTga(uint32_t size) -> std::vector<uint8_t> {
+    std::vector<uint8_t> file(18 + size_t(size) * size * 4, 0);
+    file[2] = 2;
+    file[12] = static_cast<uint8_t>(size & 0xff);
+    file[13] = static_cast<uint8_t>(size >> 8);
+    file[14] = static_cast<uint8_t>(size & 0xff);
+    file[15] = static_cast<uint8_t>(size >> 8);
+    file[16] = 32;
+    // top left origin, 8 alpha bits
+    file[17] = 0x28;
+    std::mt19937 random(25);
+    uint8_t *pPixel = file.data() + 18;
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x, pPixel += 4) {
+            uint32_t noise = random();
+            pPixel[0] = static_cast<uint8_t>(((x ^ y) & 0xf0) + (noise & 0x0f));
+            pPixel[1] = static_cast<uint8_t>(((y * 255 / size) & 0xf0) + ((noise >> 8) & 0x0f));
+            pPixel[2] = static_cast<uint8_t>(((x * 255 / size) & 0xf0) + ((noise >> 16) & 0x0f));
+            pPixel[3] = 255;
+        }
+    }
+    return file;
+}
+
+int main(int argc, char **argv) {
+    bool quick = bench::IsQuickRun(argc, argv);
+    uint32_t size = quick ? 256 : 1024;
+    size_t repeatCount = quick ? 3 : 5;
+    size_t maxWorkerCount = std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1;
+
+    TextureImportSettings settings;
+    settings.sRGB = true;
+    std::vector<uint8_t> image = BuildTga(size);
+    stdfs::path cacheDirectory = stdfs::temp_directory_path() / "TextureDecodeBenchmark";
+    stdfs::create_directories(cacheDirectory);
+    std::vector<stdfs::path> cachePaths;
+    for (size_t i = 0; i < kTextureCount; ++i) {
+        cachePaths.push_back(cacheDirectory / fmt::format("{}.dds", i));
+    }
+
+    // 0, 1, 2, 4 ... and the worker count of the machine
+    std::vector<size_t> workerCounts = {0};
+    for (size_t workerCount = 1; workerCount < maxWorkerCount; workerCount *= 2) {
+        workerCounts.push_back(workerCount);
+    }
+    workerCounts.push_back(maxWorkerCount);
+
+    JobSystem::OnInstanceCreate();
+    JobSystem *pJobSystem = JobSystem::GetInstance();
+    fmt::print("Cold import of {} RGBA8 sRGB {}x{} textures, one job per texture\n", kTextureCount, size, size);
+    fmt::print("{:>8} {:>10} {:>10} {:>12}\n", "workers", "ms", "speedup", "textures/s");
+    double baseMilliseconds = 0.0;
+    // the loaders are released in the job, a hundred mip chains do not need to stay in memory
+    std::vector<uint32_t> mipCounts(kTextureCount);
+    for (size_t workerCount : workerCounts) {
+        pJobSystem->OnCreate(workerCount);
+        double milliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+            for (const stdfs::path &cachePath : cachePaths) {
+                stdfs::remove(cachePath);
+            }
+            JobCounter counter;
+            for (size_t i = 0; i < kTextureCount; ++i) {
+                pJobSystem->ScheduleBackground(
+                    [&, i]() {
+                        std::unique_ptr<dx::IImageLoader> pLoader = TextureLoader::ImportImage(image.data(),
+                            image.size(),
+                            cachePaths[i],
+                            settings,
+                            1.f);
+                        mipCounts[i] = pLoader->GetImageHeader().mipMapCount;
+                    },
+                    &counter);
+            }
+            pJobSystem->Wait(counter);
+        });
+        pJobSystem->OnDestroy();
+
+        if (workerCount == 0) {
+            baseMilliseconds = milliseconds;
+        }
+        fmt::print("{:>8} {:>10.1f} {:>9.2f}x {:>12.1f}\n",
+            workerCount,
+            milliseconds,
+            baseMilliseconds / milliseconds,
+            double(kTextureCount) * 1000.0 / milliseconds);
+        bench::DoNotOptimize(mipCounts);
+    }
+    JobSystem::OnInstanceDestroy();
+    stdfs::remove_all(cacheDirectory);
+    return 0;
+}
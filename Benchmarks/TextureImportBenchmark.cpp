@@ -0,0 +1,117 @@
+#include <dxgiformat.h>
+#include <random>
+#include "BenchmarkUtil.hpp"
+#include "D3d12/FormatHelper.hpp"
+#include "D3d12/IImageLoader.h"
+#include "TextureObject/BlockCompressor.h"
+#include "TextureObject/TextureLoader.h"
+
+// Importing an image through TextureLoader::ImportImage with and without its TextureImportCache entry.
+// cold: the entry is deleted first, the image is decoded, mipmapped, optionally block compressed and stored.
+// warm: the entry is read back with FileDDSLoader, the file is in the OS file cache after the first run.
+// Both read every mip out of the loader like UploadTexture does. The source is an uncompressed TGA, a PNG or JPEG
+// adds its decode time to the cold column only. The cutout case adds the alpha coverage search of every mip.
+
+struct ImportCase {
+    const char *name;
+    TextureImportSettings settings;
+    // below 1 the mips keep the alpha test coverage of the top level
+    float cutOff = 1.f;
+};
+
+// 32 bit uncompressed TGA, smooth gradients with noise, the alpha is a blurred checker for the cutout case
+static auto BuildTga(uint32_t size) -> std::vector<uint8_t> {
+    std::vector<uint8_t> file(18 + size_t(size) * size * 4, 0);
+    file[2] = 2;
+    file[12] = static_cast<uint8_t>(size & 0xff);
+    file[13] = static_cast<uint8_t>(size >> 8);
+    file[14] = static_cast<uint8_t>(size & 0xff);
+    file[15] = static_cast<uint8_t>(size >> 8);
+    file[16] = 32;
+    // top left origin, 8 alpha bits
+    file[17] = 0x28;
+    std::mt19937 random(24);
+    uint8_t *pPixel = file.data() + 18;
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x, pPixel += 4) {
+            uint32_t noise = random();
+            pPixel[0] = static_cast<uint8_t>(((x ^ y) & 0xf0) + (noise & 0x0f));
+            pPixel[1] = static_cast<uint8_t>(((y * 255 / size) & 0xf0) + ((noise >> 8) & 0x0f));
+            pPixel[2] = static_cast<uint8_t>(((x * 255 / size) & 0xf0) + ((noise >> 16) & 0x0f));
+            pPixel[3] = static_cast<uint8_t>((((x / 32) ^ (y / 32)) & 1) != 0 ? 255 - (noise >> 26) : noise >> 26);
+        }
+    }
+    return file;
+}
+
+// copies every mip into tightly packed rows, the rows of block compressed mips are block rows
+static auto ReadMips(dx::IImageLoader *pLoader) -> size_t {
+    static std::vector<uint8_t> sStaging;
+    dx::ImageHeader header = pLoader->GetImageHeader();
+    bool compressed = dx::IsBCFormat(header.format);
+    size_t byteCount = 0;
+    for (uint32_t mip = 0; mip < header.mipMapCount; ++mip) {
+        uint32_t width = std::max(header.width >> mip, 1u);
+        uint32_t height = std::max(header.height >> mip, 1u);
+        uint32_t rowCount = compressed ? BlockCompressor::GetBlockCount(height) : height;
+        // a block holds 16 pixels
+        uint32_t rowSize = compressed ? BlockCompressor::GetBlockCount(width) * header.bitCount * 2
+                                      : width * header.bitCount / 8;
+        sStaging.resize(size_t(rowSize) * rowCount);
+        pLoader->GetNextMipMapData(sStaging.data(), rowSize, rowSize, rowCount);
+        byteCount += sStaging.size();
+    }
+    return byteCount;
+}
+
+int main(int argc, char **argv) {
+    bool quick = bench::IsQuickRun(argc, argv);
+    std::vector<uint32_t> sizes = quick ? std::vector<uint32_t>{512, 1024} : std::vector<uint32_t>{2048, 4096};
+    size_t repeatCount = quick ? 3 : 7;
+
+    ImportCase importCases[3];
+    importCases[0].name = "rgba8";
+    importCases[0].settings.sRGB = true;
+    importCases[1].name = "cutout";
+    importCases[1].settings.sRGB = true;
+    importCases[1].cutOff = 0.5f;
+    importCases[2].name = "bc7";
+    importCases[2].settings.sRGB = true;
+    importCases[2].settings.compress = true;
+
+    stdfs::path cacheDirectory = stdfs::temp_directory_path() / "TextureImportBenchmark";
+    stdfs::create_directories(cacheDirectory);
+
+    fmt::print("Texture import with and without the cache entry, sRGB color, full mip chain\n");
+    fmt::print("{:>6} {:>7} {:>10} {:>10} {:>9} {:>10}\n", "size", "case", "cold ms", "warm ms", "speedup", "entry MB");
+    for (uint32_t size : sizes) {
+        std::vector<uint8_t> image = BuildTga(size);
+        for (const ImportCase &importCase : importCases) {
+            stdfs::path cachePath = cacheDirectory / fmt::format("{}_{}.dds", size, importCase.name);
+            size_t byteCount = 0;
+            auto importImage = [&]() {
+                std::unique_ptr<dx::IImageLoader> pLoader = TextureLoader::ImportImage(image.data(),
+                    image.size(),
+                    cachePath,
+                    importCase.settings,
+                    importCase.cutOff);
+                byteCount = ReadMips(pLoader.get());
+            };
+            double coldMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+                stdfs::remove(cachePath);
+                importImage();
+            });
+            double warmMilliseconds = bench::MeasureMilliseconds(repeatCount, importImage);
+            fmt::print("{:>6} {:>7} {:>10.1f} {:>10.1f} {:>8.1f}x {:>10.1f}\n",
+                size,
+                importCase.name,
+                coldMilliseconds,
+                warmMilliseconds,
+                coldMilliseconds / warmMilliseconds,
+                double(stdfs::file_size(cachePath)) / (1024.0 * 1024.0));
+            bench::DoNotOptimize(byteCount);
+        }
+    }
+    stdfs::remove_all(cacheDirectory);
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include "BenchmarkUtil.hpp"
+#include "Components/Transform.h"
+#include "Foundation/Memory/GarbageCollection.h"
+#include "Object/GameObject.h"
+#include "SceneObject/TickRegistry.h"
+
+// Ticking a scene where only a few objects have update logic, the hierarchy walk against the TickRegistry.
+// The walk mirrors the old Scene::InvokeTickFunc, every phase visits every active game object and tests the tick
+// type of each of its components. The registry only visits the components subscribed to the phase.
+
+static constexpr size_t kRootCount = 64;
+static constexpr size_t kBranchCount = 4;
+static constexpr size_t kUpdateLogicStep = 100;
+
+class UpdateLogic : public Component {
+    DECLARE_CLASS(UpdateLogic);
+public:
+    void OnUpdate() override {
+        Transform *pTransform = GetGameObject()->GetTransform();
+        glm::vec3 position = pTransform->GetLocalPosition();
+        position.y = position.y > 10.f ? 0.f : position.y + 0.01f;
+        pTransform->SetLocalPosition(position);
+    }
+};
+
+struct TickScene {
+    std::vector<SharedPtr<GameObject>> gameObjects;
+    std::vector<Component *> tickComponents;
+    size_t rootCount = 0;
+};
+
+// node i is a child of node (i - kRootCount) / kBranchCount, every kUpdateLogicStep-th node has update logic
+static auto BuildScene(size_t nodeCount) -> TickScene {
+    TickScene scene;
+    scene.gameObjects.reserve(nodeCount);
+    scene.rootCount = std::min(nodeCount, kRootCount);
+    for (size_t i = 0; i < nodeCount; ++i) {
+        SharedPtr<GameObject> pGameObject = GameObject::Create();
+        scene.tickComponents.push_back(pGameObject->GetTransform());
+        if (i % kUpdateLogicStep == 0) {
+            UpdateLogic *pUpdateLogic = pGameObject->AddComponent<UpdateLogic>();
+            pUpdateLogic->SetTickType(Component::eUpdate);
+            scene.tickComponents.push_back(pUpdateLogic);
+        }
+        if (i >= kRootCount) {
+            scene.gameObjects[(i - kRootCount) / kBranchCount]->AddChild(pGameObject);
+        }
+        scene.gameObjects.push_back(std::move(pGameObject));
+    }
+    return scene;
+}
+
+static void InvokeComponent(Component *pComponent, Component::TickType phase) {
+    if (pComponent == nullptr || !HasFlag(pComponent->GetTickType(), phase) || !pComponent->GetActive()) {
+        return;
+    }
+    switch (phase) {
+    case Component::ePreUpdate:
+        pComponent->OnPreUpdate();
+        break;
+    case Component::eUpdate:
+        pComponent->OnUpdate();
+        break;
+    case Component::ePostUpdate:
+        pComponent->OnPostUpdate();
+        break;
+    case Component::ePreRender:
+        pComponent->OnPreRender();
+        break;
+    case Component::eRender:
+        pComponent->OnRender();
+        break;
+    case Component::ePostRender:
+        pComponent->OnPostRender();
+        break;
+    default:
+        break;
+    }
+}
+
+static void WalkHierarchy(GameObject *pGameObject, Component::TickType phase) {
+    InvokeComponent(pGameObject->GetTransform(), phase);
+    InvokeComponent(pGameObject->GetComponent<UpdateLogic>(), phase);
+    for (const SharedPtr<GameObject> &pChild : pGameObject->GetChildren()) {
+        if (pChild->GetActive()) {
+            WalkHierarchy(pChild.Get(), phase);
+        }
+    }
+}
+
+static void TickByWalk(const TickScene &scene) {
+    for (size_t phaseIndex = 0; phaseIndex < Component::kTickPhaseCount; ++phaseIndex) {
+        auto phase = static_cast<Component::TickType>(1 << phaseIndex);
+        for (size_t i = 0; i < scene.rootCount; ++i) {
+            if (scene.gameObjects[i]->GetActive()) {
+                WalkHierarchy(scene.gameObjects[i].Get(), phase);
+            }
+        }
+    }
+}
+
+static void TickByRegistry(TickRegistry &tickRegistry) {
+    for (size_t phaseIndex = 0; phaseIndex < Component::kTickPhaseCount; ++phaseIndex) {
+        tickRegistry.Invoke(static_cast<Component::TickType>(1 << phaseIndex));
+    }
+}
+
+int main(int argc, char **argv) {
+    bool quick = bench::IsQuickRun(argc, argv);
+    size_t nodeCount = quick ? 10 * 1000 : 100 * 1000;
+    size_t repeatCount = quick ? 5 : 21;
+
+    GarbageCollection::OnInstanceCreate();
+    GarbageCollection::GetInstance()->OnCreate();
+    {
+        TickScene walkScene = BuildScene(nodeCount);
+        TickScene registryScene = BuildScene(nodeCount);
+        TickRegistry tickRegistry;
+        for (Component *pComponent : registryScene.tickComponents) {
+            tickRegistry.Register(pComponent);
+        }
+
+        double walkMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() { TickByWalk(walkScene); });
+        double registryMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() { TickByRegistry(tickRegistry); });
+        fmt::print("Tick all phases, {} game objects, {} with update logic\n",
+            nodeCount,
+            tickRegistry.GetTickCount(Component::eUpdate));
+        fmt::print("{:>10} {:>14} {:>10}\n", "walk ms", "registry ms", "speedup");
+        fmt::print("{:>10.3f} {:>14.3f} {:>9.2f}x\n",
+            walkMilliseconds,
+            registryMilliseconds,
+            walkMilliseconds / registryMilliseconds);
+    }
+    GarbageCollection::GetInstance()->OnDestroy();
+    GarbageCollection::OnInstanceDestroy();
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include "BenchmarkUtil.hpp"
+#include "Components/Transform.h"
+#include "Foundation/Memory/GarbageCollection.h"
+#include "Object/GameObject.h"
+#include "SceneObject/TransformSystem.h"
+
+// World matrix propagation of a wide hierarchy, lazy recursive GetWorldMatrix against the TransformSystem sweep.
+// Each frame moves some nodes, resolves the world matrices and reads every one of them like the renderers do.
+// "roots moved" dirties the whole hierarchy, "1% moved" scatters local changes over all levels.
+
+static constexpr size_t kRootCount = 64;
+static constexpr size_t kBranchCount = 4;
+
+struct Hierarchy {
+    std::vector<SharedPtr<GameObject>> gameObjects;
+    std::vector<Transform *> transforms;
+};
+
+// node i is a child of node (i - kRootCount) / kBranchCount, so parents always come first
+static auto BuildHierarchy(size_t nodeCount) -> Hierarchy {
+    Hierarchy hierarchy;
+    hierarchy.gameObjects.reserve(nodeCount);
+    hierarchy.transforms.reserve(nodeCount);
+    for (size_t i = 0; i < nodeCount; ++i) {
+        SharedPtr<GameObject> pGameObject = GameObject::Create();
+        Transform *pTransform = pGameObject->GetTransform();
+        pTransform->SetLocalPosition(glm::vec3(float(i % 7), float(i % 5), float(i % 3)));
+        if (i >= kRootCount) {
+            hierarchy.gameObjects[(i - kRootCount) / kBranchCount]->AddChild(pGameObject);
+        }
+        hierarchy.transforms.push_back(pTransform);
+        hierarchy.gameObjects.push_back(std::move(pGameObject));
+    }
+    return hierarchy;
+}
+
+static void MoveNodes(const Hierarchy &hierarchy, size_t frameIndex, bool moveRoots) {
+    float offset = (frameIndex & 1) != 0 ? 1.f : 0.f;
+    size_t count = moveRoots ? kRootCount : hierarchy.transforms.size();
+    size_t step = moveRoots ? 1 : 100;
+    for (size_t i = 0; i < count; i += step) {
+        hierarchy.transforms[i]->SetLocalPosition(glm::vec3(float(i % 7) + offset, float(i % 5), float(i % 3)));
+    }
+}
+
+static auto ReadWorldMatrices(const Hierarchy &hierarchy) -> float {
+    float sum = 0.f;
+    for (const Transform *pTransform : hierarchy.transforms) {
+        sum += pTransform->GetWorldMatrix()[3].x;
+    }
+    return sum;
+}
+
+int main(int argc, char **argv) {
+    bool quick = bench::IsQuickRun(argc, argv);
+    size_t nodeCount = quick ? 10 * 1000 : 100 * 1000;
+    size_t repeatCount = quick ? 5 : 21;
+
+    GarbageCollection::OnInstanceCreate();
+    GarbageCollection::GetInstance()->OnCreate();
+    {
+        Hierarchy lazyHierarchy = BuildHierarchy(nodeCount);
+        Hierarchy systemHierarchy = BuildHierarchy(nodeCount);
+        TransformSystem transformSystem;
+        for (Transform *pTransform : systemHierarchy.transforms) {
+            transformSystem.AddTransform(pTransform);
+        }
+        transformSystem.UpdateWorldMatrices();
+
+        fmt::print("Transform propagation, {} nodes, {} roots, {} children per node\n",
+            nodeCount,
+            kRootCount,
+            kBranchCount);
+        fmt::print("{:>14} {:>10} {:>16} {:>10}\n", "moved", "lazy ms", "system ms", "speedup");
+        for (bool moveRoots : {true, false}) {
+            size_t frameIndex = 0;
+            float sum = 0.f;
+            double lazyMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+                MoveNodes(lazyHierarchy, ++frameIndex, moveRoots);
+                sum += ReadWorldMatrices(lazyHierarchy);
+            });
+            double systemMilliseconds = bench::MeasureMilliseconds(repeatCount, [&]() {
+                MoveNodes(systemHierarchy, ++frameIndex, moveRoots);
+                transformSystem.UpdateWorldMatrices();
+                sum += ReadWorldMatrices(systemHierarchy);
+            });
+            bench::DoNotOptimize(sum);
+            fmt::print("{:>14} {:>10.2f} {:>16.2f} {:>9.2f}x\n",
+                moveRoots ? "roots" : "1%",
+                lazyMilliseconds,
+                systemMilliseconds,
+                lazyMilliseconds / systemMilliseconds);
+        }
+    }
+    GarbageCollection::GetInstance()->OnDestroy();
+    GarbageCollection::OnInstanceDestroy();
+    return 0;
+}
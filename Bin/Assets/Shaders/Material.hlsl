@@ -33,6 +33,8 @@ struct CbMaterial {
  *  ENABLE_METAL_ROUGHNESS_TEXTURE
  *  ENABLE_NORMAL_TEX
  *  ENABLE_VERTEX_COLOR
+ *  ENABLE_INSTANCING
+ *  ENABLE_GPU_SCENE
  */
 
 #define ENABLE_VERTEX_UV (ENABLE_ALBEDO_TEXTURE            ||           \
@@ -75,22 +77,66 @@ struct VertexOut {
 };
 
 ConstantBuffer<CBPrePass>       gCbPrePass              : register(b0);
-ConstantBuffer<CBPreObject>     gCbPreObject            : register(b1);
 ConstantBuffer<CbLighting>      gCbLighting             : register(b3);
 SamplerState                    gStaticSamplerState[]   : register(s0);
-
-ConstantBuffer<CbMaterial>      gCbMaterial             : register(b2);
 Texture2D<float4>               gTextureList[]          : register(t0);
 
-VertexOut VSMain(VertexIn vin) {
+#if ENABLE_GPU_SCENE
+    // the constants are read from the GPUScene by index, the texture indices are per draw
+    struct CbDraw {
+        uint    objectIndex;
+        uint    firstInstance;
+        uint    materialIndex;
+        int     albedoTexIndex;
+        int     ambientOcclusionTexIndex;
+        int     emissionTexIndex;
+        int     metalRoughnessTexIndex;
+        int     normalTexIndex;
+    };
+    ConstantBuffer<CbDraw>          gCbDraw             : register(b1);
+    StructuredBuffer<CBPreObject>   gObjects            : register(t1, space1);
+    StructuredBuffer<CbMaterial>    gMaterials          : register(t2, space1);
+    #if ENABLE_INSTANCING
+        StructuredBuffer<uint>      gInstanceData       : register(t0, space1);
+    #endif
+    static CbMaterial               gCbMaterial;
+#else
+    ConstantBuffer<CBPreObject>     gCbPreObject        : register(b1);
+    ConstantBuffer<CbMaterial>      gCbMaterial         : register(b2);
+#endif
+
+void LoadMaterial() {
+    #if ENABLE_GPU_SCENE
+        gCbMaterial = gMaterials[gCbDraw.materialIndex];
+        gCbMaterial.albedoTexIndex = gCbDraw.albedoTexIndex;
+        gCbMaterial.ambientOcclusionTexIndex = gCbDraw.ambientOcclusionTexIndex;
+        gCbMaterial.emissionTexIndex = gCbDraw.emissionTexIndex;
+        gCbMaterial.metalRoughnessTexIndex = gCbDraw.metalRoughnessTexIndex;
+        gCbMaterial.normalTexIndex = gCbDraw.normalTexIndex;
+    #endif
+}
+
+CBPreObject LoadPreObject(uint instanceID) {
+    #if ENABLE_GPU_SCENE && ENABLE_INSTANCING
+        return gObjects[gInstanceData[gCbDraw.firstInstance + instanceID]];
+    #elif ENABLE_GPU_SCENE
+        return gObjects[gCbDraw.objectIndex];
+    #else
+        return gCbPreObject;
+    #endif
+}
+
+VertexOut VSMain(VertexIn vin, uint instanceID : SV_InstanceID) {
+    LoadMaterial();
+    CBPreObject preObject = LoadPreObject(instanceID);
     VertexOut vout = (VertexOut)0;
     float4 localPosition = float4(vin.position, 1.0);
-    float4 worldPosition = mul(gCbPreObject.matWorld, localPosition);
+    float4 worldPosition = mul(preObject.matWorld, localPosition);
     vout.SVPosition = mul(gCbPrePass.matJitteredViewProj, worldPosition);
     vout.position = worldPosition.xyz;
-    vout.normal = mul((float3x3)gCbPreObject.matNormal, vin.normal);
+    vout.normal = mul((float3x3)preObject.matNormal, vin.normal);
     #if ENABLE_NORMAL_TEX
-        vout.tangent.xyz = mul((float3x3)gCbPreObject.matWorld, vin.tangent.xyz);
+        vout.tangent.xyz = mul((float3x3)preObject.matWorld, vin.tangent.xyz);
         vout.tangent *= vin.tangent.w;
     #endif
     #if ENABLE_VERTEX_COLOR
@@ -101,7 +147,7 @@ VertexOut VSMain(VertexIn vin) {
     #endif
     #if GENERATE_MOTION_VECTOR
 		vout.currentClipPos = vout.SVPosition;
-		vout.previousClipPos = mul(gCbPrePass.matViewProjPrev, mul(gCbPreObject.matWorldPrev, localPosition));
+		vout.previousClipPos = mul(gCbPrePass.matViewProjPrev, mul(preObject.matWorldPrev, localPosition));
 	#endif
     return vout;
 }
@@ -148,6 +194,8 @@ float3 GetNormal(VertexOut pin) {
         uint textureIndex = NonUniformResourceIndex(gCbMaterial.normalTexIndex);
 		float3 sampleNormal = gTextureList[textureIndex].SampleBias(samplerState, pin.uv0, gCbPrePass.mipBias);
 		sampleNormal = sampleNormal * 2.f - 1.f;
+		// BC5 normal maps only store xy
+		sampleNormal.z = sqrt(saturate(1.f - dot(sampleNormal.xy, sampleNormal.xy)));
         float3 T = normalize(pin.tangent);
         float3 B = cross(N, T);
 		N = T * sampleNormal.x + B * sampleNormal.y + N * sampleNormal.z;
@@ -185,6 +233,7 @@ float2 CalcMotionVector(float4 currentClipPos, float4 previousClipPos) {
 }
 
 float4 ForwardPSMain(VertexOut pin) : SV_TARGET {
+    LoadMaterial();
     float2 metallicAndRoughness = GetMetallicAndRoughness(pin);
     float metallic = metallicAndRoughness.r;
     float roughness = metallicAndRoughness.g;
@@ -209,6 +258,7 @@ struct GBufferOut {
 };
 GBufferOut GBufferPSMain(VertexOut pin) {
 	GBufferOut pout = (GBufferOut)0;
+    LoadMaterial();
     float2 metallicAndRoughness = GetMetallicAndRoughness(pin);
     float4 albedo = GetAlbedo(pin);
     float3 N = GetNormal(pin);
@@ -1,13 +1,18 @@
 #include "Application.h"
+#include "Components/Transform.h"
 #include "D3d12/Device.h"
 #include "D3d12/UploadHeap.h"
+#include "Foundation/JobSystem.h"
 #include "Foundation/Logger.h"
+#include "Foundation/Memory/FrameArena.h"
 #include "Foundation/Memory/GarbageCollection.h"
+#include "Foundation/Memory/HeapAllocationCounter.h"
 #include "InputSystem/InputSystem.h"
 #include "InputSystem/Window.h"
 #include "Renderer/GfxDevice.h"
 #include "Renderer/GUI/GUI.h"
 #include "Renderer/RenderUtils/FrameCaptrue.h"
+#include "Renderer/RenderUtils/GPUScene.h"
 #include "Renderer/Samples/Renderer.h"
 #include "SceneObject/SceneManager.h"
 #include "ShaderLoader/ShaderManager.h"
@@ -29,14 +34,17 @@ Application::~Application() {
 
 void Application::OnCreate() {
     Logger::OnInstanceCreate();
+    JobSystem::OnInstanceCreate();
     AssetProjectSetting::OnInstanceCreate();
     InputSystem::OnInstanceCreate();
     GfxDevice::OnInstanceCreate();
     ShaderManager::OnInstanceCreate();
     GarbageCollection::OnInstanceCreate();
+    GPUScene::OnInstanceCreate();
     SceneManager::OnInstanceCreate();
 
     Logger::GetInstance()->OnCreate();
+    JobSystem::GetInstance()->OnCreate();
     AssetProjectSetting::GetInstance()->OnCreate();
     InputSystem *pInputSystem = InputSystem::GetInstance();
     pInputSystem->OnCreate("RayTracing", 1280, 720);
@@ -51,6 +59,7 @@ void Application::OnCreate() {
 
     // the gpu needs to run the command finish before the resource can be safely released
     GarbageCollection::GetInstance()->SetDelayedReleaseFrames(GfxDevice::GetInstance()->GetNumBackBuffer() + 1);
+    GPUScene::GetInstance()->OnCreate();
     SceneManager::GetInstance()->OnCreate();
     GlobalCallbacks::Get().OnCreate.Invoke();
     GUI::Get().OnCreate();
@@ -88,8 +97,11 @@ void Application::OnDestroy() {
     GUI::Get().OnDestroy();
     GlobalCallbacks::Get().OnDestroy.Invoke();
 
+    // finish all in-flight jobs before the systems they may reference are destroyed
+    JobSystem::GetInstance()->OnDestroy();
     SceneManager::GetInstance()->OnDestroy();
     SceneManager::GetInstance()->OnDestroy();
+    GPUScene::GetInstance()->OnDestroy();
     ShaderManager::GetInstance()->OnDestroy();
     GarbageCollection::GetInstance()->OnDestroy();
     GfxDevice::GetInstance()->OnDestroy();
@@ -99,11 +111,13 @@ void Application::OnDestroy() {
     Logger::GetInstance()->OnDestroy();
 
     SceneManager::OnInstanceDestroy();
+    GPUScene::OnInstanceDestroy();
     GarbageCollection::OnInstanceDestroy();
     GfxDevice::OnInstanceDestroy();
     ShaderManager::OnInstanceDestroy();
     AssetProjectSetting::OnInstanceDestroy();
     InputSystem::OnInstanceDestroy();
+    JobSystem::OnInstanceDestroy();
     Logger::OnInstanceDestroy();
 }
 
@@ -172,10 +186,14 @@ void Application::OnPostRender(GameTimer &timer) {
     MainThread::ExecuteMainThreadJob(MainThread::PostRender, timer);
     GlobalCallbacks::Get().OnPostRender.Invoke(std::ref(timer));
     _pRenderer->OnPostRender(timer);
+    Transform::OnFrameEnd();
     GarbageCollection::GetInstance()->OnPostRender(timer);
+    FrameArena::OnPostRender();
 }
 
 void Application::OnResize(uint32_t width, uint32_t height) {
+    // the swap chain and the render targets are recreated
+    ScopedHeapAllocationPermit heapAllocationPermit;
     _shouldResize = false;
     GfxDevice::GetInstance()->GetDevice()->WaitForGPUFlush();
     GlobalCallbacks::Get().OnResize.Invoke(width, height);
@@ -1,4 +1,5 @@
 #include "CameraColtroller.h"
+#include "Camera.h"
 #include "Foundation/GameTimer.h"
 #include "Foundation/Logger.h"
 #include "InputSystem/InputSystem.h"
@@ -46,10 +47,9 @@ void CameraController::OnRemoveFormScene() {
     Component::OnRemoveFormScene();
 }
 
-class Camera;
 void CameraController::OnPostUpdate() {
     Transform *pTransform = GetGameObject()->GetComponent<Transform>();
-    if (pTransform == nullptr || !GetGameObject()->HasComponent(::GetTypeID<Camera>())) {
+    if (pTransform == nullptr || !GetGameObject()->HasComponent<Camera>()) {
         return;
     }
 
@@ -1,7 +1,24 @@
 #include "Component.h"
 #include "Object/GameObject.h"
+#include "SceneObject/TickRegistry.h"
 
-Component::Component() : _pGameObject(nullptr), _tickType(eNone) {
+Component::Component()
+    : _pGameObject(nullptr), _tickType(eNone), _pTickRegistry(nullptr), _sceneSlot(kInvalidSceneSlot) {
+    _tickSlots.fill(kInvalidTickSlot);
+}
+
+void Component::SetTickType(TickType tickType) {
+    if (_tickType == tickType) {
+        return;
+    }
+    TickRegistry *pTickRegistry = _pTickRegistry;
+    if (pTickRegistry != nullptr) {
+        pTickRegistry->Unregister(this);
+    }
+    _tickType = tickType;
+    if (pTickRegistry != nullptr) {
+        pTickRegistry->Register(this);
+    }
 }
 
 void Component::SetGameObject(GameObject *pGameObject) {
@@ -1,12 +1,16 @@
 #pragma once
+#include <array>
 #include "Foundation/PreprocessorDirectives.h"
 #include "Object/Object.h"
 #include "Utils/GlobalCallbacks.h"
 
 class GameObject;
+class TickRegistry;
 class Component : public Object {
     DECLARE_CLASS(Component);
 public:
+    // inherited by every component class, the component indices index the game object component mask
+    static constexpr ClassIndexDomain kClassIndexDomain = ClassIndexDomain::eComponent;
     Component();
 public:
     auto GetGameObject() const -> GameObject * {
@@ -21,6 +25,12 @@ public:
     }
     virtual void OnRemoveFormScene() {
     }
+    // called when the component starts or stops taking part in the scene, i.e. it is in a scene and its game object
+    // is active in hierarchy
+    virtual void OnEnable() {
+    }
+    virtual void OnDisable() {
+    }
 public:
     // clang-format off
     enum TickType {
@@ -34,12 +44,13 @@ public:
     };
     ENUM_FLAGS_AS_MEMBER(TickType);
     // clang-format on
+    static constexpr size_t kTickPhaseCount = 6;
+    static constexpr uint32_t kInvalidTickSlot = static_cast<uint32_t>(-1);
+    static constexpr uint32_t kInvalidSceneSlot = static_cast<uint32_t>(-1);
     auto GetTickType() const -> TickType {
 	    return _tickType;
     }
-    void SetTickType(TickType tickType) {
-	    _tickType = tickType;
-    }
+    void SetTickType(TickType tickType);
     virtual bool GetActive() const {
 	    return true;
     }
@@ -52,6 +63,8 @@ public:
     virtual void OnPostRender() {}
 private:
     friend class GameObject;
+    friend class TickRegistry;
+    friend class Scene;
     void SetGameObject(GameObject *pGameObject);
     void InnerOnPreUpdate();
     void InnerOnUpdate();
@@ -61,7 +74,10 @@ private:
     void InnerOnPostRender();
 private:
     // clang-format off
-    GameObject *_pGameObject;
-    TickType    _tickType;
+    GameObject                                 *_pGameObject;
+    TickType                                    _tickType;
+    TickRegistry                               *_pTickRegistry;
+    std::array<uint32_t, kTickPhaseCount>       _tickSlots;
+    uint32_t                                    _sceneSlot;
     // clang-format on
 };
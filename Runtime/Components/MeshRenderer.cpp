@@ -2,25 +2,40 @@
 #include "Transform.h"
 #include "D3d12/AccelerationStructure.h"
 #include "D3d12/ASBuilder.h"
+#include "Foundation/Memory/FrameArena.h"
 #include "Object/GameObject.h"
 #include "RenderObject/Mesh.h"
 #include "SceneObject/SceneManager.h"
 #include "RenderObject/Material.h"
 #include "RenderObject/RenderGroup.hpp"
+#include "Renderer/RenderUtils/GPUScene.h"
 #include "SceneObject/Scene.h"
 #include "SceneObject/SceneRayTracingASManager.h"
 #include "SceneObject/SceneRenderObjectManager.h"
 
-MeshRenderer::MeshRenderer() : _renderData{} {
-    SetTickType(ePreRender);
+MeshRenderer::MeshRenderer() : _renderData{}, _isOccluder(false) {
+    _renderData.registrySlot = SceneRenderObjectManager::kInvalidSlot;
 }
 
 void MeshRenderer::SetMesh(std::shared_ptr<Mesh> pMesh) {
     _pMesh = std::move(pMesh);
+    if (IsRegistered()) {
+        _pCurrentScene->GetRenderObjectManager()->MarkDirty(this);
+    }
 }
 
 void MeshRenderer::SetMaterial(std::shared_ptr<Material> pMaterial) {
     _pMaterial = std::move(pMaterial);
+    if (IsRegistered()) {
+        _pCurrentScene->GetRenderObjectManager()->MarkDirty(this);
+    }
+}
+
+void MeshRenderer::SetOccluder(bool occluder) {
+    _isOccluder = occluder;
+    if (!_isOccluder) {
+        _occluderVertices = {};
+    }
 }
 
 void MeshRenderer::OnRemoveFormScene() {
@@ -47,9 +62,19 @@ void MeshRenderer::OnAddToGameObject() {
     _renderData.renderObject.cbPreObject.matWorld = glm::identity<glm::mat4x4>();
 }
 
-void MeshRenderer::OnPreRender() {
-    Component::OnPreRender();
-    CommitRenderObject();
+void MeshRenderer::OnEnable() {
+    Component::OnEnable();
+    _pCurrentScene->GetRenderObjectManager()->AddMeshRenderer(this);
+    // the transform may have changed while the renderer was disabled
+    Transform *pTransform = GetGameObject()->GetTransform();
+    if (_renderData.transformVersion != pTransform->GetWorldVersion()) {
+        UpdateTransformData(pTransform);
+    }
+}
+
+void MeshRenderer::OnDisable() {
+    Component::OnDisable();
+    _pCurrentScene->GetRenderObjectManager()->RemoveMeshRenderer(this);
 }
 
 bool MeshRenderer::PrepareAccelerationStructure() const {
@@ -66,32 +91,138 @@ auto MeshRenderer::GetBottomLevelAS() const -> dx::BottomLevelAS * {
     return _pMesh != nullptr ? _pMesh->GetBottomLevelAS() : nullptr;
 }
 
-void MeshRenderer::CommitRenderObject() {
-    if (_pMesh == nullptr || _pMaterial == nullptr) {
-        return;
+void MeshRenderer::OnTransformChanged() {
+    UpdateTransformData(GetGameObject()->GetTransform());
+}
+
+void MeshRenderer::UpdateTransformData(const Transform *pTransform) {
+    cbuffer::CbPreObject &cbPreObject = _renderData.renderObject.cbPreObject;
+    uint64_t frameIndex = FrameArena::GetFrameIndex();
+    // only the first change in a frame shifts the previous matrix
+    if (_renderData.transformFrameIndex != frameIndex) {
+        _renderData.transformFrameIndex = frameIndex;
+        cbPreObject.matWorldPrev = cbPreObject.matWorld;
+        if (IsRegistered()) {
+            _pCurrentScene->GetRenderObjectManager()->MarkMoved(this);
+        }
     }
+    _renderData.transformVersion = pTransform->GetWorldVersion();
+    cbPreObject.matWorld = pTransform->GetWorldMatrix();
+    cbPreObject.matInvWorld = pTransform->GetInverseWorldMatrix();
+    cbPreObject.matNormal = glm::AffineNormalMatrix(cbPreObject.matWorld);
+    _instanceData.transform = cbPreObject.matWorld;
+    UpdateWorldBounds();
+    if (IsRegistered()) {
+        _pCurrentScene->GetRenderObjectManager()->MarkBoundsDirty(this);
+        GPUScene::GetInstance()->UpdateObject(&_renderData.renderObject);
+    }
+}
 
-    Transform *pTransform = GetGameObject()->GetTransform();
-    bool updateRenderObject = _pMesh->GetSemanticMask() != _renderData.meshSemanticMask ||
-                              _pMaterial.get() != _renderData.renderObject.pMaterial || _pMaterial->PipelineIDDirty();
-
-    if (updateRenderObject) {
-        _renderData.meshSemanticMask = _pMesh->GetSemanticMask();
-        _renderData.shouldRender = _pMaterial->UpdatePipelineID(_renderData.meshSemanticMask);
-        _renderData.renderObject.pMaterial = _pMaterial.get();
-        _renderData.renderObject.pMesh = _pMesh.get();
+void MeshRenderer::UpdateWorldBounds() {
+    RenderObject &renderObject = _renderData.renderObject;
+    renderObject.worldBounds = _pMesh != nullptr ? _pMesh->GetBounds().Transform(renderObject.cbPreObject.matWorld)
+                                                 : AABB{};
+}
+
+bool MeshRenderer::RefreshRenderObject() {
+    RenderObject &renderObject = _renderData.renderObject;
+    if (_pMesh == nullptr || _pMaterial == nullptr) {
+        renderObject.pMaterial = nullptr;
+        renderObject.pMesh = nullptr;
+        _renderData.shouldRender = false;
+        UpdateWorldBounds();
+        return false;
     }
 
+    // the mesh or its vertices may have changed
+    _occluderVertices.clear();
+    _visibleSubMeshes.clear();
+    renderObject.visibleSubMeshes = {};
+    renderObject.lodIndex = 0;
+    _renderData.meshSemanticMask = _pMesh->GetSemanticMask();
+    _renderData.shouldRender = _pMaterial->UpdatePipelineID(_renderData.meshSemanticMask);
+    renderObject.pMaterial = _pMaterial.get();
+    renderObject.pMesh = _pMesh.get();
+    UpdateWorldBounds();
+    return _renderData.shouldRender;
+}
+
+void MeshRenderer::SettleMotion() {
+    // still moving in this frame, the previous matrix was shifted by UpdateTransformData
+    if (_renderData.transformFrameIndex == FrameArena::GetFrameIndex()) {
+        return;
+    }
     cbuffer::CbPreObject &cbPreObject = _renderData.renderObject.cbPreObject;
     cbPreObject.matWorldPrev = cbPreObject.matWorld;
-    if (pTransform->ThisFrameChanged()) {
-        cbPreObject.matWorld = pTransform->GetWorldMatrix();
-        cbPreObject.matInvWorld = inverse(cbPreObject.matWorld);
-        cbPreObject.matNormal = glm::WorldMatrixToNormalMatrix(cbPreObject.matWorld);
+    GPUScene::GetInstance()->UpdateObject(&_renderData.renderObject);
+}
+
+bool MeshRenderer::IsRegistered() const {
+    return _renderData.registrySlot != SceneRenderObjectManager::kInvalidSlot;
+}
+
+void MeshRenderer::SelectLod(float screenScale, float maxScreenError) {
+    RenderObject &renderObject = _renderData.renderObject;
+    size_t currentLod = renderObject.lodIndex;
+    size_t lod = 0;
+    for (size_t level = 1; level < _pMesh->GetLodCount(); ++level) {
+        // switching to a coarser level needs a margin, so a camera at the threshold does not toggle every frame
+        float threshold = level > currentLod ? maxScreenError * kLodHysteresis : maxScreenError;
+        if (_pMesh->GetLodError(level) * screenScale > threshold) {
+            break;
+        }
+        lod = level;
+    }
+    renderObject.lodIndex = static_cast<uint8_t>(lod);
+}
+
+auto MeshRenderer::GetOccluderVertices() -> ReadonlyArraySpan<glm::vec3> {
+    if (_occluderVertices.empty() && _pMesh != nullptr) {
+        _pMesh->GetVertices(_occluderVertices);
+    }
+    return _occluderVertices;
+}
+
+bool MeshRenderer::CullSubMeshes(const Frustum &frustum) {
+    RenderObject &renderObject = _renderData.renderObject;
+    renderObject.visibleSubMeshes = {};
+    const std::vector<SubMesh> &subMeshes = _pMesh->GetSubMeshes();
+    // the ranges are per level, only meshes without simplified levels are culled per sub mesh
+    if (subMeshes.size() <= 1 || _pMesh->GetLodCount() > 1) {
+        return true;
+    }
+
+    // the sub mesh bounds are computed by UploadMeshData, a sub mesh without bounds is not drawn
+    const AABBSoA &subMeshBounds = _pMesh->GetSubMeshBounds();
+    if (subMeshBounds.GetCount() != subMeshes.size()) {
+        return false;
     }
 
-    if (_renderData.shouldRender) {
-        SceneRenderObjectManager *pRenderObjectMgr = _pCurrentScene->GetRenderObjectManager();
-        pRenderObjectMgr->AddRenderObject(&_renderData.renderObject);
+    // the frustum moves into object space once, the sub mesh boxes are tested as they are, 8 at a time with AVX
+    _visibleSubMeshes.clear();
+    _subMeshVisibility.resize(subMeshes.size());
+    Frustum objectFrustum = frustum.Transform(renderObject.cbPreObject.matWorld);
+    FrustumCulling::Cull(objectFrustum, subMeshBounds, _subMeshVisibility.data());
+    for (size_t i = 0; i < subMeshes.size(); ++i) {
+        const SubMesh &subMesh = subMeshes[i];
+        if (_subMeshVisibility[i] == 0 || !subMesh.bounds.IsValid()) {
+            continue;
+        }
+        // a static batch stores its sub meshes back to back, neighbours inside the frustum become one draw
+        if (!_visibleSubMeshes.empty()) {
+            SubMesh &last = _visibleSubMeshes.back();
+            bool contiguous = last.indexCount > 0 && subMesh.indexCount > 0 &&
+                              last.baseVertexLocation == subMesh.baseVertexLocation &&
+                              last.baseIndexLocation + last.indexCount == subMesh.baseIndexLocation;
+            if (contiguous) {
+                last.indexCount += subMesh.indexCount;
+                last.vertexCount += subMesh.vertexCount;
+                last.bounds.Merge(subMesh.bounds);
+                continue;
+            }
+        }
+        _visibleSubMeshes.push_back(subMesh);
     }
+    renderObject.visibleSubMeshes = _visibleSubMeshes;
+    return !_visibleSubMeshes.empty();
 }
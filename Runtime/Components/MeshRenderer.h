@@ -1,5 +1,7 @@
 #pragma once
 #include "Component.h"
+#include "Foundation/Memory/PoolAllocator.h"
+#include "Foundation/ReadonlyArraySpan.hpp"
 #include "D3d12/D3dStd.h"
 #include "RenderObject/RenderObject.h"
 #include "RenderObject/VertexSemantic.hpp"
@@ -7,9 +9,14 @@
 class Mesh;
 class Material;
 class Scene;
+class Transform;
 
 class MeshRenderer : public Component {
     DECLARE_CLASS(MeshRenderer);
+    DECLARE_POOL_OBJECT(MeshRenderer);
+public:
+    // a coarser level must stay below this fraction of the error threshold before it is selected
+    static constexpr float kLodHysteresis = 0.75f;
 public:
     MeshRenderer();
     void SetMesh(std::shared_ptr<Mesh> pMesh);
@@ -23,19 +30,45 @@ public:
     auto GetASInstance() const -> const dx::ASInstance & {
 	    return _instanceData;
     }
+    // occluders are rasterized into the software depth buffer of the occlusion culling, use simple and large meshes
+    void SetOccluder(bool occluder);
+    bool IsOccluder() const {
+        return _isOccluder;
+    }
 public:
     void OnRemoveFormScene() override;
     void OnAddToScene() override;
     void OnAddToGameObject() override;
-    void OnPreRender() override;
+    void OnEnable() override;
+    void OnDisable() override;
     bool PrepareAccelerationStructure() const;
     auto GetBottomLevelAS() const -> dx::BottomLevelAS *;
+    // called by the scene for the renderers whose transform moved in this frame
+    void OnTransformChanged();
 private:
-    void CommitRenderObject();
+    friend class SceneRenderObjectManager;
+    // returns whether the renderer should be drawn
+    bool RefreshRenderObject();
+    // collapses the motion vectors once the renderer stopped moving
+    void SettleMotion();
+    void UpdateTransformData(const Transform *pTransform);
+    void UpdateWorldBounds();
+    bool IsRegistered() const;
+    // object space positions of the mesh, cached while the renderer is an occluder
+    auto GetOccluderVertices() -> ReadonlyArraySpan<glm::vec3>;
+    // screenScale is the projected size of one object space unit as a fraction of the screen height.
+    // selects the coarsest level whose projected error stays below maxScreenError
+    void SelectLod(float screenScale, float maxScreenError);
+    // tests the sub meshes of a mesh with several of them and merges the visible ones into contiguous draw ranges.
+    // returns false when no sub mesh is inside the frustum
+    bool CullSubMeshes(const Frustum &frustum);
 private:
     struct CachedRenderData {
         SemanticMask meshSemanticMask;
         bool shouldRender;
+        uint64_t transformVersion;
+        uint64_t transformFrameIndex;
+        uint32_t registrySlot;
         RenderObject renderObject;
     };
     struct CachedASInstanceData {
@@ -48,5 +81,9 @@ private:
     Scene                      *_pCurrentScene;
 	CachedRenderData			_renderData;
     dx::ASInstance              _instanceData;
+    bool                        _isOccluder;
+    std::vector<glm::vec3>      _occluderVertices;
+    std::vector<SubMesh>        _visibleSubMeshes;
+    std::vector<uint8_t>        _subMeshVisibility;
     // clang-format on
 };
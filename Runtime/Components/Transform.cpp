@@ -1,4 +1,12 @@
 #include "Transform.h"
+#include "Object/GameObject.h"
+#include "SceneObject/Scene.h"
+#include "SceneObject/SceneManager.h"
+#include "SceneObject/TransformSystem.h"
+
+// bumped by every local change, only touched on the main thread
+static uint64_t sVersionCounter = 0;
+static uint64_t sFrameBeginVersion = 0;
 
 Transform::Transform()
     : _translation(0.f),
@@ -13,12 +21,19 @@ Transform::Transform()
       _matInvLocal(glm::identity<glm::mat4x4>()),
       _matInvWorld(glm::identity<glm::mat4x4>()),
       _dirtyFlag(),
-      _thisFrameChanged(false) {
+      _localVersion(++sVersionCounter),
+      _worldVersion(0),
+      _worldVersionStamp(0),
+      _matWorldVersion(0),
+      _pTransformSystem(nullptr),
+      _transformIndex(TransformSystem::kInvalidIndex) {
     _dirtyFlag = SetFlags(_dirtyFlag, eAllDirty);
-    SetTickType(ePostRender);
 }
 
 Transform::~Transform() {
+    if (_pTransformSystem != nullptr) {
+        _pTransformSystem->RemoveTransform(this);
+    }
     if (_pParent != nullptr) {
         SetParent(nullptr);
     }
@@ -26,7 +41,10 @@ Transform::~Transform() {
     for (auto it = _children.begin(); it != _children.end(); ++it) {
         auto *pChild = *it;
         pChild->_pParent = nullptr;
-        pChild->_dirtyFlag = SetFlags(pChild->_dirtyFlag, eWorldAttribute);
+        pChild->MakeLocalChanged();
+        if (pChild->_pTransformSystem != nullptr) {
+            pChild->_pTransformSystem->MarkHierarchyDirty();
+        }
     }
     _children.clear();
 }
@@ -35,8 +53,7 @@ void Transform::SetLocalPosition(const glm::vec3 &translate) {
     if (any(epsilonNotEqual(_translation, translate, kEpsilon))) {
         _translation = translate;
         _dirtyFlag = SetFlags(_dirtyFlag, eAllDirty);
-        MakeThisFrameChanged();
-        MakeChildrenDirty(eWorldAttribute);
+        MakeLocalChanged();
     }
 }
 
@@ -44,8 +61,7 @@ void Transform::SetLocalScale(const glm::vec3 &scale) {
     if (any(epsilonNotEqual(_scale, scale, kEpsilon))) {
         _scale = scale;
         _dirtyFlag = SetFlags(_dirtyFlag, eAllDirty);
-        MakeThisFrameChanged();
-        MakeChildrenDirty(eWorldAttribute);
+        MakeLocalChanged();
     }
 }
 
@@ -53,8 +69,7 @@ void Transform::SetLocalRotation(const glm::quat &rotate) {
     if (any(epsilonNotEqual(_rotation, rotate, kEpsilon))) {
         _rotation = rotate;
         _dirtyFlag = SetFlags(_dirtyFlag, eAllDirty);
-        MakeThisFrameChanged();
-        MakeChildrenDirty(eWorldAttribute);
+        MakeLocalChanged();
     }
 }
 
@@ -65,27 +80,26 @@ void Transform::SetLocalMatrix(const glm::mat4x4 &matrix) {
     glm::decompose(_matLocal, _scale, _rotation, _translation, skew, perspective);
     _dirtyFlag = ClearFlags(_dirtyFlag, eLocalMatrix);
     _dirtyFlag = SetFlags(_dirtyFlag, eInverseLocalMatrix | eWorldAttribute);
-    MakeThisFrameChanged();
-    MakeChildrenDirty(eWorldAttribute);
+    MakeLocalChanged();
 }
 
 void Transform::SetWorldMatrix(const glm::mat4x4 &matrix) {
-    _matWorld = matrix;
-
+    // W = P * L  =>  L = inverse(P) * W
     glm::mat4x4 parentInvWorld = glm::identity<glm::mat4x4>();
     if (_pParent != nullptr) {
         parentInvWorld = _pParent->GetInverseWorldMatrix();
     }
-    _matLocal = matrix * parentInvWorld;
+    _matLocal = AffineMultiply(parentInvWorld, matrix);
 
     glm::vec3 skew;
     glm::vec4 perspective;
     glm::decompose(_matLocal, _scale, _rotation, _translation, skew, perspective);
 
-    MakeThisFrameChanged();
-    MakeChildrenDirty(eWorldAttribute);
+    MakeLocalChanged();
     _dirtyFlag = SetFlags(_dirtyFlag, eInverseLocalMatrix | eWorldAttribute);
-    _dirtyFlag = ClearFlags(_dirtyFlag, eWorldMatrix | eLocalMatrix);
+    _dirtyFlag = ClearFlags(_dirtyFlag, eLocalMatrix);
+    _matWorld = matrix;
+    _matWorldVersion = GetWorldVersion();
 }
 
 void Transform::SetLocalTRS(const glm::vec3 &translation, const glm::quat &rotation, const glm::vec3 &scale) {
@@ -93,8 +107,7 @@ void Transform::SetLocalTRS(const glm::vec3 &translation, const glm::quat &rotat
     _rotation = rotation;
     _scale = scale;
     _dirtyFlag = SetFlags(_dirtyFlag, eInverseLocalMatrix | eLocalMatrix | eWorldAttribute);
-    MakeThisFrameChanged();
-    MakeChildrenDirty(eWorldAttribute);
+    MakeLocalChanged();
 }
 
 void Transform::SetWorldTRS(const glm::vec3 &translation, const glm::quat &rotation, const glm::vec3 &scale) {
@@ -103,8 +116,7 @@ void Transform::SetWorldTRS(const glm::vec3 &translation, const glm::quat &rotat
 
 void Transform::RemoveChild(Transform *pTransform) {
     if (pTransform->GetParent() == this) {
-        RemoveChildImpl(this, pTransform);
-        _dirtyFlag = SetFlags(pTransform->_dirtyFlag, eWorldAttribute);
+        pTransform->SetParent(nullptr);
     }
 }
 
@@ -117,28 +129,31 @@ auto Transform::GetLocalMatrix() const -> const glm::mat4x4 & {
 }
 
 auto Transform::GetWorldMatrix() const -> const glm::mat4x4 & {
-    if (HasFlag(_dirtyFlag, eWorldMatrix)) {
+    uint64_t worldVersion = GetWorldVersion();
+    if (_matWorldVersion != worldVersion) {
         glm::mat4x4 parentMatrix = glm::identity<glm::mat4x4>();
         if (_pParent != nullptr) {
             parentMatrix = _pParent->GetWorldMatrix();
         }
-        _matWorld = parentMatrix * GetLocalMatrix();
-        _dirtyFlag = ClearFlags(_dirtyFlag, eWorldMatrix);
+        _matWorld = AffineMultiply(parentMatrix, GetLocalMatrix());
+        _matWorldVersion = worldVersion;
+        _dirtyFlag = SetFlags(_dirtyFlag, eWorldAttribute);
     }
     return _matWorld;
 }
 
 auto Transform::GetInverseLocalMatrix() const -> const glm::mat4x4 & {
     if (HasFlag(_dirtyFlag, eInverseLocalMatrix)) {
-        _matInvLocal = inverse(GetLocalMatrix());
+        _matInvLocal = MakeInverseAffineMatrix(_translation, _rotation, _scale);
         _dirtyFlag = ClearFlags(_dirtyFlag, eInverseLocalMatrix);
     }
     return _matInvLocal;
 }
 
 auto Transform::GetInverseWorldMatrix() const -> const glm::mat4x4 & {
+    const glm::mat4x4 &matWorld = GetWorldMatrix();
     if (HasFlag(_dirtyFlag, eInverseWorldMatrix)) {
-        _matInvWorld = inverse(GetWorldMatrix());
+        _matInvWorld = AffineInverse(matWorld);
         _dirtyFlag = ClearFlags(_dirtyFlag, eInverseWorldMatrix);
     }
     return _matInvWorld;
@@ -188,9 +203,47 @@ void Transform::LookAt(const glm::vec3 &target, const glm::vec3 &up) {
     SetLocalRotation(localQuaternion);
 }
 
-void Transform::OnPostRender() {
-	Component::OnPostRender();
-    _thisFrameChanged = false;
+void Transform::OnAddToScene() {
+    Component::OnAddToScene();
+    Scene *pScene = SceneManager::GetInstance()->GetScene(GetGameObject()->GetSceneID());
+    pScene->GetTransformSystem()->AddTransform(this);
+}
+
+void Transform::OnRemoveFormScene() {
+    Component::OnRemoveFormScene();
+    if (_pTransformSystem != nullptr) {
+        _pTransformSystem->RemoveTransform(this);
+    }
+}
+
+auto Transform::GetWorldVersion() const -> uint64_t {
+    // the system stores the version of every node when it writes the world matrix,
+    // a parent in another system can change without this one noticing
+    bool parentInSystem = _pParent == nullptr || _pParent->_pTransformSystem == _pTransformSystem;
+    if (_pTransformSystem != nullptr && parentInSystem && _pTransformSystem->IsUpToDate()) {
+        return _pTransformSystem->GetWorldVersion(_transformIndex);
+    }
+    // outside a system, or with changes pending, memoized until the next change anywhere
+    if (_worldVersionStamp != sVersionCounter) {
+        uint64_t parentVersion = _pParent != nullptr ? _pParent->GetWorldVersion() : 0;
+        _worldVersion = std::max(_localVersion, parentVersion);
+        _worldVersionStamp = sVersionCounter;
+    }
+    return _worldVersion;
+}
+
+bool Transform::ThisFrameChanged() const {
+    return GetWorldVersion() > sFrameBeginVersion;
+}
+
+void Transform::OnFrameEnd() {
+    sFrameBeginVersion = sVersionCounter;
+}
+
+void Transform::ApplyWorldMatrix(const glm::mat4x4 &matWorld, uint64_t worldVersion) {
+    _matWorld = matWorld;
+    _matWorldVersion = worldVersion;
+    _dirtyFlag = SetFlags(_dirtyFlag, eWorldAttribute);
 }
 
 void Transform::SetParentImpl(Transform *pParent, Transform *pChild) {
@@ -203,38 +256,42 @@ void Transform::RemoveChildImpl(Transform *pParent, Transform *pChild) {
         if (*it == pChild) {
             pChild->_pParent = nullptr;
             pParent->_children.erase(it);
+            return;
         }
     }
 }
 
 void Transform::ConditionUpdateWorldAttribute() const {
+    const glm::mat4x4 &matWorld = GetWorldMatrix();
     if (HasAnyFlags(_dirtyFlag, eWorldTranslation | eWorldScale | eWorldRotation)) {
         glm::vec3 skew;
         glm::vec4 perspective;
-        glm::decompose(GetWorldMatrix(), _worldScale, _worldRotation, _worldTranslation, skew, perspective);
+        glm::decompose(matWorld, _worldScale, _worldRotation, _worldTranslation, skew, perspective);
         _dirtyFlag = ClearFlags(_dirtyFlag, eWorldTranslation | eWorldScale | eWorldRotation);
     }
 }
 
-void Transform::MakeChildrenDirty(TransformDirtyFlag flag) {
-    for (auto *pChild : _children) {
-        pChild->_dirtyFlag = SetFlags(pChild->_dirtyFlag, flag);
-        pChild->MakeThisFrameChanged();
+void Transform::MakeLocalChanged() {
+    // descendants pick the new version up through GetWorldVersion, the subtree is not walked here
+    _localVersion = ++sVersionCounter;
+    if (_pTransformSystem != nullptr) {
+        _pTransformSystem->MarkDirty(_transformIndex);
     }
 }
 
-void Transform::MakeThisFrameChanged() {
-    _thisFrameChanged = true;
-}
-
 void Transform::SetParent(Transform *pTransform) {
     if (_pParent != pTransform) {
         if (_pParent != nullptr) {
             RemoveChildImpl(_pParent, this);
         }
-        SetParentImpl(pTransform, this);
-        MakeChildrenDirty(eWorldAttribute);
+        if (pTransform != nullptr) {
+            SetParentImpl(pTransform, this);
+        }
         _dirtyFlag = SetFlags(_dirtyFlag, eWorldAttribute);
+        MakeLocalChanged();
+        if (_pTransformSystem != nullptr) {
+            _pTransformSystem->MarkHierarchyDirty();
+        }
     }
 }
 
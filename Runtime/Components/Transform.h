@@ -2,21 +2,25 @@
 #include "Component.h"
 #include "Foundation/GlmStd.hpp"
 #include "Foundation/PreprocessorDirectives.h"
+#include "Foundation/Memory/PoolAllocator.h"
+
+class TransformSystem;
 
 class Transform : public Component {
     DECLARE_CLASS(Transform);
+    DECLARE_POOL_OBJECT(Transform);
 public:
     static constexpr float kEpsilon = 0.00001f;
     enum TransformDirtyFlag {
         // clang-format off
 		eLocalMatrix		= 1 << 0,
-		eWorldMatrix		= 1 << 1,
 		eInverseLocalMatrix = 1 << 2,
 		eInverseWorldMatrix = 1 << 3,
         eWorldTranslation   = 1 << 4,
         eWorldRotation      = 1 << 5,
         eWorldScale         = 1 << 6,
-        eWorldAttribute     = (eWorldMatrix | eInverseWorldMatrix | eWorldTranslation | eWorldRotation | eWorldScale),
+        // the world matrix itself is tracked by version, these are derived from it
+        eWorldAttribute     = (eInverseWorldMatrix | eWorldTranslation | eWorldRotation | eWorldScale),
         eAllDirty           = (eWorldAttribute | eLocalMatrix | eInverseLocalMatrix),
         // clang-format on
     };
@@ -61,17 +65,24 @@ public:
     auto GetChildren() const -> const std::vector<Transform *> & {
         return _children;
     }
-    bool ThisFrameChanged() const {
-	    return _thisFrameChanged;
+    // changes whenever the local transform of this node or of any ancestor changes,
+    // consumers cache the value they last saw and compare it to detect staleness
+    auto GetWorldVersion() const -> uint64_t;
+    auto GetLocalVersion() const -> uint64_t {
+        return _localVersion;
     }
+    bool ThisFrameChanged() const;
+    static void OnFrameEnd();
+public:
+    void OnAddToScene() override;
+    void OnRemoveFormScene() override;
 private:
-    void OnPostRender() override;
-private:
+    friend class TransformSystem;
+    void ApplyWorldMatrix(const glm::mat4x4 &matWorld, uint64_t worldVersion);
     static void SetParentImpl(Transform *pParent, Transform *pChild);
     static void RemoveChildImpl(Transform *pParent, Transform *pChild);
     void ConditionUpdateWorldAttribute() const;
-    void MakeChildrenDirty(TransformDirtyFlag flag);
-    void MakeThisFrameChanged();
+    void MakeLocalChanged();
     friend class GameObject;
     void SetParent(Transform *pTransform);
     void AddChild(Transform *pTransform);
@@ -92,6 +103,12 @@ private:
 	mutable glm::mat4x4			_matInvLocal;
 	mutable glm::mat4x4			_matInvWorld;
 	mutable TransformDirtyFlag	_dirtyFlag;
-    mutable bool                _thisFrameChanged;
+    uint64_t                    _localVersion;
+    mutable uint64_t            _worldVersion;
+    mutable uint64_t            _worldVersionStamp;
+    mutable uint64_t            _matWorldVersion;
+
+    TransformSystem            *_pTransformSystem;
+    uint32_t                    _transformIndex;
     // clang-format on
 };
@@ -1,17 +1,18 @@
 #pragma once
 #include <d3d12.h>
-#include <vector>
-#include <unordered_map>
+#include <memory>
 #include "D3dStd.h"
 #include "DescriptorHandleArray.hpp"
+#include "Foundation/Memory/FrameArena.h"
 
 namespace dx {
 
 class BindlessCollection : NonCopyable {
 public:
+    // the storage comes from the FrameArena, a collection must not outlive the current frame
     BindlessCollection(size_t maxHandleCount = kDynamicDescriptorMaxView) : _maxHandleCount(maxHandleCount) {
-        _pHandleArray = std::make_shared<DescriptorHandleArray>();
-        _pHandleArray->Reserve(maxHandleCount);
+        _handles.reserve(maxHandleCount);
+        _handleMap.reserve(maxHandleCount);
     }
     void AddHandle(D3D12_CPU_DESCRIPTOR_HANDLE handle) {
         if (handle.ptr == 0) {
@@ -21,8 +22,8 @@ public:
         if (_handleMap.contains(handle)) {
             return;
         }
-        _pHandleArray->Add(handle);
-        _handleMap[handle] = _pHandleArray->Count() - 1;
+        _handles.push_back(handle);
+        _handleMap[handle] = _handles.size() - 1;
     }
     auto GetHandleIndex(D3D12_CPU_DESCRIPTOR_HANDLE handle) const -> int {
         if (handle.ptr == 0) {
@@ -35,24 +36,27 @@ public:
         return -1;
     }
     auto GetCount() const -> size_t {
-        return _pHandleArray->Count();
+        return _handles.size();
     }
-    auto GetHandles() const -> const std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> & {
-        return _pHandleArray->GetHandles();
+    auto GetHandles() const -> ReadonlyArraySpan<D3D12_CPU_DESCRIPTOR_HANDLE> {
+        return _handles;
     }
-    auto GetHandleArrayPtr() const -> const std::shared_ptr<DescriptorHandleArray> & {
-	    return _pHandleArray;
+    // copies the handles into a heap array that can be kept by the shader record
+    auto CreateHandleArrayPtr() const -> std::shared_ptr<DescriptorHandleArray> {
+        auto pHandleArray = std::make_shared<DescriptorHandleArray>();
+        pHandleArray->Add(GetHandles());
+        return pHandleArray;
     }
     bool EnsureCapacity(bool size) const {
-	    return _pHandleArray->Count() + size <= _maxHandleCount;
+	    return _handles.size() + size <= _maxHandleCount;
     }
 private:
-    using HandleArrayPtr = std::shared_ptr<DescriptorHandleArray>;
-    using HandleMap = std::unordered_map<D3D12_CPU_DESCRIPTOR_HANDLE, size_t>;
+    using HandleList = FrameVector<D3D12_CPU_DESCRIPTOR_HANDLE>;
+    using HandleMap = FrameUnorderedMap<D3D12_CPU_DESCRIPTOR_HANDLE, size_t>;
 private:
     // clang-format off
 	size_t          _maxHandleCount;
-	HandleArrayPtr  _pHandleArray;
+	HandleList      _handles;
 	HandleMap       _handleMap;
     // clang-format on
 };
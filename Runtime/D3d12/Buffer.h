@@ -2,11 +2,14 @@
 #include "D3dStd.h"
 #include "Foundation/StringUtil.h"
 #include "Foundation/Memory/SharedPtr.hpp"
+#include "Foundation/Memory/PoolAllocator.h"
 #include "DescriptorHandle.h"
 
 namespace dx {
 
 class Buffer : public RefCounter {
+    DECLARE_POOL_OBJECT(Buffer);
+private:
     Buffer(Device *pDevice, D3D12_HEAP_TYPE heapType, D3D12_RESOURCE_STATES initState, const D3D12_RESOURCE_DESC &desc);
     Buffer(Device *pDevice, D3D12_HEAP_TYPE heapType, D3D12_RESOURCE_STATES initState, size_t bufferSize)
         : Buffer(pDevice, heapType, initState, CD3DX12_RESOURCE_DESC::Buffer(bufferSize)) {
@@ -30,6 +33,11 @@ public:
             new Buffer(pDevice, D3D12_HEAP_TYPE_READBACK, D3D12_RESOURCE_STATE_COPY_DEST, std::forward<Args>(args)...));
     }
     ~Buffer() override;
+    // releases the allocation through the thread safe D3D12MA allocator and the locked resource state map,
+    // so the GarbageCollection may destroy it on a worker
+    bool AllowBackgroundDestroy() const override {
+        return true;
+    }
 public:
     Inline(2) auto GetResource() const -> ID3D12Resource * {
         return _pAllocation != nullptr ? _pAllocation->GetResource() : nullptr;
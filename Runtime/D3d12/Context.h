@@ -32,6 +32,11 @@ public:
     void BindDynamicDescriptorHeap();
     void FlushResourceBarriers();
     void CopyResource(ID3D12Resource *pDstResource, ID3D12Resource *pSrcResource);
+    void CopyBufferRegion(ID3D12Resource *pDstBuffer,
+        size_t dstOffset,
+        ID3D12Resource *pSrcBuffer,
+        size_t srcOffset,
+        size_t numBytes);
     auto GetCommandList() const -> NativeCommandList *;
     auto GetCommandAllocator() const -> ID3D12CommandAllocator *;
 
@@ -230,6 +235,15 @@ inline void Context::CopyResource(ID3D12Resource *pDstResource, ID3D12Resource *
     _pCommandList->CopyResource(pDstResource, pSrcResource);
 }
 
+inline void Context::CopyBufferRegion(ID3D12Resource *pDstBuffer,
+    size_t dstOffset,
+    ID3D12Resource *pSrcBuffer,
+    size_t srcOffset,
+    size_t numBytes) {
+    FlushResourceBarriers();
+    _pCommandList->CopyBufferRegion(pDstBuffer, dstOffset, pSrcBuffer, srcOffset, numBytes);
+}
+
 inline auto Context::GetCommandList() const -> NativeCommandList * {
     return _pCommandList;
 }
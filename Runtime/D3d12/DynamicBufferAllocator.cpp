@@ -82,6 +82,8 @@ auto DynamicBufferAllocator::AllocBuffer(size_t bufferSize, size_t addressAlignm
             size_t offset = pCurrent - memoryBlock.pBegin;
             allocInfo.pBuffer = pCurrent;
             allocInfo.virtualAddress = memoryBlock.virtualAddress + offset;
+            allocInfo.pResource = memoryBlock.pAllocation->GetResource();
+            allocInfo.offset = offset;
             memoryBlock.pCurrent = pCurrent + bufferSize;
             return allocInfo;
         }
@@ -116,6 +118,8 @@ auto DynamicBufferAllocator::AllocBuffer(size_t bufferSize, size_t addressAlignm
 
     allocInfo.pBuffer = block.pCurrent;
     allocInfo.virtualAddress = block.virtualAddress;
+    allocInfo.pResource = pResource;
+    allocInfo.offset = 0;
     block.pCurrent = block.pBegin + bufferSize;
     return allocInfo;
 }
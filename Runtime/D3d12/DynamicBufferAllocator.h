@@ -9,6 +9,9 @@ public:
     struct AllocInfo {
         uint8_t                      *pBuffer;
         D3D12_GPU_VIRTUAL_ADDRESS     virtualAddress;
+        // the upload heap resource and the offset inside of it, the source of a copy into a static buffer
+        ID3D12Resource               *pResource;
+        size_t                        offset;
     };
 public:
     DynamicBufferAllocator();
@@ -2,11 +2,13 @@
 #include "D3dStd.h"
 #include "Foundation/NamespeceAlias.h"
 #include "Foundation/Memory/SharedPtr.hpp"
+#include "Foundation/Memory/PoolAllocator.h"
 #include <string>
 
 namespace dx {
 
 class Texture : public RefCounter  {
+    DECLARE_POOL_OBJECT(Texture);
 private:
     Texture(Device *pDevice,
         const D3D12_RESOURCE_DESC &desc,
@@ -19,6 +21,11 @@ public:
     }
 
     ~Texture() override;
+    // releases the allocation through the thread safe D3D12MA allocator and the locked resource state map,
+    // so the GarbageCollection may destroy it on a worker
+    bool AllowBackgroundDestroy() const override {
+        return true;
+    }
     void SetName(std::string_view name);
     auto GetWidth() const -> uint64_t {
         return _textureDesc.Width;
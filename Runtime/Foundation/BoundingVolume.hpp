@@ -0,0 +1,90 @@
+#pragma once
+#include <limits>
+#include "Foundation/GlmStd.hpp"
+
+// Axis aligned bounding box, a default constructed box is empty (min > max).
+struct AABB {
+    glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+public:
+    bool IsValid() const {
+        return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+    }
+    void Merge(const glm::vec3 &point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+    void Merge(const AABB &other) {
+        min = glm::min(min, other.min);
+        max = glm::max(max, other.max);
+    }
+    auto GetCenter() const -> glm::vec3 {
+        return (min + max) * 0.5f;
+    }
+    auto GetExtents() const -> glm::vec3 {
+        return (max - min) * 0.5f;
+    }
+    // bounds of the box transformed by an affine matrix, see "Transforming Axis-Aligned Bounding Boxes" (Arvo 1990)
+    auto Transform(const glm::mat4x4 &matrix) const -> AABB {
+        if (!IsValid()) {
+            return {};
+        }
+        glm::vec3 center = glm::vec3(matrix * glm::vec4(GetCenter(), 1.f));
+        glm::vec3 extents = GetExtents();
+        glm::vec3 worldExtents = glm::abs(glm::vec3(matrix[0])) * extents.x +
+                                 glm::abs(glm::vec3(matrix[1])) * extents.y +
+                                 glm::abs(glm::vec3(matrix[2])) * extents.z;
+        return AABB{center - worldExtents, center + worldExtents};
+    }
+};
+
+struct BoundingSphere {
+    glm::vec3 center = glm::vec3(0.f);
+    float radius = -1.f;
+public:
+    bool IsValid() const {
+        return radius >= 0.f;
+    }
+};
+
+// Six inward facing planes (xyz normal, w distance), a point p is inside when dot(plane.xyz, p) + plane.w >= 0.
+// The planes are not normalized, they are only used for the sign tests of the culling.
+struct Frustum {
+    enum PlaneIndex { eLeft, eRight, eBottom, eTop, eNear, eFar, ePlaneCount };
+    glm::vec4 planes[ePlaneCount];
+public:
+    // extracts the planes of a clip space with depth in [0, 1], reversed z only swaps the near and the far plane.
+    // See "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix" (Gribb, Hartmann 2001)
+    static auto FromMatrix(const glm::mat4x4 &matViewProj) -> Frustum {
+        glm::mat4x4 m = glm::transpose(matViewProj);
+        Frustum frustum;
+        frustum.planes[eLeft] = m[3] + m[0];
+        frustum.planes[eRight] = m[3] - m[0];
+        frustum.planes[eBottom] = m[3] + m[1];
+        frustum.planes[eTop] = m[3] - m[1];
+        frustum.planes[eNear] = m[2];
+        frustum.planes[eFar] = m[3] - m[2];
+        return frustum;
+    }
+    // the frustum in the space that matrix maps into the space of this one, e.g. object space for a world matrix.
+    // A box tested in that space is an oriented box in this one, tighter than the box around its transformed corners
+    auto Transform(const glm::mat4x4 &matrix) const -> Frustum {
+        glm::mat4x4 matTranspose = glm::transpose(matrix);
+        Frustum frustum;
+        for (size_t i = 0; i < ePlaneCount; ++i) {
+            frustum.planes[i] = matTranspose * planes[i];
+        }
+        return frustum;
+    }
+    bool Intersects(const AABB &bounds) const {
+        glm::vec3 center = bounds.GetCenter();
+        glm::vec3 extents = bounds.GetExtents();
+        for (const glm::vec4 &plane : planes) {
+            glm::vec3 normal = glm::vec3(plane);
+            if (glm::dot(normal, center) + plane.w + glm::dot(glm::abs(normal), extents) < 0.f) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
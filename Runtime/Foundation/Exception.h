@@ -58,11 +58,12 @@ protected:
     std::string _whatBuffer;
 };
 
+// the message is only formatted when the assertion fails, a passing Assert does not allocate
 #define Assert(cond)                                                                                                   \
     do {                                                                                                               \
-        bool _bValueFlag = static_cast<bool>(cond);                                                                    \
-        ::Exception::CondThrow(_bValueFlag,                                                                            \
-            fmt::format("In Function {}, Assert({}) Failed!", __FUNCTION_NAME__, #cond));                              \
+        if (!static_cast<bool>(cond)) {                                                                                \
+            ::Exception::Throw("In Function {}, Assert({}) Failed!", __FUNCTION_NAME__, #cond);                        \
+        }                                                                                                              \
     } while (false)
 
 class NotImplementedException : public std::exception {
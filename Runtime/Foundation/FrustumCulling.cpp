@@ -0,0 +1,116 @@
+#include "FrustumCulling.h"
+#include <bit>
+#include <cmath>
+
+void AABBSoA::Resize(size_t count) {
+    _centerX.resize(count);
+    _centerY.resize(count);
+    _centerZ.resize(count);
+    _extentX.resize(count);
+    _extentY.resize(count);
+    _extentZ.resize(count);
+}
+
+void AABBSoA::Set(size_t index, const AABB &bounds) {
+    glm::vec3 center(0.f);
+    glm::vec3 extents(std::numeric_limits<float>::max());
+    if (bounds.IsValid()) {
+        center = bounds.GetCenter();
+        extents = bounds.GetExtents();
+    }
+    _centerX[index] = center.x;
+    _centerY[index] = center.y;
+    _centerZ[index] = center.z;
+    _extentX[index] = extents.x;
+    _extentY[index] = extents.y;
+    _extentZ[index] = extents.z;
+}
+
+void AABBSoA::Move(size_t dstIndex, size_t srcIndex) {
+    _centerX[dstIndex] = _centerX[srcIndex];
+    _centerY[dstIndex] = _centerY[srcIndex];
+    _centerZ[dstIndex] = _centerZ[srcIndex];
+    _extentX[dstIndex] = _extentX[srcIndex];
+    _extentY[dstIndex] = _extentY[srcIndex];
+    _extentZ[dstIndex] = _extentZ[srcIndex];
+}
+
+auto FrustumCulling::Cull(const Frustum &frustum, const AABBSoA &boxes, uint8_t *pVisible) -> size_t {
+    const float *pCenterX = boxes._centerX.data();
+    const float *pCenterY = boxes._centerY.data();
+    const float *pCenterZ = boxes._centerZ.data();
+    const float *pExtentX = boxes._extentX.data();
+    const float *pExtentY = boxes._extentY.data();
+    const float *pExtentZ = boxes._extentZ.data();
+    size_t count = boxes.GetCount();
+    size_t visibleCount = 0;
+    size_t i = 0;
+
+    // a box is outside when dot(n, center) + w + dot(|n|, extents) < 0 for any plane.
+    // an overflow of the unbounded extents only produces +inf, never NaN, because the planes are finite
+#if GLM_STD_AVX
+    for (; i + 8 <= count; i += 8) {
+        __m256 cx = _mm256_loadu_ps(pCenterX + i);
+        __m256 cy = _mm256_loadu_ps(pCenterY + i);
+        __m256 cz = _mm256_loadu_ps(pCenterZ + i);
+        __m256 ex = _mm256_loadu_ps(pExtentX + i);
+        __m256 ey = _mm256_loadu_ps(pExtentY + i);
+        __m256 ez = _mm256_loadu_ps(pExtentZ + i);
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (const glm::vec4 &plane : frustum.planes) {
+            __m256 d = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), cx), _mm256_set1_ps(plane.w));
+            d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(plane.y), cy));
+            d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(plane.z), cz));
+            d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.x)), ex));
+            d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.y)), ey));
+            d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(std::abs(plane.z)), ez));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+        int mask = _mm256_movemask_ps(inside);
+        for (int lane = 0; lane < 8; ++lane) {
+            pVisible[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+        }
+        visibleCount += static_cast<size_t>(std::popcount(static_cast<uint32_t>(mask)));
+    }
+#elif GLM_STD_SSE
+    for (; i + 4 <= count; i += 4) {
+        __m128 cx = _mm_loadu_ps(pCenterX + i);
+        __m128 cy = _mm_loadu_ps(pCenterY + i);
+        __m128 cz = _mm_loadu_ps(pCenterZ + i);
+        __m128 ex = _mm_loadu_ps(pExtentX + i);
+        __m128 ey = _mm_loadu_ps(pExtentY + i);
+        __m128 ez = _mm_loadu_ps(pExtentZ + i);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const glm::vec4 &plane : frustum.planes) {
+            __m128 d = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), cx), _mm_set1_ps(plane.w));
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(plane.y), cy));
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(plane.z), cz));
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(std::abs(plane.x)), ex));
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(std::abs(plane.y)), ey));
+            d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(std::abs(plane.z)), ez));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, _mm_setzero_ps()));
+        }
+        int mask = _mm_movemask_ps(inside);
+        for (int lane = 0; lane < 4; ++lane) {
+            pVisible[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+        }
+        visibleCount += static_cast<size_t>(std::popcount(static_cast<uint32_t>(mask)));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        bool inside = true;
+        for (const glm::vec4 &plane : frustum.planes) {
+            float d = plane.x * pCenterX[i] + plane.w;
+            d += plane.y * pCenterY[i];
+            d += plane.z * pCenterZ[i];
+            d += std::abs(plane.x) * pExtentX[i];
+            d += std::abs(plane.y) * pExtentY[i];
+            d += std::abs(plane.z) * pExtentZ[i];
+            inside = inside && d >= 0.f;
+        }
+        pVisible[i] = static_cast<uint8_t>(inside);
+        visibleCount += static_cast<size_t>(inside);
+    }
+    return visibleCount;
+}
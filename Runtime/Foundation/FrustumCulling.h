@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Foundation/BoundingVolume.hpp"
+
+// Structure of arrays storage of bounding boxes as center and extents, laid out for the batched frustum test.
+// An unbounded box (e.g. a mesh without bounds yet) uses the largest extents and always passes the test.
+class AABBSoA {
+public:
+    void Resize(size_t count);
+    void Set(size_t index, const AABB &bounds);
+    // copies the box at srcIndex over dstIndex, used by swap removal
+    void Move(size_t dstIndex, size_t srcIndex);
+    auto GetCount() const -> size_t {
+        return _centerX.size();
+    }
+private:
+    friend class FrustumCulling;
+    // clang-format off
+    std::vector<float>  _centerX;
+    std::vector<float>  _centerY;
+    std::vector<float>  _centerZ;
+    std::vector<float>  _extentX;
+    std::vector<float>  _extentY;
+    std::vector<float>  _extentZ;
+    // clang-format on
+};
+
+class FrustumCulling {
+public:
+    // writes 1 for the boxes that intersect the frustum and 0 for the others, returns the number of visible boxes.
+    // tests 8 boxes per iteration with AVX, 4 with SSE
+    static auto Cull(const Frustum &frustum, const AABBSoA &boxes, uint8_t *pVisible) -> size_t;
+};
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstring>
+#include "PreprocessorDirectives.h"
 #include <glm/glm.hpp>
 #include <glm/detail/type_quat.hpp>
 #include <glm/ext/quaternion_trigonometric.hpp>
@@ -6,6 +8,220 @@
 #include <glm/gtx/matrix_decompose.hpp>
 #include <fmt/format.h>
 
+// GLM_STD_AVX is defined by the avx2 option of the build, a compiler targeting AVX on its own enables it as well
+#if !defined(GLM_STD_AVX) && defined(__AVX__)
+    #define GLM_STD_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    #define GLM_STD_SSE 1
+    #include <immintrin.h>
+#endif
+
+#pragma region AffineKernel
+
+// Kernels for column major affine matrices (last row is 0, 0, 0, 1), stored as 16 contiguous floats.
+// The SSE path only needs SSE2, the batched multiply uses AVX when the target enables it.
+namespace glm::affine_detail {
+
+#if GLM_STD_SSE
+Inline(2) __m128 Splat(__m128 v, int lane) {
+    switch (lane) {
+    case 0:
+        return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+    case 1:
+        return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+    case 2:
+        return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+    default:
+        return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+}
+
+Inline(2) __m128 Cross(__m128 a, __m128 b) {
+    __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+    return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+Inline(2) __m128 Dot3(__m128 a, __m128 b) {
+    __m128 m = _mm_mul_ps(a, b);
+    __m128 x = Splat(m, 0);
+    __m128 y = Splat(m, 1);
+    __m128 z = Splat(m, 2);
+    return _mm_add_ps(_mm_add_ps(x, y), z);
+}
+
+// computes the rows of the inverse 3x3 (the columns of the normal matrix), w is zero
+Inline(2) void InverseRows(const float *pMatrix, __m128 &r0, __m128 &r1, __m128 &r2) {
+    const __m128 xyzMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+    __m128 c0 = _mm_and_ps(_mm_loadu_ps(pMatrix + 0), xyzMask);
+    __m128 c1 = _mm_and_ps(_mm_loadu_ps(pMatrix + 4), xyzMask);
+    __m128 c2 = _mm_and_ps(_mm_loadu_ps(pMatrix + 8), xyzMask);
+    r0 = Cross(c1, c2);
+    r1 = Cross(c2, c0);
+    r2 = Cross(c0, c1);
+    __m128 invDet = _mm_div_ps(_mm_set1_ps(1.f), Dot3(c0, r0));
+    r0 = _mm_mul_ps(r0, invDet);
+    r1 = _mm_mul_ps(r1, invDet);
+    r2 = _mm_mul_ps(r2, invDet);
+}
+#endif
+
+Inline(2) void ScalarInverseRows(const float *m, float r[3][3]) {
+    // rows of the inverse are the cross products of the columns divided by the determinant
+    r[0][0] = m[5] * m[10] - m[6] * m[9];
+    r[0][1] = m[6] * m[8] - m[4] * m[10];
+    r[0][2] = m[4] * m[9] - m[5] * m[8];
+    r[1][0] = m[9] * m[2] - m[10] * m[1];
+    r[1][1] = m[10] * m[0] - m[8] * m[2];
+    r[1][2] = m[8] * m[1] - m[9] * m[0];
+    r[2][0] = m[1] * m[6] - m[2] * m[5];
+    r[2][1] = m[2] * m[4] - m[0] * m[6];
+    r[2][2] = m[0] * m[5] - m[1] * m[4];
+    float invDet = 1.f / (m[0] * r[0][0] + m[1] * r[0][1] + m[2] * r[0][2]);
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            r[i][j] *= invDet;
+        }
+    }
+}
+
+// out = a * b
+Inline(2) void Multiply(const float *a, const float *b, float *out) {
+#if GLM_STD_SSE
+    __m128 a0 = _mm_loadu_ps(a + 0);
+    __m128 a1 = _mm_loadu_ps(a + 4);
+    __m128 a2 = _mm_loadu_ps(a + 8);
+    __m128 a3 = _mm_loadu_ps(a + 12);
+    __m128 result[4];
+    for (int j = 0; j < 4; ++j) {
+        __m128 bj = _mm_loadu_ps(b + j * 4);
+        __m128 r = _mm_mul_ps(a0, Splat(bj, 0));
+        r = _mm_add_ps(r, _mm_mul_ps(a1, Splat(bj, 1)));
+        r = _mm_add_ps(r, _mm_mul_ps(a2, Splat(bj, 2)));
+        result[j] = r;
+    }
+    // the last column of b is (t, 1)
+    result[3] = _mm_add_ps(result[3], a3);
+    for (int j = 0; j < 4; ++j) {
+        _mm_storeu_ps(out + j * 4, result[j]);
+    }
+#else
+    float result[16];
+    for (int j = 0; j < 4; ++j) {
+        for (int i = 0; i < 4; ++i) {
+            result[j * 4 + i] = a[i] * b[j * 4 + 0] + a[4 + i] * b[j * 4 + 1] + a[8 + i] * b[j * 4 + 2];
+        }
+    }
+    for (int i = 0; i < 4; ++i) {
+        result[12 + i] += a[12 + i];
+    }
+    std::memcpy(out, result, sizeof(result));
+#endif
+}
+
+Inline(2) void Inverse(const float *m, float *out) {
+#if GLM_STD_SSE
+    __m128 r0, r1, r2;
+    InverseRows(m, r0, r1, r2);
+    __m128 r3 = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    __m128 t = _mm_loadu_ps(m + 12);
+    __m128 c3 = _mm_mul_ps(r0, Splat(t, 0));
+    c3 = _mm_add_ps(c3, _mm_mul_ps(r1, Splat(t, 1)));
+    c3 = _mm_add_ps(c3, _mm_mul_ps(r2, Splat(t, 2)));
+    c3 = _mm_sub_ps(_mm_set_ps(1.f, 0.f, 0.f, 0.f), c3);
+    _mm_storeu_ps(out + 0, r0);
+    _mm_storeu_ps(out + 4, r1);
+    _mm_storeu_ps(out + 8, r2);
+    _mm_storeu_ps(out + 12, c3);
+#else
+    float r[3][3];
+    ScalarInverseRows(m, r);
+    float result[16] = {};
+    for (int j = 0; j < 3; ++j) {
+        for (int i = 0; i < 3; ++i) {
+            result[j * 4 + i] = r[i][j];
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        result[12 + i] = -(r[i][0] * m[12] + r[i][1] * m[13] + r[i][2] * m[14]);
+    }
+    result[15] = 1.f;
+    std::memcpy(out, result, sizeof(result));
+#endif
+}
+
+// transpose(inverse(mat3(m))) extended to 4x4
+Inline(2) void NormalMatrix(const float *m, float *out) {
+#if GLM_STD_SSE
+    __m128 r0, r1, r2;
+    InverseRows(m, r0, r1, r2);
+    _mm_storeu_ps(out + 0, r0);
+    _mm_storeu_ps(out + 4, r1);
+    _mm_storeu_ps(out + 8, r2);
+    _mm_storeu_ps(out + 12, _mm_set_ps(1.f, 0.f, 0.f, 0.f));
+#else
+    float r[3][3];
+    ScalarInverseRows(m, r);
+    float result[16] = {};
+    for (int j = 0; j < 3; ++j) {
+        for (int i = 0; i < 3; ++i) {
+            result[j * 4 + i] = r[j][i];
+        }
+    }
+    result[15] = 1.f;
+    std::memcpy(out, result, sizeof(result));
+#endif
+}
+
+// pOut[i] = pLhs[i] * pRhs[i]
+inline void MultiplyBatch(const float *pLhs, const float *pRhs, float *pOut, size_t count) {
+#if GLM_STD_AVX
+    for (size_t n = 0; n < count; ++n) {
+        const float *a = pLhs + n * 16;
+        const float *b = pRhs + n * 16;
+        float *out = pOut + n * 16;
+        __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 0));
+        __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 4));
+        __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(a + 8));
+        // two columns of b per register
+        for (int j = 0; j < 4; j += 2) {
+            __m256 bj = _mm256_loadu_ps(b + j * 4);
+            __m256 r = _mm256_mul_ps(a0, _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(0, 0, 0, 0)));
+            r = _mm256_add_ps(r, _mm256_mul_ps(a1, _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(1, 1, 1, 1))));
+            r = _mm256_add_ps(r, _mm256_mul_ps(a2, _mm256_shuffle_ps(bj, bj, _MM_SHUFFLE(2, 2, 2, 2))));
+            if (j == 2) {
+                __m256 a3 = _mm256_insertf128_ps(_mm256_setzero_ps(), _mm_loadu_ps(a + 12), 1);
+                r = _mm256_add_ps(r, a3);
+            }
+            _mm256_storeu_ps(out + j * 4, r);
+        }
+    }
+#else
+    for (size_t n = 0; n < count; ++n) {
+        Multiply(pLhs + n * 16, pRhs + n * 16, pOut + n * 16);
+    }
+#endif
+}
+
+inline void InverseBatch(const float *pMatrices, float *pOut, size_t count) {
+    for (size_t n = 0; n < count; ++n) {
+        Inverse(pMatrices + n * 16, pOut + n * 16);
+    }
+}
+
+inline void NormalMatrixBatch(const float *pMatrices, float *pOut, size_t count) {
+    for (size_t n = 0; n < count; ++n) {
+        NormalMatrix(pMatrices + n * 16, pOut + n * 16);
+    }
+}
+
+}    // namespace glm::affine_detail
+
+#pragma endregion
+
 namespace glm {
 
 inline quat Direction2LookAtQuaternion(vec3 direction, glm::vec3 up = glm::vec3(0.f, 1.f, 0.f)) {
@@ -22,12 +238,65 @@ inline vec3 LookAtQuaternion2Direction(quat rotation) {
 }
 
 
+// same result as translate(T) * mat4_cast(R) * scale(S), without the two matrix products
 inline mat4x4 MakeAffineMatrix(const vec3 &translation, const quat &rotation, const vec3 &scale) {
-	glm::mat4x4 matrix = glm::scale(glm::mat4_cast(rotation), scale);
-    matrix = glm::translate(glm::identity<glm::mat4>(), translation) * matrix;
+    float xx = rotation.x * rotation.x;
+    float yy = rotation.y * rotation.y;
+    float zz = rotation.z * rotation.z;
+    float xy = rotation.x * rotation.y;
+    float xz = rotation.x * rotation.z;
+    float yz = rotation.y * rotation.z;
+    float wx = rotation.w * rotation.x;
+    float wy = rotation.w * rotation.y;
+    float wz = rotation.w * rotation.z;
+    return mat4x4(vec4(1.f - 2.f * (yy + zz), 2.f * (xy + wz), 2.f * (xz - wy), 0.f) * scale.x,
+        vec4(2.f * (xy - wz), 1.f - 2.f * (xx + zz), 2.f * (yz + wx), 0.f) * scale.y,
+        vec4(2.f * (xz + wy), 2.f * (yz - wx), 1.f - 2.f * (xx + yy), 0.f) * scale.z,
+        vec4(translation, 1.f));
+}
+
+// inverse of MakeAffineMatrix(translation, rotation, scale): scale(1/S) * transpose(R) * translate(-T)
+inline mat4x4 MakeInverseAffineMatrix(const vec3 &translation, const quat &rotation, const vec3 &scale) {
+    mat4x4 matrix = MakeAffineMatrix(vec3(0.f), conjugate(rotation), vec3(1.f));
+    vec3 invScale = 1.f / scale;
+    for (int j = 0; j < 3; ++j) {
+        matrix[j] = vec4(vec3(matrix[j]) * invScale, 0.f);
+    }
+    vec3 t = -(vec3(matrix[0]) * translation.x + vec3(matrix[1]) * translation.y + vec3(matrix[2]) * translation.z);
+    matrix[3] = vec4(t, 1.f);
     return matrix;
 }
 
+inline mat4x4 AffineMultiply(const mat4x4 &lhs, const mat4x4 &rhs) {
+    mat4x4 result;
+    affine_detail::Multiply(&lhs[0][0], &rhs[0][0], &result[0][0]);
+    return result;
+}
+
+inline mat4x4 AffineInverse(const mat4x4 &matrix) {
+    mat4x4 result;
+    affine_detail::Inverse(&matrix[0][0], &result[0][0]);
+    return result;
+}
+
+inline mat4x4 AffineNormalMatrix(const mat4x4 &world) {
+    mat4x4 result;
+    affine_detail::NormalMatrix(&world[0][0], &result[0][0]);
+    return result;
+}
+
+inline void AffineMultiplyBatch(const mat4x4 *pLhs, const mat4x4 *pRhs, mat4x4 *pOut, size_t count) {
+    affine_detail::MultiplyBatch(&pLhs[0][0][0], &pRhs[0][0][0], &pOut[0][0][0], count);
+}
+
+inline void AffineInverseBatch(const mat4x4 *pMatrices, mat4x4 *pOut, size_t count) {
+    affine_detail::InverseBatch(&pMatrices[0][0][0], &pOut[0][0][0], count);
+}
+
+inline void AffineNormalMatrixBatch(const mat4x4 *pMatrices, mat4x4 *pOut, size_t count) {
+    affine_detail::NormalMatrixBatch(&pMatrices[0][0][0], &pOut[0][0][0], count);
+}
+
 inline void Quaternion2BasisAxis(quat q, vec3 &x, vec3 &y, vec3 &z) {
 	q = normalize(q);
     mat3 matrix = mat3_cast(q);
@@ -54,7 +323,7 @@ inline quat MakeQuaternionByEuler(float pitch, float yaw, float roll) {
 }
 
 inline mat4x4 WorldMatrixToNormalMatrix(const mat4x4 &world) {
-	return mat4x4(transpose(inverse(mat3x3(world))));
+	return AffineNormalMatrix(world);
 }
 
 }
@@ -0,0 +1,308 @@
+#include "JobSystem.h"
+#include "Logger.h"
+#include "Memory/PoolAllocator.h"
+#include "StringUtil.h"
+#include <fmt/format.h>
+
+#if PLATFORM_WIN
+    #include <Windows.h>
+#endif
+
+// jobs come from a pool and ParallelFor chunks carry a RangeFunction instead of a std::function,
+// so scheduling in a steady state frame does not touch the general purpose heap
+struct JobCounter::Job {
+    DECLARE_POOL_OBJECT(Job);
+public:
+    // clang-format off
+    JobSystem::JobFunction      function;
+    JobSystem::RangeFunction    rangeFunction;          // used instead of function when pInvoke is set
+    size_t                      rangeBegin = 0;
+    size_t                      rangeEnd = 0;
+    JobCounter                 *pSignalCounter = nullptr;
+    Job                        *pNextContinuation = nullptr;
+    // clang-format on
+};
+
+struct JobSystem::Worker {
+    // clang-format off
+    std::thread                 thread;
+    WorkStealingQueue<Job *>    queue;
+    // clang-format on
+};
+
+static thread_local size_t sWorkerIndex = JobSystem::kInvalidWorkerIndex;
+
+JobSystem::JobSystem() : _queuedJobCount(0), _sleepingWorkerCount(0), _quit(false) {
+}
+
+JobSystem::~JobSystem() {
+}
+
+void JobSystem::OnCreate(size_t numWorkers) {
+    _quit.store(false);
+    _globalQueue.jobs.resize(kGlobalQueueInitialSize);
+    _backgroundQueue.jobs.resize(kGlobalQueueInitialSize);
+    for (size_t i = 0; i < numWorkers; ++i) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+    // all queues must exist before any worker starts stealing
+    for (size_t i = 0; i < numWorkers; ++i) {
+        _workers[i]->thread = std::thread(&JobSystem::WorkerEntry, this, i);
+    }
+    Logger::Info("JobSystem create {} worker threads", numWorkers);
+}
+
+void JobSystem::OnDestroy() {
+    {
+        std::unique_lock lock(_sleepMutex);
+        _quit.store(true);
+    }
+    _wakeCondition.notify_all();
+    for (std::unique_ptr<Worker> &pWorker : _workers) {
+        pWorker->thread.join();
+    }
+
+    // workers have exited, run the remaining jobs on the calling thread
+    while (TryExecuteOneJob(true)) {
+    }
+    Assert(_queuedJobCount.load() == 0);
+    _workers.clear();
+}
+
+void JobSystem::Schedule(JobFunction job, JobCounter *pSignalCounter, JobCounter *pWaitCounter) {
+    if (pSignalCounter != nullptr) {
+        pSignalCounter->_pendingCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Job *pJob = new Job;
+    pJob->function = std::move(job);
+    pJob->pSignalCounter = pSignalCounter;
+    if (pWaitCounter != nullptr) {
+        std::unique_lock lock(pWaitCounter->_mutex);
+        if (!pWaitCounter->IsFinished()) {
+            pJob->pNextContinuation = pWaitCounter->_pContinuations;
+            pWaitCounter->_pContinuations = pJob;
+            return;
+        }
+    }
+    Submit(pJob);
+}
+
+void JobSystem::Schedule(JobFunction job, MainThread::JobWorkTime jobWorkTime, MainThread::Job callback) {
+    Schedule([job = std::move(job), jobWorkTime, callback = std::move(callback)]() mutable {
+        job();
+        MainThread::AddMainThreadJob(jobWorkTime, std::move(callback));
+    });
+}
+
+void JobSystem::ScheduleBackground(JobFunction job, JobCounter *pSignalCounter) {
+    if (pSignalCounter != nullptr) {
+        pSignalCounter->_pendingCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Job *pJob = new Job;
+    pJob->function = std::move(job);
+    pJob->pSignalCounter = pSignalCounter;
+    if (_workers.empty()) {
+        Execute(pJob);
+        return;
+    }
+
+    _queuedJobCount.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::unique_lock lock(_globalQueueMutex);
+        PushJob(_backgroundQueue, pJob);
+    }
+    WakeUpWorker();
+}
+
+void JobSystem::Wait(const JobCounter &counter) {
+    while (!counter.IsFinished()) {
+        if (!TryExecuteOneJob(false)) {
+            std::this_thread::yield();
+        }
+    }
+    // the last Finish() may still hold the mutex, wait for it before the counter goes out of scope
+    std::unique_lock lock(counter._mutex);
+}
+
+void JobSystem::ParallelForImpl(size_t begin, size_t end, size_t grainSize, const RangeFunction &function) {
+    if (begin >= end) {
+        return;
+    }
+
+    grainSize = std::max<size_t>(grainSize, 1);
+    if (_workers.empty() || end - begin <= grainSize) {
+        function.pInvoke(function.pFunction, begin, end);
+        return;
+    }
+
+    JobCounter counter;
+    // the calling thread takes the first chunk itself
+    for (size_t first = begin + grainSize; first < end; first += grainSize) {
+        counter._pendingCount.fetch_add(1, std::memory_order_relaxed);
+        Job *pJob = new Job;
+        pJob->rangeFunction = function;
+        pJob->rangeBegin = first;
+        pJob->rangeEnd = std::min(first + grainSize, end);
+        pJob->pSignalCounter = &counter;
+        Submit(pJob);
+    }
+    function.pInvoke(function.pFunction, begin, std::min(begin + grainSize, end));
+    Wait(counter);
+}
+
+auto JobSystem::GetDefaultWorkerCount() -> size_t {
+    size_t hardwareConcurrency = std::thread::hardware_concurrency();
+    // keep one core for the main thread
+    return hardwareConcurrency > 1 ? hardwareConcurrency - 1 : 0;
+}
+
+auto JobSystem::GetCurrentWorkerIndex() -> size_t {
+    return sWorkerIndex;
+}
+
+void JobSystem::WorkerEntry(size_t workerIndex) {
+    sWorkerIndex = workerIndex;
+#if PLATFORM_WIN
+    std::wstring threadName = nstd::to_wstring(fmt::format("JobWorker {}", workerIndex));
+    SetThreadDescription(GetCurrentThread(), threadName.c_str());
+#endif
+
+    while (true) {
+        if (TryExecuteOneJob(true)) {
+            continue;
+        }
+
+        std::unique_lock lock(_sleepMutex);
+        _sleepingWorkerCount.fetch_add(1, std::memory_order_seq_cst);
+        _wakeCondition.wait(lock, [&]() {
+            return _quit.load() || _queuedJobCount.load(std::memory_order_seq_cst) > 0;
+        });
+        _sleepingWorkerCount.fetch_sub(1, std::memory_order_relaxed);
+        if (_quit.load()) {
+            break;
+        }
+    }
+    sWorkerIndex = kInvalidWorkerIndex;
+}
+
+void JobSystem::Submit(Job *pJob) {
+    if (_workers.empty()) {
+        Execute(pJob);
+        return;
+    }
+
+    _queuedJobCount.fetch_add(1, std::memory_order_seq_cst);
+    size_t workerIndex = GetCurrentWorkerIndex();
+    if (workerIndex == kInvalidWorkerIndex || !_workers[workerIndex]->queue.Push(pJob)) {
+        std::unique_lock lock(_globalQueueMutex);
+        PushJob(_globalQueue, pJob);
+    }
+    WakeUpWorker();
+}
+
+void JobSystem::PushJob(JobQueue &queue, Job *pJob) {
+    if (queue.count == queue.jobs.size()) {
+        std::vector<Job *> jobs(std::max(queue.jobs.size() * 2, kGlobalQueueInitialSize));
+        for (size_t i = 0; i < queue.count; ++i) {
+            jobs[i] = queue.jobs[(queue.head + i) % queue.jobs.size()];
+        }
+        queue.jobs.swap(jobs);
+        queue.head = 0;
+    }
+    queue.jobs[(queue.head + queue.count) % queue.jobs.size()] = pJob;
+    ++queue.count;
+}
+
+auto JobSystem::PopJob(JobQueue &queue) -> Job * {
+    if (queue.count == 0) {
+        return nullptr;
+    }
+    Job *pJob = queue.jobs[queue.head];
+    queue.head = (queue.head + 1) % queue.jobs.size();
+    --queue.count;
+    return pJob;
+}
+
+bool JobSystem::TryExecuteOneJob(bool allowBackground) {
+    Job *pJob = FetchJob(allowBackground);
+    if (pJob == nullptr) {
+        return false;
+    }
+    _queuedJobCount.fetch_sub(1, std::memory_order_relaxed);
+    Execute(pJob);
+    return true;
+}
+
+auto JobSystem::FetchJob(bool allowBackground) -> Job * {
+    Job *pJob = nullptr;
+    size_t workerIndex = GetCurrentWorkerIndex();
+    if (workerIndex != kInvalidWorkerIndex && _workers[workerIndex]->queue.Pop(pJob)) {
+        return pJob;
+    }
+
+    {
+        std::unique_lock lock(_globalQueueMutex);
+        if ((pJob = PopJob(_globalQueue)) != nullptr) {
+            return pJob;
+        }
+    }
+
+    // start from the neighbour to spread the thieves over the queues
+    size_t numWorkers = _workers.size();
+    size_t startIndex = workerIndex != kInvalidWorkerIndex ? workerIndex + 1 : 0;
+    for (size_t i = 0; i < numWorkers; ++i) {
+        size_t victimIndex = (startIndex + i) % numWorkers;
+        if (victimIndex != workerIndex && _workers[victimIndex]->queue.Steal(pJob)) {
+            return pJob;
+        }
+    }
+
+    if (allowBackground) {
+        std::unique_lock lock(_globalQueueMutex);
+        return PopJob(_backgroundQueue);
+    }
+    return nullptr;
+}
+
+void JobSystem::Execute(Job *pJob) {
+    if (pJob->rangeFunction.pInvoke != nullptr) {
+        pJob->rangeFunction.pInvoke(pJob->rangeFunction.pFunction, pJob->rangeBegin, pJob->rangeEnd);
+    } else {
+        pJob->function();
+    }
+    JobCounter *pSignalCounter = pJob->pSignalCounter;
+    delete pJob;
+    if (pSignalCounter != nullptr) {
+        Finish(pSignalCounter);
+    }
+}
+
+void JobSystem::Finish(JobCounter *pCounter) {
+    Job *pContinuation = nullptr;
+    {
+        // take the lock before decrementing so a concurrent Schedule can not miss the transition to zero
+        std::unique_lock lock(pCounter->_mutex);
+        if (pCounter->_pendingCount.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        pContinuation = std::exchange(pCounter->_pContinuations, nullptr);
+    }
+    while (pContinuation != nullptr) {
+        Job *pJob = pContinuation;
+        pContinuation = pJob->pNextContinuation;
+        pJob->pNextContinuation = nullptr;
+        Submit(pJob);
+    }
+}
+
+void JobSystem::WakeUpWorker() {
+    if (_sleepingWorkerCount.load(std::memory_order_seq_cst) == 0) {
+        return;
+    }
+    // lock the mutex so that the notification can not slip in between the predicate check and the wait
+    std::unique_lock lock(_sleepMutex);
+    lock.unlock();
+    _wakeCondition.notify_one();
+}
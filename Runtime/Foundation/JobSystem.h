@@ -0,0 +1,113 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "MainThread.h"
+#include "Singleton.hpp"
+#include "WorkStealingQueue.hpp"
+
+class JobCounter : private NonCopyable {
+public:
+    JobCounter() : _pendingCount(0) {
+    }
+    ~JobCounter() {
+        Assert(IsFinished());
+    }
+    bool IsFinished() const {
+        return _pendingCount.load(std::memory_order_acquire) == 0;
+    }
+    auto GetPendingCount() const -> int32_t {
+        return _pendingCount.load(std::memory_order_acquire);
+    }
+private:
+    friend class JobSystem;
+    struct Job;
+    // clang-format off
+    std::atomic<int32_t>    _pendingCount;
+    mutable std::mutex      _mutex;
+    Job                    *_pContinuations = nullptr;     // intrusive list linked through Job::pNextContinuation
+    // clang-format on
+};
+
+class JobSystem : public Singleton<JobSystem> {
+public:
+    using JobFunction = std::function<void()>;
+    // non owning reference to the ParallelFor body, valid while ParallelFor blocks
+    struct RangeFunction {
+        const void *pFunction = nullptr;
+        void (*pInvoke)(const void *pFunction, size_t begin, size_t end) = nullptr;
+    };
+    static constexpr size_t kInvalidWorkerIndex = static_cast<size_t>(-1);
+    static constexpr size_t kGlobalQueueInitialSize = 1024;
+public:
+    JobSystem();
+    ~JobSystem() override;
+public:
+    // numWorkers == 0, all jobs are executed inline on the calling thread
+    void OnCreate(size_t numWorkers = GetDefaultWorkerCount());
+    void OnDestroy();
+    // pSignalCounter is decremented when the job finished.
+    // if pWaitCounter is not null, the job is not started until pWaitCounter reaches zero
+    void Schedule(JobFunction job, JobCounter *pSignalCounter = nullptr, JobCounter *pWaitCounter = nullptr);
+    // the job is executed on the worker thread, the callback is executed on the main thread at jobWorkTime
+    void Schedule(JobFunction job, MainThread::JobWorkTime jobWorkTime, MainThread::Job callback);
+    // for long running work like asset streaming. the job waits in its own queue that only the idle workers drain,
+    // after the other jobs, so a Wait or a ParallelFor never picks it up. runs inline when there are no workers
+    void ScheduleBackground(JobFunction job, JobCounter *pSignalCounter = nullptr);
+    // the calling thread helps to execute jobs until counter reaches zero, background jobs excepted.
+    // a counter must be waited before it is destroyed
+    void Wait(const JobCounter &counter);
+    // split [begin, end) into chunks of grainSize and blocks until all chunks finished.
+    // function is only referenced by the chunk jobs, whatever it captures is never copied to the heap
+    template<typename Function>
+    void ParallelFor(size_t begin, size_t end, size_t grainSize, const Function &function) {
+        RangeFunction rangeFunction;
+        rangeFunction.pFunction = &function;
+        rangeFunction.pInvoke = [](const void *pFunction, size_t first, size_t last) {
+            (*static_cast<const Function *>(pFunction))(first, last);
+        };
+        ParallelForImpl(begin, end, grainSize, rangeFunction);
+    }
+    auto GetWorkerCount() const -> size_t {
+        return _workers.size();
+    }
+    static auto GetDefaultWorkerCount() -> size_t;
+    static auto GetCurrentWorkerIndex() -> size_t;
+private:
+    using Job = JobCounter::Job;
+    struct Worker;
+    // ring buffer, only grows when full
+    struct JobQueue {
+        std::vector<Job *> jobs;
+        size_t head = 0;
+        size_t count = 0;
+    };
+    void ParallelForImpl(size_t begin, size_t end, size_t grainSize, const RangeFunction &function);
+    void WorkerEntry(size_t workerIndex);
+    void Submit(Job *pJob);
+    static void PushJob(JobQueue &queue, Job *pJob);
+    static auto PopJob(JobQueue &queue) -> Job *;
+    // only the loop of a worker passes allowBackground, a waiting thread must return to its own work quickly
+    bool TryExecuteOneJob(bool allowBackground);
+    auto FetchJob(bool allowBackground) -> Job *;
+    void Execute(Job *pJob);
+    void Finish(JobCounter *pCounter);
+    void WakeUpWorker();
+private:
+    // clang-format off
+    std::vector<std::unique_ptr<Worker>>    _workers;
+    std::mutex                              _globalQueueMutex;
+    JobQueue                                _globalQueue;
+    // guarded by _globalQueueMutex as well
+    JobQueue                                _backgroundQueue;
+    std::atomic<int64_t>                    _queuedJobCount;
+    std::atomic<uint32_t>                   _sleepingWorkerCount;
+    std::mutex                              _sleepMutex;
+    std::condition_variable                 _wakeCondition;
+    std::atomic<bool>                       _quit;
+    // clang-format on
+};
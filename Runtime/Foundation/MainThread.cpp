@@ -5,6 +5,8 @@
 static std::thread::id sMainThreadId = std::this_thread::get_id();
 static std::mutex sQueueMutex[magic_enum::enum_count<MainThread::JobWorkTime>()];
 static std::vector<MainThread::Job> sJobQueue[magic_enum::enum_count<MainThread::JobWorkTime>()];
+// swapped with sJobQueue on execution, both keep their capacity so a steady state frame does not allocate
+static std::vector<MainThread::Job> sExecuteQueue[magic_enum::enum_count<MainThread::JobWorkTime>()];
 
 bool MainThread::IsMainThread() {
     return std::this_thread::get_id() == sMainThreadId;
@@ -36,20 +38,31 @@ void MainThread::AddMainThreadJob(JobWorkTime jobWorkTime, Job job) {
 void MainThread::ExecuteMainThreadJob(JobWorkTime jobWorkTime, GameTimer &gameTimer) {
     EnsureMainThread();
     size_t index = magic_enum::enum_index(jobWorkTime).value();
+    std::vector<Job> &queue = sExecuteQueue[index];
     std::unique_lock lock(sQueueMutex[index]);
-    std::vector<Job> queue = std::move(sJobQueue[index]);
-    sJobQueue[index].clear();
+    queue.swap(sJobQueue[index]);
     lock.unlock();
 
-    std::vector<Job> nextFrameExecuteJob;
+    if (queue.empty()) {
+        return;
+    }
+
+    size_t nextFrameJobCount = 0;
     for (Job &job : queue) {
 	    JobStatus status = job(gameTimer);
         if (status == JobStatus::ExecuteInNextFrame) {
-	        nextFrameExecuteJob.push_back(std::move(job));
+            Job &dest = queue[nextFrameJobCount++];
+            if (&dest != &job) {
+                dest = std::move(job);
+            }
         }
     }
+    queue.resize(nextFrameJobCount);
 
     lock.lock();
-    sJobQueue[index].insert(sJobQueue[index].end(), nextFrameExecuteJob.begin(), nextFrameExecuteJob.end());
+    sJobQueue[index].insert(sJobQueue[index].end(),
+        std::make_move_iterator(queue.begin()),
+        std::make_move_iterator(queue.end()));
     lock.unlock();
+    queue.clear();
 }
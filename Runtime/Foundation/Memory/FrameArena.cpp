@@ -0,0 +1,99 @@
+#include "FrameArena.h"
+#include "Foundation/Exception.h"
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <new>
+
+static std::atomic<uint64_t> sFrameIndex = 0;
+
+namespace {
+
+struct Block {
+    static void Free(std::byte *pointer) {
+        ::operator delete(pointer, std::align_val_t(alignof(std::max_align_t)));
+    }
+    // clang-format off
+    std::unique_ptr<std::byte[], decltype(&Free)>   pData = {nullptr, &Free};
+    size_t                                          size = 0;
+    // clang-format on
+};
+
+struct ThreadArena {
+    void Rewind(uint64_t frameIndex) {
+        this->frameIndex = frameIndex;
+        blockIndex = 0;
+        offset = 0;
+        usedBytes = 0;
+    }
+    auto AllocateBlock(size_t minSize) -> Block & {
+        Block block;
+        block.size = std::max(minSize, FrameArena::kDefaultBlockSize);
+        block.pData.reset(static_cast<std::byte *>(
+            ::operator new(block.size, std::align_val_t(alignof(std::max_align_t)))));
+        return blocks.emplace_back(std::move(block));
+    }
+public:
+    // clang-format off
+    uint64_t            frameIndex = 0;
+    size_t              blockIndex = 0;
+    size_t              offset     = 0;
+    size_t              usedBytes  = 0;
+    std::vector<Block>  blocks;
+    // clang-format on
+};
+
+thread_local ThreadArena sThreadArena;
+
+}    // namespace
+
+auto FrameArena::Allocate(size_t size, size_t alignment) -> void * {
+    Assert(std::has_single_bit(alignment));
+    ThreadArena &arena = sThreadArena;
+    uint64_t frameIndex = sFrameIndex.load(std::memory_order_relaxed);
+    if (arena.frameIndex != frameIndex) {
+        arena.Rewind(frameIndex);
+    }
+
+    size = std::max<size_t>(size, 1);
+    while (arena.blockIndex < arena.blocks.size()) {
+        Block &block = arena.blocks[arena.blockIndex];
+        size_t address = reinterpret_cast<size_t>(block.pData.get()) + arena.offset;
+        size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+        if (arena.offset + padding + size <= block.size) {
+            arena.offset += padding + size;
+            arena.usedBytes += padding + size;
+            return reinterpret_cast<void *>(address + padding);
+        }
+        ++arena.blockIndex;
+        arena.offset = 0;
+    }
+
+    // the blocks are kept across frames, so this only happens until the arena reaches its high water mark
+    Block &block = arena.AllocateBlock(size + alignment);
+    arena.blockIndex = arena.blocks.size() - 1;
+    size_t address = reinterpret_cast<size_t>(block.pData.get());
+    size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+    arena.offset = padding + size;
+    arena.usedBytes += padding + size;
+    return reinterpret_cast<void *>(address + padding);
+}
+
+void FrameArena::OnPostRender() {
+    sFrameIndex.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto FrameArena::GetFrameIndex() -> uint64_t {
+    return sFrameIndex.load(std::memory_order_relaxed);
+}
+
+auto FrameArena::GetStatistics() -> Statistics {
+    const ThreadArena &arena = sThreadArena;
+    Statistics statistics;
+    statistics.blockCount = arena.blocks.size();
+    for (const Block &block : arena.blocks) {
+        statistics.reservedBytes += block.size;
+    }
+    statistics.usedBytes = arena.frameIndex == GetFrameIndex() ? arena.usedBytes : 0;
+    return statistics;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "Foundation/PreprocessorDirectives.h"
+
+// Thread local linear allocator for transient per frame data.
+// Memory is valid until the next FrameArena::OnPostRender, Deallocate is a no-op.
+// Each thread lazily rewinds its arena on the first allocation of a new frame, so
+// jobs running on worker threads must not keep frame memory alive across a frame boundary.
+class FrameArena {
+public:
+    static constexpr size_t kDefaultBlockSize = 256 * 1024;
+    struct Statistics {
+        size_t blockCount = 0;
+        size_t reservedBytes = 0;
+        size_t usedBytes = 0;
+    };
+public:
+    static auto Allocate(size_t size, size_t alignment) -> void *;
+    static void OnPostRender();
+    static auto GetFrameIndex() -> uint64_t;
+    // statistics of the calling thread arena
+    static auto GetStatistics() -> Statistics;
+};
+
+template<typename T>
+class FrameAllocator {
+public:
+    using value_type = T;
+public:
+    FrameAllocator() noexcept = default;
+    template<typename U>
+    FrameAllocator(const FrameAllocator<U> &) noexcept {
+    }
+    auto allocate(size_t count) -> T * {
+        return static_cast<T *>(FrameArena::Allocate(count * sizeof(T), alignof(T)));
+    }
+    void deallocate(T *, size_t) noexcept {
+    }
+    template<typename U>
+    friend bool operator==(const FrameAllocator &, const FrameAllocator<U> &) noexcept {
+        return true;
+    }
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+template<typename K, typename V, typename Hash = std::hash<K>, typename Equal = std::equal_to<K>>
+using FrameUnorderedMap = std::unordered_map<K, V, Hash, Equal, FrameAllocator<std::pair<const K, V>>>;
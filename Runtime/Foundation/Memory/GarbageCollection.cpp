@@ -1,70 +1,117 @@
 #include "GarbageCollection.h"
 #include "RefCounter.h"
+#include "Foundation/JobSystem.h"
+#include "Foundation/NamespeceAlias.h"
 
-GarbageCollection::GarbageCollection() : _frameIndex(0), _delayedReleaseFrames(5) {
+GarbageCollection::GarbageCollection()
+    : _frameIndex(0), _delayedReleaseFrames(5), _enableBackgroundDestroy(true), _releasedObjectCount(0) {
 }
 
 GarbageCollection::~GarbageCollection() {
 }
 
 void GarbageCollection::OnCreate() {
+    _pBackgroundCounter = std::make_unique<JobCounter>();
 }
 
 void GarbageCollection::OnDestroy() {
-    _frameIndex = std::numeric_limits<uint64_t>::max();
-    DoGCWork();
+    if (JobSystem::GetInstance() != nullptr) {
+        JobSystem::GetInstance()->Wait(*_pBackgroundCounter);
+    }
+    _pBackgroundCounter = nullptr;
+
+    // destroying an object may release other objects, repeat until all buckets are empty
+    bool hasGarbage = false;
+    do {
+        hasGarbage = false;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            RefCounter *pHead = _buckets[i].pHead.exchange(nullptr, std::memory_order_acquire);
+            hasGarbage |= pHead != nullptr;
+            DestroyObjectList(pHead);
+        }
+    } while (hasGarbage);
 }
 
 void GarbageCollection::SetDelayedReleaseFrames(size_t num) {
     Assert(num >= 1);
+    Exception::CondThrow(num <= kMaxDelayedReleaseFrames,
+        "The delayed release frames {} exceeds the limit {}",
+        num,
+        kMaxDelayedReleaseFrames);
     _delayedReleaseFrames = num;
 }
 
+void GarbageCollection::SetEnableBackgroundDestroy(bool enable) {
+    _enableBackgroundDestroy = enable;
+}
+
 void GarbageCollection::AddObject(RefCounter *pObject) {
     Assert(pObject->GetRefCount() == 0);
-    Node node = {
-        _frameIndex,
+    // the bucket is not drained until _delayedReleaseFrames later,
+    // a stale frame index only delays the release by one ring cycle
+    uint64_t frameIndex = _frameIndex.load(std::memory_order_acquire);
+    Bucket &bucket = _buckets[frameIndex % kBucketCount];
+    RefCounter *pHead = bucket.pHead.load(std::memory_order_relaxed);
+    do {
+        pObject->_pNextGarbage = pHead;
+    } while (!bucket.pHead.compare_exchange_weak(pHead,
         pObject,
-    };
-
-    Lock();
-    _objects.push_back(node);
-    UnLock();
+        std::memory_order_release,
+        std::memory_order_relaxed));
+    _releasedObjectCount.fetch_add(1, std::memory_order_relaxed);
 }
 
 void GarbageCollection::DoGCWork() {
     MainThread::EnsureMainThread();
-    if (_frameIndex < _delayedReleaseFrames) {
+    uint64_t frameIndex = _frameIndex.load(std::memory_order_relaxed);
+    if (frameIndex < _delayedReleaseFrames) {
         return;
     }
 
-    uint64_t freeReleaseFrameIndex = _frameIndex - _delayedReleaseFrames;
-    Lock();
-    auto iter = _objects.begin();
-    auto end = _objects.end();
-    UnLock();
-
-    while (iter != end) {
-        if (freeReleaseFrameIndex >= iter->releaseFrameIndex) {
-            delete iter->pObject;
-            iter = _objects.erase(iter);
-        } else {
-            return;
-        }
-    }
+    auto beginTime = stdchrono::steady_clock::now();
+    _statistics.destroyedObjectCount = DestroyBucket((frameIndex - _delayedReleaseFrames) % kBucketCount);
+    auto endTime = stdchrono::steady_clock::now();
+    _statistics.destroyTimeMs = stdchrono::duration<double, std::milli>(endTime - beginTime).count();
 }
 
 void GarbageCollection::OnPostRender(GameTimer &timer) {
+    _statistics.backgroundDestroyedObjectCount = 0;
     DoGCWork();
-    ++_frameIndex;
+    _statistics.releasedObjectCount = _releasedObjectCount.exchange(0, std::memory_order_relaxed);
+    _frameIndex.fetch_add(1, std::memory_order_release);
 }
 
-void GarbageCollection::Lock() {
-     while (_lock.test_and_set(std::memory_order_acquire)) {
-	     std::this_thread::yield();
-     }
+auto GarbageCollection::DestroyBucket(size_t bucketIndex) -> size_t {
+    RefCounter *pHead = _buckets[bucketIndex].pHead.exchange(nullptr, std::memory_order_acquire);
+    bool backgroundDestroy = _enableBackgroundDestroy && JobSystem::GetInstance() != nullptr &&
+                             JobSystem::GetInstance()->GetWorkerCount() > 0;
+
+    size_t destroyedCount = 0;
+    RefCounter *pBackgroundHead = nullptr;
+    while (pHead != nullptr) {
+        RefCounter *pObject = pHead;
+        pHead = pHead->_pNextGarbage;
+        if (backgroundDestroy && pObject->AllowBackgroundDestroy()) {
+            pObject->_pNextGarbage = pBackgroundHead;
+            pBackgroundHead = pObject;
+            ++_statistics.backgroundDestroyedObjectCount;
+        } else {
+            delete pObject;
+            ++destroyedCount;
+        }
+    }
+
+    if (pBackgroundHead != nullptr) {
+        JobSystem::GetInstance()->Schedule([=]() { DestroyObjectList(pBackgroundHead); },
+            _pBackgroundCounter.get());
+    }
+    return destroyedCount;
 }
 
-void GarbageCollection::UnLock() {
-    _lock.clear(std::memory_order_release);               
+void GarbageCollection::DestroyObjectList(RefCounter *pHead) {
+    while (pHead != nullptr) {
+        RefCounter *pObject = pHead;
+        pHead = pHead->_pNextGarbage;
+        delete pObject;
+    }
 }
@@ -1,9 +1,19 @@
 #pragma once
 #include "Foundation/Singleton.hpp"
-#include <list>
+#include <atomic>
+#include <memory>
 
 class RefCounter;
+class JobCounter;
 class GarbageCollection : public Singleton<GarbageCollection> {
+public:
+	static constexpr size_t kMaxDelayedReleaseFrames = 7;
+	struct Statistics {
+		size_t	releasedObjectCount = 0;			// objects released in the last frame
+		size_t	destroyedObjectCount = 0;			// objects destroyed on the main thread in the last frame
+		size_t	backgroundDestroyedObjectCount = 0;	// objects handed to the job system in the last frame
+		double	destroyTimeMs = 0.0;				// main thread time spent in DoGCWork in the last frame
+	};
 public:
 	GarbageCollection();
 	~GarbageCollection() override;
@@ -11,19 +21,29 @@ public:
 	void OnCreate();
 	void OnDestroy();
 	void SetDelayedReleaseFrames(size_t num);
+	void SetEnableBackgroundDestroy(bool enable);
 	void AddObject(RefCounter *pObject);
 	void DoGCWork();
 	void OnPostRender(GameTimer &timer);
+	auto GetStatistics() const -> const Statistics & {
+		return _statistics;
+	}
 private:
-	void Lock();
-	void UnLock();
-	struct Node {
-		uint64_t	releaseFrameIndex;
-		RefCounter *pObject = nullptr;
+	auto DestroyBucket(size_t bucketIndex) -> size_t;
+	static void DestroyObjectList(RefCounter *pHead);
+	static constexpr size_t kBucketCount = kMaxDelayedReleaseFrames + 1;
+	// each bucket is an intrusive lock free stack linked through RefCounter::_pNextGarbage
+	struct alignas(64) Bucket {
+		std::atomic<RefCounter *> pHead = nullptr;
 	};
 private:
-	uint64_t			_frameIndex;
-	size_t				_delayedReleaseFrames;
-	std::list<Node>		_objects;
-	std::atomic_flag	_lock;
+	// clang-format off
+	std::atomic<uint64_t>		_frameIndex;
+	size_t						_delayedReleaseFrames;
+	bool						_enableBackgroundDestroy;
+	Bucket						_buckets[kBucketCount];
+	std::atomic<size_t>			_releasedObjectCount;
+	Statistics					_statistics;
+	std::unique_ptr<JobCounter>	_pBackgroundCounter;
+	// clang-format on
 };
@@ -0,0 +1,105 @@
+#include "HeapAllocationCounter.h"
+#include "Foundation/Exception.h"
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <new>
+
+static std::atomic<uint64_t> sAllocationCount = 0;
+static thread_local uint32_t sPermitDepth = 0;
+
+bool HeapAllocationCounter::IsEnabled() {
+#if ENABLE_HEAP_ALLOCATION_COUNTER
+    return true;
+#else
+    return false;
+#endif
+}
+
+auto HeapAllocationCounter::GetAllocationCount() -> uint64_t {
+    return sAllocationCount.load(std::memory_order_relaxed);
+}
+
+ScopedNoHeapAllocationCheck::ScopedNoHeapAllocationCheck(bool enable)
+    : _enable(enable && HeapAllocationCounter::IsEnabled()),
+      _allocationCount(HeapAllocationCounter::GetAllocationCount()) {
+}
+
+ScopedNoHeapAllocationCheck::~ScopedNoHeapAllocationCheck() noexcept(false) {
+    // do not replace an exception that is already unwinding through the scope
+    if (!_enable || std::uncaught_exceptions() > 0) {
+        return;
+    }
+    uint64_t allocationCount = HeapAllocationCounter::GetAllocationCount() - _allocationCount;
+    Exception::CondThrow(allocationCount == 0, "{} heap allocations in a ScopedNoHeapAllocationCheck", allocationCount);
+}
+
+ScopedHeapAllocationPermit::ScopedHeapAllocationPermit() {
+    ++sPermitDepth;
+}
+
+ScopedHeapAllocationPermit::~ScopedHeapAllocationPermit() {
+    --sPermitDepth;
+}
+
+#if ENABLE_HEAP_ALLOCATION_COUNTER
+
+static auto CountedAlloc(size_t size, size_t alignment) -> void * {
+    if (sPermitDepth == 0) {
+        sAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    size = size != 0 ? size : 1;
+    #if PLATFORM_WIN
+    return _aligned_malloc(size, alignment);
+    #else
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    #endif
+}
+
+static void CountedFree(void *pointer) {
+    #if PLATFORM_WIN
+    _aligned_free(pointer);
+    #else
+    std::free(pointer);
+    #endif
+}
+
+void *operator new(size_t size) {
+    if (void *pointer = CountedAlloc(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    if (void *pointer = CountedAlloc(size, static_cast<size_t>(alignment))) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    return CountedAlloc(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return CountedAlloc(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *pointer) noexcept {
+    CountedFree(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    CountedFree(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept {
+    CountedFree(pointer);
+}
+
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept {
+    CountedFree(pointer);
+}
+
+#endif
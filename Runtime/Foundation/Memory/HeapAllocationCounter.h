@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+
+// Counts the calls to the global operator new when ENABLE_HEAP_ALLOCATION_COUNTER is defined.
+// Used to verify that steady state frames do not touch the general purpose heap.
+class HeapAllocationCounter {
+public:
+    static bool IsEnabled();
+    static auto GetAllocationCount() -> uint64_t;
+};
+
+// Asserts that no heap allocation happens in the scope, does nothing when the counter or the check is disabled.
+// The counter is global, allocations of other threads count too unless they hold a ScopedHeapAllocationPermit.
+class ScopedNoHeapAllocationCheck {
+public:
+    explicit ScopedNoHeapAllocationCheck(bool enable = true);
+    ~ScopedNoHeapAllocationCheck() noexcept(false);
+private:
+    bool        _enable;
+    uint64_t    _allocationCount;
+};
+
+// Allocations of the calling thread are not counted in the scope. For work that is allowed to allocate
+// while a frame is checked, e.g. streaming assets in on the job system.
+class ScopedHeapAllocationPermit {
+public:
+    ScopedHeapAllocationPermit();
+    ~ScopedHeapAllocationPermit();
+};
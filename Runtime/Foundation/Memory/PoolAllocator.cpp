@@ -0,0 +1,145 @@
+#include "PoolAllocator.h"
+#include "Foundation/Exception.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <new>
+
+static auto GetPoolRegistryMutex() -> std::mutex & {
+    static std::mutex sMutex;
+    return sMutex;
+}
+
+static std::atomic<bool> sPoolEnabled = true;
+
+static auto GetPoolRegistry() -> std::vector<PoolAllocator *> & {
+    static std::vector<PoolAllocator *> sPools;
+    return sPools;
+}
+
+PoolAllocator::PoolAllocator(std::string_view name, size_t objectSize, size_t objectAlignment)
+    : _name(name),
+      _objectSize(objectSize),
+      _objectAlignment(objectAlignment),
+      _pFreeList(nullptr),
+      _liveCount(0),
+      _peakCount(0),
+      _allocateCount(0) {
+
+    Assert(objectAlignment <= kCacheLineSize);
+    size_t chunkSize = std::max(objectSize, sizeof(FreeChunk));
+    chunkSize = (chunkSize + kSizeClassGranularity - 1) / kSizeClassGranularity * kSizeClassGranularity;
+    // objects up to a cache line must not straddle two lines, larger ones start on a line boundary
+    if (chunkSize > kCacheLineSize / 2) {
+        chunkSize = (chunkSize + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize;
+    } else {
+        chunkSize = std::bit_ceil(chunkSize);
+    }
+    _chunkSize = chunkSize;
+    _chunkCountPerSlab = std::max<size_t>(kSlabSize / _chunkSize, 1);
+
+    std::unique_lock lock(GetPoolRegistryMutex());
+    GetPoolRegistry().push_back(this);
+}
+
+PoolAllocator::~PoolAllocator() {
+    {
+        std::unique_lock lock(GetPoolRegistryMutex());
+        std::erase(GetPoolRegistry(), this);
+    }
+    for (void *pSlab : _slabs) {
+        ::operator delete(pSlab, std::align_val_t(kCacheLineSize));
+    }
+}
+
+auto PoolAllocator::Allocate() -> void * {
+    std::unique_lock lock(_mutex);
+    if (!sPoolEnabled.load(std::memory_order_relaxed)) {
+        // still counted as live so SetEnabled can tell when switching back is safe
+        ++_liveCount;
+        ++_allocateCount;
+        _peakCount = std::max(_peakCount, _liveCount);
+        lock.unlock();
+        return ::operator new(_objectSize, std::align_val_t(_objectAlignment));
+    }
+    if (_pFreeList == nullptr) {
+        AllocateSlab();
+    }
+    FreeChunk *pChunk = _pFreeList;
+    _pFreeList = pChunk->pNext;
+    ++_liveCount;
+    ++_allocateCount;
+    _peakCount = std::max(_peakCount, _liveCount);
+    return pChunk;
+}
+
+void PoolAllocator::Free(void *pointer) {
+    if (pointer == nullptr) {
+        return;
+    }
+    std::unique_lock lock(_mutex);
+    Assert(_liveCount > 0);
+    if (!sPoolEnabled.load(std::memory_order_relaxed)) {
+        --_liveCount;
+        lock.unlock();
+        ::operator delete(pointer, std::align_val_t(_objectAlignment));
+        return;
+    }
+    FreeChunk *pChunk = static_cast<FreeChunk *>(pointer);
+    pChunk->pNext = _pFreeList;
+    _pFreeList = pChunk;
+    --_liveCount;
+}
+
+auto PoolAllocator::GetStatistics() const -> Statistics {
+    std::unique_lock lock(_mutex);
+    Statistics statistics;
+    statistics.name = _name;
+    statistics.chunkSize = _chunkSize;
+    statistics.liveCount = _liveCount;
+    statistics.peakCount = _peakCount;
+    statistics.allocateCount = _allocateCount;
+    statistics.slabCount = _slabs.size();
+    return statistics;
+}
+
+auto PoolAllocator::GetAllPoolStatistics() -> std::vector<Statistics> {
+    std::unique_lock lock(GetPoolRegistryMutex());
+    std::vector<Statistics> result;
+    result.reserve(GetPoolRegistry().size());
+    for (const PoolAllocator *pPool : GetPoolRegistry()) {
+        result.push_back(pPool->GetStatistics());
+    }
+    return result;
+}
+
+void PoolAllocator::SetEnabled(bool enable) {
+    std::unique_lock lock(GetPoolRegistryMutex());
+    for (const PoolAllocator *pPool : GetPoolRegistry()) {
+        Statistics statistics = pPool->GetStatistics();
+        Exception::CondThrow(statistics.liveCount == 0,
+            "PoolAllocator::SetEnabled: pool {} still has {} live objects",
+            statistics.name,
+            statistics.liveCount);
+    }
+    sPoolEnabled.store(enable, std::memory_order_relaxed);
+}
+
+bool PoolAllocator::IsEnabled() {
+    return sPoolEnabled.load(std::memory_order_relaxed);
+}
+
+void PoolAllocator::AllocateSlab() {
+    size_t slabSize = _chunkSize * _chunkCountPerSlab;
+    auto *pSlab = static_cast<uint8_t *>(::operator new(slabSize, std::align_val_t(kCacheLineSize)));
+    _slabs.push_back(pSlab);
+
+    // link the chunks in address order so consecutive allocations are adjacent in memory
+    FreeChunk *pHead = _pFreeList;
+    for (size_t i = _chunkCountPerSlab; i > 0; --i) {
+        auto *pChunk = reinterpret_cast<FreeChunk *>(pSlab + (i - 1) * _chunkSize);
+        pChunk->pNext = pHead;
+        pHead = pChunk;
+    }
+    _pFreeList = pHead;
+}
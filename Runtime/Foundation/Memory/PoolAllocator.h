@@ -0,0 +1,81 @@
+#pragma once
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include "Foundation/NonCopyable.h"
+#include "Foundation/PreprocessorDirectives.h"
+
+// Fixed size slab allocator. Every type that opts in with DECLARE_POOL_OBJECT owns one pool,
+// so objects of the same type that are ticked together are packed into the same slabs.
+class PoolAllocator : private NonCopyable {
+public:
+    static constexpr size_t kCacheLineSize = 64;
+    static constexpr size_t kSizeClassGranularity = 16;
+    static constexpr size_t kSlabSize = 64 * 1024;
+    struct Statistics {
+        std::string_view name;
+        size_t chunkSize = 0;
+        size_t liveCount = 0;
+        size_t peakCount = 0;
+        size_t allocateCount = 0;
+        size_t slabCount = 0;
+    };
+public:
+    PoolAllocator(std::string_view name, size_t objectSize, size_t objectAlignment);
+    ~PoolAllocator();
+    auto Allocate() -> void *;
+    void Free(void *pointer);
+    auto GetObjectSize() const -> size_t {
+        return _objectSize;
+    }
+    auto GetStatistics() const -> Statistics;
+    static auto GetAllPoolStatistics() -> std::vector<Statistics>;
+    // disabled pools forward to the global heap, used to measure what the pools buy.
+    // Switching requires that no pool has live objects, a chunk must be freed the way it was allocated
+    static void SetEnabled(bool enable);
+    static bool IsEnabled();
+private:
+    void AllocateSlab();
+    struct FreeChunk {
+        FreeChunk *pNext;
+    };
+private:
+    // clang-format off
+    std::string_view        _name;
+    size_t                  _objectSize;
+    size_t                  _objectAlignment;
+    size_t                  _chunkSize;
+    size_t                  _chunkCountPerSlab;
+    FreeChunk              *_pFreeList;
+    std::vector<void *>     _slabs;
+    size_t                  _liveCount;
+    size_t                  _peakCount;
+    size_t                  _allocateCount;
+    mutable std::mutex      _mutex;
+    // clang-format on
+};
+
+template<typename T>
+auto GetTypePoolAllocator(std::string_view name) -> PoolAllocator & {
+    static PoolAllocator sPool(name, sizeof(T), alignof(T));
+    return sPool;
+}
+
+// Route new/delete of Type to a dedicated pool. MakeShared and the GarbageCollection pick it up
+// through the class level operators. Derived classes that do not declare their own pool fall back
+// to the global heap because their size does not match.
+#define DECLARE_POOL_OBJECT(Type)                                                                                      \
+public:                                                                                                                \
+    static void *operator new(size_t size) {                                                                           \
+        if (size != sizeof(Type)) {                                                                                    \
+            return ::operator new(size);                                                                               \
+        }                                                                                                              \
+        return GetTypePoolAllocator<Type>(#Type).Allocate();                                                           \
+    }                                                                                                                  \
+    static void operator delete(void *pointer, size_t size) {                                                          \
+        if (size != sizeof(Type)) {                                                                                    \
+            ::operator delete(pointer);                                                                                \
+            return;                                                                                                    \
+        }                                                                                                              \
+        GetTypePoolAllocator<Type>(#Type).Free(pointer);                                                               \
+    }
@@ -14,6 +14,12 @@ public:
 	auto GetRefCount() const noexcept -> int32_t {
 		return _refCount.load();
 	}
+	// return true if the destructor does not touch main thread state and can run on a worker thread
+	virtual bool AllowBackgroundDestroy() const {
+		return false;
+	}
 private:
+	friend class GarbageCollection;
 	std::atomic<int32_t> _refCount;
+	RefCounter *_pNextGarbage = nullptr;
 };
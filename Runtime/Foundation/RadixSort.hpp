@@ -0,0 +1,141 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "Foundation/Exception.h"
+#include "Foundation/JobSystem.h"
+#include "Foundation/Memory/FrameArena.h"
+
+// LSD radix sort of 64 bit keys, 8 bits per pass.
+// The sort is stable, items with equal keys keep their input order.
+// A pass in which all keys share the same digit is skipped, so keys that leave bits unused need fewer passes.
+class RadixSort {
+public:
+    static constexpr size_t kRadixBits = 8;
+    static constexpr size_t kRadixSize = 1 << kRadixBits;
+    static constexpr size_t kPassCount = 64 / kRadixBits;
+    // smaller inputs are sorted on the calling thread by ParallelSort
+    static constexpr size_t kParallelThreshold = 64 * 1024;
+    static constexpr size_t kMaxChunkCount = 64;
+public:
+    // scratch must have the same size as items, the sorted result ends up in items
+    template<typename T, typename KeyFunc>
+    static void Sort(std::span<T> items, std::span<T> scratch, const KeyFunc &getKey);
+    // splits every pass into chunks on the JobSystem
+    template<typename T, typename KeyFunc>
+    static void ParallelSort(std::span<T> items, std::span<T> scratch, const KeyFunc &getKey);
+private:
+    using Histogram = std::array<uint32_t, kRadixSize>;
+    static auto GetDigit(uint64_t key, size_t pass) -> size_t {
+        return static_cast<size_t>(key >> (pass * kRadixBits)) & (kRadixSize - 1);
+    }
+};
+
+template<typename T, typename KeyFunc>
+void RadixSort::Sort(std::span<T> items, std::span<T> scratch, const KeyFunc &getKey) {
+    Assert(items.size() == scratch.size());
+    size_t count = items.size();
+    if (count <= 1) {
+        return;
+    }
+
+    // the histograms of all passes are built in a single read
+    std::array<Histogram, kPassCount> histograms = {};
+    for (const T &item : items) {
+        uint64_t key = getKey(item);
+        for (size_t pass = 0; pass < kPassCount; ++pass) {
+            ++histograms[pass][GetDigit(key, pass)];
+        }
+    }
+
+    T *pSrc = items.data();
+    T *pDst = scratch.data();
+    for (size_t pass = 0; pass < kPassCount; ++pass) {
+        Histogram &histogram = histograms[pass];
+        if (histogram[GetDigit(getKey(pSrc[0]), pass)] == count) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t &bucket : histogram) {
+            uint32_t bucketSize = bucket;
+            bucket = offset;
+            offset += bucketSize;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            pDst[histogram[GetDigit(getKey(pSrc[i]), pass)]++] = std::move(pSrc[i]);
+        }
+        std::swap(pSrc, pDst);
+    }
+
+    if (pSrc != items.data()) {
+        std::move(pSrc, pSrc + count, items.data());
+    }
+}
+
+template<typename T, typename KeyFunc>
+void RadixSort::ParallelSort(std::span<T> items, std::span<T> scratch, const KeyFunc &getKey) {
+    Assert(items.size() == scratch.size());
+    JobSystem *pJobSystem = JobSystem::GetInstance();
+    size_t count = items.size();
+    if (count < kParallelThreshold || pJobSystem == nullptr || pJobSystem->GetWorkerCount() == 0) {
+        Sort(items, scratch, getKey);
+        return;
+    }
+
+    // the chunk boundaries stay fixed over all passes, the per chunk offsets keep the scatter stable
+    size_t chunkCount = std::min(pJobSystem->GetWorkerCount() + 1, kMaxChunkCount);
+    size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+    FrameVector<Histogram> chunkHistograms(chunkCount);
+
+    T *pSrc = items.data();
+    T *pDst = scratch.data();
+    for (size_t pass = 0; pass < kPassCount; ++pass) {
+        pJobSystem->ParallelFor(0, chunkCount, 1, [&](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk < end; ++chunk) {
+                Histogram &histogram = chunkHistograms[chunk];
+                histogram.fill(0);
+                size_t last = std::min((chunk + 1) * chunkSize, count);
+                for (size_t i = chunk * chunkSize; i < last; ++i) {
+                    ++histogram[GetDigit(getKey(pSrc[i]), pass)];
+                }
+            }
+        });
+
+        Histogram total = {};
+        for (const Histogram &histogram : chunkHistograms) {
+            for (size_t digit = 0; digit < kRadixSize; ++digit) {
+                total[digit] += histogram[digit];
+            }
+        }
+        if (total[GetDigit(getKey(pSrc[0]), pass)] == count) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (size_t digit = 0; digit < kRadixSize; ++digit) {
+            for (Histogram &histogram : chunkHistograms) {
+                uint32_t bucketSize = histogram[digit];
+                histogram[digit] = offset;
+                offset += bucketSize;
+            }
+        }
+
+        pJobSystem->ParallelFor(0, chunkCount, 1, [&](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk < end; ++chunk) {
+                Histogram &offsets = chunkHistograms[chunk];
+                size_t last = std::min((chunk + 1) * chunkSize, count);
+                for (size_t i = chunk * chunkSize; i < last; ++i) {
+                    pDst[offsets[GetDigit(getKey(pSrc[i]), pass)]++] = std::move(pSrc[i]);
+                }
+            }
+        });
+        std::swap(pSrc, pDst);
+    }
+
+    if (pSrc != items.data()) {
+        std::move(pSrc, pSrc + count, items.data());
+    }
+}
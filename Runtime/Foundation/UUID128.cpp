@@ -54,7 +54,8 @@ UUID128::UUID128(const uuids::uuid &id) : uuid(id) {
 }
 
 auto UUID128::GetNameGenerator() -> uuids::uuid_name_generator & {
-    static uuids::uuid_name_generator generator(from_string(sClassUUID).value());
+    // the generator hashes with a shared SHA-1 state, every thread gets its own
+    static thread_local uuids::uuid_name_generator generator(from_string(sClassUUID).value());
     return generator;
 }
 
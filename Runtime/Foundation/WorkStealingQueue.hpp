@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include "Foundation/Exception.h"
+#include "Foundation/NonCopyable.h"
+
+// Chase-Lev work stealing deque with a fixed capacity.
+// The owner thread calls Push/Pop on the bottom end, any other thread may Steal from the top end.
+// See: "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al. 2013)
+template<typename T>
+    requires(std::is_pointer_v<T>)
+class WorkStealingQueue : private NonCopyable {
+public:
+    explicit WorkStealingQueue(size_t capacity = 4096) : _top(0), _bottom(0) {
+        Assert(std::has_single_bit(capacity));
+        _mask = static_cast<int64_t>(capacity - 1);
+        _pBuffer = std::make_unique<std::atomic<T>[]>(capacity);
+    }
+    // only the owner thread can call Push
+    bool Push(T item) {
+        int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        int64_t top = _top.load(std::memory_order_acquire);
+        if (bottom - top > _mask) {
+            return false;
+        }
+        _pBuffer[bottom & _mask].store(item, std::memory_order_relaxed);
+        _bottom.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+    // only the owner thread can call Pop
+    bool Pop(T &item) {
+        int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = _top.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = _pBuffer[bottom & _mask].load(std::memory_order_relaxed);
+        if (top != bottom) {
+            return true;
+        }
+
+        // last element, race against the thieves
+        bool success = _top.compare_exchange_strong(top,
+            top + 1,
+            std::memory_order_seq_cst,
+            std::memory_order_relaxed);
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return success;
+    }
+    bool Steal(T &item) {
+        int64_t top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = _bottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return false;
+        }
+
+        item = _pBuffer[top & _mask].load(std::memory_order_relaxed);
+        return _top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+    bool Empty() const {
+        int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        int64_t top = _top.load(std::memory_order_relaxed);
+        return bottom <= top;
+    }
+private:
+    // clang-format off
+    alignas(64) std::atomic<int64_t>    _top;
+    alignas(64) std::atomic<int64_t>    _bottom;
+    int64_t                             _mask;
+    std::unique_ptr<std::atomic<T>[]>   _pBuffer;
+    // clang-format on
+};
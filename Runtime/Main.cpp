@@ -3,6 +3,7 @@
 #include <Windows.h>
 #include "Applcation/Application.h"
 #include "Foundation/GameTimer.h"
+#include "Foundation/Memory/HeapAllocationCounter.h"
 #include "Foundation/StringUtil.h"
 
 int main() {
@@ -12,12 +13,18 @@ int main() {
         Application::OnInstanceCreate();
         Application *pApp = Application::GetInstance();
         pApp->OnCreate();
+
+        // the first frames fill the pools, frame arenas and queues, after that a frame must not touch the heap.
+        // only checked when the heap_allocation_check option is enabled
+        constexpr size_t kWarmupFrameCount = 16;
+        size_t frameCount = 0;
         while (pApp->IsRunning()) {
             pApp->PollEvent(timer);
             timer.StartNewFrame();
             if (pApp->IsPaused()) {
 	            std::this_thread::sleep_for(std::chrono::milliseconds(100));
             } else {
+                ScopedNoHeapAllocationCheck noHeapAllocationCheck(++frameCount > kWarmupFrameCount);
 	            pApp->OnPreUpdate(timer);
 	            pApp->OnUpdate(timer);
 	            pApp->OnPostUpdate(timer);
@@ -1,7 +1,16 @@
 #include "GameObject.h"
 #include "Components/Transform.h"
+#include "SceneObject/Scene.h"
+#include "SceneObject/SceneManager.h"
+#include "SceneObject/TickRegistry.h"
 
-GameObject::GameObject() : _active(true), _sceneID(SceneID::Invalid) {
+GameObject::GameObject()
+    : _active(true),
+      _activeInHierarchy(true),
+      _static(false),
+      _sceneID(SceneID::Invalid),
+      _sceneSlot(kInvalidSceneSlot),
+      _componentMask(0) {
 }
 
 GameObject::~GameObject() {
@@ -12,17 +21,24 @@ GameObject::~GameObject() {
     _children.clear();
     for (auto iter = _components.rbegin(); iter != _components.rend(); ++iter) {
         auto &pComponent = *iter;
+        UnregisterTickComponent(pComponent.Get());
         pComponent->OnRemoveFormGameObject();
     }
     _components.clear();
-
+    _componentLookup.clear();
+    _componentMask = 0;
 }
 
 void GameObject::OnAddToScene(SceneID sceneID) {
     _sceneID = sceneID;
+    Scene *pScene = GetScene();
     for (SharedPtr<Component> &pComponent : _components) {
+        pScene->RegisterComponent(pComponent.Get());
         pComponent->OnAddToScene();
     }
+    if (_activeInHierarchy) {
+        RegisterTickComponents();
+    }
 
     Transform *pTransform = GetComponent<Transform>();
     if (pTransform == nullptr) {
@@ -41,8 +57,11 @@ void GameObject::OnRemoveFormScene() {
     for (Transform *pChild : pTransform->GetChildren()) {
         pChild->GetGameObject()->OnRemoveFormScene();
     }
+    UnregisterTickComponents();
+    Scene *pScene = GetScene();
     for (SharedPtr<Component> &pComponent : _components) {
         pComponent->OnRemoveFormScene();
+        pScene->UnregisterComponent(pComponent.Get());
     }
     _sceneID = SceneID::Invalid;
     _children.clear();
@@ -63,6 +82,7 @@ void GameObject::AddChild(SharedPtr<GameObject> pChild) {
     if (pParent == nullptr || pParent->GetGameObject() != this) {
         _children.push_back(pChild);
         GetTransform()->AddChild(pChild->GetTransform());
+        pChild->UpdateActiveInHierarchy();
     }
 }
 
@@ -74,6 +94,7 @@ void GameObject::RemoveChild(GameObject *pChild) {
 	            (*iter)->OnRemoveFormScene();
             }
             (*iter)->GetTransform()->SetParent(nullptr);
+            (*iter)->UpdateActiveInHierarchy();
             _children.erase(iter);
             return;
         }
@@ -87,7 +108,7 @@ auto GameObject::GetChildren() const -> const ChildrenContainer & {
 
 auto GameObject::GetTransform() -> Transform * {
     Assert(_components.size() >= 1);
-    Assert(_components.front()->GetClassTypeID() == GetTypeID<Transform>());
+    Assert(_components.front()->GetClassIndex() == ::GetClassIndex<Transform>());
     return static_cast<Transform *>(_components.front().Get());
 }
 
@@ -98,54 +119,97 @@ auto GameObject::GetTransform() const -> const Transform * {
 void GameObject::InitComponent(Component *pComponent) {
     pComponent->InitInstanceId();
     pComponent->SetGameObject(this);
+    AddComponentLookup(pComponent);
     pComponent->OnAddToGameObject();
     if (_sceneID.IsValid()) {
+        Scene *pScene = GetScene();
+        pScene->RegisterComponent(pComponent);
         pComponent->OnAddToScene();
+        if (_activeInHierarchy) {
+            pScene->GetTickRegistry()->Register(pComponent);
+            pComponent->OnEnable();
+        }
     }
 }
 
-bool GameObject::GetParentActive() const {
-    const Transform *pTransform = GetTransform();
-    const Transform *pParent = pTransform->GetParent();
-    if (pParent == nullptr) {
-        return true;
+void GameObject::DetachComponent(Component *pComponent) {
+    UnregisterTickComponent(pComponent);
+    if (_sceneID.IsValid()) {
+        pComponent->OnRemoveFormScene();
+        GetScene()->UnregisterComponent(pComponent);
     }
-    return pParent->GetGameObject()->GetActive();
+    pComponent->OnRemoveFormGameObject();
+    RemoveComponentLookup(pComponent);
 }
 
-void GameObject::InvokeTickFunc(Component::TickType tickType, void(GameObject::*pTickFunc)(), void(Component::*pComponentTickFunc)()) {
-    for (SharedPtr<Component> &pComponent : _components) {
-        if (HasFlag(pComponent->GetTickType(), tickType)) {
-            (pComponent.Get()->*pComponentTickFunc)();
-        }
-    }
-    for (SharedPtr<GameObject> &pChild : _children) {
-        if (pChild->_active) {
-            (pChild.Get()->*pTickFunc)();
-        }
-    }
+auto GameObject::GetScene() const -> Scene * {
+    return SceneManager::GetInstance()->GetScene(_sceneID);
 }
 
-void GameObject::InnerOnPreUpdate() {
-    InvokeTickFunc(Component::ePreUpdate, &GameObject::InnerOnPreUpdate, &Component::InnerOnPreUpdate);
+void GameObject::AddComponentLookup(Component *pComponent) {
+    uint32_t classIndex = pComponent->GetClassIndex();
+    Exception::CondThrow(classIndex < kMaxComponentClassCount,
+        "The number of component classes exceeds kMaxComponentClassCount");
+    uint64_t bit = uint64_t(1) << classIndex;
+    Assert((_componentMask & bit) == 0);
+    auto slot = static_cast<ptrdiff_t>(std::popcount(_componentMask & (bit - 1)));
+    _componentLookup.insert(_componentLookup.begin() + slot, pComponent);
+    _componentMask |= bit;
 }
 
-void GameObject::InnerOnUpdate() {
-    InvokeTickFunc(Component::eUpdate, &GameObject::InnerOnUpdate, &Component::InnerOnUpdate);
+void GameObject::RemoveComponentLookup(Component *pComponent) {
+    uint64_t bit = uint64_t(1) << pComponent->GetClassIndex();
+    auto slot = static_cast<ptrdiff_t>(std::popcount(_componentMask & (bit - 1)));
+    Assert(_componentLookup[slot] == pComponent);
+    _componentLookup.erase(_componentLookup.begin() + slot);
+    _componentMask &= ~bit;
 }
 
-void GameObject::InnerOnPostUpdate() {
-    InvokeTickFunc(Component::ePostUpdate, &GameObject::InnerOnPostUpdate, &Component::InnerOnPostUpdate);
+void GameObject::SetActive(bool active) {
+    if (_active != active) {
+        _active = active;
+        UpdateActiveInHierarchy();
+    }
 }
 
-void GameObject::InnerOnPreRender() {
-    InvokeTickFunc(Component::ePreRender, &GameObject::InnerOnPreRender, &Component::InnerOnPreRender);
+void GameObject::UpdateActiveInHierarchy() {
+    const Transform *pParent = GetTransform()->GetParent();
+    bool activeInHierarchy = _active && (pParent == nullptr || pParent->GetGameObject()->_activeInHierarchy);
+    // the subtree below an unchanged node keeps its state, stop here
+    if (activeInHierarchy == _activeInHierarchy) {
+        return;
+    }
+
+    _activeInHierarchy = activeInHierarchy;
+    if (_sceneID.IsValid()) {
+        if (_activeInHierarchy) {
+            RegisterTickComponents();
+        } else {
+            UnregisterTickComponents();
+        }
+    }
+    for (Transform *pChild : GetTransform()->GetChildren()) {
+        pChild->GetGameObject()->UpdateActiveInHierarchy();
+    }
+}
+
+void GameObject::RegisterTickComponents() {
+    TickRegistry *pTickRegistry = GetScene()->GetTickRegistry();
+    for (SharedPtr<Component> &pComponent : _components) {
+        pTickRegistry->Register(pComponent.Get());
+        pComponent->OnEnable();
+    }
 }
 
-void GameObject::InnerOnRender() {
-    InvokeTickFunc(Component::eRender, &GameObject::InnerOnRender, &Component::InnerOnRender);
+void GameObject::UnregisterTickComponents() {
+    for (SharedPtr<Component> &pComponent : _components) {
+        UnregisterTickComponent(pComponent.Get());
+    }
 }
 
-void GameObject::InnerOnPostRender() {
-    InvokeTickFunc(Component::ePostRender, &GameObject::InnerOnPostRender, &Component::InnerOnPostRender);
+void GameObject::UnregisterTickComponent(Component *pComponent) {
+    if (pComponent->_pTickRegistry != nullptr) {
+        pComponent->OnDisable();
+        pComponent->_pTickRegistry->Unregister(pComponent);
+    }
 }
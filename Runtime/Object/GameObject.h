@@ -1,18 +1,23 @@
 #pragma once
+#include <bit>
 #include "Object.h"
 #include "Components/Component.h"
 #include "Foundation/DebugBreak.h"
 #include "SceneObject/SceneID.hpp"
 #include "Foundation/Exception.h"
 #include "Foundation/Memory/SharedPtr.hpp"
+#include "Foundation/Memory/PoolAllocator.h"
 
 class Component;
 class Transform;
+class Scene;
 class GameObject : public Object {
     DECLARE_CLASS(GameObject);
+    DECLARE_POOL_OBJECT(GameObject);
 private:
     using ComponentContainer = std::vector<SharedPtr<Component>>;
     using ChildrenContainer = std::vector<SharedPtr<GameObject>>;
+    using ComponentLookup = std::vector<Component *>;
     friend class Scene;
     GameObject();
 public:
@@ -20,28 +25,21 @@ public:
     void OnAddToScene(SceneID sceneID);
     void OnRemoveFormScene();
 public:
+    // the component class index is used as bit index of the component mask
+    static constexpr uint32_t kMaxComponentClassCount = 64;
+    static constexpr uint32_t kInvalidSceneSlot = static_cast<uint32_t>(-1);
     static auto Create() -> SharedPtr<GameObject>;
 
     template<typename T>
         requires(std::is_base_of_v<Component, T>)
     auto GetComponent() -> T * {
-        for (SharedPtr<Component> &pComponent : _components) {
-            if (::GetTypeID<T>() == pComponent->GetClassTypeID()) {
-                return static_cast<T *>(pComponent.Get());
-            }
-        }
-        return nullptr;
+        return static_cast<T *>(FindComponent(::GetClassIndex<T>()));
     }
 
     template<typename T>
         requires(std::is_base_of_v<Component, T>)
     auto GetComponent() const -> const T * {
-        for (const SharedPtr<Component> &pComponent : _components) {
-            if (::GetTypeID<T>() == pComponent->GetClassTypeID()) {
-                return static_cast<const T *>(pComponent.Get());
-            }
-        }
-        return nullptr;
+        return static_cast<const T *>(FindComponent(::GetClassIndex<T>()));
     }
 
     template<typename T>
@@ -75,38 +73,42 @@ public:
     template<typename T>
         requires(std::is_base_of_v<Component, T> && !std::is_same_v<T, Transform>)
     bool RemoveComponent() {
-        for (auto it = _components.begin(); it != _components.end(); ++it) {
-            if ((*it)->GetClassTypeID() == GetTypeID<T>()) {
-                auto &pComponent = *it;
-                if (_sceneID.IsValid()) {
-	                pComponent->OnRemoveFormScene();
-                }
-                pComponent->OnRemoveFormGameObject();
-                _components.erase(it);
-                return true;
-            }
+        Component *pComponent = FindComponent(::GetClassIndex<T>());
+        if (pComponent == nullptr) {
+            return false;
         }
-        return false;
+        DetachComponent(pComponent);
+        std::erase_if(_components, [=](const SharedPtr<Component> &pItem) { return pItem.Get() == pComponent; });
+        return true;
     }
 
-    bool HasComponent(TypeID typeId) const {
-        Assert(typeId != GetTypeID<Transform>());
-        for (auto it = _components.begin(); it != _components.end(); ++it) {
-            if ((*it)->GetClassTypeID() == typeId) {
-                return true;
-            }
-        }
-		return false;
+    template<typename T>
+        requires(std::is_base_of_v<Component, T>)
+    bool HasComponent() const {
+        return HasComponent(::GetClassIndex<T>());
+    }
+    bool HasComponent(uint32_t classIndex) const {
+        return classIndex < kMaxComponentClassCount && (_componentMask & (uint64_t(1) << classIndex)) != 0;
+    }
+    auto GetComponentMask() const -> uint64_t {
+        return _componentMask;
     }
     auto GetSceneID() const -> SceneID {
 	    return _sceneID;
     }
 
-    void SetActive(bool active) {
-	    _active = active;
-    }
+    void SetActive(bool active);
+    // cached, updated incrementally when the active state of this object or of an ancestor changes
 	bool GetActive() const {
-	    return _active && GetParentActive();
+	    return _activeInHierarchy;
+    }
+
+    // a static object does not move after it is built, the StaticBatcher only merges the mesh renderers of those
+    void SetStatic(bool isStatic) {
+        _static = isStatic;
+    }
+    bool GetStatic() const {
+        return _static;
     }
 
     void AddChild(SharedPtr<GameObject> pChild);
@@ -119,20 +121,32 @@ private:
 	    _sceneID = sceneID;
     }
     void InitComponent(Component *pComponent);
-    bool GetParentActive() const;
-private:
-    void InvokeTickFunc(Component::TickType tickType, void (GameObject::*pTickFunc)(), void (Component::*pComponentTickFunc)());
-	void InnerOnPreUpdate();
-    void InnerOnUpdate();
-    void InnerOnPostUpdate();
-    void InnerOnPreRender();
-    void InnerOnRender();
-    void InnerOnPostRender();
+    void DetachComponent(Component *pComponent);
+    auto GetScene() const -> Scene *;
+    // _componentLookup is sorted by class index, the slot of a class is the number of lower bits set in the mask
+    auto FindComponent(uint32_t classIndex) const -> Component * {
+        if (!HasComponent(classIndex)) {
+            return nullptr;
+        }
+        uint64_t lowerBits = _componentMask & ((uint64_t(1) << classIndex) - 1);
+        return _componentLookup[std::popcount(lowerBits)];
+    }
+    void AddComponentLookup(Component *pComponent);
+    void RemoveComponentLookup(Component *pComponent);
+    void UpdateActiveInHierarchy();
+    void RegisterTickComponents();
+    void UnregisterTickComponents();
+    void UnregisterTickComponent(Component *pComponent);
 private:
     // clang-format off
     bool               _active;
+    bool               _activeInHierarchy;
+    bool               _static;
     SceneID            _sceneID;
+    uint32_t           _sceneSlot;
     ComponentContainer _components;
+    uint64_t           _componentMask;
+    ComponentLookup    _componentLookup;
     ChildrenContainer  _children; 
     // clang-format on
 };
@@ -1,19 +1,26 @@
 #pragma once
 #include "Foundation/NonCopyable.h"
+#include <atomic>
 #include <string_view>
 #include <typeindex>
 #include "Foundation/TypeSafeWrapper.hpp"
 
 using TypeID = TypeSafeWrapper<std::uint64_t>;
 
+// class indices of different domains are never stored in the same table, each domain counts from zero so that
+// querying other classes does not push the component indices past the component mask
+enum class ClassIndexDomain { eObject, eComponent, eCount };
+
 class ITypeBase : private NonCopyable {
 public:
     using SuperType = void;
     using ThisType = ITypeBase;
+    static constexpr ClassIndexDomain kClassIndexDomain = ClassIndexDomain::eObject;
     virtual ~ITypeBase() = default;
     virtual auto GetClassTypeID() const -> TypeID;
     virtual auto GetClassTypeName() const -> std::string_view;
     virtual auto GetClassTypeIndex() const -> std::type_index;
+    virtual auto GetClassIndex() const -> uint32_t;
 };
 
 namespace TypeIDDetail {
@@ -31,6 +38,12 @@ constexpr std::uint64_t fnv1a_hash(std::string_view sv) {
     return fnv1a_hash(sv.length(), sv.data());
 }
 
+// class indices are handed out on first use, so only the classes that are actually queried take a slot
+inline auto AllocateClassIndex(ClassIndexDomain domain) -> uint32_t {
+    static std::atomic<uint32_t> sClassCounts[static_cast<size_t>(ClassIndexDomain::eCount)] = {};
+    return sClassCounts[static_cast<size_t>(domain)].fetch_add(1, std::memory_order_relaxed);
+}
+
 }    // namespace TypeIDDetail
 
 template<typename T>
@@ -90,6 +103,18 @@ inline auto ITypeBase::GetClassTypeIndex() const -> std::type_index {
     return std::type_index(typeid(ITypeBase));
 }
 
+inline auto ITypeBase::GetClassIndex() const -> uint32_t {
+    static const uint32_t sClassIndex = TypeIDDetail::AllocateClassIndex(kClassIndexDomain);
+    return sClassIndex;
+}
+
+// dense sequential index of a class declared with DECLARE_CLASS within its ClassIndexDomain,
+// suitable for bitmasks and lookup tables
+template<typename T>
+auto GetClassIndex() -> uint32_t {
+    return T::GetStaticClassIndex();
+}
+
 #define DECLARE_CLASS(Type)                                                                                            \
 public:                                                                                                                \
     using SuperType = ThisType;                                                                                        \
@@ -102,4 +127,11 @@ public:
     }                                                                                                                  \
     auto GetClassTypeIndex() const->std::type_index override {                                                         \
         return std::type_index(typeid(Type));                                                                          \
+    }                                                                                                                  \
+    static auto GetStaticClassIndex()->uint32_t {                                                                      \
+        static const uint32_t sClassIndex = TypeIDDetail::AllocateClassIndex(kClassIndexDomain);                       \
+        return sClassIndex;                                                                                            \
+    }                                                                                                                  \
+    auto GetClassIndex() const->uint32_t override {                                                                    \
+        return GetStaticClassIndex();                                                                                  \
     }
@@ -3,13 +3,28 @@
 #include "Foundation/TypeSafeWrapper.hpp"
 #include "Serialize/Transfer.hpp"
 
+// the low 32 bits are the slot in the ObjectHandleTable, the high 32 bits the generation of the slot
 struct InstanceID : public TypeSafeWrapper<int64_t> {
+	static auto Make(uint32_t index, uint32_t generation) -> InstanceID {
+		InstanceID instanceId;
+		instanceId.Set(static_cast<int64_t>((static_cast<uint64_t>(generation) << 32) | index));
+		return instanceId;
+	}
 	void Set(int64_t id) {
 		_data = id;
 	}
 	auto Get() const -> int64_t {
 		return _data;
 	}
+	auto GetIndex() const -> uint32_t {
+		return static_cast<uint32_t>(static_cast<uint64_t>(_data) & 0xffffffff);
+	}
+	auto GetGeneration() const -> uint32_t {
+		return static_cast<uint32_t>(static_cast<uint64_t>(_data) >> 32);
+	}
+	bool IsValid() const {
+		return GetGeneration() != 0;
+	}
 	template<typename>
 	friend struct TransferHelper;
 };
@@ -1,15 +1,23 @@
 #include "Object.h"
+#include "ObjectHandleTable.h"
 
 IMPLEMENT_VIRTUAL_SERIALIZER(Object)
 
-static std::atomic_int64_t sGlobalInstanceID = 0;
-
 Object::Object() {
 
 }
 
+Object::~Object() {
+	if (_instanceId.IsValid()) {
+		ObjectHandleTable::Free(_instanceId, this);
+	}
+}
+
 void Object::InitInstanceId() {
-	_instanceId.Set(sGlobalInstanceID++);
+	// a component moved to another game object keeps its identity
+	if (!_instanceId.IsValid()) {
+		_instanceId = ObjectHandleTable::Allocate(this);
+	}
 };
 
 template<TransferContextConcept Archive>
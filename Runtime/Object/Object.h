@@ -9,6 +9,7 @@ public:
 	DECLARE_VIRTUAL_SERIALIZER(Object);
 public:
 	Object();
+	~Object() override;
 	void InitInstanceId();
 	void SetName(std::string name) {
 		_name = std::move(name);
@@ -0,0 +1,107 @@
+#include "ObjectHandleTable.h"
+#include "Foundation/Exception.h"
+#include <atomic>
+#include <mutex>
+
+namespace {
+
+struct Slot {
+    // clang-format off
+    std::atomic<Object *>   pObject    = nullptr;
+    std::atomic<uint32_t>   generation = 1;
+    uint32_t                nextFree   = 0;
+    // clang-format on
+};
+
+constexpr uint32_t kInvalidSlot = static_cast<uint32_t>(-1);
+
+struct TableState {
+    // pages never move once allocated, so Resolve can read them without the lock
+    // clang-format off
+    std::atomic<Slot *>     pages[ObjectHandleTable::kMaxPageCount] = {};
+    std::mutex              mutex;
+    uint32_t                slotCount     = 0;
+    uint32_t                freeListHead  = kInvalidSlot;
+    size_t                  aliveCount    = 0;
+    // clang-format on
+};
+
+// never destroyed, objects may still be released during static destruction
+auto GetTableState() -> TableState & {
+    static TableState *pState = new TableState();
+    return *pState;
+}
+
+auto GetSlot(TableState &state, uint32_t index) -> Slot * {
+    Slot *pPage = state.pages[index / ObjectHandleTable::kPageSize].load(std::memory_order_acquire);
+    return pPage != nullptr ? &pPage[index % ObjectHandleTable::kPageSize] : nullptr;
+}
+
+}    // namespace
+
+auto ObjectHandleTable::Allocate(Object *pObject) -> InstanceID {
+    TableState &state = GetTableState();
+    std::unique_lock lock(state.mutex);
+
+    uint32_t index = state.freeListHead;
+    if (index != kInvalidSlot) {
+        state.freeListHead = GetSlot(state, index)->nextFree;
+    } else {
+        index = state.slotCount++;
+        uint32_t pageIndex = index / kPageSize;
+        Exception::CondThrow(pageIndex < kMaxPageCount, "ObjectHandleTable is full");
+        if (state.pages[pageIndex].load(std::memory_order_relaxed) == nullptr) {
+            state.pages[pageIndex].store(new Slot[kPageSize], std::memory_order_release);
+        }
+    }
+
+    Slot *pSlot = GetSlot(state, index);
+    pSlot->pObject.store(pObject, std::memory_order_release);
+    ++state.aliveCount;
+    return InstanceID::Make(index, pSlot->generation.load(std::memory_order_relaxed));
+}
+
+void ObjectHandleTable::Free(InstanceID instanceId, const Object *pObject) {
+    TableState &state = GetTableState();
+    std::unique_lock lock(state.mutex);
+
+    uint32_t index = instanceId.GetIndex();
+    Slot *pSlot = index < state.slotCount ? GetSlot(state, index) : nullptr;
+    // the id may have been overwritten by deserialization, only free the slot this object owns
+    if (pSlot == nullptr || pSlot->pObject.load(std::memory_order_relaxed) != pObject ||
+        pSlot->generation.load(std::memory_order_relaxed) != instanceId.GetGeneration()) {
+        return;
+    }
+
+    pSlot->pObject.store(nullptr, std::memory_order_release);
+    // zero is skipped so that a default constructed InstanceID never resolves
+    uint32_t generation = pSlot->generation.load(std::memory_order_relaxed) + 1;
+    pSlot->generation.store(generation != 0 ? generation : 1, std::memory_order_release);
+    pSlot->nextFree = state.freeListHead;
+    state.freeListHead = index;
+    --state.aliveCount;
+}
+
+auto ObjectHandleTable::Resolve(InstanceID instanceId) -> Object * {
+    TableState &state = GetTableState();
+    uint32_t index = instanceId.GetIndex();
+    if (index / kPageSize >= kMaxPageCount) {
+        return nullptr;
+    }
+    Slot *pSlot = GetSlot(state, index);
+    if (pSlot == nullptr || pSlot->generation.load(std::memory_order_acquire) != instanceId.GetGeneration()) {
+        return nullptr;
+    }
+    Object *pObject = pSlot->pObject.load(std::memory_order_acquire);
+    // the slot may have been freed and reused in between, the generation tells
+    if (pSlot->generation.load(std::memory_order_acquire) != instanceId.GetGeneration()) {
+        return nullptr;
+    }
+    return pObject;
+}
+
+auto ObjectHandleTable::GetAliveCount() -> size_t {
+    TableState &state = GetTableState();
+    std::unique_lock lock(state.mutex);
+    return state.aliveCount;
+}
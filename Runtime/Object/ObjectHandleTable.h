@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include "InstanceID.hpp"
+
+class Object;
+
+// Global generational handle table, every Object takes one slot for its lifetime.
+// An InstanceID is the slot index plus the generation of the slot, so a stale id of a destroyed object
+// resolves to nullptr instead of a dangling pointer, even after the slot has been reused.
+// Allocate and Free are serialized, Resolve is lock free and may be called from any thread,
+// but the returned pointer does not keep the object alive.
+class ObjectHandleTable {
+public:
+    static constexpr uint32_t kPageSize = 4096;
+    static constexpr uint32_t kMaxPageCount = 4096;
+public:
+    static auto Allocate(Object *pObject) -> InstanceID;
+    static void Free(InstanceID instanceId, const Object *pObject);
+    static auto Resolve(InstanceID instanceId) -> Object *;
+    static auto GetAliveCount() -> size_t;
+};
+
+template<typename T>
+auto ResolveInstanceID(InstanceID instanceId) -> T * {
+    return dynamic_cast<T *>(ObjectHandleTable::Resolve(instanceId));
+}
@@ -5,6 +5,7 @@
 #include "D3d12/Buffer.h"
 #include "Renderer/GfxDevice.h"
 #include "Foundation/Formatter.hpp"
+#include <algorithm>
 
 GPUMeshData::GPUMeshData() : _vertexBufferView{}, _indexBufferView{} {
 }
@@ -56,22 +57,25 @@ void GPUMeshData::UploadGpuMemory(const CPUMeshData *pMeshData) {
     uploadHeap.CommitUploadCommand();
 }
 
-auto GPUMeshData::RequireBottomLevelAS(dx::IASBuilder *pIASBuilder) -> dx::BottomLevelAS * {
+auto GPUMeshData::RequireBottomLevelAS(dx::IASBuilder *pIASBuilder, size_t indexCount) -> dx::BottomLevelAS * {
     std::string_view name = _pStaticBuffer->GetName();
     if (_pBottomLevelAS == nullptr) {
         std::string opaqueBottomLevelASName = fmt::format("{}_BottomLevelAS", name);
-        _pBottomLevelAS = GenerateBottomLevelAccelerationStructure(pIASBuilder);
+        _pBottomLevelAS = GenerateBottomLevelAccelerationStructure(pIASBuilder, indexCount);
         _pBottomLevelAS->SetName(opaqueBottomLevelASName);
     }
     return _pBottomLevelAS.Get();
 }
 
-auto GPUMeshData::GenerateBottomLevelAccelerationStructure(dx::IASBuilder *pIASBuilder) const
+auto GPUMeshData::GenerateBottomLevelAccelerationStructure(dx::IASBuilder *pIASBuilder, size_t indexCount) const
     -> SharedPtr<dx::BottomLevelAS> {
     constexpr DXGI_FORMAT vertexFormat = GetSemanticInfo(SemanticIndex::eVertex).format;
     dx::BottomLevelASGenerator generator;
     if (_indexBufferView.SizeInBytes > 0) {
-        generator.AddGeometry(_vertexBufferView, vertexFormat, _indexBufferView);
+        D3D12_INDEX_BUFFER_VIEW indexBufferView = _indexBufferView;
+        indexBufferView.SizeInBytes = static_cast<UINT>(std::min<size_t>(indexCount * sizeof(uint32_t),
+            indexBufferView.SizeInBytes));
+        generator.AddGeometry(_vertexBufferView, vertexFormat, indexBufferView);
     } else {
         generator.AddGeometry(_vertexBufferView, vertexFormat);
     }
@@ -17,8 +17,10 @@ public:
 private:
 	friend class Mesh;
 	void UploadGpuMemory(const CPUMeshData *pMeshData);
-	auto RequireBottomLevelAS(dx::IASBuilder *pIASBuilder) -> dx::BottomLevelAS *;
-	auto GenerateBottomLevelAccelerationStructure(dx::IASBuilder *pIASBuilder) const -> SharedPtr<dx::BottomLevelAS>;
+	// only the first indexCount indices are part of the acceleration structure
+	auto RequireBottomLevelAS(dx::IASBuilder *pIASBuilder, size_t indexCount) -> dx::BottomLevelAS *;
+	auto GenerateBottomLevelAccelerationStructure(dx::IASBuilder *pIASBuilder, size_t indexCount) const
+		-> SharedPtr<dx::BottomLevelAS>;
 private:
 	// clang-format off
 	SharedPtr<dx::Buffer>				_pStaticBuffer;
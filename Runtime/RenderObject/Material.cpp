@@ -6,8 +6,10 @@
 #include "ShaderLoader/ShaderManager.h"
 #include "Foundation/HashUtil.hpp"
 #include "Renderer/RenderPasses/ForwardPass.h"
+#include "Renderer/RenderUtils/GPUScene.h"
 #include "RenderObject/RenderGroup.hpp"
 #include "RenderObject/VertexSemantic.hpp"
+#include <atomic>
 
 namespace ShaderFeatures {
 
@@ -25,7 +27,12 @@ static const char *sTextureKeyword[] = {
 }    // namespace ShaderFeatures
 
 Material::Material()
-    : _renderGroup(RenderGroup::eOpaque), _pipelineIDDirty(false), _pipelineSemanticMask(), _pipelineID(0) {
+    : _renderGroup(RenderGroup::eOpaque),
+      _pipelineIDDirty(false),
+      _pipelineSemanticMask(),
+      _pipelineID(0),
+      _version(0),
+      _gpuSceneIndex(GPUSceneTable::kInvalidSlot) {
 
     _cbPreMaterial.albedo = Colors::White;
     _cbPreMaterial.emission = Colors::Black;
@@ -42,21 +49,29 @@ Material::Material()
     _cbPreMaterial.normalTexIndex = 0;
     _cbPreMaterial.padding0 = 0;
     _cbPreMaterial.padding1 = 0;
+    if (GPUScene *pGPUScene = GPUScene::GetInstance()) {
+        pGPUScene->AddMaterial(this);
+    }
 }
 
 Material::~Material() {
+    if (GPUScene *pGPUScene = GPUScene::GetInstance()) {
+        pGPUScene->RemoveMaterial(this);
+    }
 }
 
+static std::atomic<uint64_t> sChangeVersion = 0;
+
 void Material::SetRenderGroup(uint16_t renderGroup) {
     _renderGroup = renderGroup;
     _defineList.Set(ShaderFeatures::sEnableAlphaTest, (RenderGroup::IsAlphaTest(renderGroup)));
-    _pipelineIDDirty = true;
+    MarkPipelineIDDirty();
 }
 
 void Material::SetTexture(TextureType textureType, SharedPtr<dx::Texture> pTexture, dx::SRV srv) {
     _textures[textureType] = std::move(pTexture);
     _defineList.Set(ShaderFeatures::sTextureKeyword[textureType], _textures[textureType] != nullptr);
-    _pipelineIDDirty = true;
+    MarkPipelineIDDirty();
 
     _textureHandles[textureType] = dx::SRV{};
     if (_textures[textureType] != nullptr) {
@@ -74,34 +89,42 @@ auto Material::GetTextureHandle(TextureType textureType) const -> D3D12_CPU_DESC
 
 void Material::SetAlbedo(const glm::vec4 &albedo) {
     _cbPreMaterial.albedo = albedo;
+    SyncGPUScene();
 }
 
 void Material::SetEmission(const glm::vec4 &emission) {
     _cbPreMaterial.emission = emission;
+    SyncGPUScene();
 }
 
 void Material::SetTillingAndOffset(const glm::vec4 &tilingAndOffset) {
     _cbPreMaterial.tilingAndOffset = tilingAndOffset;
+    SyncGPUScene();
 }
 
 void Material::SetCutoff(float cutoff) {
     _cbPreMaterial.cutoff = cutoff;
+    SyncGPUScene();
 }
 
 void Material::SetRoughness(float roughness) {
     _cbPreMaterial.roughness = roughness;
+    SyncGPUScene();
 }
 
 void Material::SetMetallic(float metallic) {
     _cbPreMaterial.metallic = metallic;
+    SyncGPUScene();
 }
 
 void Material::SetNormalScale(float normalScale) {
     _cbPreMaterial.normalScale = normalScale;
+    SyncGPUScene();
 }
 
 void Material::SetSamplerAddressMode(SamplerAddressMode mode) {
     _cbPreMaterial.samplerStateIndex = mode;
+    SyncGPUScene();
 }
 
 static std::vector<size_t> sPipelineIDList = {};
@@ -151,6 +174,10 @@ bool Material::PipelineIDDirty() const {
     return _pipelineIDDirty;
 }
 
+auto Material::GetChangeVersion() -> uint64_t {
+    return sChangeVersion.load(std::memory_order_relaxed);
+}
+
 auto Material::GetRenderGroup() const -> uint16_t {
     return _renderGroup;
 }
@@ -158,3 +185,15 @@ auto Material::GetRenderGroup() const -> uint16_t {
 auto Material::GetPipelineID() const -> uint16_t {
     return _pipelineID;
 }
+
+void Material::MarkPipelineIDDirty() {
+    _pipelineIDDirty = true;
+    ++_version;
+    sChangeVersion.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Material::SyncGPUScene() const {
+    if (GPUScene *pGPUScene = GPUScene::GetInstance()) {
+        pGPUScene->UpdateMaterial(this);
+    }
+}
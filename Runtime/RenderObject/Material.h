@@ -33,6 +33,12 @@ public:
     void SetSamplerAddressMode(SamplerAddressMode mode);
     bool UpdatePipelineID(SemanticMask meshSemanticMask);
     bool PipelineIDDirty() const;
+    // bumped whenever the pipeline of any material becomes dirty
+    static auto GetChangeVersion() -> uint64_t;
+    // bumped whenever the pipeline of this material becomes dirty
+    auto GetVersion() const -> uint64_t {
+	    return _version;
+    }
     auto GetRenderGroup() const -> uint16_t;
     auto GetPipelineID() const -> uint16_t;
 
@@ -49,6 +55,9 @@ public:
     auto GetSamplerStateIndex() const -> int {
 	    return _cbPreMaterial.samplerStateIndex;
     }
+    auto GetGPUSceneIndex() const -> uint32_t {
+	    return _gpuSceneIndex;
+    }
 private:
     struct alignas(sizeof(glm::vec4)) CbPreMaterial {
         glm::vec4 albedo;
@@ -67,9 +76,14 @@ private:
         int padding0;
         int padding1;
     };
+private:
+    // writes the constants to the material buffer of the GPUScene
+    void SyncGPUScene() const;
+    void MarkPipelineIDDirty();
 private:
     friend class ForwardPass;
     friend class GBufferPass;
+    friend class GPUScene;
     // clang-format off
     uint32_t                     _renderGroup;
     dx::DefineList               _defineList;
@@ -80,5 +94,8 @@ private:
     bool                         _pipelineIDDirty;
     SemanticMask                 _pipelineSemanticMask;
     uint32_t                     _pipelineID;
+    uint64_t                     _version;
+    // slot in the material buffer of the GPUScene
+    uint32_t                     _gpuSceneIndex;
     // clang-format on
 };
\ No newline at end of file
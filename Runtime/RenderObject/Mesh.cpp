@@ -3,8 +3,10 @@
 #include "CPUMeshData.h"
 #include "Foundation/DebugBreak.h"
 #include "Foundation/Logger.h"
+#include <atomic>
+#include <cmath>
 
-Mesh::Mesh() : _vertexAttributeDirty(false) {
+Mesh::Mesh() : _vertexAttributeDirty(false), _boundsDirty(false) {
 	_pCpuMeshData = std::make_unique<CPUMeshData>();
 	_pGpuMeshData = std::make_unique<GPUMeshData>();
 }
@@ -28,19 +30,59 @@ auto Mesh::GetSemanticMask() const -> SemanticMask {
     return _pCpuMeshData->GetSemanticMask();
 }
 
-void Mesh::GetVertices(std::vector<glm::vec3> &vertices) const {
-    auto iter = _pCpuMeshData->GetSemanticBegin(SemanticIndex::eVertex);
-    auto end = _pCpuMeshData->GetSemanticEnd(SemanticIndex::eVertex);
+template<typename T>
+static void collect(CPUMeshData *pCpuMeshData, SemanticIndex index, std::vector<T> &data) {
+    if (!HasFlag(pCpuMeshData->GetSemanticMask(), SemanticMaskCast(index))) {
+        return;
+    }
+    auto iter = pCpuMeshData->GetSemanticBegin(index);
+    auto end = pCpuMeshData->GetSemanticEnd(index);
     while (iter != end) {
-        vertices.push_back(iter.Get<glm::vec3>());
+        data.push_back(iter.Get<T>());
         ++iter;
     }
 }
 
+void Mesh::GetVertices(std::vector<glm::vec3> &vertices) const {
+    collect(_pCpuMeshData.get(), SemanticIndex::eVertex, vertices);
+}
+
+void Mesh::GetNormals(std::vector<glm::vec3> &normals) const {
+    collect(_pCpuMeshData.get(), SemanticIndex::eNormal, normals);
+}
+
+void Mesh::GetTangents(std::vector<glm::vec4> &tangents) const {
+    collect(_pCpuMeshData.get(), SemanticIndex::eTangent, tangents);
+}
+
+void Mesh::GetColors(std::vector<glm::vec4> &colors) const {
+    collect(_pCpuMeshData.get(), SemanticIndex::eColor, colors);
+}
+
+void Mesh::GetUV0(std::vector<glm::vec2> &uvs) const {
+    collect(_pCpuMeshData.get(), SemanticIndex::eTexCoord0, uvs);
+}
+
+auto Mesh::GetIndices() const -> ReadonlyArraySpan<uint32_t> {
+    return ReadonlyArraySpan<uint32_t>(_pCpuMeshData->GetIndices(), _pCpuMeshData->GetIndexCount());
+}
+
 auto Mesh::GetSubMeshes() const -> const std::vector<SubMesh> & {
     return _subMeshes;
 }
 
+auto Mesh::GetSubMeshes(size_t lod) const -> const std::vector<SubMesh> & {
+    if (lod == 0) {
+        return _subMeshes;
+    }
+    Assert(lod <= _lods.size());
+    return _lods[lod - 1].subMeshes;
+}
+
+auto Mesh::GetLodError(size_t lod) const -> float {
+    return lod == 0 ? 0.f : _lods[lod - 1].error;
+}
+
 auto Mesh::GetGPUMeshData() const -> const GPUMeshData * {
     return _pGpuMeshData.get();
 }
@@ -54,12 +96,14 @@ void Mesh::SetIndices(ReadonlyArraySpan<uint32_t> indices) {
     Assert(indices.Count() == _pCpuMeshData->GetIndexCount());
     auto ptr = _pCpuMeshData->GetIndicesBegin();
     std::memcpy(ptr, indices.Data(), sizeof(uint32_t) * indices.Count());
+    _boundsDirty = true;
 }
 
 void Mesh::SetIndices(ReadonlyArraySpan<int32_t> indices) {
     Assert(indices.Count() == _pCpuMeshData->GetIndexCount());
     auto ptr = _pCpuMeshData->GetIndicesBegin();
     std::memcpy(ptr, indices.Data(), sizeof(uint32_t) * indices.Count());
+    _boundsDirty = true;
 }
 
 template<typename T>
@@ -78,6 +122,7 @@ void Mesh::SetVertices(ReadonlyArraySpan<glm::vec3> vertices) {
     auto end = _pCpuMeshData->GetSemanticEnd(SemanticIndex::eVertex);
     fill(begin, end, vertices);
     _vertexAttributeDirty = true;
+    _boundsDirty = true;
 }
 
 void Mesh::SetNormals(ReadonlyArraySpan<glm::vec3> normals) {
@@ -114,12 +159,37 @@ void Mesh::SetUV0(ReadonlyArraySpan<glm::vec2> uvs) {
 
 void Mesh::SetSubMeshes(std::vector<SubMesh> subMeshes) {
     _subMeshes = std::move(subMeshes);
+    _boundsDirty = true;
 }
 
+void Mesh::SetLods(std::vector<MeshLod> lods) {
+    Exception::CondThrow(!_subMeshes.empty(), "Mesh::SetLods: the sub meshes of level 0 must be set first");
+    for (const MeshLod &lod : lods) {
+        Exception::CondThrow(lod.subMeshes.size() == _subMeshes.size(),
+            "Mesh::SetLods: every level requires {} sub meshes",
+            _subMeshes.size());
+        for (const SubMesh &subMesh : lod.subMeshes) {
+            Exception::CondThrow(subMesh.baseIndexLocation + subMesh.indexCount <= _pCpuMeshData->GetIndexCount(),
+                "Mesh::SetLods: the index range is out of the index buffer");
+        }
+    }
+    _lods = std::move(lods);
+    _boundsDirty = true;
+}
+
+static std::atomic<uint64_t> sChangeVersion = 0;
+
 void Mesh::Resize(SemanticMask mask, size_t vertexCount, size_t indexCount) {
     _pCpuMeshData->Resize(mask, vertexCount, indexCount);
     _vertexAttributeDirty = true;
+    _boundsDirty = true;
     _subMeshes.clear();
+    _lods.clear();
+    sChangeVersion.fetch_add(1, std::memory_order_relaxed);
+}
+
+auto Mesh::GetChangeVersion() -> uint64_t {
+    return sChangeVersion.load(std::memory_order_relaxed);
 }
 
 void Mesh::UploadMeshData() {
@@ -135,6 +205,11 @@ void Mesh::UploadMeshData() {
         subMesh.baseVertexLocation = 0;
         _subMeshes.push_back(subMesh);
     }
+    if (_boundsDirty) {
+        UpdateBounds();
+        _boundsDirty = false;
+        sChangeVersion.fetch_add(1, std::memory_order_relaxed);
+    }
     _pGpuMeshData->SetName(_name);
 }
 
@@ -158,5 +233,70 @@ auto Mesh::RequireBottomLevelAS(dx::IASBuilder *pASBuilder) -> dx::BottomLevelAS
         Logger::Error("Mesh::RequireBottomLevelAS, vertexAttribute Dirty!");
 	    return nullptr;
     }
-    return _pGpuMeshData->RequireBottomLevelAS(pASBuilder);
+    // the simplified levels share the index buffer, only level 0 is traced
+    size_t indexCount = 0;
+    for (const SubMesh &subMesh : _subMeshes) {
+        indexCount = std::max(indexCount, subMesh.baseIndexLocation + subMesh.indexCount);
+    }
+    return _pGpuMeshData->RequireBottomLevelAS(pASBuilder, indexCount);
+}
+
+void Mesh::UpdateBounds() {
+    _bounds = AABB{};
+    _boundingSphere = BoundingSphere{};
+    _subMeshBounds.Resize(0);
+    if (!HasFlag(_pCpuMeshData->GetSemanticMask(), SemanticMask::eVertex)) {
+        return;
+    }
+
+    auto vertexBegin = _pCpuMeshData->GetSemanticBegin(SemanticIndex::eVertex);
+    const uint32_t *pIndices = _pCpuMeshData->GetIndices();
+    size_t vertexCount = _pCpuMeshData->GetVertexCount();
+    _subMeshBounds.Resize(_subMeshes.size());
+    for (size_t subMeshIndex = 0; subMeshIndex < _subMeshes.size(); ++subMeshIndex) {
+        SubMesh &subMesh = _subMeshes[subMeshIndex];
+        // the sphere is centered on the box, one more pass over the vertices finds the radius
+        subMesh.bounds = AABB{};
+        for (size_t i = 0; i < subMesh.indexCount; ++i) {
+            size_t vertexIndex = subMesh.baseVertexLocation + pIndices[subMesh.baseIndexLocation + i];
+            Assert(vertexIndex < vertexCount);
+            subMesh.bounds.Merge((vertexBegin + vertexIndex).Get<glm::vec3>());
+        }
+        _subMeshBounds.Set(subMeshIndex, subMesh.bounds);
+
+        subMesh.boundingSphere = BoundingSphere{};
+        if (!subMesh.bounds.IsValid()) {
+            continue;
+        }
+        glm::vec3 center = subMesh.bounds.GetCenter();
+        float radiusSqr = 0.f;
+        for (size_t i = 0; i < subMesh.indexCount; ++i) {
+            size_t vertexIndex = subMesh.baseVertexLocation + pIndices[subMesh.baseIndexLocation + i];
+            glm::vec3 offset = (vertexBegin + vertexIndex).Get<glm::vec3>() - center;
+            radiusSqr = std::max(radiusSqr, glm::dot(offset, offset));
+        }
+        subMesh.boundingSphere = BoundingSphere{center, std::sqrt(radiusSqr)};
+        _bounds.Merge(subMesh.bounds);
+    }
+
+    // the simplified levels only use the vertices of level 0
+    for (MeshLod &lod : _lods) {
+        for (size_t i = 0; i < lod.subMeshes.size(); ++i) {
+            lod.subMeshes[i].bounds = _subMeshes[i].bounds;
+            lod.subMeshes[i].boundingSphere = _subMeshes[i].boundingSphere;
+        }
+    }
+
+    if (!_bounds.IsValid()) {
+        return;
+    }
+    // the sphere of the whole mesh encloses the sub mesh spheres
+    glm::vec3 center = _bounds.GetCenter();
+    float radius = 0.f;
+    for (const SubMesh &subMesh : _subMeshes) {
+        if (subMesh.boundingSphere.IsValid()) {
+            radius = std::max(radius, glm::length(subMesh.boundingSphere.center - center) + subMesh.boundingSphere.radius);
+        }
+    }
+    _boundingSphere = BoundingSphere{center, radius};
 }
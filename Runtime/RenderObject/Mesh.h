@@ -2,6 +2,8 @@
 #include <memory>
 #include <vector>
 #include "D3d12/D3dStd.h"
+#include "Foundation/BoundingVolume.hpp"
+#include "Foundation/FrustumCulling.h"
 #include "Foundation/GlmStd.hpp"
 #include "Foundation/NonCopyable.h"
 #include "Foundation/ReadonlyArraySpan.hpp"
@@ -16,6 +18,17 @@ struct SubMesh {
 	size_t indexCount;
 	size_t baseVertexLocation;
 	size_t baseIndexLocation;
+	// computed by Mesh::UploadMeshData from the vertices referenced by the indices
+	AABB bounds;
+	BoundingSphere boundingSphere;
+};
+
+// a simplified level of detail, its indices follow the indices of level 0 in the index buffer of the mesh
+struct MeshLod {
+	// one range per sub mesh of level 0, sharing its vertices
+	std::vector<SubMesh> subMeshes;
+	// simplification error in object space, see MeshSimplifier
+	float error = 0.f;
 };
 
 class Mesh : private NonCopyable {
@@ -28,8 +41,32 @@ public:
 	auto GetIndexCount() const -> size_t;
 	auto GetSemanticMask() const -> SemanticMask;
 	void GetVertices(std::vector<glm::vec3> &vertices) const;
+	// the attribute getters append nothing when the channel does not exist
+	void GetNormals(std::vector<glm::vec3> &normals) const;
+	void GetTangents(std::vector<glm::vec4> &tangents) const;
+	void GetColors(std::vector<glm::vec4> &colors) const;
+	void GetUV0(std::vector<glm::vec2> &uvs) const;
+	// the sub mesh indices are relative to their baseVertexLocation
+	auto GetIndices() const -> ReadonlyArraySpan<uint32_t>;
 	auto GetSubMeshes() const -> const std::vector<SubMesh> &;
+	// level 0 is the mesh itself
+	auto GetLodCount() const -> size_t {
+		return _lods.size() + 1;
+	}
+	auto GetSubMeshes(size_t lod) const -> const std::vector<SubMesh> &;
+	auto GetLodError(size_t lod) const -> float;
 	auto GetGPUMeshData() const -> const GPUMeshData *;
+	// object space bounds of all sub meshes, valid after UploadMeshData
+	auto GetBounds() const -> const AABB & {
+		return _bounds;
+	}
+	auto GetBoundingSphere() const -> const BoundingSphere & {
+		return _boundingSphere;
+	}
+	// the bounds of the level 0 sub meshes laid out for FrustumCulling::Cull, valid after UploadMeshData
+	auto GetSubMeshBounds() const -> const AABBSoA & {
+		return _subMeshBounds;
+	}
 public:
 	void SetName(std::string_view name);
 	void SetIndices(ReadonlyArraySpan<uint32_t> indices);
@@ -40,22 +77,32 @@ public:
 	void SetColors(ReadonlyArraySpan<glm::vec4> colors);
 	void SetUV0(ReadonlyArraySpan<glm::vec2> uvs);
 	void SetSubMeshes(std::vector<SubMesh> subMeshes);
+	// requires the sub meshes of level 0 to be set, the errors must not decrease with the level
+	void SetLods(std::vector<MeshLod> lods);
 	void Resize(SemanticMask mask, size_t vertexCount, size_t indexCount);
 	void UploadMeshData();
 	auto GetBottomLevelAS() const -> dx::BottomLevelAS *;
 	bool IsGpuDataDirty() const {
 		return _vertexAttributeDirty;
 	}
+	// bumped whenever the semantic mask or the bounds of any mesh may have changed
+	static auto GetChangeVersion() -> uint64_t;
 private:
 	friend class SceneRayTracingASManager;
 	void SetDataCheck(size_t vertexCount, SemanticIndex index) const;
 	auto RequireBottomLevelAS(dx::IASBuilder *pASBuilder) -> dx::BottomLevelAS *;
+	void UpdateBounds();
 private:
 	// clang-format off
 	std::string						_name;
 	std::vector<SubMesh>			_subMeshes;
+	std::vector<MeshLod>			_lods;
 	std::unique_ptr<CPUMeshData>	_pCpuMeshData;
 	std::unique_ptr<GPUMeshData>	_pGpuMeshData;
 	bool							_vertexAttributeDirty;
+	bool							_boundsDirty;
+	AABB							_bounds;
+	BoundingSphere					_boundingSphere;
+	AABBSoA							_subMeshBounds;
 	// clang-format on
 };
@@ -0,0 +1,332 @@
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include "Foundation/Exception.h"
+
+namespace {
+
+// symmetric 4x4 matrix of the summed plane equations, stored as its upper triangle
+struct Quadric {
+    double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+    double b2 = 0.0, bc = 0.0, bd = 0.0;
+    double c2 = 0.0, cd = 0.0;
+    double d2 = 0.0;
+public:
+    void AddPlane(double a, double b, double c, double d) {
+        a2 += a * a, ab += a * b, ac += a * c, ad += a * d;
+        b2 += b * b, bc += b * c, bd += b * d;
+        c2 += c * c, cd += c * d;
+        d2 += d * d;
+    }
+    Quadric &operator+=(const Quadric &other) {
+        a2 += other.a2, ab += other.ab, ac += other.ac, ad += other.ad;
+        b2 += other.b2, bc += other.bc, bd += other.bd;
+        c2 += other.c2, cd += other.cd;
+        d2 += other.d2;
+        return *this;
+    }
+    friend auto operator+(Quadric lhs, const Quadric &rhs) -> Quadric {
+        lhs += rhs;
+        return lhs;
+    }
+    // sum of the squared distances of p to the planes
+    auto Evaluate(const glm::vec3 &p) const -> double {
+        double x = p.x, y = p.y, z = p.z;
+        double error = a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x;
+        error += b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y;
+        error += c2 * z * z + 2.0 * cd * z + d2;
+        return std::max(error, 0.0);
+    }
+};
+
+struct Collapse {
+    uint32_t from;
+    uint32_t to;
+    double cost;
+};
+
+auto TriangleNormal(const glm::vec3 &p0, const glm::vec3 &p1, const glm::vec3 &p2) -> glm::vec3 {
+    return glm::cross(p1 - p0, p2 - p0);
+}
+
+// vertices at the same position share the smallest vertex index among them as representative
+void WeldPositions(ReadonlyArraySpan<glm::vec3> positions, std::vector<uint32_t> &weld, std::vector<uint32_t> &groupSize) {
+    size_t vertexCount = positions.Count();
+    std::vector<uint32_t> order(vertexCount);
+    std::iota(order.begin(), order.end(), 0);
+    auto less = [&](uint32_t lhs, uint32_t rhs) {
+        const glm::vec3 &a = positions[lhs];
+        const glm::vec3 &b = positions[rhs];
+        if (a.x != b.x) {
+            return a.x < b.x;
+        }
+        if (a.y != b.y) {
+            return a.y < b.y;
+        }
+        if (a.z != b.z) {
+            return a.z < b.z;
+        }
+        return lhs < rhs;
+    };
+    std::sort(order.begin(), order.end(), less);
+
+    weld.resize(vertexCount);
+    groupSize.assign(vertexCount, 0);
+    for (size_t begin = 0; begin < vertexCount;) {
+        size_t end = begin + 1;
+        const glm::vec3 &position = positions[order[begin]];
+        while (end < vertexCount && positions[order[end]].x == position.x && positions[order[end]].y == position.y &&
+               positions[order[end]].z == position.z) {
+            ++end;
+        }
+        for (size_t i = begin; i < end; ++i) {
+            weld[order[i]] = order[begin];
+        }
+        groupSize[order[begin]] = static_cast<uint32_t>(end - begin);
+        begin = end;
+    }
+}
+
+}    // namespace
+
+auto MeshSimplifier::Simplify(ReadonlyArraySpan<glm::vec3> positions,
+    ReadonlyArraySpan<uint32_t> indices,
+    size_t targetIndexCount,
+    float maxError) -> LodLevel {
+
+    Exception::CondThrow(indices.Count() % 3 == 0, "MeshSimplifier::Simplify: only triangle lists are supported");
+    size_t vertexCount = positions.Count();
+    std::vector<uint32_t> weld;
+    std::vector<uint32_t> groupSize;
+    WeldPositions(positions, weld, groupSize);
+
+    // drop the triangles that are already degenerate after welding
+    LodLevel result;
+    result.indices.reserve(indices.Count());
+    for (size_t i = 0; i < indices.Count(); i += 3) {
+        uint32_t w0 = weld[indices[i + 0]];
+        uint32_t w1 = weld[indices[i + 1]];
+        uint32_t w2 = weld[indices[i + 2]];
+        if (w0 != w1 && w1 != w2 && w2 != w0) {
+            result.indices.insert(result.indices.end(), indices.begin() + i, indices.begin() + i + 3);
+        }
+    }
+
+    // every welded edge has to be shared by exactly two triangles, otherwise it is a border or non manifold
+    std::vector<uint8_t> locked(vertexCount, 0);
+    for (size_t v = 0; v < vertexCount; ++v) {
+        locked[v] = static_cast<uint8_t>(groupSize[weld[v]] > 1);
+    }
+    std::vector<uint64_t> edges;
+    edges.reserve(result.indices.size());
+    for (size_t i = 0; i < result.indices.size(); i += 3) {
+        for (size_t e = 0; e < 3; ++e) {
+            uint64_t w0 = weld[result.indices[i + e]];
+            uint64_t w1 = weld[result.indices[i + (e + 1) % 3]];
+            edges.push_back(std::min(w0, w1) << 32 | std::max(w0, w1));
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    for (size_t begin = 0; begin < edges.size();) {
+        size_t end = begin + 1;
+        while (end < edges.size() && edges[end] == edges[begin]) {
+            ++end;
+        }
+        if (end - begin != 2) {
+            locked[edges[begin] >> 32] = 1;
+            locked[edges[begin] & 0xffffffff] = 1;
+        }
+        begin = end;
+    }
+
+    std::vector<Quadric> quadrics(vertexCount);
+    for (size_t i = 0; i < result.indices.size(); i += 3) {
+        uint32_t w0 = weld[result.indices[i + 0]];
+        uint32_t w1 = weld[result.indices[i + 1]];
+        uint32_t w2 = weld[result.indices[i + 2]];
+        glm::vec3 normal = TriangleNormal(positions[w0], positions[w1], positions[w2]);
+        float length = glm::length(normal);
+        if (length <= 0.f) {
+            continue;
+        }
+        normal = normal / length;
+        double d = -glm::dot(normal, positions[w0]);
+        for (uint32_t w : { w0, w1, w2 }) {
+            quadrics[w].AddPlane(normal.x, normal.y, normal.z, d);
+        }
+    }
+
+    targetIndexCount -= targetIndexCount % 3;
+    double maxCost = static_cast<double>(maxError) * maxError;
+    double resultCost = 0.0;
+    std::vector<uint32_t> collapseTo(vertexCount);
+    std::iota(collapseTo.begin(), collapseTo.end(), 0);
+    std::vector<uint32_t> adjacencyOffsets;
+    std::vector<uint32_t> adjacency;
+    std::vector<Collapse> collapses;
+    std::vector<uint8_t> touched;
+    std::vector<uint32_t> marks(vertexCount, 0);
+    uint32_t markStamp = 0;
+
+    while (result.indices.size() > targetIndexCount) {
+        size_t triangleCount = result.indices.size() / 3;
+
+        // triangles around every welded vertex
+        adjacencyOffsets.assign(vertexCount + 1, 0);
+        for (uint32_t index : result.indices) {
+            ++adjacencyOffsets[weld[index] + 1];
+        }
+        std::partial_sum(adjacencyOffsets.begin(), adjacencyOffsets.end(), adjacencyOffsets.begin());
+        adjacency.resize(result.indices.size());
+        std::vector<uint32_t> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < result.indices.size(); ++i) {
+            adjacency[cursor[weld[result.indices[i]]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        // half edge collapses, the locked vertex of an edge can only be the target
+        collapses.clear();
+        for (size_t i = 0; i < result.indices.size(); i += 3) {
+            for (size_t e = 0; e < 3; ++e) {
+                uint32_t v0 = result.indices[i + e];
+                uint32_t v1 = result.indices[i + (e + 1) % 3];
+                uint32_t w0 = weld[v0];
+                uint32_t w1 = weld[v1];
+                if (!locked[w0]) {
+                    collapses.push_back(Collapse{v0, v1, (quadrics[w0] + quadrics[w1]).Evaluate(positions[w1])});
+                }
+                if (!locked[w1]) {
+                    collapses.push_back(Collapse{v1, v0, (quadrics[w0] + quadrics[w1]).Evaluate(positions[w0])});
+                }
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse &lhs, const Collapse &rhs) {
+            return lhs.cost < rhs.cost;
+        });
+
+        // collapses in one pass must not share a triangle, the fans used by the checks stay valid
+        touched.assign(vertexCount, 0);
+        size_t targetTriangleCount = targetIndexCount / 3;
+        size_t collapseCount = 0;
+        for (const Collapse &collapse : collapses) {
+            if (collapse.cost > maxCost || triangleCount <= targetTriangleCount) {
+                break;
+            }
+            uint32_t from = weld[collapse.from];
+            uint32_t to = weld[collapse.to];
+            if (touched[from] || touched[to]) {
+                continue;
+            }
+
+            // link condition, an interior edge has exactly two common neighbours
+            ++markStamp;
+            for (uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1]; ++a) {
+                const uint32_t *pTriangle = &result.indices[adjacency[a] * 3];
+                for (size_t k = 0; k < 3; ++k) {
+                    marks[weld[pTriangle[k]]] = markStamp;
+                }
+            }
+            size_t commonCount = 0;
+            ++markStamp;
+            for (uint32_t a = adjacencyOffsets[to]; a < adjacencyOffsets[to + 1]; ++a) {
+                const uint32_t *pTriangle = &result.indices[adjacency[a] * 3];
+                for (size_t k = 0; k < 3; ++k) {
+                    uint32_t w = weld[pTriangle[k]];
+                    if (w != from && w != to && marks[w] == markStamp - 1) {
+                        marks[w] = markStamp;
+                        ++commonCount;
+                    }
+                }
+            }
+            if (commonCount != 2) {
+                continue;
+            }
+
+            // the remaining triangles around the collapsed vertex must not flip
+            bool flipped = false;
+            size_t removedCount = 0;
+            for (uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1] && !flipped; ++a) {
+                const uint32_t *pTriangle = &result.indices[adjacency[a] * 3];
+                glm::vec3 oldPositions[3];
+                glm::vec3 newPositions[3];
+                bool removed = false;
+                for (size_t k = 0; k < 3; ++k) {
+                    uint32_t w = weld[pTriangle[k]];
+                    removed = removed || w == to;
+                    oldPositions[k] = positions[w];
+                    newPositions[k] = w == from ? positions[to] : positions[w];
+                }
+                if (removed) {
+                    ++removedCount;
+                    continue;
+                }
+                glm::vec3 oldNormal = TriangleNormal(oldPositions[0], oldPositions[1], oldPositions[2]);
+                glm::vec3 newNormal = TriangleNormal(newPositions[0], newPositions[1], newPositions[2]);
+                flipped = glm::dot(oldNormal, newNormal) <= 0.f;
+            }
+            if (flipped) {
+                continue;
+            }
+
+            // the collapsed vertex is not on a seam, so the target vertex of this edge is the one of its chart
+            collapseTo[collapse.from] = collapse.to;
+            quadrics[to] += quadrics[from];
+            for (uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1]; ++a) {
+                const uint32_t *pTriangle = &result.indices[adjacency[a] * 3];
+                for (size_t k = 0; k < 3; ++k) {
+                    touched[weld[pTriangle[k]]] = 1;
+                }
+            }
+            triangleCount -= std::min(removedCount, triangleCount);
+            resultCost = std::max(resultCost, collapse.cost);
+            ++collapseCount;
+        }
+        if (collapseCount == 0) {
+            break;
+        }
+
+        size_t writeIndex = 0;
+        for (size_t i = 0; i < result.indices.size(); i += 3) {
+            uint32_t v0 = collapseTo[result.indices[i + 0]];
+            uint32_t v1 = collapseTo[result.indices[i + 1]];
+            uint32_t v2 = collapseTo[result.indices[i + 2]];
+            if (weld[v0] == weld[v1] || weld[v1] == weld[v2] || weld[v2] == weld[v0]) {
+                continue;
+            }
+            result.indices[writeIndex++] = v0;
+            result.indices[writeIndex++] = v1;
+            result.indices[writeIndex++] = v2;
+        }
+        result.indices.resize(writeIndex);
+    }
+
+    result.error = static_cast<float>(std::sqrt(resultCost));
+    return result;
+}
+
+auto MeshSimplifier::GenerateLodChain(ReadonlyArraySpan<glm::vec3> positions,
+    ReadonlyArraySpan<uint32_t> indices,
+    size_t maxLodCount,
+    float reduction,
+    float maxError) -> std::vector<LodLevel> {
+
+    std::vector<LodLevel> lods;
+    size_t sourceIndexCount = indices.Count();
+    float sourceError = 0.f;
+    for (size_t lod = 0; lod < maxLodCount; ++lod) {
+        size_t targetIndexCount = static_cast<size_t>(static_cast<float>(sourceIndexCount / 3) * reduction) * 3;
+        if (targetIndexCount < 3) {
+            break;
+        }
+        // every level starts from the full mesh, the error does not accumulate over simplified levels
+        LodLevel level = Simplify(positions, indices, targetIndexCount, maxError);
+        if (static_cast<float>(level.indices.size()) > static_cast<float>(sourceIndexCount) * 0.9f) {
+            break;
+        }
+        level.error = std::max(level.error, sourceError);
+        sourceIndexCount = level.indices.size();
+        sourceError = level.error;
+        lods.push_back(std::move(level));
+    }
+    return lods;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Foundation/GlmStd.hpp"
+#include "Foundation/ReadonlyArraySpan.hpp"
+
+// Quadric error edge collapse simplification of an indexed triangle list.
+// Vertices are collapsed onto one of their neighbours, so a simplified level is only a new index buffer over the
+// vertices of the source mesh. Vertices shared by an attribute seam (several vertices at one position), an open border
+// or a non manifold edge are locked, which keeps uv and normal discontinuities and open silhouettes in place.
+// See: "Surface Simplification Using Quadric Error Metrics" (Garland and Heckbert 1997)
+class MeshSimplifier {
+public:
+    struct LodLevel {
+        std::vector<uint32_t> indices;
+        // square root of the largest quadric error of the collapses, roughly a distance in object space
+        float error = 0.f;
+    };
+public:
+    // collapses the cheapest edges until targetIndexCount is reached or the next collapse would exceed maxError
+    static auto Simplify(ReadonlyArraySpan<glm::vec3> positions,
+        ReadonlyArraySpan<uint32_t> indices,
+        size_t targetIndexCount,
+        float maxError) -> LodLevel;
+    // every level aims at reduction times the triangles of the previous one. the chain ends after maxLodCount levels
+    // or when a level removes less than 10% of the triangles. the source level is not part of the result
+    static auto GenerateLodChain(ReadonlyArraySpan<glm::vec3> positions,
+        ReadonlyArraySpan<uint32_t> indices,
+        size_t maxLodCount,
+        float reduction,
+        float maxError) -> std::vector<LodLevel>;
+};
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstdint>
 
 struct RenderGroup {
     enum : uint16_t {
@@ -8,7 +9,32 @@ struct RenderGroup {
         eTransparent = 4000,
         ePostProcess = 5000,
     };
+    enum SortPolicy : uint8_t {
+        // group by pipeline and material to minimize state changes, then near to far for early z rejection
+        eStateThenNearToFar,
+        // far to near for correct blending, the state only breaks ties
+        eFarToNear,
+    };
 public:
+    static constexpr auto GetSortPolicy(uint16_t renderGroup) -> SortPolicy {
+        return IsTransparent(renderGroup) ? eFarToNear : eStateThenNearToFar;
+    }
+    // the first render group value of the group that contains renderGroup
+    static constexpr auto GetGroupBase(uint16_t renderGroup) -> uint16_t {
+        if (IsOpaque(renderGroup)) {
+            return 0;
+        }
+        if (IsAlphaTest(renderGroup)) {
+            return eOpaque + 1;
+        }
+        if (IsSkyBox(renderGroup)) {
+            return eSkyBox;
+        }
+        if (IsTransparent(renderGroup)) {
+            return eSkyBox + 1;
+        }
+        return eTransparent + 1;
+    }
     static constexpr bool IsOpaque(uint16_t renderGroup) {
         return renderGroup <= eOpaque;
     }
@@ -0,0 +1,8 @@
+#include "RenderObject.h"
+
+auto RenderObject::GetDrawSubMeshes() const -> std::span<const SubMesh> {
+    if (!visibleSubMeshes.empty()) {
+        return visibleSubMeshes;
+    }
+    return pMesh->GetSubMeshes(lodIndex);
+}
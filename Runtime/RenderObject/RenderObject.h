@@ -1,8 +1,11 @@
 #pragma once
 #include <cstdint>
+#include <span>
+#include "Foundation/BoundingVolume.hpp"
 #include "Renderer/RenderUtils/ConstantBufferHelper.h"
+#include "Renderer/RenderUtils/GPUSceneTable.h"
+#include "RenderObject/Mesh.h"
 
-class Mesh;
 class Transform;
 class Material;
 
@@ -13,6 +16,16 @@ struct RenderObject {
 	const Transform			*pTransform		= nullptr;
 	cbuffer::CbPreObject	 cbPreObject	= {};
 	uint16_t				 priority		= 0;
+	AABB					 worldBounds	= {};
+	// level of detail of the mesh, selected by the MeshRenderer
+	uint8_t					 lodIndex		= 0;
+	// index of cbPreObject in the object buffer of the GPUScene
+	uint32_t				 objectIndex		= GPUSceneTable::kInvalidSlot;
+	// sub mesh ranges inside the frustum, only set for meshes with several sub meshes such as static batches
+	std::span<const SubMesh> visibleSubMeshes = {};
+public:
+	// the visible ranges when the sub meshes were culled, otherwise all sub meshes of the selected level
+	auto GetDrawSubMeshes() const -> std::span<const SubMesh>;
 };
 
 // clang-format off
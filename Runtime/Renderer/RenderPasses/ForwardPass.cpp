@@ -76,7 +76,7 @@ void ForwardPass::DrawBatchInternal(std::span<RenderObject *const> batch, const
         // texture list bindless
         pGfxCtx->SetDynamicViews(eTextureList, bindlessCollection.GetHandles());
         for (size_t i = index; i != batchIdx; ++i) {
-            pGfxCtx->SetGraphicsRootDynamicConstantBuffer(ePreObject, batch[index]->cbPreObject);
+            pGfxCtx->SetGraphicsRootDynamicConstantBuffer(ePreObject, batch[i]->cbPreObject);
 
             const Material *pMaterial = batch[i]->pMaterial;
             Material::CbPreMaterial cbMaterial = pMaterial->_cbPreMaterial;
@@ -99,7 +99,7 @@ void ForwardPass::DrawBatchInternal(std::span<RenderObject *const> batch, const
                 pGfxCtx->SetIndexBuffer(pGpuMeshData->GetIndexBufferView());
             }
 
-            for (const SubMesh &subMesh : pMesh->GetSubMeshes()) {
+            for (const SubMesh &subMesh : batch[i]->GetDrawSubMeshes()) {
                 if (subMesh.indexCount > 0) {
                     pGfxCtx->DrawIndexedInstanced(subMesh.indexCount,
                         1,
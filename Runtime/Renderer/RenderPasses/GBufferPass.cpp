@@ -4,10 +4,12 @@
 #include "D3d12/D3dStd.h"
 #include "D3d12/Device.h"
 #include "Foundation/ColorUtil.hpp"
+#include "Foundation/Memory/FrameArena.h"
 #include "Renderer/GfxDevice.h"
 #include "Renderer/RenderUtils/RenderSetting.h"
 #include "Renderer/RenderUtils/UserMarker.h"
 #include "Renderer/RenderUtils/ConstantBufferHelper.h"
+#include "Renderer/RenderUtils/GPUScene.h"
 #include "RenderObject/GPUMeshData.h"
 #include "RenderObject/Material.h"
 #include "RenderObject/Mesh.h"
@@ -16,6 +18,7 @@
 #include "RenderObject/VertexSemantic.hpp"
 #include "ShaderLoader/ShaderManager.h"
 #include "Utils/AssetProjectSetting.h"
+#include <cstring>
 
 GBufferPass::GBufferPass() : _generateMotionVector(false), _width(0), _height(0) {
 }
@@ -28,8 +31,10 @@ void GBufferPass::OnCreate(bool generateMotionVector) {
 
     _pRootSignature = dx::RootSignature::Create(eMaxNumRootParam, 6);
     _pRootSignature->At(eCbPrePass).InitAsBufferCBV(0);
-    _pRootSignature->At(eCbPreObject).InitAsBufferCBV(1);
-    _pRootSignature->At(eCbMaterial).InitAsBufferCBV(2);
+    _pRootSignature->At(eDrawConstants).InitAsConstants(sizeof(DrawConstants) / sizeof(uint32_t), 1);
+    _pRootSignature->At(eInstanceData).InitAsBufferSRV(0, 1);
+    _pRootSignature->At(eObjectBuffer).InitAsBufferSRV(1, 1);
+    _pRootSignature->At(eMaterialBuffer).InitAsBufferSRV(2, 1);
 
     // eTextureList enable bindless
     CD3DX12_DESCRIPTOR_RANGE1 range = {
@@ -139,14 +144,35 @@ void GBufferPass::DrawBatchInternal(std::span<RenderObject *const> batch, const
     pGfxCtx->SetPipelineState(pPipelineState);
     pGfxCtx->SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     pGfxCtx->SetGraphicsRootConstantBufferView(eCbPrePass, args.cbPrePassCBuffer);
+    GPUScene *pGPUScene = GPUScene::GetInstance();
+    pGfxCtx->SetGraphicsRootShaderResourceView(eObjectBuffer, pGPUScene->GetObjectBufferAddress());
+    pGfxCtx->SetGraphicsRootShaderResourceView(eMaterialBuffer, pGPUScene->GetMaterialBufferAddress());
     using TextureType = Material::TextureType;
+    using DrawItem = InstancingBatchBuilder::Batch;
+
+#if ENABLE_INSTANCING
+    // runs of the same mesh and material are drawn once, the instance buffer holds the object index of each instance
+    _instancingBatchBuilder.Build(batch);
+    const std::vector<uint32_t> &instances = _instancingBatchBuilder.GetInstances();
+    size_t instanceBufferSize = instances.size() * sizeof(uint32_t);
+    dx::DynamicBufferAllocator::AllocInfo instanceBuffer = pGfxCtx->AllocBuffer(instanceBufferSize, sizeof(uint32_t));
+    std::memcpy(instanceBuffer.pBuffer, instances.data(), instanceBufferSize);
+    pGfxCtx->SetGraphicsRootShaderResourceView(eInstanceData, instanceBuffer.virtualAddress);
+    std::span<const DrawItem> drawItems = _instancingBatchBuilder.GetBatches();
+#else
+    FrameVector<DrawItem> drawItemList;
+    for (RenderObject *pRenderObject : batch) {
+        drawItemList.push_back(DrawItem{pRenderObject, 0, 1});
+    }
+    std::span<const DrawItem> drawItems = drawItemList;
+#endif
 
     size_t index = 0;
-    while (index < batch.size()) {
+    while (index < drawItems.size()) {
         dx::BindlessCollection bindlessCollection;
         size_t batchIdx = index;
-        while (batchIdx < batch.size() && bindlessCollection.EnsureCapacity(TextureType::eMaxNum)) {
-            const Material *pMaterial = batch[batchIdx]->pMaterial;
+        while (batchIdx < drawItems.size() && bindlessCollection.EnsureCapacity(TextureType::eMaxNum)) {
+            const Material *pMaterial = drawItems[batchIdx].pRenderObject->pMaterial;
             for (const dx::SRV &srv : pMaterial->_textureHandles) {
                 bindlessCollection.AddHandle(srv.GetCpuHandle());
             }
@@ -156,38 +182,45 @@ void GBufferPass::DrawBatchInternal(std::span<RenderObject *const> batch, const
         // texture list bindless
         pGfxCtx->SetDynamicViews(eTextureList, bindlessCollection.GetHandles());
         for (size_t i = index; i != batchIdx; ++i) {
-            pGfxCtx->SetGraphicsRootDynamicConstantBuffer(eCbPreObject, batch[i]->cbPreObject);
-
-            const Material *pMaterial = batch[i]->pMaterial;
-            Material::CbPreMaterial cbMaterial = pMaterial->_cbPreMaterial;
-            cbMaterial.albedoTexIndex = bindlessCollection.GetHandleIndex(
+            const DrawItem &drawItem = drawItems[i];
+            const RenderObject *pRenderObject = drawItem.pRenderObject;
+            const Material *pMaterial = pRenderObject->pMaterial;
+
+            // SV_InstanceID starts at zero for every draw, firstInstance offsets it into the instance buffer
+            DrawConstants drawConstants = {};
+            drawConstants.objectIndex = pRenderObject->objectIndex;
+            drawConstants.firstInstance = drawItem.firstInstance;
+            drawConstants.materialIndex = pMaterial->_gpuSceneIndex;
+            drawConstants.albedoTexIndex = bindlessCollection.GetHandleIndex(
                 pMaterial->_textureHandles[TextureType::eAlbedoTex].GetCpuHandle());
-            cbMaterial.ambientOcclusionTexIndex = bindlessCollection.GetHandleIndex(
+            drawConstants.ambientOcclusionTexIndex = bindlessCollection.GetHandleIndex(
                 pMaterial->_textureHandles[TextureType::eAmbientOcclusionTex].GetCpuHandle());
-            cbMaterial.emissionTexIndex = bindlessCollection.GetHandleIndex(
+            drawConstants.emissionTexIndex = bindlessCollection.GetHandleIndex(
                 pMaterial->_textureHandles[TextureType::eEmissionTex].GetCpuHandle());
-            cbMaterial.metalRoughnessTexIndex = bindlessCollection.GetHandleIndex(
+            drawConstants.metalRoughnessTexIndex = bindlessCollection.GetHandleIndex(
                 pMaterial->_textureHandles[TextureType::eMetalRoughnessTex].GetCpuHandle());
-            cbMaterial.normalTexIndex = bindlessCollection.GetHandleIndex(
+            drawConstants.normalTexIndex = bindlessCollection.GetHandleIndex(
                 pMaterial->_textureHandles[TextureType::eNormalTex].GetCpuHandle());
-            pGfxCtx->SetGraphicsRootDynamicConstantBuffer(eCbMaterial, cbMaterial);
+            pGfxCtx->SetGraphics32Constants(eDrawConstants,
+                sizeof(DrawConstants) / sizeof(uint32_t),
+                &drawConstants);
 
-            const Mesh *pMesh = batch[i]->pMesh;
+            const Mesh *pMesh = pRenderObject->pMesh;
             const GPUMeshData *pGpuMeshData = pMesh->GetGPUMeshData();
             pGfxCtx->SetVertexBuffers(0, pGpuMeshData->GetVertexBufferView());
             if (pMesh->GetIndexCount() > 0) {
                 pGfxCtx->SetIndexBuffer(pGpuMeshData->GetIndexBufferView());
             }
 
-            for (const SubMesh &subMesh : pMesh->GetSubMeshes()) {
+            for (const SubMesh &subMesh : pRenderObject->GetDrawSubMeshes()) {
                 if (subMesh.indexCount > 0) {
                     pGfxCtx->DrawIndexedInstanced(subMesh.indexCount,
-                        1,
+                        drawItem.instanceCount,
                         subMesh.baseIndexLocation,
                         subMesh.baseVertexLocation,
                         0);
                 } else {
-                    pGfxCtx->DrawInstanced(subMesh.vertexCount, 1, subMesh.baseVertexLocation, 0);
+                    pGfxCtx->DrawInstanced(subMesh.vertexCount, drawItem.instanceCount, subMesh.baseVertexLocation, 0);
                 }
             }
         }
@@ -204,6 +237,10 @@ auto GBufferPass::GetPipelineState(RenderObject *pRenderObject) -> ID3D12Pipelin
 
     dx::DefineList defineList = pMaterial->_defineList.Clone();
     defineList.Set("GENERATE_MOTION_VECTOR");
+    defineList.Set("ENABLE_GPU_SCENE");
+#if ENABLE_INSTANCING
+    defineList.Set("ENABLE_INSTANCING");
+#endif
 
     ShaderLoadInfo shaderLoadInfo;
     shaderLoadInfo.sourcePath = AssetProjectSetting::ToAssetPath("Shaders/Material.hlsl");
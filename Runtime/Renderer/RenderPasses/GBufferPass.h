@@ -3,6 +3,7 @@
 #include "D3d12/DescriptorHandle.h"
 #include "D3d12/Texture.h"
 #include "RenderPass.h"
+#include "Renderer/RenderUtils/InstancingBatchBuilder.h"
 #include "Utils/GlobalCallbacks.h"
 
 struct RenderObject;
@@ -31,13 +32,31 @@ public:
     // clang-format on
 
     enum RootParam {
-        eCbPreObject,
-        eCbMaterial,
+        // DrawConstants of the draw
+        eDrawConstants,
         eTextureList,
         eCbPrePass,
+        // the object and the material buffer of the GPUScene
+        eObjectBuffer,
+        eMaterialBuffer,
+        // object indices of the instances, used with ENABLE_INSTANCING
+        eInstanceData,
         eMaxNumRootParam
     };
 
+    // the per draw part of the constants, the rest is read from the GPUScene by index.
+    // the texture indices point into the bindless list of the draw, so they can not live in the material buffer
+    struct DrawConstants {
+        uint32_t objectIndex;
+        uint32_t firstInstance;
+        uint32_t materialIndex;
+        int albedoTexIndex;
+        int ambientOcclusionTexIndex;
+        int emissionTexIndex;
+        int metalRoughnessTexIndex;
+        int normalTexIndex;
+    };
+
     enum {
 	    eAlbedoMetallicTex,
         ePackNormalRoughnessTex,
@@ -64,5 +83,6 @@ private:
     size_t                          _height;
     PipelineStateMap                _pipelineStateMap;
     SharedPtr<dx::RootSignature>    _pRootSignature;
+    InstancingBatchBuilder          _instancingBatchBuilder;
     // clang-format on
 };
\ No newline at end of file
@@ -316,6 +316,8 @@ void RayTracingShadowPass::BuildShaderRecode(ReadonlyArraySpan<RayTracingGeometr
     dispatchRaysDesc.missShaderTable.push_back(dx::ShaderRecode(pMissShaderIdentifier));
 
     auto pEmptyLocalRootSignature = BuildInResource::Get().GetEmptyLocalRootSignature();
+    // all hit groups share one array, the context commits it to the descriptor heap only once
+    std::shared_ptr<dx::DescriptorHandleArray> pAlbedoHandleArray = bindlessCollection.CreateHandleArrayPtr();
 
     uint materialIndex = 0;
     for (const RayTracingGeometry &geometry : geometries) {
@@ -349,7 +351,7 @@ void RayTracingShadowPass::BuildShaderRecode(ReadonlyArraySpan<RayTracingGeometr
         localRootParameterData.SetView(eVertexBuffer, pGpuMeshData->GetVertexBufferView().BufferLocation);
         localRootParameterData.SetView(eIndexBuffer, pGpuMeshData->GetIndexBufferView().BufferLocation);
         localRootParameterData.SetView(eInstanceMaterial, shadowMaterialBuffer);
-        localRootParameterData.SetDescriptorTable(eAlbedoTextureList, bindlessCollection.GetHandleArrayPtr());
+        localRootParameterData.SetDescriptorTable(eAlbedoTextureList, pAlbedoHandleArray);
         dispatchRaysDesc.hitGroupTable.push_back(std::move(shaderRecode));
     }
 }
@@ -0,0 +1,149 @@
+#include "GPUScene.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include "D3d12/Buffer.h"
+#include "D3d12/Context.h"
+#include "Renderer/GfxDevice.h"
+#include "RenderObject/Material.h"
+#include "RenderObject/RenderObject.h"
+
+GPUScene::GPUScene()
+    : _objectBuffer(sizeof(cbuffer::CbPreObject)),
+      _materialBuffer(sizeof(Material::CbPreMaterial)),
+      _uploadedBytes(0) {
+    _objectBuffer.name = "GPUScene::ObjectBuffer";
+    _materialBuffer.name = "GPUScene::MaterialBuffer";
+}
+
+GPUScene::~GPUScene() {
+}
+
+void GPUScene::OnCreate() {
+    // the passes bind the buffers before the first object or material may exist
+    CreateBuffer(_objectBuffer, kInitialCapacity);
+    CreateBuffer(_materialBuffer, kInitialCapacity);
+}
+
+void GPUScene::OnDestroy() {
+    _objectBuffer.pBuffer = nullptr;
+    _materialBuffer.pBuffer = nullptr;
+}
+
+void GPUScene::AddObject(RenderObject *pRenderObject) {
+    AddSlot(_objectBuffer, &pRenderObject->objectIndex, &pRenderObject->cbPreObject);
+}
+
+void GPUScene::RemoveObject(RenderObject *pRenderObject) {
+    RemoveSlot(_objectBuffer, &pRenderObject->objectIndex);
+}
+
+void GPUScene::UpdateObject(const RenderObject *pRenderObject) {
+    if (pRenderObject->objectIndex != GPUSceneTable::kInvalidSlot) {
+        _objectBuffer.table.Write(pRenderObject->objectIndex, &pRenderObject->cbPreObject);
+    }
+}
+
+void GPUScene::AddMaterial(Material *pMaterial) {
+    AddSlot(_materialBuffer, &pMaterial->_gpuSceneIndex, &pMaterial->_cbPreMaterial);
+}
+
+void GPUScene::RemoveMaterial(Material *pMaterial) {
+    RemoveSlot(_materialBuffer, &pMaterial->_gpuSceneIndex);
+}
+
+void GPUScene::UpdateMaterial(const Material *pMaterial) {
+    if (pMaterial->_gpuSceneIndex != GPUSceneTable::kInvalidSlot) {
+        _materialBuffer.table.Write(pMaterial->_gpuSceneIndex, &pMaterial->_cbPreMaterial);
+    }
+}
+
+void GPUScene::AddSlot(Buffer &buffer, uint32_t *pSlot, const void *pData) {
+    Assert(*pSlot == GPUSceneTable::kInvalidSlot);
+    *pSlot = buffer.table.Allocate();
+    buffer.table.Write(*pSlot, pData);
+    if (buffer.slotOwners.size() < buffer.table.GetSlotCount()) {
+        buffer.slotOwners.resize(buffer.table.GetSlotCount(), nullptr);
+    }
+    buffer.slotOwners[*pSlot] = pSlot;
+}
+
+void GPUScene::RemoveSlot(Buffer &buffer, uint32_t *pSlot) {
+    if (*pSlot == GPUSceneTable::kInvalidSlot) {
+        return;
+    }
+    buffer.table.Free(*pSlot);
+    buffer.slotOwners[*pSlot] = nullptr;
+    buffer.slotOwners.resize(buffer.table.GetSlotCount());
+    *pSlot = GPUSceneTable::kInvalidSlot;
+}
+
+void GPUScene::CreateBuffer(Buffer &buffer, size_t capacity) {
+    buffer.pBuffer = dx::Buffer::CreateStatic(GfxDevice::GetInstance()->GetDevice(), capacity * buffer.table.GetStride());
+    buffer.pBuffer->SetName(buffer.name);
+}
+
+void GPUScene::Upload(dx::GraphicsContext *pGfxCtx) {
+    _uploadedBytes = 0;
+    UploadBuffer(pGfxCtx, _objectBuffer);
+    UploadBuffer(pGfxCtx, _materialBuffer);
+}
+
+void GPUScene::UploadBuffer(dx::GraphicsContext *pGfxCtx, Buffer &buffer) {
+    GPUSceneTable &table = buffer.table;
+    if (table.GetFragmentation() > kDefragmentThreshold) {
+        _moves.clear();
+        table.Defragment(_moves);
+        for (const GPUSceneTable::Move &move : _moves) {
+            uint32_t *pSlot = buffer.slotOwners[move.from];
+            *pSlot = move.to;
+            buffer.slotOwners[move.to] = pSlot;
+        }
+        buffer.slotOwners.resize(table.GetSlotCount());
+    }
+
+    // a grown buffer starts empty, every used slot is copied again
+    size_t requiredSize = table.GetSlotCount() * table.GetStride();
+    if (requiredSize > 0 && (buffer.pBuffer == nullptr || buffer.pBuffer->GetBufferSize() < requiredSize)) {
+        CreateBuffer(buffer, std::bit_ceil(std::max<size_t>(table.GetSlotCount(), kInitialCapacity)));
+        table.MarkAllDirty();
+    }
+
+    _dirtyRanges.clear();
+    table.CollectDirtyRanges(_dirtyRanges, kMaxUploadGap);
+    table.ClearDirty();
+    if (_dirtyRanges.empty()) {
+        return;
+    }
+
+    size_t uploadSize = 0;
+    for (const GPUSceneTable::Range &range : _dirtyRanges) {
+        uploadSize += range.count * table.GetStride();
+    }
+    dx::DynamicBufferAllocator::AllocInfo allocInfo = pGfxCtx->AllocBuffer(uploadSize, sizeof(glm::vec4));
+
+    ID3D12Resource *pResource = buffer.pBuffer->GetResource();
+    pGfxCtx->Transition(pResource, D3D12_RESOURCE_STATE_COPY_DEST);
+    size_t srcOffset = 0;
+    for (const GPUSceneTable::Range &range : _dirtyRanges) {
+        size_t size = range.count * table.GetStride();
+        std::memcpy(allocInfo.pBuffer + srcOffset, table.GetData(range.first), size);
+        pGfxCtx->CopyBufferRegion(pResource,
+            range.first * table.GetStride(),
+            allocInfo.pResource,
+            allocInfo.offset + srcOffset,
+            size);
+        srcOffset += size;
+    }
+    pGfxCtx->Transition(pResource,
+        D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    _uploadedBytes += uploadSize;
+}
+
+auto GPUScene::GetObjectBufferAddress() const -> D3D12_GPU_VIRTUAL_ADDRESS {
+    return _objectBuffer.pBuffer != nullptr ? _objectBuffer.pBuffer->GetResource()->GetGPUVirtualAddress() : 0;
+}
+
+auto GPUScene::GetMaterialBufferAddress() const -> D3D12_GPU_VIRTUAL_ADDRESS {
+    return _materialBuffer.pBuffer != nullptr ? _materialBuffer.pBuffer->GetResource()->GetGPUVirtualAddress() : 0;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "D3d12/D3dStd.h"
+#include "Foundation/Singleton.hpp"
+#include "Foundation/Memory/SharedPtr.hpp"
+#include "GPUSceneTable.h"
+
+struct RenderObject;
+class Material;
+
+namespace dx {
+class Buffer;
+class GraphicsContext;
+}    // namespace dx
+
+// Persistent GPU buffers of the per object and the per material constants, draws address them by index.
+// The owners write their constants when they change, Upload copies the dirty ranges into the static buffers once per
+// frame, so the upload size follows the changes instead of the number of draws.
+class GPUScene : public Singleton<GPUScene> {
+public:
+    static constexpr size_t kInitialCapacity = 1024;
+    // clean slots between two dirty ranges that are copied along instead of starting a new copy
+    static constexpr uint32_t kMaxUploadGap = 4;
+    // the tables are compacted when more of their slots are holes
+    static constexpr float kDefragmentThreshold = 0.25f;
+public:
+    GPUScene();
+    ~GPUScene() override;
+    void OnCreate();
+    void OnDestroy();
+    void AddObject(RenderObject *pRenderObject);
+    void RemoveObject(RenderObject *pRenderObject);
+    void UpdateObject(const RenderObject *pRenderObject);
+    void AddMaterial(Material *pMaterial);
+    void RemoveMaterial(Material *pMaterial);
+    void UpdateMaterial(const Material *pMaterial);
+    // records the copies of the dirty ranges, call before the passes that read the buffers
+    void Upload(dx::GraphicsContext *pGfxCtx);
+    auto GetObjectBufferAddress() const -> D3D12_GPU_VIRTUAL_ADDRESS;
+    auto GetMaterialBufferAddress() const -> D3D12_GPU_VIRTUAL_ADDRESS;
+    // bytes copied by the last Upload
+    auto GetUploadedBytes() const -> size_t {
+        return _uploadedBytes;
+    }
+private:
+    struct Buffer {
+        explicit Buffer(size_t stride) : table(stride) {
+        }
+    public:
+        GPUSceneTable table;
+        // the index field of the owner of every slot, updated when the slot moves
+        std::vector<uint32_t *> slotOwners;
+        SharedPtr<dx::Buffer> pBuffer;
+        std::string name;
+    };
+    static void AddSlot(Buffer &buffer, uint32_t *pSlot, const void *pData);
+    static void RemoveSlot(Buffer &buffer, uint32_t *pSlot);
+    static void CreateBuffer(Buffer &buffer, size_t capacity);
+    void UploadBuffer(dx::GraphicsContext *pGfxCtx, Buffer &buffer);
+private:
+    // clang-format off
+    Buffer                              _objectBuffer;
+    Buffer                              _materialBuffer;
+    std::vector<GPUSceneTable::Range>   _dirtyRanges;
+    std::vector<GPUSceneTable::Move>    _moves;
+    size_t                              _uploadedBytes;
+    // clang-format on
+};
@@ -0,0 +1,132 @@
+#include "GPUSceneTable.h"
+#include <algorithm>
+#include <cstring>
+#include "Foundation/Exception.h"
+
+GPUSceneTable::GPUSceneTable(size_t stride) : _stride(stride), _usedCount(0) {
+}
+
+auto GPUSceneTable::Allocate() -> uint32_t {
+    uint32_t slot = kInvalidSlot;
+    while (!_freeList.empty() && slot == kInvalidSlot) {
+        uint32_t candidate = _freeList.top();
+        _freeList.pop();
+        if (candidate < _used.size() && _used[candidate] == 0) {
+            slot = candidate;
+        }
+    }
+    if (slot == kInvalidSlot) {
+        slot = static_cast<uint32_t>(_used.size());
+        _used.push_back(0);
+        _dirty.push_back(0);
+        _data.resize(_data.size() + _stride);
+    }
+    _used[slot] = 1;
+    ++_usedCount;
+    return slot;
+}
+
+void GPUSceneTable::Free(uint32_t slot) {
+    Assert(IsUsed(slot));
+    _used[slot] = 0;
+    _dirty[slot] = 0;
+    --_usedCount;
+    _freeList.push(slot);
+
+    // the free slots at the end are cut off, the free list drops them lazily
+    size_t slotCount = _used.size();
+    while (slotCount > 0 && _used[slotCount - 1] == 0) {
+        --slotCount;
+    }
+    _used.resize(slotCount);
+    _dirty.resize(slotCount);
+    _data.resize(slotCount * _stride);
+}
+
+void GPUSceneTable::Write(uint32_t slot, const void *pData) {
+    Assert(IsUsed(slot));
+    std::memcpy(_data.data() + slot * _stride, pData, _stride);
+    MarkDirty(slot);
+}
+
+void GPUSceneTable::MarkAllDirty() {
+    for (uint32_t slot = 0; slot < _used.size(); ++slot) {
+        if (_used[slot] != 0) {
+            MarkDirty(slot);
+        }
+    }
+}
+
+void GPUSceneTable::MarkDirty(uint32_t slot) {
+    if (_dirty[slot] == 0) {
+        _dirty[slot] = 1;
+        _dirtySlots.push_back(slot);
+    }
+}
+
+void GPUSceneTable::CollectDirtyRanges(std::vector<Range> &ranges, uint32_t maxGap) {
+    // sorted and compacted in place, the upload of every frame with a moving object must not allocate.
+    // freed or cut off since it was written, or written again after a free
+    std::erase_if(_dirtySlots, [&](uint32_t slot) { return slot >= _dirty.size() || _dirty[slot] == 0; });
+    std::ranges::sort(_dirtySlots);
+    _dirtySlots.erase(std::ranges::unique(_dirtySlots).begin(), _dirtySlots.end());
+
+    for (uint32_t slot : _dirtySlots) {
+        if (!ranges.empty()) {
+            Range &last = ranges.back();
+            uint32_t end = last.first + last.count;
+            if (slot < end) {
+                continue;
+            }
+            if (slot - end <= maxGap) {
+                last.count = slot - last.first + 1;
+                continue;
+            }
+        }
+        ranges.push_back(Range{slot, 1});
+    }
+}
+
+void GPUSceneTable::ClearDirty() {
+    for (uint32_t slot : _dirtySlots) {
+        if (slot < _dirty.size()) {
+            _dirty[slot] = 0;
+        }
+    }
+    _dirtySlots.clear();
+}
+
+void GPUSceneTable::Defragment(std::vector<Move> &moves) {
+    uint32_t hole = 0;
+    uint32_t last = static_cast<uint32_t>(_used.size());
+    while (true) {
+        while (hole < last && _used[hole] != 0) {
+            ++hole;
+        }
+        while (last > hole && _used[last - 1] == 0) {
+            --last;
+        }
+        if (last == 0 || hole >= last - 1) {
+            break;
+        }
+        uint32_t from = last - 1;
+        std::memcpy(_data.data() + hole * _stride, _data.data() + from * _stride, _stride);
+        _used[hole] = 1;
+        _used[from] = 0;
+        _dirty[from] = 0;
+        MarkDirty(hole);
+        moves.push_back(Move{from, hole});
+    }
+
+    _used.resize(_usedCount);
+    _dirty.resize(_usedCount);
+    _data.resize(_usedCount * _stride);
+    _freeList = FreeList{};
+}
+
+auto GPUSceneTable::GetFragmentation() const -> float {
+    if (_used.empty()) {
+        return 0.f;
+    }
+    return static_cast<float>(_used.size() - _usedCount) / static_cast<float>(_used.size());
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+// CPU mirror of one persistent GPU array of fixed size elements, it does not depend on the GPU.
+// Slots are handed out lowest first, writes go to the mirror and mark the slot dirty, and the dirty slots are coalesced
+// into ranges for the upload. Defragment moves the highest used slots into the holes below them, so the used slots stay
+// dense and the GPU buffer does not grow with the churn.
+class GPUSceneTable {
+public:
+    static constexpr uint32_t kInvalidSlot = static_cast<uint32_t>(-1);
+    struct Range {
+        uint32_t first;
+        uint32_t count;
+    };
+    struct Move {
+        uint32_t from;
+        uint32_t to;
+    };
+public:
+    explicit GPUSceneTable(size_t stride);
+    auto Allocate() -> uint32_t;
+    void Free(uint32_t slot);
+    void Write(uint32_t slot, const void *pData);
+    void MarkAllDirty();
+    // dirty ranges separated by at most maxGap clean slots are merged, a few more bytes for fewer copies.
+    // does not allocate once ranges has grown to the dirty range count
+    void CollectDirtyRanges(std::vector<Range> &ranges, uint32_t maxGap = 0);
+    void ClearDirty();
+    // fills the holes with the highest used slots and appends the moves, the owners have to follow them
+    void Defragment(std::vector<Move> &moves);
+    // fraction of the slots below the high water mark that are free
+    auto GetFragmentation() const -> float;
+    auto GetStride() const -> size_t {
+        return _stride;
+    }
+    // the high water mark, the GPU buffer needs this many elements
+    auto GetSlotCount() const -> uint32_t {
+        return static_cast<uint32_t>(_used.size());
+    }
+    auto GetUsedCount() const -> uint32_t {
+        return _usedCount;
+    }
+    bool IsUsed(uint32_t slot) const {
+        return slot < _used.size() && _used[slot] != 0;
+    }
+    auto GetData(uint32_t slot) const -> const uint8_t * {
+        return _data.data() + slot * _stride;
+    }
+private:
+    using FreeList = std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t>>;
+    void MarkDirty(uint32_t slot);
+private:
+    // clang-format off
+    size_t                  _stride;
+    uint32_t                _usedCount;
+    std::vector<uint8_t>    _data;
+    std::vector<uint8_t>    _used;
+    std::vector<uint8_t>    _dirty;
+    std::vector<uint32_t>   _dirtySlots;
+    // may hold slots that were reused or cut off by a shrink, they are skipped when popped
+    FreeList                _freeList;
+    // clang-format on
+};
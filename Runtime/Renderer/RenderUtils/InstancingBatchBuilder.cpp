@@ -0,0 +1,75 @@
+#include "InstancingBatchBuilder.h"
+#include <algorithm>
+#include <functional>
+#include "RenderObject/RenderObject.h"
+
+static auto CanShareInstances(const RenderObject *pFirst, const RenderObject *pRenderObject) -> bool {
+    return pFirst->visibleSubMeshes.empty() && pRenderObject->visibleSubMeshes.empty() &&
+           pFirst->pMesh == pRenderObject->pMesh && pFirst->lodIndex == pRenderObject->lodIndex;
+}
+
+void InstancingBatchBuilder::Build(std::span<RenderObject *const> renderObjects) {
+    _batches.clear();
+    _instances.clear();
+    _instances.reserve(renderObjects.size());
+
+    size_t index = 0;
+    while (index < renderObjects.size()) {
+        const Material *pMaterial = renderObjects[index]->pMaterial;
+        size_t first = index++;
+        while (index < renderObjects.size() && renderObjects[index]->pMaterial == pMaterial) {
+            ++index;
+        }
+        BuildMaterialRun(renderObjects.subspan(first, index - first));
+    }
+}
+
+void InstancingBatchBuilder::BuildMaterialRun(std::span<RenderObject *const> renderObjects) {
+    _items.clear();
+    for (size_t i = 0; i < renderObjects.size(); ++i) {
+        _items.push_back(Item{renderObjects[i], static_cast<uint32_t>(i)});
+    }
+
+    // the order breaks the ties, so the first item of a group is its earliest object. std::stable_sort would take a
+    // temporary buffer from the heap every frame. Objects with culled sub meshes go behind the others, so the objects
+    // that can share a draw stay contiguous
+    std::sort(_items.begin(), _items.end(), [](const Item &lhs, const Item &rhs) {
+        if (lhs.pRenderObject->pMesh != rhs.pRenderObject->pMesh) {
+            return std::less<const Mesh *>()(lhs.pRenderObject->pMesh, rhs.pRenderObject->pMesh);
+        }
+        if (lhs.pRenderObject->lodIndex != rhs.pRenderObject->lodIndex) {
+            return lhs.pRenderObject->lodIndex < rhs.pRenderObject->lodIndex;
+        }
+        bool lhsCulled = !lhs.pRenderObject->visibleSubMeshes.empty();
+        bool rhsCulled = !rhs.pRenderObject->visibleSubMeshes.empty();
+        if (lhsCulled != rhsCulled) {
+            return rhsCulled;
+        }
+        return lhs.order < rhs.order;
+    });
+
+    // firstInstance holds the first item of the group until the instances are written
+    _runBatches.clear();
+    size_t index = 0;
+    while (index < _items.size()) {
+        const RenderObject *pFirst = _items[index].pRenderObject;
+        size_t first = index++;
+        // objects with culled sub meshes draw their own ranges, they neither start nor join a batch
+        while (index < _items.size() && CanShareInstances(pFirst, _items[index].pRenderObject)) {
+            ++index;
+        }
+        _runBatches.push_back(Batch{pFirst, static_cast<uint32_t>(first), static_cast<uint32_t>(index - first)});
+    }
+    std::sort(_runBatches.begin(), _runBatches.end(), [&](const Batch &lhs, const Batch &rhs) {
+        return _items[lhs.firstInstance].order < _items[rhs.firstInstance].order;
+    });
+
+    for (Batch batch : _runBatches) {
+        uint32_t firstItem = batch.firstInstance;
+        batch.firstInstance = static_cast<uint32_t>(_instances.size());
+        for (uint32_t i = 0; i < batch.instanceCount; ++i) {
+            _instances.push_back(_items[firstItem + i].pRenderObject->objectIndex);
+        }
+        _batches.push_back(batch);
+    }
+}
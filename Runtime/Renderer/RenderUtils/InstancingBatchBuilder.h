@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct RenderObject;
+
+// Groups the render objects of a sorted draw list by mesh, level of detail and material, and packs the GPUScene object
+// indices of their objects into one array that is uploaded as the instance buffer of the draws.
+// The objects of one material are contiguous in a sorted list. Inside such a run the batches are ordered by their first
+// object, so the near to far order of the run is kept between the batches.
+class InstancingBatchBuilder {
+public:
+    struct Batch {
+        // the first object of the batch, it provides the mesh, the level of detail and the material
+        const RenderObject *pRenderObject;
+        uint32_t firstInstance;
+        uint32_t instanceCount;
+    };
+public:
+    void Build(std::span<RenderObject *const> renderObjects);
+    auto GetBatches() const -> const std::vector<Batch> & {
+        return _batches;
+    }
+    auto GetInstances() const -> const std::vector<uint32_t> & {
+        return _instances;
+    }
+private:
+    struct Item {
+        const RenderObject *pRenderObject;
+        uint32_t order;
+    };
+    void BuildMaterialRun(std::span<RenderObject *const> renderObjects);
+private:
+    // clang-format off
+    std::vector<Batch>                      _batches;
+    std::vector<uint32_t>                   _instances;
+    std::vector<Item>                       _items;
+    std::vector<Batch>                      _runBatches;
+    // clang-format on
+};
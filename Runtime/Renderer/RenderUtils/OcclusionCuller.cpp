@@ -0,0 +1,332 @@
+#include "OcclusionCuller.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "Foundation/Exception.h"
+#include "Foundation/JobSystem.h"
+
+OcclusionCuller::OcclusionCuller(uint32_t width, uint32_t height)
+    : _width(width), _height(height), _matViewProj(1.f), _reversedZ(false) {
+    Exception::CondThrow(width > 0 && width % kTileWidth == 0, "The width must be a multiple of {}", kTileWidth);
+    Exception::CondThrow(height > 0 && height % kTileHeight == 0, "The height must be a multiple of {}", kTileHeight);
+    _tileCountX = width / kTileWidth;
+    _tileCountY = height / kTileHeight;
+    _depthBuffer.resize(static_cast<size_t>(width) * height, 1.f);
+    _tileBins.resize(static_cast<size_t>(_tileCountX) * _tileCountY);
+
+    HiZLevel level;
+    level.width = width;
+    level.height = height;
+    _hierarchy.push_back(std::move(level));
+    while (_hierarchy.back().width > 1 || _hierarchy.back().height > 1) {
+        HiZLevel next;
+        next.width = (_hierarchy.back().width + 1) / 2;
+        next.height = (_hierarchy.back().height + 1) / 2;
+        next.minDepth.resize(static_cast<size_t>(next.width) * next.height);
+        next.maxDepth.resize(static_cast<size_t>(next.width) * next.height);
+        _hierarchy.push_back(std::move(next));
+    }
+}
+
+OcclusionCuller::~OcclusionCuller() {
+}
+
+void OcclusionCuller::BeginFrame(const glm::mat4x4 &matViewProj, bool reversedZ) {
+    _matViewProj = matViewProj;
+    _reversedZ = reversedZ;
+    _triangles.clear();
+    for (std::vector<uint32_t> &bin : _tileBins) {
+        bin.clear();
+    }
+    std::fill(_depthBuffer.begin(), _depthBuffer.end(), 1.f);
+    _statistics = Statistics{};
+}
+
+void OcclusionCuller::AddOccluder(const glm::mat4x4 &matWorld,
+    ReadonlyArraySpan<glm::vec3> vertices,
+    ReadonlyArraySpan<uint32_t> indices) {
+
+    if (indices.Count() < 3) {
+        return;
+    }
+    // the indices are validated once up front, the triangle loop reads the vertices unchecked
+    Assert(std::ranges::max(indices) < vertices.Count());
+    const glm::vec3 *pVertices = vertices.Data();
+    const uint32_t *pIndices = indices.Data();
+    glm::mat4x4 matWorldViewProj = _matViewProj * matWorld;
+    for (size_t i = 0; i + 2 < indices.Count(); i += 3) {
+        glm::vec4 v0 = matWorldViewProj * glm::vec4(pVertices[pIndices[i + 0]], 1.f);
+        glm::vec4 v1 = matWorldViewProj * glm::vec4(pVertices[pIndices[i + 1]], 1.f);
+        glm::vec4 v2 = matWorldViewProj * glm::vec4(pVertices[pIndices[i + 2]], 1.f);
+        AddClippedTriangle(v0, v1, v2);
+    }
+    _statistics.occluderTriangleCount += indices.Count() / 3;
+}
+
+auto OcclusionCuller::GetNearDistance(const glm::vec4 &clip) const -> float {
+    return _reversedZ ? clip.w - clip.z : clip.z;
+}
+
+auto OcclusionCuller::ToScreen(const glm::vec4 &clip) const -> glm::vec3 {
+    float invW = 1.f / clip.w;
+    float depth = clip.z * invW;
+    return glm::vec3((clip.x * invW * 0.5f + 0.5f) * static_cast<float>(_width),
+        (0.5f - clip.y * invW * 0.5f) * static_cast<float>(_height),
+        _reversedZ ? 1.f - depth : depth);
+}
+
+void OcclusionCuller::AddClippedTriangle(const glm::vec4 &v0, const glm::vec4 &v1, const glm::vec4 &v2) {
+    // only the near plane needs clipping, the edge functions handle the other planes and depth is clamped to 1
+    glm::vec4 input[3] = { v0, v1, v2 };
+    glm::vec4 polygon[4];
+    size_t vertexCount = 0;
+    for (size_t i = 0; i < 3; ++i) {
+        const glm::vec4 &curr = input[i];
+        const glm::vec4 &next = input[(i + 1) % 3];
+        float currDistance = GetNearDistance(curr);
+        float nextDistance = GetNearDistance(next);
+        if (currDistance >= 0.f) {
+            polygon[vertexCount++] = curr;
+        }
+        if ((currDistance >= 0.f) != (nextDistance >= 0.f)) {
+            float t = currDistance / (currDistance - nextDistance);
+            polygon[vertexCount++] = curr + (next - curr) * t;
+        }
+    }
+    if (vertexCount < 3) {
+        return;
+    }
+
+    glm::vec3 screen[4];
+    for (size_t i = 0; i < vertexCount; ++i) {
+        if (polygon[i].w <= 0.f) {
+            return;
+        }
+        screen[i] = ToScreen(polygon[i]);
+    }
+    AddScreenTriangle(screen[0], screen[1], screen[2]);
+    if (vertexCount == 4) {
+        AddScreenTriangle(screen[0], screen[2], screen[3]);
+    }
+}
+
+void OcclusionCuller::AddScreenTriangle(glm::vec3 p0, glm::vec3 p1, glm::vec3 p2) {
+    float area = (p1.x - p0.x) * (p2.y - p0.y) - (p2.x - p0.x) * (p1.y - p0.y);
+    if (std::abs(area) < 1e-6f) {
+        return;
+    }
+    // occluders are rasterized two sided, flip the winding so that the inside is positive
+    if (area < 0.f) {
+        std::swap(p1, p2);
+        area = -area;
+    }
+
+    float minX = std::min({ p0.x, p1.x, p2.x });
+    float minY = std::min({ p0.y, p1.y, p2.y });
+    float maxX = std::max({ p0.x, p1.x, p2.x });
+    float maxY = std::max({ p0.y, p1.y, p2.y });
+    if (maxX < 0.f || maxY < 0.f || minX >= static_cast<float>(_width) || minY >= static_cast<float>(_height)) {
+        return;
+    }
+
+    ScreenTriangle triangle;
+    const glm::vec3 *points[3] = { &p0, &p1, &p2 };
+    for (size_t i = 0; i < 3; ++i) {
+        const glm::vec3 &a = *points[i];
+        const glm::vec3 &b = *points[(i + 1) % 3];
+        triangle.edgeA[i] = a.y - b.y;
+        triangle.edgeB[i] = b.x - a.x;
+        triangle.edgeC[i] = a.x * b.y - a.y * b.x;
+    }
+
+    // depth is affine in screen space, solve the plane through the three vertices
+    float invArea = 1.f / area;
+    float dz1 = p1.z - p0.z;
+    float dz2 = p2.z - p0.z;
+    triangle.depthA = (dz1 * (p2.y - p0.y) - dz2 * (p1.y - p0.y)) * invArea;
+    triangle.depthB = (dz2 * (p1.x - p0.x) - dz1 * (p2.x - p0.x)) * invArea;
+    // sampled at the pixel center, biased to the farthest depth the plane reaches inside the pixel
+    triangle.depthC = p0.z - triangle.depthA * p0.x - triangle.depthB * p0.y +
+                      0.5f * (std::abs(triangle.depthA) + std::abs(triangle.depthB));
+
+    triangle.minX = std::max(static_cast<int32_t>(std::floor(minX)), 0);
+    triangle.minY = std::max(static_cast<int32_t>(std::floor(minY)), 0);
+    triangle.maxX = std::min(static_cast<int32_t>(std::floor(maxX)), static_cast<int32_t>(_width) - 1);
+    triangle.maxY = std::min(static_cast<int32_t>(std::floor(maxY)), static_cast<int32_t>(_height) - 1);
+
+    uint32_t triangleIndex = static_cast<uint32_t>(_triangles.size());
+    _triangles.push_back(triangle);
+    uint32_t tileMinX = static_cast<uint32_t>(triangle.minX) / kTileWidth;
+    uint32_t tileMinY = static_cast<uint32_t>(triangle.minY) / kTileHeight;
+    uint32_t tileMaxX = static_cast<uint32_t>(triangle.maxX) / kTileWidth;
+    uint32_t tileMaxY = static_cast<uint32_t>(triangle.maxY) / kTileHeight;
+    for (uint32_t tileY = tileMinY; tileY <= tileMaxY; ++tileY) {
+        for (uint32_t tileX = tileMinX; tileX <= tileMaxX; ++tileX) {
+            _tileBins[tileY * _tileCountX + tileX].push_back(triangleIndex);
+        }
+    }
+}
+
+void OcclusionCuller::RasterizeOccluders() {
+    _statistics.rasterizedTriangleCount = _triangles.size();
+    if (!_triangles.empty()) {
+        // every tile owns a disjoint region of the depth buffer, no synchronization is needed
+        JobSystem::GetInstance()->ParallelFor(0, _tileBins.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t tileIndex = begin; tileIndex < end; ++tileIndex) {
+                RasterizeTile(tileIndex);
+            }
+        });
+    }
+    BuildHierarchy();
+}
+
+void OcclusionCuller::RasterizeTile(size_t tileIndex) {
+    int32_t tileX = static_cast<int32_t>(tileIndex % _tileCountX) * static_cast<int32_t>(kTileWidth);
+    int32_t tileY = static_cast<int32_t>(tileIndex / _tileCountX) * static_cast<int32_t>(kTileHeight);
+    for (uint32_t triangleIndex : _tileBins[tileIndex]) {
+        const ScreenTriangle &triangle = _triangles[triangleIndex];
+        int32_t minX = std::max(triangle.minX, tileX);
+        int32_t maxX = std::min(triangle.maxX, tileX + static_cast<int32_t>(kTileWidth) - 1);
+        int32_t minY = std::max(triangle.minY, tileY);
+        int32_t maxY = std::min(triangle.maxY, tileY + static_cast<int32_t>(kTileHeight) - 1);
+        for (int32_t y = minY; y <= maxY; ++y) {
+            float *pRow = _depthBuffer.data() + static_cast<size_t>(y) * _width;
+            float sampleY = static_cast<float>(y) + 0.5f;
+            int32_t x = minX;
+#if GLM_STD_AVX
+            // 8 aligned pixels per iteration, lanes outside the triangle bounds fail the edge test
+            x = minX & ~7;
+            __m256 laneOffset = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+            __m256 edge0Row = _mm256_set1_ps(triangle.edgeB[0] * sampleY + triangle.edgeC[0]);
+            __m256 edge1Row = _mm256_set1_ps(triangle.edgeB[1] * sampleY + triangle.edgeC[1]);
+            __m256 edge2Row = _mm256_set1_ps(triangle.edgeB[2] * sampleY + triangle.edgeC[2]);
+            __m256 depthRow = _mm256_set1_ps(triangle.depthB * sampleY + triangle.depthC);
+            for (; x <= maxX; x += 8) {
+                __m256 sampleX = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffset);
+                __m256 e0 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(triangle.edgeA[0]), sampleX), edge0Row);
+                __m256 e1 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(triangle.edgeA[1]), sampleX), edge1Row);
+                __m256 e2 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(triangle.edgeA[2]), sampleX), edge2Row);
+                __m256 inside = _mm256_and_ps(_mm256_cmp_ps(e0, _mm256_setzero_ps(), _CMP_GE_OQ),
+                    _mm256_and_ps(_mm256_cmp_ps(e1, _mm256_setzero_ps(), _CMP_GE_OQ),
+                        _mm256_cmp_ps(e2, _mm256_setzero_ps(), _CMP_GE_OQ)));
+                if (_mm256_movemask_ps(inside) == 0) {
+                    continue;
+                }
+                __m256 depth = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(triangle.depthA), sampleX), depthRow);
+                depth = _mm256_max_ps(depth, _mm256_setzero_ps());
+                __m256 old = _mm256_loadu_ps(pRow + x);
+                _mm256_storeu_ps(pRow + x, _mm256_blendv_ps(old, _mm256_min_ps(old, depth), inside));
+            }
+#endif
+            for (; x <= maxX; ++x) {
+                float sampleX = static_cast<float>(x) + 0.5f;
+                float e0 = triangle.edgeA[0] * sampleX + triangle.edgeB[0] * sampleY + triangle.edgeC[0];
+                float e1 = triangle.edgeA[1] * sampleX + triangle.edgeB[1] * sampleY + triangle.edgeC[1];
+                float e2 = triangle.edgeA[2] * sampleX + triangle.edgeB[2] * sampleY + triangle.edgeC[2];
+                if (e0 >= 0.f && e1 >= 0.f && e2 >= 0.f) {
+                    float depth = triangle.depthA * sampleX + triangle.depthB * sampleY + triangle.depthC;
+                    pRow[x] = std::min(pRow[x], std::max(depth, 0.f));
+                }
+            }
+        }
+    }
+}
+
+void OcclusionCuller::BuildHierarchy() {
+    for (size_t level = 1; level < _hierarchy.size(); ++level) {
+        HiZLevel &dst = _hierarchy[level];
+        uint32_t srcWidth = _hierarchy[level - 1].width;
+        uint32_t srcHeight = _hierarchy[level - 1].height;
+        for (uint32_t y = 0; y < dst.height; ++y) {
+            for (uint32_t x = 0; x < dst.width; ++x) {
+                // odd sizes clamp to the last texel instead of reading past the edge
+                uint32_t x0 = x * 2;
+                uint32_t y0 = y * 2;
+                uint32_t x1 = std::min(x0 + 1, srcWidth - 1);
+                uint32_t y1 = std::min(y0 + 1, srcHeight - 1);
+                float minDepth = std::min(std::min(GetDepth(level - 1, x0, y0, false), GetDepth(level - 1, x1, y0, false)),
+                    std::min(GetDepth(level - 1, x0, y1, false), GetDepth(level - 1, x1, y1, false)));
+                float maxDepth = std::max(std::max(GetDepth(level - 1, x0, y0, true), GetDepth(level - 1, x1, y0, true)),
+                    std::max(GetDepth(level - 1, x0, y1, true), GetDepth(level - 1, x1, y1, true)));
+                dst.minDepth[y * dst.width + x] = minDepth;
+                dst.maxDepth[y * dst.width + x] = maxDepth;
+            }
+        }
+    }
+}
+
+auto OcclusionCuller::GetDepth(size_t level, uint32_t x, uint32_t y, bool farthest) const -> float {
+    if (level == 0) {
+        return _depthBuffer[static_cast<size_t>(y) * _width + x];
+    }
+    const HiZLevel &hiz = _hierarchy[level];
+    size_t index = static_cast<size_t>(y) * hiz.width + x;
+    return farthest ? hiz.maxDepth[index] : hiz.minDepth[index];
+}
+
+bool OcclusionCuller::IsVisible(const AABB &worldBounds) {
+    ++_statistics.testedCount;
+    if (!worldBounds.IsValid()) {
+        return true;
+    }
+
+    glm::vec2 screenMin(std::numeric_limits<float>::max());
+    glm::vec2 screenMax(std::numeric_limits<float>::lowest());
+    float nearestDepth = 1.f;
+    for (size_t i = 0; i < 8; ++i) {
+        glm::vec3 corner((i & 1) ? worldBounds.max.x : worldBounds.min.x,
+            (i & 2) ? worldBounds.max.y : worldBounds.min.y,
+            (i & 4) ? worldBounds.max.z : worldBounds.min.z);
+        glm::vec4 clip = _matViewProj * glm::vec4(corner, 1.f);
+        // the box crosses the near plane, it covers the whole screen in the worst case
+        if (GetNearDistance(clip) <= 0.f || clip.w <= 0.f) {
+            return true;
+        }
+        glm::vec3 screen = ToScreen(clip);
+        screenMin = glm::min(screenMin, glm::vec2(screen.x, screen.y));
+        screenMax = glm::max(screenMax, glm::vec2(screen.x, screen.y));
+        nearestDepth = std::min(nearestDepth, screen.z);
+    }
+
+    // leave the boxes outside the screen to the frustum culling
+    if (screenMax.x < 0.f || screenMax.y < 0.f || screenMin.x >= static_cast<float>(_width) ||
+        screenMin.y >= static_cast<float>(_height) || nearestDepth <= 0.f) {
+        return true;
+    }
+
+    glm::uvec4 pixelRect;
+    pixelRect.x = static_cast<uint32_t>(std::max(std::floor(screenMin.x), 0.f));
+    pixelRect.y = static_cast<uint32_t>(std::max(std::floor(screenMin.y), 0.f));
+    pixelRect.z = static_cast<uint32_t>(std::min(std::floor(screenMax.x), static_cast<float>(_width - 1)));
+    pixelRect.w = static_cast<uint32_t>(std::min(std::floor(screenMax.y), static_cast<float>(_height - 1)));
+    bool occluded = IsNodeOccluded(_hierarchy.size() - 1, 0, 0, pixelRect, nearestDepth);
+    _statistics.occludedCount += static_cast<size_t>(occluded);
+    return !occluded;
+}
+
+bool OcclusionCuller::IsNodeOccluded(size_t level, uint32_t x, uint32_t y, const glm::uvec4 &pixelRect, float depth) const {
+    // the node lies entirely behind the occludee, nothing in it can hide the box
+    if (depth <= GetDepth(level, x, y, false)) {
+        return false;
+    }
+    if (depth > GetDepth(level, x, y, true)) {
+        return true;
+    }
+
+    // on level 0 min and max are the same value, one of the tests above always decides
+    Assert(level > 0);
+    const HiZLevel &child = _hierarchy[level - 1];
+    uint32_t shift = static_cast<uint32_t>(level - 1);
+    uint32_t childMinX = std::max(x * 2, pixelRect.x >> shift);
+    uint32_t childMinY = std::max(y * 2, pixelRect.y >> shift);
+    uint32_t childMaxX = std::min({ x * 2 + 1, pixelRect.z >> shift, child.width - 1 });
+    uint32_t childMaxY = std::min({ y * 2 + 1, pixelRect.w >> shift, child.height - 1 });
+    for (uint32_t childY = childMinY; childY <= childMaxY; ++childY) {
+        for (uint32_t childX = childMinX; childX <= childMaxX; ++childX) {
+            if (!IsNodeOccluded(level - 1, childX, childY, pixelRect, depth)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Foundation/BoundingVolume.hpp"
+#include "Foundation/NonCopyable.h"
+#include "Foundation/ReadonlyArraySpan.hpp"
+
+// CPU occlusion culling against a low resolution depth buffer.
+// Occluder triangles are clipped, binned into screen tiles and rasterized tile by tile on the JobSystem,
+// 8 pixels per iteration with AVX. A min/max depth hierarchy is built on top and the bounds of the occludees are
+// tested against it coarse to fine. It does not depend on the GPU, so it can run headless.
+// See: "Masked Software Occlusion Culling" (Hasselgren et al. 2016)
+class OcclusionCuller : private NonCopyable {
+public:
+    static constexpr uint32_t kTileWidth = 32;
+    static constexpr uint32_t kTileHeight = 16;
+    static constexpr uint32_t kDefaultWidth = 320;
+    static constexpr uint32_t kDefaultHeight = 192;
+    struct Statistics {
+        size_t occluderTriangleCount = 0;
+        size_t rasterizedTriangleCount = 0;
+        size_t testedCount = 0;
+        size_t occludedCount = 0;
+    };
+public:
+    OcclusionCuller(uint32_t width = kDefaultWidth, uint32_t height = kDefaultHeight);
+    ~OcclusionCuller();
+public:
+    // the depth range of the clip space is [0, 1], with reversed z the near plane is at 1
+    void BeginFrame(const glm::mat4x4 &matViewProj, bool reversedZ);
+    void AddOccluder(const glm::mat4x4 &matWorld,
+        ReadonlyArraySpan<glm::vec3> vertices,
+        ReadonlyArraySpan<uint32_t> indices);
+    // rasterizes all occluders added since BeginFrame and builds the depth hierarchy
+    void RasterizeOccluders();
+    // conservative, boxes crossing the near plane or outside the screen are visible
+    bool IsVisible(const AABB &worldBounds);
+    auto GetWidth() const -> uint32_t {
+        return _width;
+    }
+    auto GetHeight() const -> uint32_t {
+        return _height;
+    }
+    // row major, 0 is the near plane and 1 the far plane independent of reversed z
+    auto GetDepthBuffer() const -> ReadonlyArraySpan<float> {
+        return _depthBuffer;
+    }
+    auto GetStatistics() const -> const Statistics & {
+        return _statistics;
+    }
+private:
+    struct ScreenTriangle {
+        // inside when edgeA[i] * x + edgeB[i] * y + edgeC[i] >= 0 for all edges
+        float edgeA[3];
+        float edgeB[3];
+        float edgeC[3];
+        // depth = depthA * x + depthB * y + depthC
+        float depthA;
+        float depthB;
+        float depthC;
+        // inclusive pixel bounds
+        int32_t minX;
+        int32_t minY;
+        int32_t maxX;
+        int32_t maxY;
+    };
+    // level 0 is the depth buffer itself, every further level halves the resolution
+    struct HiZLevel {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<float> minDepth;
+        std::vector<float> maxDepth;
+    };
+    // signed distance to the near plane in clip space, positive in front of it
+    auto GetNearDistance(const glm::vec4 &clip) const -> float;
+    // returns x, y in pixels and the linear depth in [0, 1], nearest first
+    auto ToScreen(const glm::vec4 &clip) const -> glm::vec3;
+    void AddClippedTriangle(const glm::vec4 &v0, const glm::vec4 &v1, const glm::vec4 &v2);
+    void AddScreenTriangle(glm::vec3 p0, glm::vec3 p1, glm::vec3 p2);
+    void RasterizeTile(size_t tileIndex);
+    void BuildHierarchy();
+    auto GetDepth(size_t level, uint32_t x, uint32_t y, bool farthest) const -> float;
+    // pixelRect is the inclusive pixel rectangle (minX, minY, maxX, maxY) of the occludee
+    bool IsNodeOccluded(size_t level, uint32_t x, uint32_t y, const glm::uvec4 &pixelRect, float depth) const;
+private:
+    // clang-format off
+    uint32_t                                _width;
+    uint32_t                                _height;
+    uint32_t                                _tileCountX;
+    uint32_t                                _tileCountY;
+    glm::mat4x4                             _matViewProj;
+    bool                                    _reversedZ;
+    std::vector<float>                      _depthBuffer;
+    std::vector<ScreenTriangle>             _triangles;
+    std::vector<std::vector<uint32_t>>      _tileBins;
+    std::vector<HiZLevel>                   _hierarchy;
+    Statistics                              _statistics;
+    // clang-format on
+};
@@ -74,11 +74,14 @@ void RenderView::BeforeFinalizeOptional_SetMipBias(float mipBias) {
 }
 
 void RenderView::Step4_Finalize() {
-    glm::mat4x4 jitterMatrix = glm::translate(glm::identity<glm::mat4>(), glm::vec3(_cbPrePass.viewportJitter, 0.f));
+    glm::vec3 jitter = glm::vec3(_cbPrePass.viewportJitter, 0.f);
+    glm::mat4x4 jitterMatrix = glm::translate(glm::identity<glm::mat4>(), jitter);
+    glm::mat4x4 invJitterMatrix = glm::translate(glm::identity<glm::mat4>(), -jitter);
+    // inverse(J * M) = inverse(M) * inverse(J), the camera already provides inverse(M)
     _cbPrePass.matJitteredViewProj = jitterMatrix * _cbPrePass.matViewProj;
-    _cbPrePass.matInvJitteredViewProj = glm::inverse(_cbPrePass.matJitteredViewProj);
+    _cbPrePass.matInvJitteredViewProj = _cbPrePass.matInvViewProj * invJitterMatrix;
     _cbPrePass.matJitteredProj = jitterMatrix * _cbPrePass.matProj;
-    _cbPrePass.matInvJitteredProj = glm::inverse(_cbPrePass.matJitteredProj);
+    _cbPrePass.matInvJitteredProj = _cbPrePass.matInvProj * invJitterMatrix;
 
     _cbPrePass.totalTime = GameTimer::Get().GetTotalTimeS();
     _cbPrePass.deltaTime = GameTimer::Get().GetDeltaTimeS();
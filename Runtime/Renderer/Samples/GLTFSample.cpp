@@ -68,7 +68,8 @@ void GLTFSample::OnPreRender(GameTimer &timer) {
     _renderView.Step4_Finalize();
 
     SceneRenderObjectManager *pRenderObjectMgr = _pScene->GetRenderObjectManager();
-    pRenderObjectMgr->ClassifyRenderObjects(_pCameraGO->GetTransform()->GetWorldPosition());
+    pRenderObjectMgr->ClassifyRenderObjects(_pCameraGO->GetTransform()->GetWorldPosition(),
+        _renderView.GetCBPrePass().matViewProj);
 }
 
 void GLTFSample::OnRender(GameTimer &timer) {
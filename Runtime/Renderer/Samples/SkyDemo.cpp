@@ -74,7 +74,8 @@ void SkyDemo::OnPreRender(GameTimer &timer) {
     _renderView.Step4_Finalize();
 
     SceneRenderObjectManager *pRenderObjectMgr = _pScene->GetRenderObjectManager();
-    pRenderObjectMgr->ClassifyRenderObjects(_pCameraGO->GetTransform()->GetWorldPosition());
+    pRenderObjectMgr->ClassifyRenderObjects(_pCameraGO->GetTransform()->GetWorldPosition(),
+        _renderView.GetCBPrePass().matViewProj);
 }
 
 void SkyDemo::OnRender(GameTimer &timer) {
@@ -27,6 +27,8 @@
 #include "Renderer/RenderPasses/SkyBoxPass.h"
 #include "Renderer/RenderUtils/ConstantBufferHelper.h"
 #include "Renderer/RenderUtils/FrameCaptrue.h"
+#include "Renderer/RenderUtils/GPUScene.h"
+#include "Renderer/RenderUtils/OcclusionCuller.h"
 #include "Renderer/RenderUtils/RenderSetting.h"
 #include "RenderObject/Material.h"
 #include "SceneObject/GLTFLoader.h"
@@ -88,7 +90,9 @@ void SoftShadow::OnPreRender(GameTimer &timer) {
     _renderView.Step4_Finalize();
 
     SceneRenderObjectManager *pRenderObjectMgr = _pScene->GetRenderObjectManager();
-    pRenderObjectMgr->ClassifyRenderObjects(_pCameraGO->GetTransform()->GetWorldPosition());
+    pRenderObjectMgr->ClassifyRenderObjects(_pCameraGO->GetTransform()->GetWorldPosition(),
+        _renderView.GetCBPrePass().matViewProj);
+    pRenderObjectMgr->ApplyOcclusionCulling(_pOcclusionCuller.get(), RenderSetting::Get().GetReversedZ());
 }
 
 void SoftShadow::OnRender(GameTimer &timer) {
@@ -140,6 +144,9 @@ void SoftShadow::PrepareFrame() {
     pGfxCxt->SetViewport(_renderView.GetRenderSizeViewport());
     pGfxCxt->SetScissor(_renderView.GetRenderSizeScissorRect());
 
+    // copy the constants changed this frame before the GBufferPass reads them
+    GPUScene::GetInstance()->Upload(pGfxCxt.get());
+
     GBufferPass::DrawArgs gbufferDrawArgs = {};
     gbufferDrawArgs.pGfxCtx = pGfxCxt.get();
     gbufferDrawArgs.cbPrePassCBuffer = cbPrePassAddress;
@@ -148,8 +155,8 @@ void SoftShadow::PrepareFrame() {
     _pGBufferPass->PreDraw(gbufferDrawArgs);
 
     SceneRenderObjectManager *pRenderObjectMgr = _pScene->GetRenderObjectManager();
-    _pGBufferPass->DrawBatch(pRenderObjectMgr->GetOpaqueRenderObjects(), gbufferDrawArgs);
-    _pGBufferPass->DrawBatch(pRenderObjectMgr->GetAlphaTestRenderObjects(), gbufferDrawArgs);
+    _pGBufferPass->DrawBatch(pRenderObjectMgr->GetUnoccludedOpaqueRenderObjects(), gbufferDrawArgs);
+    _pGBufferPass->DrawBatch(pRenderObjectMgr->GetUnoccludedAlphaTestRenderObjects(), gbufferDrawArgs);
     _pGBufferPass->PostDraw(gbufferDrawArgs);
 
     _pDenoiser->SetTexture(nrd::ResourceType::IN_MV, _pGBufferPass->GetGBufferTexture(GBufferPass::eMotionVectorTex));
@@ -247,6 +254,7 @@ void SoftShadow::CreateRenderPass() {
     _pRayTracingShadowPass = std::make_unique<RayTracingShadowPass>();
     _pDenoiser = std::make_unique<Denoiser>();
     _pFsr2Pass = std::make_unique<FSR2Integration>();
+    _pOcclusionCuller = std::make_unique<OcclusionCuller>();
 
     _pGBufferPass->OnCreate(true);
     _pPostProcessPass->OnCreate();
@@ -320,6 +328,8 @@ void SoftShadow::CreateCubeObject() {
 
 void SoftShadow::LoadGLTF() {
     GLTFLoader loader;
+    loader.SetStaticBatching(true);
+    loader.SetTextureCompression(true);
     loader.Load(AssetProjectSetting::ToAssetPath("Models/powerplant/powerplant.gltf"));
     SharedPtr<GameObject> pRootGameObject = loader.GetRootGameObject();
     pRootGameObject->GetTransform()->SetLocalScale(glm::vec3(10.f));
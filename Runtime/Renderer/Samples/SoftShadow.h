@@ -15,6 +15,7 @@ class PostProcessPass;
 class GameObject;
 class Scene;
 class GBufferPass;
+class OcclusionCuller;
 
 class SoftShadow : public Renderer {
 public:
@@ -66,4 +67,5 @@ private:
 	std::unique_ptr<RayTracingShadowPass>	_pRayTracingShadowPass;
 	std::unique_ptr<Denoiser>				_pDenoiser;
 	std::unique_ptr<FSR2Integration>		_pFsr2Pass;
+	std::unique_ptr<OcclusionCuller>		_pOcclusionCuller;
 };
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include "Foundation/ReadonlyArraySpan.hpp"
+
+class Component;
+
+// readonly view over a list of components that all have the class T, hands out T * without copying the list
+template<typename T>
+class ComponentSpan final {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T *;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T *const *;
+        using reference = T *;
+    public:
+        Iterator() noexcept : _ppComponent(nullptr) {
+        }
+        explicit Iterator(Component *const *ppComponent) noexcept : _ppComponent(ppComponent) {
+        }
+        auto operator*() const -> T * {
+            return static_cast<T *>(*_ppComponent);
+        }
+        auto operator++() -> Iterator & {
+            ++_ppComponent;
+            return *this;
+        }
+        auto operator++(int) -> Iterator {
+            Iterator iterator = *this;
+            ++_ppComponent;
+            return iterator;
+        }
+        bool operator==(const Iterator &other) const noexcept = default;
+    private:
+        Component *const *_ppComponent;
+    };
+public:
+    constexpr ComponentSpan() noexcept = default;
+    constexpr ComponentSpan(ReadonlyArraySpan<Component *> components) noexcept : _components(components) {
+    }
+    auto begin() const noexcept -> Iterator {
+        return Iterator(_components.begin());
+    }
+    auto end() const noexcept -> Iterator {
+        return Iterator(_components.end());
+    }
+    constexpr bool Empty() const noexcept {
+        return _components.Size() == 0;
+    }
+    constexpr auto Size() const noexcept -> size_t {
+        return _components.Size();
+    }
+    auto operator[](size_t index) const -> T * {
+        return static_cast<T *>(_components[index]);
+    }
+private:
+    ReadonlyArraySpan<Component *> _components;
+};
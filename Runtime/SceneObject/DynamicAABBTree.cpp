@@ -0,0 +1,356 @@
+#include "DynamicAABBTree.h"
+#include <algorithm>
+#include "Foundation/Exception.h"
+
+DynamicAABBTree::DynamicAABBTree()
+    : _root(kNullNode), _freeList(kNullNode), _proxyCount(0), _reinsertCount(0), _rebuildAreaRatio(0.f) {
+}
+
+DynamicAABBTree::~DynamicAABBTree() {
+}
+
+auto DynamicAABBTree::CreateProxy(const AABB &bounds, Component *pUserData) -> int32_t {
+    Assert(bounds.IsValid());
+    int32_t proxyID = AllocateNode();
+    Node &node = _nodes[proxyID];
+    node.bounds = Fatten(bounds);
+    node.pUserData = pUserData;
+    node.height = 0;
+    InsertLeaf(proxyID);
+    ++_proxyCount;
+    return proxyID;
+}
+
+void DynamicAABBTree::DestroyProxy(int32_t proxyID) {
+    Assert(_nodes[proxyID].IsLeaf() && _nodes[proxyID].height == 0);
+    RemoveLeaf(proxyID);
+    FreeNode(proxyID);
+    --_proxyCount;
+}
+
+bool DynamicAABBTree::MoveProxy(int32_t proxyID, const AABB &bounds) {
+    Assert(bounds.IsValid());
+    Node &node = _nodes[proxyID];
+    Assert(node.IsLeaf());
+    AABB fatBounds = Fatten(bounds);
+    // a box that shrank a lot is inserted again as well, otherwise the stale fat box keeps growing the tree
+    if (Contains(node.bounds, bounds) && SurfaceArea(node.bounds) <= 4.f * SurfaceArea(fatBounds)) {
+        return false;
+    }
+
+    RemoveLeaf(proxyID);
+    _nodes[proxyID].bounds = fatBounds;
+    InsertLeaf(proxyID);
+    ++_reinsertCount;
+    return true;
+}
+
+auto DynamicAABBTree::GetHeight() const -> int32_t {
+    return _root != kNullNode ? _nodes[_root].height : 0;
+}
+
+auto DynamicAABBTree::GetAreaRatio() const -> float {
+    if (_root == kNullNode) {
+        return 0.f;
+    }
+    float rootArea = SurfaceArea(_nodes[_root].bounds);
+    if (rootArea <= 0.f) {
+        return 0.f;
+    }
+    float totalArea = 0.f;
+    for (const Node &node : _nodes) {
+        if (node.height >= 0) {
+            totalArea += SurfaceArea(node.bounds);
+        }
+    }
+    return totalArea / rootArea;
+}
+
+void DynamicAABBTree::Rebuild() {
+    std::vector<int32_t> leaves;
+    leaves.reserve(_proxyCount);
+    for (int32_t nodeID = 0; nodeID < static_cast<int32_t>(_nodes.size()); ++nodeID) {
+        Node &node = _nodes[nodeID];
+        if (node.height < 0) {
+            continue;
+        }
+        if (node.IsLeaf()) {
+            node.parent = kNullNode;
+            leaves.push_back(nodeID);
+        } else {
+            FreeNode(nodeID);
+        }
+    }
+
+    _root = leaves.empty() ? kNullNode : BuildRange(leaves.data(), leaves.size());
+    if (_root != kNullNode) {
+        _nodes[_root].parent = kNullNode;
+    }
+    _reinsertCount = 0;
+    _rebuildAreaRatio = GetAreaRatio();
+}
+
+bool DynamicAABBTree::RebuildIfDegraded() {
+    // measuring the ratio walks all nodes, wait until a quarter of the proxies were inserted again
+    if (_reinsertCount * 4 < _proxyCount || _proxyCount < 2) {
+        return false;
+    }
+    _reinsertCount = 0;
+    if (_rebuildAreaRatio > 0.f && GetAreaRatio() <= _rebuildAreaRatio * kRebuildAreaGrowth) {
+        return false;
+    }
+    Rebuild();
+    return true;
+}
+
+auto DynamicAABBTree::Fatten(const AABB &bounds) -> AABB {
+    glm::vec3 margin = glm::max(bounds.GetExtents() * kFatMarginRatio, glm::vec3(kMinFatMargin));
+    return AABB{bounds.min - margin, bounds.max + margin};
+}
+
+auto DynamicAABBTree::Union(const AABB &lhs, const AABB &rhs) -> AABB {
+    return AABB{glm::min(lhs.min, rhs.min), glm::max(lhs.max, rhs.max)};
+}
+
+auto DynamicAABBTree::SurfaceArea(const AABB &bounds) -> float {
+    glm::vec3 size = bounds.max - bounds.min;
+    return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+bool DynamicAABBTree::Contains(const AABB &outer, const AABB &inner) {
+    return glm::all(glm::lessThanEqual(outer.min, inner.min)) && glm::all(glm::greaterThanEqual(outer.max, inner.max));
+}
+
+auto DynamicAABBTree::TestFrustum(const Frustum &frustum, const AABB &bounds) -> FrustumTest {
+    glm::vec3 center = bounds.GetCenter();
+    glm::vec3 extents = bounds.GetExtents();
+    FrustumTest result = eInside;
+    for (const glm::vec4 &plane : frustum.planes) {
+        glm::vec3 normal = glm::vec3(plane);
+        float distance = glm::dot(normal, center) + plane.w;
+        float radius = glm::dot(glm::abs(normal), extents);
+        if (distance + radius < 0.f) {
+            return eOutside;
+        }
+        if (distance - radius < 0.f) {
+            result = eIntersect;
+        }
+    }
+    return result;
+}
+
+bool DynamicAABBTree::RayIntersects(const AABB &bounds,
+    const glm::vec3 &origin,
+    const glm::vec3 &invDirection,
+    float maxDistance) {
+    glm::vec3 t0 = (bounds.min - origin) * invDirection;
+    glm::vec3 t1 = (bounds.max - origin) * invDirection;
+    glm::vec3 tMin = glm::min(t0, t1);
+    glm::vec3 tMax = glm::max(t0, t1);
+    float enter = std::max({tMin.x, tMin.y, tMin.z, 0.f});
+    float exit = std::min({tMax.x, tMax.y, tMax.z, maxDistance});
+    return enter <= exit;
+}
+
+auto DynamicAABBTree::AllocateNode() -> int32_t {
+    int32_t nodeID = _freeList;
+    if (nodeID == kNullNode) {
+        nodeID = static_cast<int32_t>(_nodes.size());
+        _nodes.emplace_back();
+    } else {
+        _freeList = _nodes[nodeID].parent;
+    }
+
+    Node &node = _nodes[nodeID];
+    node.bounds = AABB{};
+    node.pUserData = nullptr;
+    node.parent = kNullNode;
+    node.child1 = kNullNode;
+    node.child2 = kNullNode;
+    node.height = 0;
+    return nodeID;
+}
+
+void DynamicAABBTree::FreeNode(int32_t nodeID) {
+    Node &node = _nodes[nodeID];
+    node.parent = _freeList;
+    node.height = -1;
+    node.pUserData = nullptr;
+    _freeList = nodeID;
+}
+
+void DynamicAABBTree::InsertLeaf(int32_t leaf) {
+    if (_root == kNullNode) {
+        _root = leaf;
+        _nodes[leaf].parent = kNullNode;
+        return;
+    }
+
+    // descend towards the sibling with the lowest cost, the cost of a subtree includes the growth of its ancestors
+    AABB leafBounds = _nodes[leaf].bounds;
+    int32_t index = _root;
+    while (!_nodes[index].IsLeaf()) {
+        const Node &node = _nodes[index];
+        float area = SurfaceArea(node.bounds);
+        float combinedArea = SurfaceArea(Union(node.bounds, leafBounds));
+        float cost = 2.f * combinedArea;
+        float inheritanceCost = 2.f * (combinedArea - area);
+
+        auto GetChildCost = [&](int32_t childID) {
+            const Node &child = _nodes[childID];
+            float unionArea = SurfaceArea(Union(leafBounds, child.bounds));
+            if (child.IsLeaf()) {
+                return unionArea + inheritanceCost;
+            }
+            return unionArea - SurfaceArea(child.bounds) + inheritanceCost;
+        };
+        float cost1 = GetChildCost(node.child1);
+        float cost2 = GetChildCost(node.child2);
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    int32_t sibling = index;
+    int32_t oldParent = _nodes[sibling].parent;
+    int32_t newParent = AllocateNode();
+    Node &parentNode = _nodes[newParent];
+    parentNode.parent = oldParent;
+    parentNode.bounds = Union(leafBounds, _nodes[sibling].bounds);
+    parentNode.height = _nodes[sibling].height + 1;
+    parentNode.child1 = sibling;
+    parentNode.child2 = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+
+    if (oldParent == kNullNode) {
+        _root = newParent;
+    } else if (_nodes[oldParent].child1 == sibling) {
+        _nodes[oldParent].child1 = newParent;
+    } else {
+        _nodes[oldParent].child2 = newParent;
+    }
+    RefitAncestors(_nodes[leaf].parent);
+}
+
+void DynamicAABBTree::RemoveLeaf(int32_t leaf) {
+    if (leaf == _root) {
+        _root = kNullNode;
+        return;
+    }
+
+    int32_t parent = _nodes[leaf].parent;
+    int32_t grandParent = _nodes[parent].parent;
+    int32_t sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+    FreeNode(parent);
+    _nodes[leaf].parent = kNullNode;
+    if (grandParent == kNullNode) {
+        _root = sibling;
+        _nodes[sibling].parent = kNullNode;
+        return;
+    }
+
+    if (_nodes[grandParent].child1 == parent) {
+        _nodes[grandParent].child1 = sibling;
+    } else {
+        _nodes[grandParent].child2 = sibling;
+    }
+    _nodes[sibling].parent = grandParent;
+    RefitAncestors(grandParent);
+}
+
+void DynamicAABBTree::RefitAncestors(int32_t nodeID) {
+    while (nodeID != kNullNode) {
+        nodeID = Balance(nodeID);
+        Node &node = _nodes[nodeID];
+        const Node &child1 = _nodes[node.child1];
+        const Node &child2 = _nodes[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.bounds = Union(child1.bounds, child2.bounds);
+        nodeID = node.parent;
+    }
+}
+
+auto DynamicAABBTree::Balance(int32_t iA) -> int32_t {
+    Node &A = _nodes[iA];
+    if (A.IsLeaf() || A.height < 2) {
+        return iA;
+    }
+
+    int32_t iB = A.child1;
+    int32_t iC = A.child2;
+    Node &B = _nodes[iB];
+    Node &C = _nodes[iC];
+    int32_t balance = C.height - B.height;
+
+    // rotate the higher child up, its higher grandchild stays below it and the other one moves to A
+    auto Rotate = [&](int32_t iUp, Node &up, int32_t &aSlot, const Node &other) {
+        int32_t iF = up.child1;
+        int32_t iG = up.child2;
+        Node &F = _nodes[iF];
+        Node &G = _nodes[iG];
+
+        up.child1 = iA;
+        up.parent = A.parent;
+        A.parent = iUp;
+        if (up.parent == kNullNode) {
+            _root = iUp;
+        } else if (_nodes[up.parent].child1 == iA) {
+            _nodes[up.parent].child1 = iUp;
+        } else {
+            _nodes[up.parent].child2 = iUp;
+        }
+
+        int32_t iKeep = F.height > G.height ? iF : iG;
+        int32_t iMove = F.height > G.height ? iG : iF;
+        Node &keep = _nodes[iKeep];
+        Node &move = _nodes[iMove];
+        up.child2 = iKeep;
+        aSlot = iMove;
+        move.parent = iA;
+        A.bounds = Union(other.bounds, move.bounds);
+        A.height = 1 + std::max(other.height, move.height);
+        up.bounds = Union(A.bounds, keep.bounds);
+        up.height = 1 + std::max(A.height, keep.height);
+        return iUp;
+    };
+
+    if (balance > 1) {
+        return Rotate(iC, C, A.child2, B);
+    }
+    if (balance < -1) {
+        return Rotate(iB, B, A.child1, C);
+    }
+    return iA;
+}
+
+auto DynamicAABBTree::BuildRange(int32_t *pLeaves, size_t count) -> int32_t {
+    if (count == 1) {
+        return pLeaves[0];
+    }
+
+    AABB centroidBounds;
+    for (size_t i = 0; i < count; ++i) {
+        centroidBounds.Merge(_nodes[pLeaves[i]].bounds.GetCenter());
+    }
+    glm::vec3 size = centroidBounds.max - centroidBounds.min;
+    int axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+
+    size_t half = count / 2;
+    std::nth_element(pLeaves, pLeaves + half, pLeaves + count, [&](int32_t lhs, int32_t rhs) {
+        return _nodes[lhs].bounds.GetCenter()[axis] < _nodes[rhs].bounds.GetCenter()[axis];
+    });
+    int32_t child1 = BuildRange(pLeaves, half);
+    int32_t child2 = BuildRange(pLeaves + half, count - half);
+
+    int32_t nodeID = AllocateNode();
+    Node &node = _nodes[nodeID];
+    node.child1 = child1;
+    node.child2 = child2;
+    node.bounds = Union(_nodes[child1].bounds, _nodes[child2].bounds);
+    node.height = 1 + std::max(_nodes[child1].height, _nodes[child2].height);
+    _nodes[child1].parent = nodeID;
+    _nodes[child2].parent = nodeID;
+    return nodeID;
+}
@@ -0,0 +1,230 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Foundation/BoundingVolume.hpp"
+#include "Foundation/Memory/FrameArena.h"
+#include "Foundation/NonCopyable.h"
+
+class Component;
+
+// Incremental bounding volume hierarchy over the components of a scene.
+// Leaves store fattened boxes, so small movements do not touch the tree. Insertions pick the sibling with the
+// smallest surface area cost and AVL rotations keep the tree balanced, a full rebuild runs when the quality degrades.
+// See: Box2D b2DynamicTree (Catto), "Fast, Effective BVH Updates for Animated Scenes" (Kopta et al. 2012)
+class DynamicAABBTree : private NonCopyable {
+public:
+    static constexpr int32_t kNullNode = -1;
+    // the fat box grows by this fraction of the extents, but at least by kMinFatMargin
+    static constexpr float kFatMarginRatio = 0.1f;
+    static constexpr float kMinFatMargin = 0.05f;
+    // rebuild when the area ratio exceeds this multiple of the ratio measured after the last rebuild
+    static constexpr float kRebuildAreaGrowth = 1.5f;
+public:
+    DynamicAABBTree();
+    ~DynamicAABBTree();
+public:
+    auto CreateProxy(const AABB &bounds, Component *pUserData) -> int32_t;
+    void DestroyProxy(int32_t proxyID);
+    // returns true when the proxy left its fat box and was inserted again
+    bool MoveProxy(int32_t proxyID, const AABB &bounds);
+    auto GetUserData(int32_t proxyID) const -> Component * {
+        return _nodes[proxyID].pUserData;
+    }
+    auto GetFatBounds(int32_t proxyID) const -> const AABB & {
+        return _nodes[proxyID].bounds;
+    }
+    auto GetProxyCount() const -> size_t {
+        return _proxyCount;
+    }
+    auto GetHeight() const -> int32_t;
+    // summed surface area of all nodes divided by the area of the root, lower is better
+    auto GetAreaRatio() const -> float;
+    // top down median split build over all leaves
+    void Rebuild();
+    // cheap to call every frame, the area ratio is only measured after enough proxies were inserted again
+    bool RebuildIfDegraded();
+public:
+    // callback(int32_t proxyID) -> bool, return false to stop the query.
+    // subtrees entirely inside the frustum are accepted without testing their leaves
+    template<typename Callback>
+    void QueryFrustum(const Frustum &frustum, const Callback &callback) const;
+    // callback(int32_t proxyID) -> bool, return false to stop the query
+    template<typename Callback>
+    void QueryAABB(const AABB &bounds, const Callback &callback) const;
+    // callback(int32_t proxyID) -> bool, return false to stop the query
+    template<typename Callback>
+    void QuerySphere(const BoundingSphere &sphere, const Callback &callback) const;
+    // callback(int32_t proxyID, float maxDistance) -> float, returns the new max distance.
+    // return the closest hit distance to clip the ray, maxDistance to continue or 0 to stop
+    template<typename Callback>
+    void RayCast(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, const Callback &callback) const;
+private:
+    struct Node {
+        AABB        bounds;
+        Component  *pUserData;
+        // the next free node while the node is in the free list
+        int32_t     parent;
+        int32_t     child1;
+        int32_t     child2;
+        // leaf = 0, free node = -1
+        int32_t     height;
+    public:
+        bool IsLeaf() const {
+            return child1 == kNullNode;
+        }
+    };
+    enum FrustumTest { eOutside, eIntersect, eInside };
+    static auto Fatten(const AABB &bounds) -> AABB;
+    static auto Union(const AABB &lhs, const AABB &rhs) -> AABB;
+    static auto SurfaceArea(const AABB &bounds) -> float;
+    static bool Contains(const AABB &outer, const AABB &inner);
+    static auto TestFrustum(const Frustum &frustum, const AABB &bounds) -> FrustumTest;
+    static bool RayIntersects(const AABB &bounds, const glm::vec3 &origin, const glm::vec3 &invDirection, float maxDistance);
+    auto AllocateNode() -> int32_t;
+    void FreeNode(int32_t nodeID);
+    void InsertLeaf(int32_t leaf);
+    void RemoveLeaf(int32_t leaf);
+    // refits and balances the ancestors, starting at nodeID
+    void RefitAncestors(int32_t nodeID);
+    auto Balance(int32_t nodeID) -> int32_t;
+    auto BuildRange(int32_t *pLeaves, size_t count) -> int32_t;
+private:
+    // clang-format off
+    std::vector<Node>   _nodes;
+    int32_t             _root;
+    int32_t             _freeList;
+    size_t              _proxyCount;
+    size_t              _reinsertCount;
+    float               _rebuildAreaRatio;
+    // clang-format on
+};
+
+template<typename Callback>
+void DynamicAABBTree::QueryFrustum(const Frustum &frustum, const Callback &callback) const {
+    if (_root == kNullNode) {
+        return;
+    }
+
+    // the sign of the node id marks a subtree that is already known to be inside
+    FrameVector<int32_t> stack;
+    stack.reserve(64);
+    stack.push_back(_root);
+    while (!stack.empty()) {
+        int32_t nodeID = stack.back();
+        stack.pop_back();
+        bool inside = nodeID < 0;
+        nodeID = inside ? ~nodeID : nodeID;
+
+        const Node &node = _nodes[nodeID];
+        if (!inside) {
+            FrustumTest result = TestFrustum(frustum, node.bounds);
+            if (result == eOutside) {
+                continue;
+            }
+            inside = result == eInside;
+        }
+
+        if (node.IsLeaf()) {
+            if (!callback(nodeID)) {
+                return;
+            }
+            continue;
+        }
+        stack.push_back(inside ? ~node.child1 : node.child1);
+        stack.push_back(inside ? ~node.child2 : node.child2);
+    }
+}
+
+template<typename Callback>
+void DynamicAABBTree::QueryAABB(const AABB &bounds, const Callback &callback) const {
+    if (_root == kNullNode) {
+        return;
+    }
+
+    FrameVector<int32_t> stack;
+    stack.reserve(64);
+    stack.push_back(_root);
+    while (!stack.empty()) {
+        int32_t nodeID = stack.back();
+        stack.pop_back();
+        const Node &node = _nodes[nodeID];
+        if (glm::any(glm::lessThan(node.bounds.max, bounds.min)) ||
+            glm::any(glm::greaterThan(node.bounds.min, bounds.max))) {
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            if (!callback(nodeID)) {
+                return;
+            }
+            continue;
+        }
+        stack.push_back(node.child1);
+        stack.push_back(node.child2);
+    }
+}
+
+template<typename Callback>
+void DynamicAABBTree::QuerySphere(const BoundingSphere &sphere, const Callback &callback) const {
+    if (_root == kNullNode) {
+        return;
+    }
+
+    float radiusSqr = sphere.radius * sphere.radius;
+    FrameVector<int32_t> stack;
+    stack.reserve(64);
+    stack.push_back(_root);
+    while (!stack.empty()) {
+        int32_t nodeID = stack.back();
+        stack.pop_back();
+        const Node &node = _nodes[nodeID];
+        glm::vec3 closest = glm::clamp(sphere.center, node.bounds.min, node.bounds.max);
+        glm::vec3 offset = closest - sphere.center;
+        if (glm::dot(offset, offset) > radiusSqr) {
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            if (!callback(nodeID)) {
+                return;
+            }
+            continue;
+        }
+        stack.push_back(node.child1);
+        stack.push_back(node.child2);
+    }
+}
+
+template<typename Callback>
+void DynamicAABBTree::RayCast(const glm::vec3 &origin,
+    const glm::vec3 &direction,
+    float maxDistance,
+    const Callback &callback) const {
+    if (_root == kNullNode) {
+        return;
+    }
+
+    // a zero component gives +-inf, the slab test handles it
+    glm::vec3 invDirection = 1.f / direction;
+    FrameVector<int32_t> stack;
+    stack.reserve(64);
+    stack.push_back(_root);
+    while (!stack.empty()) {
+        int32_t nodeID = stack.back();
+        stack.pop_back();
+        const Node &node = _nodes[nodeID];
+        if (!RayIntersects(node.bounds, origin, invDirection, maxDistance)) {
+            continue;
+        }
+
+        if (node.IsLeaf()) {
+            maxDistance = callback(nodeID, maxDistance);
+            if (maxDistance <= 0.f) {
+                return;
+            }
+            continue;
+        }
+        stack.push_back(node.child1);
+        stack.push_back(node.child2);
+    }
+}
@@ -1,4 +1,6 @@
 #include "GLTFLoader.h"
+#include <algorithm>
+#include <mutex>
 #include <assimp/GltfMaterial.h>
 #include <assimp/Importer.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -7,15 +9,76 @@
 #include "D3d12/IImageLoader.h"
 #include "D3d12/Texture.h"
 #include "Foundation/Formatter.hpp"
+#include "Foundation/JobSystem.h"
+#include "Foundation/Logger.h"
+#include "Foundation/Memory/HeapAllocationCounter.h"
 #include "Object/GameObject.h"
 #include "Renderer/GfxDevice.h"
 #include "RenderObject/Mesh.h"
+#include "RenderObject/MeshSimplifier.h"
 #include "RenderObject/VertexSemantic.hpp"
+#include "SceneObject/StaticBatcher.h"
 #include "TextureObject/DDSLoader.h"
+#include "TextureObject/TextureImportCache.h"
 #include "TextureObject/TextureLoader.h"
-#include "TextureObject/WICLoader.h"
+#include "D3d12/UploadHeap.h"
+#include <magic_enum.hpp>
+
+namespace {
+
+struct OccluderCandidate {
+    MeshRenderer *pMeshRenderer;
+    AABB bounds;
+};
+
+void CollectOccluderCandidates(GameObject *pGameObject, std::vector<OccluderCandidate> &candidates) {
+    if (MeshRenderer *pMeshRenderer = pGameObject->GetComponent<MeshRenderer>()) {
+        const std::shared_ptr<Mesh> &pMesh = pMeshRenderer->GetMesh();
+        const std::shared_ptr<Material> &pMaterial = pMeshRenderer->GetMaterial();
+        if (pMesh != nullptr && pMaterial != nullptr && pMesh->GetBounds().IsValid()) {
+            AABB bounds = pMesh->GetBounds().Transform(pGameObject->GetTransform()->GetWorldMatrix());
+            candidates.push_back(OccluderCandidate{pMeshRenderer, bounds});
+        }
+    }
+    for (const SharedPtr<GameObject> &pChild : pGameObject->GetChildren()) {
+        CollectOccluderCandidates(pChild.Get(), candidates);
+    }
+}
+
+}    // namespace
+
+// a texture of the model and the material slots that wait for it
+struct GLTFLoader::TextureRequest {
+    struct Target {
+        // the material may be destroyed before the texture arrives
+        std::weak_ptr<Material> pMaterial;
+        Material::TextureType textureType;
+    };
+public:
+    GLTFMaterial::Texture texture;
+    TextureImportSettings settings;
+    std::vector<Target> targets;
+    // written by DecodeTexture, consumed by BindTextures
+    std::unique_ptr<dx::IImageLoader> pImageLoader;
+};
+
+// the texture requests of one Load. the workers queue the decoded requests, the main thread uploads everything that
+// arrived since the last frame and waits for the upload heap once
+struct GLTFLoader::TextureStream {
+    // clang-format off
+    std::mutex                                      mutex;
+    // guarded by mutex
+    std::vector<std::shared_ptr<TextureRequest>>    decodedRequests;
+    // swapped with decodedRequests, both keep their capacity
+    std::vector<std::shared_ptr<TextureRequest>>    bindRequests;
+    std::vector<SharedPtr<dx::Texture>>             textures;
+    size_t                                          pendingCount = 0;
+    std::shared_ptr<TextureLoader>                  pTextureLoader;
+    // clang-format on
+};
 
 bool GLTFLoader::Load(stdfs::path path, int flag) {
+    auto beginTime = stdchrono::steady_clock::now();
     Assimp::Importer importer;
     importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_LINE | aiPrimitiveType_POINT);
     _pAiScene = importer.ReadFile(path.string(), flag);
@@ -24,7 +87,7 @@ bool GLTFLoader::Load(stdfs::path path, int flag) {
         return false;
     }
 
-    stdfs::path directory = path.remove_filename();
+    stdfs::path directory = stdfs::path(path).remove_filename();
     _materials.resize(_pAiScene->mNumMaterials);
     std::vector<bool> flags(_pAiScene->mNumMaterials, false);
 
@@ -34,11 +97,36 @@ bool GLTFLoader::Load(stdfs::path path, int flag) {
         if (flags[pAiMesh->mMaterialIndex]) {
             continue;
         }
-        _materials[pAiMesh->mMaterialIndex].Create(&_textureLoader, directory, _pAiScene, pAiMaterial);
+        _materials[pAiMesh->mMaterialIndex].Create(directory, _pAiScene, pAiMaterial);
         flags[pAiMesh->mMaterialIndex] = true;
     }
 
-    _pRootGameObject = RecursiveBuildGameObject(_pAiScene->mRootNode);
+    // the nodes driven by an animation move, so do their children, every other game object of the asset is static
+    _animatedNodeNames.clear();
+    for (size_t i = 0; i < _pAiScene->mNumAnimations; ++i) {
+        const aiAnimation *pAiAnimation = _pAiScene->mAnimations[i];
+        for (size_t j = 0; j < pAiAnimation->mNumChannels; ++j) {
+            _animatedNodeNames.insert(pAiAnimation->mChannels[j]->mNodeName.C_Str());
+        }
+    }
+
+    _pRootGameObject = RecursiveBuildGameObject(_pAiScene->mRootNode, false);
+    // the occluders are judged per mesh and stay out of the static batches, a batch spans too much of the asset
+    SelectOccluders();
+    if (_staticBatching) {
+        StaticBatcher staticBatcher;
+        staticBatcher.Build(_pRootGameObject.Get());
+    }
+
+    size_t textureCount = _textureRequests.size();
+    LoadTexturesAsync();
+
+    // the textures are still decoding, a warm TextureImportCache makes them arrive within a few frames
+    auto endTime = stdchrono::steady_clock::now();
+    Logger::Info("GLTFLoader: load {} in {:.1f} ms, {} textures pending",
+        path.string(),
+        stdchrono::duration<double, std::milli>(endTime - beginTime).count(),
+        textureCount);
     return true;
 }
 
@@ -46,9 +134,11 @@ auto GLTFLoader::GetRootGameObject() const -> SharedPtr<GameObject> {
     return _pRootGameObject;
 }
 
-auto GLTFLoader::RecursiveBuildGameObject(aiNode *pAiNode) -> SharedPtr<GameObject> {
+auto GLTFLoader::RecursiveBuildGameObject(aiNode *pAiNode, bool animated) -> SharedPtr<GameObject> {
+    animated = animated || _animatedNodeNames.contains(pAiNode->mName.C_Str());
     SharedPtr<GameObject> pGameObject = GameObject::Create();
     pGameObject->SetName(pAiNode->mName.C_Str());
+    pGameObject->SetStatic(!animated);
     if (pAiNode->mNumMeshes == 1) {
         unsigned int meshIdx = pAiNode->mMeshes[0];
         aiMesh *pAiMesh = _pAiScene->mMeshes[meshIdx];
@@ -57,6 +147,7 @@ auto GLTFLoader::RecursiveBuildGameObject(aiNode *pAiNode) -> SharedPtr<GameObje
         for (size_t i = 0; i < pAiNode->mNumMeshes; ++i) {
             SharedPtr<GameObject> pChild = GameObject::Create();
             pChild->SetName(pGameObject->GetName() + fmt::format("_MeshRenderer_{}", i));
+            pChild->SetStatic(!animated);
             pGameObject->AddChild(pChild);
             unsigned int meshIdx = pAiNode->mMeshes[i];
             aiMesh *pAiMesh = _pAiScene->mMeshes[meshIdx];
@@ -74,7 +165,7 @@ auto GLTFLoader::RecursiveBuildGameObject(aiNode *pAiNode) -> SharedPtr<GameObje
         glm::vec3(scale.x, scale.y, scale.z));
 
     for (size_t i = 0; i < pAiNode->mNumChildren; ++i) {
-        auto pChild = RecursiveBuildGameObject(pAiNode->mChildren[i]);
+        auto pChild = RecursiveBuildGameObject(pAiNode->mChildren[i], animated);
         pGameObject->AddChild(pChild);
     }
     return pGameObject;
@@ -89,6 +180,36 @@ auto GLTFLoader::BuildMeshRenderer(size_t meshIndex, aiMesh *pAiMesh) -> SharedP
     return pMeshRenderer;
 }
 
+void GLTFLoader::SelectOccluders() {
+    std::vector<OccluderCandidate> candidates;
+    CollectOccluderCandidates(_pRootGameObject.Get(), candidates);
+    AABB assetBounds;
+    for (const OccluderCandidate &candidate : candidates) {
+        assetBounds.Merge(candidate.bounds);
+    }
+    if (!assetBounds.IsValid()) {
+        return;
+    }
+
+    // relative to the asset, so the selection does not depend on the unit scale of the file. a wall or a floor spans
+    // a large area in two axes, the smaller of the two largest extents rejects poles and thin beams
+    glm::vec3 assetSize = assetBounds.max - assetBounds.min;
+    float minExtent = std::max({assetSize.x, assetSize.y, assetSize.z}) * kMinOccluderRelativeSize;
+    size_t occluderCount = 0;
+    for (const OccluderCandidate &candidate : candidates) {
+        MeshRenderer *pMeshRenderer = candidate.pMeshRenderer;
+        glm::vec3 size = candidate.bounds.max - candidate.bounds.min;
+        float middleExtent = size.x + size.y + size.z - std::max({size.x, size.y, size.z}) -
+                             std::min({size.x, size.y, size.z});
+        bool occluder = RenderGroup::IsOpaque(pMeshRenderer->GetMaterial()->GetRenderGroup()) &&
+                        pMeshRenderer->GetMesh()->GetIndexCount() / 3 <= kMaxOccluderTriangleCount &&
+                        middleExtent >= minExtent;
+        pMeshRenderer->SetOccluder(occluder);
+        occluderCount += static_cast<size_t>(occluder);
+    }
+    Logger::Info("GLTFLoader: {} of {} mesh renderers are occluders", occluderCount, candidates.size());
+}
+
 auto GLTFLoader::BuildMesh(aiMesh *pAiMesh) -> std::shared_ptr<Mesh> {
     std::shared_ptr<Mesh> pMesh = std::make_shared<Mesh>();
     pMesh->SetName(pAiMesh->mName.C_Str());
@@ -147,6 +268,41 @@ auto GLTFLoader::BuildMesh(aiMesh *pAiMesh) -> std::shared_ptr<Mesh> {
         }
     }
 
+    // the simplified levels share the vertices, their indices are appended to the index buffer
+    size_t baseIndexCount = indices.size();
+    std::vector<MeshLod> lods;
+    if (pAiMesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE && baseIndexCount / 3 >= kMinLodTriangleCount) {
+        AABB bounds;
+        for (const glm::vec3 &vertex : vertices) {
+            bounds.Merge(vertex);
+        }
+        float maxError = length(bounds.max - bounds.min) * kMaxLodRelativeError;
+        std::vector<MeshSimplifier::LodLevel> levels = MeshSimplifier::GenerateLodChain(vertices,
+            indices,
+            kMaxLodCount,
+            kLodReduction,
+            maxError);
+        for (MeshSimplifier::LodLevel &level : levels) {
+            MeshLod lod;
+            SubMesh subMesh;
+            subMesh.vertexCount = numVertices;
+            subMesh.indexCount = level.indices.size();
+            subMesh.baseVertexLocation = 0;
+            subMesh.baseIndexLocation = indices.size();
+            lod.subMeshes.push_back(subMesh);
+            lod.error = level.error;
+            Logger::Info("Mesh '{}' lod {}: {} -> {} triangles ({:.1f}%), error {:.5f}",
+                pAiMesh->mName.C_Str(),
+                lods.size() + 1,
+                baseIndexCount / 3,
+                level.indices.size() / 3,
+                100.0 * static_cast<double>(level.indices.size()) / static_cast<double>(baseIndexCount),
+                level.error);
+            indices.insert(indices.end(), level.indices.begin(), level.indices.end());
+            lods.push_back(std::move(lod));
+        }
+    }
+
     pMesh->Resize(mask, numVertices, indices.size());
     pMesh->SetVertices(vertices);
     if (HasFlag(mask, SemanticMask::eNormal)) {
@@ -165,6 +321,15 @@ auto GLTFLoader::BuildMesh(aiMesh *pAiMesh) -> std::shared_ptr<Mesh> {
     if (indices.size() > 0) {
 	    pMesh->SetIndices(indices);
     }
+    if (!lods.empty()) {
+        SubMesh subMesh;
+        subMesh.vertexCount = numVertices;
+        subMesh.indexCount = baseIndexCount;
+        subMesh.baseVertexLocation = 0;
+        subMesh.baseIndexLocation = 0;
+        pMesh->SetSubMeshes({ subMesh });
+        pMesh->SetLods(std::move(lods));
+    }
 
     pMesh->UploadMeshData();
     return pMesh;
@@ -180,38 +345,180 @@ auto GLTFLoader::BuildMaterial(size_t materialIndex) -> std::shared_ptr<Material
     std::shared_ptr<Material> &pMaterial = gltfMaterial.pStdMaterial;
     pMaterial->SetRenderGroup(gltfMaterial.renderGroup);
     pMaterial->SetCutoff(gltfMaterial.alphaCutoff);
+    // the material renders with its factors until BindTextures patches in the textures
+    auto addTarget = [&](const auto &texture, const TextureImportSettings &settings, Material::TextureType type) {
+        TextureRequest &request = GetTextureRequest(texture.path, settings);
+        request.texture = texture;
+        request.targets.push_back(TextureRequest::Target{pMaterial, type});
+    };
     if (gltfMaterial.baseColorMap.IsValid()) {
-        SharedPtr<dx::Texture> pBaseTexture = gltfMaterial.LoadTexture(gltfMaterial.baseColorMap, true);
-        dx::SRV srv = _textureLoader.GetSRV2D(pBaseTexture.Get());
-        pMaterial->SetTexture(Material::eAlbedoTex, pBaseTexture, std::move(srv));
+        addTarget(gltfMaterial.baseColorMap,
+            GetTextureImportSettings(true, TextureUsage::eColor),
+            Material::eAlbedoTex);
     }
     if (gltfMaterial.normalMap.IsValid()) {
-        SharedPtr<dx::Texture> pNormalMap = gltfMaterial.LoadTexture(gltfMaterial.normalMap, false);
-        dx::SRV srv = _textureLoader.GetSRV2D(pNormalMap.Get());
-        pMaterial->SetTexture(Material::eNormalTex, pNormalMap, std::move(srv));
+        addTarget(gltfMaterial.normalMap,
+            GetTextureImportSettings(false, TextureUsage::eNormalMap),
+            Material::eNormalTex);
     }
     if (gltfMaterial.emissionMap.IsValid()) {
-        SharedPtr<dx::Texture> pEmissionMap = gltfMaterial.LoadTexture(gltfMaterial.emissionMap, false);
-        dx::SRV srv = _textureLoader.GetSRV2D(pEmissionMap.Get());
-        pMaterial->SetTexture(Material::eEmissionTex, pEmissionMap, std::move(srv));
+        addTarget(gltfMaterial.emissionMap,
+            GetTextureImportSettings(false, TextureUsage::eColor),
+            Material::eEmissionTex);
     }
     if (gltfMaterial.metalnessRoughnessMap.IsValid()) {
-        SharedPtr<dx::Texture> pMetalRoughnessMap = gltfMaterial.LoadTexture(gltfMaterial.metalnessRoughnessMap, true);
-        dx::SRV srv = _textureLoader.GetSRV2D(pMetalRoughnessMap.Get());
-        pMaterial->SetTexture(Material::eMetalRoughnessTex, pMetalRoughnessMap, std::move(srv));
-        pMaterial->SetRoughness(1.f);
-        pMaterial->SetMetallic(1.f);
+        addTarget(gltfMaterial.metalnessRoughnessMap,
+            GetTextureImportSettings(true, TextureUsage::eColor),
+            Material::eMetalRoughnessTex);
     }
     if (gltfMaterial.ambientOcclusionMap.IsValid()) {
-        SharedPtr<dx::Texture> pAmbientOcclusionMap = gltfMaterial.LoadTexture(gltfMaterial.ambientOcclusionMap, false);
-        dx::SRV srv = _textureLoader.GetSRV2D(pAmbientOcclusionMap.Get());
-        pMaterial->SetTexture(Material::eAmbientOcclusionTex, pAmbientOcclusionMap, std::move(srv));
+        // occlusion packed into the r channel of the metal roughness texture keeps the other channels
+        bool packedOcclusion = gltfMaterial.ambientOcclusionMap.path == gltfMaterial.metalnessRoughnessMap.path;
+        TextureUsage usage = packedOcclusion ? TextureUsage::eColor : TextureUsage::eGrayscale;
+        addTarget(gltfMaterial.ambientOcclusionMap,
+            GetTextureImportSettings(false, usage),
+            Material::eAmbientOcclusionTex);
     }
     return pMaterial;
 }
 
-void GLTFLoader::GLTFMaterial::Create(TextureLoader *pTextureLoader, stdfs::path directory, const aiScene *pAiScene, const aiMaterial *pAiMaterial) {
-    this->pTextureLoader = pTextureLoader;
+auto GLTFLoader::GetTextureImportSettings(bool sRGB, TextureUsage usage) const -> TextureImportSettings {
+    TextureImportSettings settings;
+    settings.sRGB = sRGB;
+    settings.compress = _textureCompression;
+    settings.usage = usage;
+    settings.quality = _textureQuality;
+    return settings;
+}
+
+auto GLTFLoader::GetTextureRequest(const stdfs::path &path, const TextureImportSettings &settings) -> TextureRequest & {
+    std::string key = fmt::format("{}_{}_{}_{}_{}",
+        path.string(),
+        settings.sRGB,
+        settings.compress,
+        magic_enum::enum_name(settings.usage),
+        magic_enum::enum_name(settings.quality));
+    auto [iter, inserted] = _textureRequestIndices.emplace(std::move(key), _textureRequests.size());
+    if (inserted) {
+        std::shared_ptr<TextureRequest> pRequest = std::make_shared<TextureRequest>();
+        pRequest->settings = settings;
+        _textureRequests.push_back(std::move(pRequest));
+    }
+    return *_textureRequests[iter->second];
+}
+
+void GLTFLoader::LoadTexturesAsync() {
+    if (_textureRequests.empty()) {
+        return;
+    }
+
+    std::shared_ptr<TextureStream> pStream = std::make_shared<TextureStream>();
+    pStream->decodedRequests.reserve(_textureRequests.size());
+    pStream->bindRequests.reserve(_textureRequests.size());
+    pStream->textures.reserve(_textureRequests.size());
+    pStream->pendingCount = _textureRequests.size();
+    pStream->pTextureLoader = _pTextureLoader;
+
+    JobSystem *pJobSystem = JobSystem::GetInstance();
+    for (std::shared_ptr<TextureRequest> &pRequest : _textureRequests) {
+        auto decodeJob = [pStream, pRequest] {
+            DecodeTexture(*pRequest);
+            std::unique_lock lock(pStream->mutex);
+            pStream->decodedRequests.push_back(pRequest);
+        };
+        // a decode takes tens of milliseconds, the main thread must not pick it up while it waits for a ParallelFor
+        if (pJobSystem != nullptr) {
+            pJobSystem->ScheduleBackground(std::move(decodeJob));
+        } else {
+            decodeJob();
+        }
+    }
+    MainThread::AddMainThreadJob(MainThread::PreRender, [pStream](GameTimer &) { return BindTextures(*pStream); });
+    _textureRequests.clear();
+    _textureRequestIndices.clear();
+}
+
+void GLTFLoader::DecodeTexture(TextureRequest &request) {
+    // streaming runs alongside frames that are checked for heap allocations
+    ScopedHeapAllocationPermit heapAllocationPermit;
+    const GLTFMaterial::Texture &texture = request.texture;
+    if (texture.pTextureData == nullptr) {
+        request.pImageLoader = TextureLoader::ImportFile(texture.path, request.settings);
+        return;
+    }
+
+    if (texture.extension == "DDS" || texture.extension == "dds") {
+        // the loader points into pTextureData, the request keeps it alive until the upload
+        std::unique_ptr<MemoryDDSLoader> pDDSLoader = std::make_unique<MemoryDDSLoader>();
+        if (pDDSLoader->Load(texture.pTextureData.get(), texture.textureDataSize, 0.f)) {
+            request.pImageLoader = std::move(pDDSLoader);
+        }
+        return;
+    }
+
+    stdfs::path cachePath = TextureImportCache::GetCachePath(texture.pTextureData.get(),
+        texture.textureDataSize,
+        request.settings,
+        0.f);
+    request.pImageLoader = TextureLoader::ImportImage(texture.pTextureData.get(),
+        texture.textureDataSize,
+        cachePath,
+        request.settings,
+        0.f);
+}
+
+auto GLTFLoader::BindTextures(TextureStream &stream) -> MainThread::JobStatus {
+    std::unique_lock lock(stream.mutex);
+    stream.bindRequests.swap(stream.decodedRequests);
+    lock.unlock();
+    if (stream.bindRequests.empty()) {
+        return MainThread::ExecuteInNextFrame;
+    }
+
+    ScopedHeapAllocationPermit heapAllocationPermit;
+    for (const std::shared_ptr<TextureRequest> &pRequest : stream.bindRequests) {
+        if (pRequest->pImageLoader == nullptr) {
+            Logger::Warning("GLTFLoader: can not load the texture '{}'", pRequest->texture.path.string());
+            stream.textures.push_back(nullptr);
+            continue;
+        }
+        SharedPtr<dx::Texture> pTexture = TextureLoader::UploadTexture(pRequest->pImageLoader.get(),
+            pRequest->settings.sRGB);
+        pTexture->SetName(pRequest->texture.path.string());
+        pRequest->pImageLoader = nullptr;
+        stream.textures.push_back(std::move(pTexture));
+    }
+    // the materials are drawn in this frame, the upload heap only flushes on its own when it is full
+    GfxDevice::GetInstance()->GetUploadHeap()->FlushAndFinish();
+
+    for (size_t i = 0; i < stream.bindRequests.size(); ++i) {
+        if (stream.textures[i] != nullptr) {
+            dx::SRV srv = stream.pTextureLoader->GetSRV2D(stream.textures[i].Get());
+            BindTexture(*stream.bindRequests[i], stream.textures[i], std::move(srv));
+        }
+    }
+    stream.pendingCount -= stream.bindRequests.size();
+    stream.bindRequests.clear();
+    stream.textures.clear();
+    return stream.pendingCount > 0 ? MainThread::ExecuteInNextFrame : MainThread::Finished;
+}
+
+void GLTFLoader::BindTexture(const TextureRequest &request, const SharedPtr<dx::Texture> &pTexture, dx::SRV srv) {
+    for (const TextureRequest::Target &target : request.targets) {
+        std::shared_ptr<Material> pMaterial = target.pMaterial.lock();
+        if (pMaterial == nullptr) {
+            continue;
+        }
+        pMaterial->SetTexture(target.textureType, pTexture, srv);
+        if (target.textureType == Material::eMetalRoughnessTex) {
+            // the factors scale the texture
+            pMaterial->SetRoughness(1.f);
+            pMaterial->SetMetallic(1.f);
+        }
+    }
+}
+
+void GLTFLoader::GLTFMaterial::Create(stdfs::path directory, const aiScene *pAiScene, const aiMaterial *pAiMaterial) {
     if (!ProcessTexture(baseColorMap, directory, pAiScene, pAiMaterial, aiTextureType_BASE_COLOR)) {
         ProcessTexture(baseColorMap, directory, pAiScene, pAiMaterial, aiTextureType_DIFFUSE);
     }
@@ -242,35 +549,6 @@ void GLTFLoader::GLTFMaterial::Create(TextureLoader *pTextureLoader, stdfs::path
     }
 }
 
-auto GLTFLoader::GLTFMaterial::LoadTexture(Texture &texture, bool makeSRGB) -> SharedPtr<dx::Texture> {
-    if (auto it = textureMap.find(&texture); it != textureMap.end()) {
-        return it->second;
-    }
-
-    SharedPtr<dx::Texture> pTexture = nullptr;
-    std::unique_ptr<dx::IImageLoader> pImageLoader;
-    if (texture.pTextureData != nullptr) {
-	    bool loadSuccess = false;
-	    if (texture.extension == "DDS" || texture.extension == "dds") {
-		    std::unique_ptr<MemoryDDSLoader> pLoader = std::make_unique<MemoryDDSLoader>();
-            loadSuccess = pLoader->Load(texture.pTextureData.get(), texture.textureDataSize, 0.f);
-            pImageLoader = std::move(pLoader);
-	    } else {
-		    std::unique_ptr<WICLoader> pLoader = std::make_unique<WICLoader>();
-            loadSuccess = pLoader->Load(texture.pTextureData.get(), texture.textureDataSize, 0.f);
-            pImageLoader = std::move(pLoader);
-	    }
-	    if (loadSuccess) {
-            pTexture = TextureLoader::UploadTexture(pImageLoader.get(), makeSRGB);
-	    }
-    } else {
-		pTexture = pTextureLoader->LoadFromFile(texture.path, makeSRGB);
-    }
-
-    textureMap[&texture] = pTexture;
-    return pTexture;
-}
-
 bool GLTFLoader::GLTFMaterial::ProcessTexture(Texture &texture,
     const stdfs::path &directory,
     const aiScene *pAiScene,
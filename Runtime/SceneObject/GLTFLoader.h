@@ -1,5 +1,6 @@
 #pragma once
 #include <memory>
+#include <unordered_set>
 #include "Foundation/NonCopyable.h"
 #include "Foundation/NamespeceAlias.h"
 #include <assimp/postprocess.h>
@@ -7,6 +8,7 @@
 #include "Components/MeshRenderer.h"
 #include "Foundation/Memory/SharedPtr.hpp"
 #include "Foundation/ColorUtil.hpp"
+#include "Foundation/MainThread.h"
 #include "RenderObject/RenderGroup.hpp"
 #include "TextureObject/TextureLoader.h"
 
@@ -20,21 +22,64 @@ class GLTFLoader : NonCopyable {
 public:
     constexpr static int kDefaultLoadFlag = (aiProcessPreset_TargetRealtime_MaxQuality | aiProcess_ConvertToLeftHanded |
                                              aiProcess_OptimizeGraph);
+    // meshes with fewer triangles are not simplified
+    constexpr static size_t kMinLodTriangleCount = 256;
+    constexpr static size_t kMaxLodCount = 3;
+    // every level keeps this fraction of the triangles of the previous one
+    constexpr static float kLodReduction = 0.5f;
+    // largest simplification error relative to the bounding box diagonal of the mesh
+    constexpr static float kMaxLodRelativeError = 0.05f;
+    // opaque meshes whose bounds span this fraction of the asset in their two largest extents become occluders
+    constexpr static float kMinOccluderRelativeSize = 0.1f;
+    // more triangles cost too much in the software rasterizer of the occlusion culling
+    constexpr static size_t kMaxOccluderTriangleCount = 4096;
+    // the game objects are ready when Load returns, the textures are decoded on the JobSystem workers and bound to the
+    // materials on the main thread before the render of the frame they finish in
     bool Load(stdfs::path path, int flag = kDefaultLoadFlag);
     auto GetRootGameObject() const -> SharedPtr<GameObject>;
+    // merges the meshes of the static game objects with the StaticBatcher after they are built, off by default
+    void SetStaticBatching(bool enable) {
+        _staticBatching = enable;
+    }
+    // block compresses the textures decoded from image files, the format follows the material slot, off by default
+    void SetTextureCompression(bool enable, BlockCompressor::Quality quality = BlockCompressor::Quality::eNormal) {
+        _textureCompression = enable;
+        _textureQuality = quality;
+    }
 private:
     struct GLTFMaterial;
-    auto RecursiveBuildGameObject(aiNode *pAiNode) -> SharedPtr<GameObject>;
+    struct TextureRequest;
+    struct TextureStream;
+    // the game object is static unless the node or one of its ancestors is animated
+    auto RecursiveBuildGameObject(aiNode *pAiNode, bool animated) -> SharedPtr<GameObject>;
     auto BuildMeshRenderer(size_t meshIndex, aiMesh *pAiMesh) -> SharedPtr<MeshRenderer>;
     static auto BuildMesh(aiMesh *pAiMesh) -> std::shared_ptr<Mesh>;
+    // marks the large and simple opaque mesh renderers of the asset as occluders
+    void SelectOccluders();
     auto BuildMaterial(size_t materialIndex) -> std::shared_ptr<Material>;
+    auto GetTextureImportSettings(bool sRGB, TextureUsage usage) const -> TextureImportSettings;
+    // slots that reference the same image with the same settings share one request
+    auto GetTextureRequest(const stdfs::path &path, const TextureImportSettings &settings) -> TextureRequest &;
+    void LoadTexturesAsync();
+    // runs on a worker
+    static void DecodeTexture(TextureRequest &request);
+    // runs on the main thread once per frame until every texture of the stream is bound
+    static auto BindTextures(TextureStream &stream) -> MainThread::JobStatus;
+    static void BindTexture(const TextureRequest &request, const SharedPtr<dx::Texture> &pTexture, dx::SRV srv);
 private:
     // clang-format off
     const aiScene              *_pAiScene = nullptr;
     std::string                 _errorMessage;
     std::vector<GLTFMaterial>       _materials;
     SharedPtr<GameObject>       _pRootGameObject;
-    TextureLoader               _textureLoader;
+    std::unordered_set<std::string> _animatedNodeNames;
+    // shared with the pending texture jobs, they may finish after the loader is gone
+    std::shared_ptr<TextureLoader>  _pTextureLoader = std::make_shared<TextureLoader>();
+    std::vector<std::shared_ptr<TextureRequest>> _textureRequests;
+    std::unordered_map<std::string, size_t>      _textureRequestIndices;
+    bool                        _staticBatching = false;
+    bool                        _textureCompression = false;
+    BlockCompressor::Quality    _textureQuality = BlockCompressor::Quality::eNormal;
     // clang-format on
 };
 
@@ -53,8 +98,7 @@ struct GLTFLoader::GLTFMaterial {
         // clang-format on
     };
 public:
-    void Create(TextureLoader *pTextureLoader, stdfs::path directory, const aiScene *pAiScene, const aiMaterial *pAiMaterial);
-    auto LoadTexture(Texture &texture, bool makeSRGB) -> SharedPtr<dx::Texture>;
+    void Create(stdfs::path directory, const aiScene *pAiScene, const aiMaterial *pAiMaterial);
 private:
     bool ProcessTexture(Texture &texture,
         const stdfs::path &directory,
@@ -70,7 +114,5 @@ public:
     Texture emissionMap;
     Texture metalnessRoughnessMap;
     Texture ambientOcclusionMap;
-    TextureLoader *pTextureLoader = nullptr;
     std::shared_ptr<::Material> pStdMaterial;
-    std::unordered_map<Texture *, SharedPtr<dx::Texture>> textureMap;
 };
\ No newline at end of file
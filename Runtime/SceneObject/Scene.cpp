@@ -1,13 +1,22 @@
 #include "Scene.h"
+#include "Components/MeshRenderer.h"
+#include "Components/Transform.h"
 #include "Object/GameObject.h"
+#include "Object/ObjectHandleTable.h"
 #include "Foundation/Exception.h"
+#include "DynamicAABBTree.h"
 #include "SceneLightManager.h"
 #include "SceneRayTracingASManager.h"
 #include "SceneRenderObjectManager.h"
+#include "TickRegistry.h"
+#include "TransformSystem.h"
 
 Scene::Scene() {
     _pLightManager = std::make_unique<SceneLightManager>();
-    _pRenderObjectMgr = std::make_unique<SceneRenderObjectManager>();
+    _pSpatialIndex = std::make_unique<DynamicAABBTree>();
+    _pRenderObjectMgr = std::make_unique<SceneRenderObjectManager>(_pSpatialIndex.get());
+    _pTransformSystem = std::make_unique<TransformSystem>();
+    _pTickRegistry = std::make_unique<TickRegistry>();
 #if ENABLE_RAY_TRACING
     _pRayTracingASMgr = std::make_unique<SceneRayTracingASManager>();
 #endif
@@ -30,6 +39,7 @@ void Scene::AddGameObject(SharedPtr<GameObject> pGameObject) {
     }
     Exception::CondThrow(!pGameObject->GetSceneID().IsValid(), "This game object has been added to the scene");
     pGameObject->OnAddToScene(_sceneID);
+    pGameObject->_sceneSlot = static_cast<uint32_t>(_gameObjects.size());
     _gameObjects.push_back(std::move(pGameObject));
 }
 
@@ -38,13 +48,23 @@ void Scene::RemoveGameObject(const SharedPtr<GameObject> &pGameObject) {
 }
 
 void Scene::RemoveGameObjectInternal(InstanceID instanceId) {
-    for (auto it = _gameObjects.begin(); it != _gameObjects.end(); ++it) {
-        if ((*it)->GetInstanceID() == instanceId) {
-            (*it)->OnRemoveFormScene();
-            _gameObjects.erase(it);
-            return;
-        }
+    GameObject *pGameObject = ResolveInstanceID<GameObject>(instanceId);
+    // only the root objects own a slot, the children are removed together with their root
+    if (pGameObject == nullptr || pGameObject->_sceneSlot == GameObject::kInvalidSceneSlot ||
+        pGameObject->GetSceneID() != _sceneID) {
+        return;
+    }
+
+    uint32_t slot = pGameObject->_sceneSlot;
+    Assert(_gameObjects[slot].Get() == pGameObject);
+    SharedPtr<GameObject> pRemoved = std::move(_gameObjects[slot]);
+    pRemoved->OnRemoveFormScene();
+    pRemoved->_sceneSlot = GameObject::kInvalidSceneSlot;
+    if (slot + 1 != _gameObjects.size()) {
+        _gameObjects[slot] = std::move(_gameObjects.back());
+        _gameObjects[slot]->_sceneSlot = slot;
     }
+    _gameObjects.pop_back();
 }
 
 void Scene::OnCreate(std::string name, SceneID sceneID) {
@@ -55,39 +75,76 @@ void Scene::OnCreate(std::string name, SceneID sceneID) {
 void Scene::OnDestroy() {
     while (!_gameObjects.empty()) {
         _gameObjects.back()->OnRemoveFormScene();
+        _gameObjects.back()->_sceneSlot = GameObject::kInvalidSceneSlot;
         _gameObjects.pop_back();
     }
 }
 
-void Scene::InvokeTickFunc(void(GameObject::*pTickFunc)()) {
-    for (auto &pGameObject : _gameObjects) {
-	    if (pGameObject->GetActive()) {
-            (pGameObject.Get()->*pTickFunc)();
-	    }
-    }
-}
-
 void Scene::OnPreUpdate(GameTimer &timer) {
-    InvokeTickFunc(&GameObject::InnerOnPreUpdate);
+    _pTickRegistry->Invoke(Component::ePreUpdate);
 }
 
 void Scene::OnUpdate(GameTimer &timer) {
-    InvokeTickFunc(&GameObject::InnerOnUpdate);
+    _pTickRegistry->Invoke(Component::eUpdate);
 }
 
 void Scene::OnPostUpdate(GameTimer &timer) {
-    InvokeTickFunc(&GameObject::InnerOnPostUpdate);
+    _pTickRegistry->Invoke(Component::ePostUpdate);
 }
 
 void Scene::OnPreRender(GameTimer &timer) {
-    InvokeTickFunc(&GameObject::InnerOnPreRender);
+    // the render objects read the world matrices, resolve all changes of this frame first
+    _pTransformSystem->UpdateWorldMatrices();
+    _pRenderObjectMgr->OnPreRender();
+    DispatchTransformChanges();
+    _pRenderObjectMgr->SyncWorldBounds();
+    _pSpatialIndex->RebuildIfDegraded();
+    _pTickRegistry->Invoke(Component::ePreRender);
 }
 
 void Scene::OnRender(GameTimer &timer) {
-    InvokeTickFunc(&GameObject::InnerOnRender);
+    _pTickRegistry->Invoke(Component::eRender);
 }
 
 void Scene::OnPostRender(GameTimer &timer) {
-    InvokeTickFunc(&GameObject::InnerOnPostRender);
-    _pRenderObjectMgr->Reset();
+    _pTickRegistry->Invoke(Component::ePostRender);
+}
+
+auto Scene::GetComponents(uint32_t classIndex) const -> ReadonlyArraySpan<Component *> {
+    if (classIndex >= _componentLists.size()) {
+        return {};
+    }
+    return _componentLists[classIndex];
+}
+
+void Scene::RegisterComponent(Component *pComponent) {
+    uint32_t classIndex = pComponent->GetClassIndex();
+    if (classIndex >= _componentLists.size()) {
+        _componentLists.resize(classIndex + 1);
+    }
+    ComponentList &componentList = _componentLists[classIndex];
+    pComponent->_sceneSlot = static_cast<uint32_t>(componentList.size());
+    componentList.push_back(pComponent);
+}
+
+void Scene::UnregisterComponent(Component *pComponent) {
+    ComponentList &componentList = _componentLists[pComponent->GetClassIndex()];
+    uint32_t slot = pComponent->_sceneSlot;
+    Assert(componentList[slot] == pComponent);
+    componentList[slot] = componentList.back();
+    componentList[slot]->_sceneSlot = slot;
+    componentList.pop_back();
+    pComponent->_sceneSlot = Component::kInvalidSceneSlot;
+}
+
+auto Scene::GetChangedTransforms() const -> ReadonlyArraySpan<Transform *> {
+    return _pTransformSystem->GetChangedTransforms();
+}
+
+void Scene::DispatchTransformChanges() {
+    for (Transform *pTransform : _pTransformSystem->GetChangedTransforms()) {
+        if (MeshRenderer *pMeshRenderer = pTransform->GetGameObject()->GetComponent<MeshRenderer>()) {
+            pMeshRenderer->OnTransformChanged();
+        }
+    }
 }
@@ -1,20 +1,30 @@
 #pragma once
 #include <memory>
-#include <list>
+#include <vector>
 #include "Foundation/NonCopyable.h"
 #include "Object/InstanceID.hpp"
+#include "Object/ITypeBase.hpp"
 #include "SceneID.hpp"
+#include "ComponentSpan.hpp"
 #include "Foundation/Memory/SharedPtr.hpp"
+#include "Foundation/ReadonlyArraySpan.hpp"
 #include "Utils/GlobalCallbacks.h"
 
 class GameObject;
 class SceneLightManager;
 class SceneRenderObjectManager;
 class SceneRayTracingASManager;
+class TransformSystem;
+class Transform;
+class TickRegistry;
+class DynamicAABBTree;
+class Component;
 
 class Scene : private NonCopyable {
 	friend class SceneManager;
-	using GameObjectList = std::list<SharedPtr<GameObject>>;
+	friend class GameObject;
+	// dense, removal swaps the last root object into the freed slot
+	using GameObjectList = std::vector<SharedPtr<GameObject>>;
 public:
 	Scene();
 	~Scene();
@@ -54,29 +64,59 @@ public:
 	auto GetRayTracingASManager() const -> SceneRayTracingASManager * {
 		return _pRayTracingASMgr.get();
 	}
+	auto GetTransformSystem() const -> TransformSystem * {
+		return _pTransformSystem.get();
+	}
+	auto GetTickRegistry() const -> TickRegistry * {
+		return _pTickRegistry.get();
+	}
+	// world bounds of the mesh renderers for frustum, overlap and ray queries.
+	// up to date after the transform changes of OnPreRender were dispatched
+	auto GetSpatialIndex() const -> DynamicAABBTree * {
+		return _pSpatialIndex.get();
+	}
+	// valid after the transform update at the beginning of OnPreRender
+	auto GetChangedTransforms() const -> ReadonlyArraySpan<Transform *>;
+	// all components of exactly one class in this scene, stored contiguously for systems that process a single type
+	auto GetComponents(uint32_t classIndex) const -> ReadonlyArraySpan<Component *>;
+	template<typename T>
+		requires(std::is_base_of_v<Component, T>)
+	auto GetComponents() const -> ComponentSpan<T> {
+		return GetComponents(::GetClassIndex<T>());
+	}
 private:
+	void RegisterComponent(Component *pComponent);
+	void UnregisterComponent(Component *pComponent);
 	void RemoveGameObjectInternal(InstanceID instanceId);
 	void OnCreate(std::string name, SceneID sceneID);
 	void OnDestroy();
 private:
-	void InvokeTickFunc(void (GameObject::*pTickFunc)());
 	void OnPreUpdate(GameTimer &timer);
 	void OnUpdate(GameTimer &timer);
 	void OnPostUpdate(GameTimer &timer);
 	void OnPreRender(GameTimer &timer);
 	void OnRender(GameTimer &timer);
 	void OnPostRender(GameTimer &timer);
+	void DispatchTransformChanges();
 private:
 	using SceneRenderObjectManagerPtr = std::unique_ptr<SceneRenderObjectManager>;
 	using SceneLightManagerPtr = std::unique_ptr<SceneLightManager>;
 	using SceneRayTracingASManagerPtr = std::unique_ptr<SceneRayTracingASManager>;
+	using TransformSystemPtr = std::unique_ptr<TransformSystem>;
+	using TickRegistryPtr = std::unique_ptr<TickRegistry>;
+	using DynamicAABBTreePtr = std::unique_ptr<DynamicAABBTree>;
+	using ComponentList = std::vector<Component *>;
 	// clang-format off
 	std::string					_name;
 	SceneID						_sceneID;
 	GameObjectList				_gameObjects;
 	SceneLightManagerPtr		_pLightManager;
+	DynamicAABBTreePtr			_pSpatialIndex;
 	SceneRenderObjectManagerPtr	_pRenderObjectMgr;
 	SceneRayTracingASManagerPtr	_pRayTracingASMgr;
+	TransformSystemPtr			_pTransformSystem;
+	TickRegistryPtr				_pTickRegistry;
+	std::vector<ComponentList>	_componentLists;
 
 	CallbackHandle				_preUpdateCallbackHandle;
 	CallbackHandle				_updateCallbackHandle;
@@ -54,7 +54,8 @@ auto SceneRayTracingASManager::BuildMeshBottomLevelAS() -> std::shared_ptr<Regio
         geometry._instanceMask = 0xFF;    // todo
         geometry._instanceFlag = isTransparent ? dx::RayTracingInstanceFlags::eForceNonOpaque
                                                : dx::RayTracingInstanceFlags::eNone;
-        geometry._transform = pMeshRenderer->GetGameObject()->GetTransform()->GetWorldMatrix();
+        // kept up to date by the transform change list, static renderers cost no matrix work here
+        geometry._transform = pMeshRenderer->GetASInstance().transform;
         pRegionTopLevelAS->_geometries.push_back(geometry);
 
         pMeshRenderer->GetMesh()->RequireBottomLevelAS(_pAsyncASBuilder.get());
@@ -1,107 +1,442 @@
+#include <algorithm>
 #include <bit>
+#include <cmath>
+#include <limits>
 #include "SceneRenderObjectManager.h"
 #include "RenderObject/RenderGroup.hpp"
 #include "Components/Transform.h"
 #include "Foundation/Logger.h"
 #include "RenderObject/RenderObject.h"
 #include "RenderObject/Material.h"
+#include "Foundation/Memory/FrameArena.h"
+#include "Foundation/RadixSort.hpp"
+#include "Components/MeshRenderer.h"
+#include "RenderObject/Mesh.h"
+#include "DynamicAABBTree.h"
+#include "Renderer/RenderUtils/OcclusionCuller.h"
+#include "Renderer/RenderUtils/GPUScene.h"
 
-RenderObjectKey::RenderObjectKey() : key1(0), key2(0) {
+namespace {
+
+constexpr size_t kGroupOffsetBits = 10;
+constexpr size_t kPriorityBits = 8;
+constexpr size_t kPipelineBits = 14;
+constexpr size_t kStateMaterialBits = 12;
+constexpr size_t kStateDepthBits = 20;
+constexpr size_t kBlendMaterialBits = 8;
+constexpr size_t kBlendDepthBits = 24;
+static_assert(kGroupOffsetBits + kPriorityBits + kPipelineBits + kStateMaterialBits + kStateDepthBits == 64);
+static_assert(kGroupOffsetBits + kPriorityBits + kBlendDepthBits + kPipelineBits + kBlendMaterialBits == 64);
+
+auto ClampBits(uint32_t value, size_t bits) -> uint64_t {
+    return std::min<uint64_t>(value, (uint64_t(1) << bits) - 1);
+}
+
+auto MaskBits(uint32_t value, size_t bits) -> uint64_t {
+    return value & ((uint64_t(1) << bits) - 1);
+}
+
+// fibonacci hashing moves the varying middle bits of the pointer into the top bits, the key keeps the low bits
+auto HashMaterialPointer(const Material *pMaterial) -> uint32_t {
+    auto address = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pMaterial));
+    return static_cast<uint32_t>((address * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+}    // namespace
+
+RenderObjectKey::RenderObjectKey() : _renderGroup(0), _priority(0), _pipelineID(0), _materialID(0) {
 }
 
 void RenderObjectKey::SetRenderGroup(uint16_t renderGroup) {
-    this->renderGroup = renderGroup;
+    _renderGroup = renderGroup;
 }
 
 auto RenderObjectKey::GetRenderGroup() const -> uint16_t {
-    return renderGroup;
+    return _renderGroup;
 }
 
 void RenderObjectKey::SetPriority(uint16_t priority) {
-    this->priority = priority;
+    _priority = priority;
 }
 
 auto RenderObjectKey::GetPriority() const -> uint16_t {
-    return priority;;
+    return _priority;
 }
 
-void RenderObjectKey::SetPipelineID(uint32_t variantID) {
-    this->pipelineID = variantID;
+void RenderObjectKey::SetPipelineID(uint32_t pipelineID) {
+    Assert(pipelineID < (1 << kPipelineBits));
+    _pipelineID = pipelineID;
 }
 
 auto RenderObjectKey::GetPipelineID() const -> uint32_t {
-    return pipelineID;
+    return _pipelineID;
+}
+
+void RenderObjectKey::SetMaterialID(uint32_t materialID) {
+    _materialID = materialID;
+}
+
+auto RenderObjectKey::GetMaterialID() const -> uint32_t {
+    return _materialID;
+}
+
+auto RenderObjectKey::Pack(float depthSqr) const -> uint64_t {
+    uint64_t key = ClampBits(_renderGroup - RenderGroup::GetGroupBase(_renderGroup), kGroupOffsetBits);
+    key = (key << kPriorityBits) | ClampBits(_priority, kPriorityBits);
+    if (RenderGroup::GetSortPolicy(_renderGroup) == RenderGroup::eFarToNear) {
+        uint32_t depth = QuantizeDepth(depthSqr, kBlendDepthBits);
+        key = (key << kBlendDepthBits) | MaskBits(~depth, kBlendDepthBits);
+        key = (key << kPipelineBits) | MaskBits(_pipelineID, kPipelineBits);
+        key = (key << kBlendMaterialBits) | MaskBits(_materialID, kBlendMaterialBits);
+    } else {
+        key = (key << kPipelineBits) | MaskBits(_pipelineID, kPipelineBits);
+        key = (key << kStateMaterialBits) | MaskBits(_materialID, kStateMaterialBits);
+        key = (key << kStateDepthBits) | QuantizeDepth(depthSqr, kStateDepthBits);
+    }
+    return key;
+}
+
+auto RenderObjectKey::QuantizeDepth(float depthSqr, size_t bits) -> uint32_t {
+    Assert(bits > 0 && bits < 32);
+    // the bit pattern of a non negative float grows with its value, the sign bit is always zero
+    depthSqr = std::max(depthSqr, 0.f);
+    if (!std::isfinite(depthSqr)) {
+        depthSqr = std::numeric_limits<float>::max();
+    }
+    return std::bit_cast<uint32_t>(depthSqr) >> (31 - bits);
+}
+
+SceneRenderObjectManager::SceneRenderObjectManager(DynamicAABBTree *pSpatialIndex)
+    : _pSpatialIndex(pSpatialIndex),
+      _bucketDirty{},
+      _cameraPos(0.f),
+      _matViewProj(1.f),
+      _cameraPosValid(false),
+      _materialVersion(Material::GetChangeVersion()),
+      _meshVersion(Mesh::GetChangeVersion()),
+      _lodScreenError(kDefaultLodScreenError) {
+}
+
+SceneRenderObjectManager::~SceneRenderObjectManager() {
+    for (const Entry &entry : _entries) {
+        if (entry.proxyID != DynamicAABBTree::kNullNode) {
+            _pSpatialIndex->DestroyProxy(entry.proxyID);
+        }
+        entry.pMeshRenderer->_renderData.registrySlot = kInvalidSlot;
+    }
+}
+
+void SceneRenderObjectManager::AddMeshRenderer(MeshRenderer *pMeshRenderer) {
+    Assert(pMeshRenderer->_renderData.registrySlot == kInvalidSlot);
+    pMeshRenderer->_renderData.registrySlot = static_cast<uint32_t>(_entries.size());
+    _entries.push_back(Entry{pMeshRenderer, RenderObjectKey{}, eHidden, false, false, DynamicAABBTree::kNullNode, 0});
+    _worldBounds.Resize(_entries.size());
+    _visible.push_back(1);
+    SetWorldBounds(pMeshRenderer->_renderData.registrySlot, pMeshRenderer->_renderData.renderObject.worldBounds);
+    MarkDirty(pMeshRenderer);
+    GPUScene::GetInstance()->AddObject(&pMeshRenderer->_renderData.renderObject);
 }
 
-void RenderObjectKey::SetDepthSquare(double depthSqr) {
-	this->distanceSqr = depthSqr;
+void SceneRenderObjectManager::RemoveMeshRenderer(MeshRenderer *pMeshRenderer) {
+    uint32_t slot = pMeshRenderer->_renderData.registrySlot;
+    Assert(slot != kInvalidSlot && _entries[slot].pMeshRenderer == pMeshRenderer);
+    Entry &entry = _entries[slot];
+    MarkBucketDirty(entry.bucket);
+    if (entry.proxyID != DynamicAABBTree::kNullNode) {
+        _pSpatialIndex->DestroyProxy(entry.proxyID);
+    }
+    if (entry.dirty) {
+        std::erase(_dirtyRenderers, pMeshRenderer);
+    }
+    if (entry.boundsDirty) {
+        std::erase(_boundsDirtyRenderers, pMeshRenderer);
+    }
+    std::erase(_movedRenderers, pMeshRenderer);
+    if (GPUScene *pGPUScene = GPUScene::GetInstance()) {
+        pGPUScene->RemoveObject(&pMeshRenderer->_renderData.renderObject);
+    }
+
+    entry = _entries.back();
+    entry.pMeshRenderer->_renderData.registrySlot = slot;
+    _entries.pop_back();
+    _worldBounds.Move(slot, _entries.size());
+    _worldBounds.Resize(_entries.size());
+    _visible[slot] = _visible.back();
+    _visible.pop_back();
+    pMeshRenderer->_renderData.registrySlot = kInvalidSlot;
 }
 
-auto RenderObjectKey::GetDepthSquare() const -> double {
-	return distanceSqr;
+void SceneRenderObjectManager::MarkDirty(MeshRenderer *pMeshRenderer) {
+    Entry &entry = _entries[pMeshRenderer->_renderData.registrySlot];
+    if (!entry.dirty) {
+        entry.dirty = true;
+        _dirtyRenderers.push_back(pMeshRenderer);
+    }
 }
 
-void SceneRenderObjectManager::ClassifyRenderObjects(const glm::vec3 &worldCameraPos) {
-    struct Item {
-        RenderObjectKey key;
-        RenderObject *pRenderObject;
-    };
+void SceneRenderObjectManager::MarkMoved(MeshRenderer *pMeshRenderer) {
+    Entry &entry = _entries[pMeshRenderer->_renderData.registrySlot];
+    MarkBucketDirty(entry.bucket);
+    _movedRenderers.push_back(pMeshRenderer);
+}
 
-    std::vector<Item> items;
-    items.reserve(_renderObjects.size());
-    for (size_t i = 0; i < _renderObjects.size(); ++i) {
-        RenderObject *pRenderObject = _renderObjects[i];
-        Item item;
-        item.key.SetRenderGroup(pRenderObject->pMaterial->GetRenderGroup());
-        item.key.SetPriority(pRenderObject->priority);
-        item.key.SetPipelineID(pRenderObject->pMaterial->GetPipelineID());
+void SceneRenderObjectManager::MarkBoundsDirty(MeshRenderer *pMeshRenderer) {
+    Entry &entry = _entries[pMeshRenderer->_renderData.registrySlot];
+    MarkBucketDirty(entry.bucket);
+    if (!entry.boundsDirty) {
+        entry.boundsDirty = true;
+        _boundsDirtyRenderers.push_back(pMeshRenderer);
+    }
+}
+
+void SceneRenderObjectManager::OnPreRender() {
+    for (MeshRenderer *pMeshRenderer : _movedRenderers) {
+        pMeshRenderer->SettleMotion();
+    }
+    _movedRenderers.clear();
+}
+
+void SceneRenderObjectManager::ClassifyRenderObjects(const glm::vec3 &worldCameraPos, const glm::mat4x4 &matViewProj) {
+    // a mesh changed somewhere, every entry is refreshed. this only happens while assets are being loaded or edited
+    uint64_t materialVersion = Material::GetChangeVersion();
+    uint64_t meshVersion = Mesh::GetChangeVersion();
+    if (meshVersion != _meshVersion) {
+        _meshVersion = meshVersion;
+        _materialVersion = materialVersion;
+        for (Entry &entry : _entries) {
+            MarkDirty(entry.pMeshRenderer);
+        }
+    } else if (materialVersion != _materialVersion) {
+        // a material is shared by many renderers and the first refresh clears its dirty flag, so every entry compares
+        // the version of its own material. streamed textures only refresh the renderers of the patched materials
+        _materialVersion = materialVersion;
+        for (Entry &entry : _entries) {
+            const std::shared_ptr<Material> &pMaterial = entry.pMeshRenderer->GetMaterial();
+            if (!entry.dirty && pMaterial != nullptr && pMaterial->GetVersion() != entry.materialVersion) {
+                MarkDirty(entry.pMeshRenderer);
+            }
+        }
+    }
+
+    for (MeshRenderer *pMeshRenderer : _dirtyRenderers) {
+        RefreshEntry(_entries[pMeshRenderer->_renderData.registrySlot]);
+    }
+    _dirtyRenderers.clear();
 
+    SyncWorldBounds();
+
+    // a rotation only changes the frustum, so the matrix is compared as well
+    bool cameraMoved = !_cameraPosValid || any(epsilonNotEqual(_cameraPos, worldCameraPos, Transform::kEpsilon));
+    bool viewChanged = cameraMoved || _matViewProj != matViewProj;
+    _cameraPos = worldCameraPos;
+    _matViewProj = matViewProj;
+    _cameraPosValid = true;
+
+    bool anyBucketDirty = std::ranges::any_of(_bucketDirty, [](bool dirty) { return dirty; });
+    if (viewChanged || anyBucketDirty) {
+        Cull(matViewProj);
+    }
+
+    if (viewChanged || anyBucketDirty) {
+        SortBuckets(worldCameraPos, viewChanged);
+    }
+    SelectLods(matViewProj);
+}
+
+void SceneRenderObjectManager::RefreshEntry(Entry &entry) {
+    entry.dirty = false;
+    MarkBucketDirty(entry.bucket);
+
+    MeshRenderer *pMeshRenderer = entry.pMeshRenderer;
+    entry.bucket = eHidden;
+    const std::shared_ptr<Material> &pMaterial = pMeshRenderer->GetMaterial();
+    entry.materialVersion = pMaterial != nullptr ? pMaterial->GetVersion() : 0;
+    bool shouldRender = pMeshRenderer->RefreshRenderObject();
+    SetWorldBounds(pMeshRenderer->_renderData.registrySlot, pMeshRenderer->_renderData.renderObject.worldBounds);
+    if (!shouldRender) {
+        return;
+    }
+
+    // the passes index the GPUScene buffers with these slots, they stay valid while the renderer is registered
+    const RenderObject *pRenderObject = &pMeshRenderer->_renderData.renderObject;
+    Assert(pRenderObject->objectIndex != GPUSceneTable::kInvalidSlot);
+    Assert(pRenderObject->pMaterial->GetGPUSceneIndex() != GPUSceneTable::kInvalidSlot);
+    uint16_t renderGroup = pRenderObject->pMaterial->GetRenderGroup();
+    entry.key = RenderObjectKey{};
+    entry.key.SetRenderGroup(renderGroup);
+    entry.key.SetPriority(pRenderObject->priority);
+    entry.key.SetPipelineID(pRenderObject->pMaterial->GetPipelineID());
+    entry.key.SetMaterialID(HashMaterialPointer(pRenderObject->pMaterial));
+    if (RenderGroup::IsOpaque(renderGroup)) {
+        entry.bucket = eOpaque;
+    } else if (RenderGroup::IsAlphaTest(renderGroup)) {
+        entry.bucket = eAlphaTest;
+    } else if (RenderGroup::IsTransparent(renderGroup)) {
+        entry.bucket = eTransparent;
+    }
+    MarkBucketDirty(entry.bucket);
+}
+
+void SceneRenderObjectManager::SortBuckets(const glm::vec3 &worldCameraPos, bool sortAll) {
+    std::array<bool, eBucketCount> sortBucket = {};
+    for (size_t bucket = 0; bucket < eBucketCount; ++bucket) {
+        sortBucket[bucket] = sortAll || _bucketDirty[bucket];
+    }
+
+    // a single pass over the registry partitions the visible entries into the buckets that are sorted
+    std::array<FrameVector<SortItem>, eBucketCount> bucketItems;
+    for (size_t i = 0; i < _entries.size(); ++i) {
+        const Entry &entry = _entries[i];
+        if (entry.bucket == eHidden || !sortBucket[entry.bucket] || !_visible[i]) {
+            continue;
+        }
+        RenderObject *pRenderObject = &entry.pMeshRenderer->_renderData.renderObject;
         glm::vec3 vector = worldCameraPos - pRenderObject->pTransform->GetWorldPosition();
-        float depthSqr = dot(vector, vector);
-        item.key.SetDepthSquare(depthSqr);
+        bucketItems[entry.bucket].push_back(SortItem{entry.key.Pack(dot(vector, vector)), pRenderObject});
+    }
 
-        item.pRenderObject = pRenderObject;
-        items.push_back(item);
+    for (size_t bucket = 0; bucket < eBucketCount; ++bucket) {
+        if (sortBucket[bucket]) {
+            SortBucket(static_cast<Bucket>(bucket), bucketItems[bucket]);
+        }
     }
+}
 
-    std::ranges::stable_sort(items, [](const Item &lhs, const Item &rhs) { return lhs.key < rhs.key; });
+void SceneRenderObjectManager::SortBucket(Bucket bucket, FrameVector<SortItem> &items) {
+    // the radix sort is stable, equal keys keep the registry order
+    FrameVector<SortItem> scratch(items.size());
+    RadixSort::ParallelSort(std::span(items), std::span(scratch), [](const SortItem &item) { return item.key; });
 
     static bool debugPrint = false;
     if (debugPrint) {
-        for (auto item : items) {
-	        Logger::Debug("RenderGroup: {}, Priority: {}, PipelineID: {}, DepthSqr: {}", 
-                item.key.GetRenderGroup(),
-                item.key.GetPriority(),
-                item.key.GetPipelineID(),
-                item.key.GetDepthSquare()
-            );
+        for (const SortItem &item : items) {
+            Logger::Debug("SortKey: {:016x}", item.key);
         }
     }
 
-    _opaqueRenderObjects.clear();
-    _alphaTestRenderObjects.clear();
-    _transparentRenderObjects.clear();
+    std::vector<RenderObject *> &renderObjects = _buckets[bucket];
+    renderObjects.clear();
+    for (const SortItem &item : items) {
+        renderObjects.push_back(item.pRenderObject);
+    }
+    _bucketDirty[bucket] = false;
+}
 
-    auto it = items.begin();
-    auto FetchRenderObject = [&](std::vector<RenderObject *> &result, bool (*pItemInRenderGroup)(uint16_t)) {
-        while (it != items.end()) {
-            if (pItemInRenderGroup(it->key.GetRenderGroup())) {
-                result.push_back(it->pRenderObject);
-                ++it;
-            } else {
-                break;
+void SceneRenderObjectManager::SyncWorldBounds() {
+    for (MeshRenderer *pMeshRenderer : _boundsDirtyRenderers) {
+        uint32_t slot = pMeshRenderer->_renderData.registrySlot;
+        _entries[slot].boundsDirty = false;
+        SetWorldBounds(slot, pMeshRenderer->_renderData.renderObject.worldBounds);
+    }
+    _boundsDirtyRenderers.clear();
+}
+
+void SceneRenderObjectManager::SetWorldBounds(uint32_t slot, const AABB &bounds) {
+    _worldBounds.Set(slot, bounds);
+
+    // unbounded objects stay out of the tree, the culling treats them as always visible
+    Entry &entry = _entries[slot];
+    if (!bounds.IsValid()) {
+        if (entry.proxyID != DynamicAABBTree::kNullNode) {
+            _pSpatialIndex->DestroyProxy(entry.proxyID);
+            entry.proxyID = DynamicAABBTree::kNullNode;
+        }
+    } else if (entry.proxyID == DynamicAABBTree::kNullNode) {
+        entry.proxyID = _pSpatialIndex->CreateProxy(bounds, entry.pMeshRenderer);
+    } else {
+        _pSpatialIndex->MoveProxy(entry.proxyID, bounds);
+    }
+}
+
+void SceneRenderObjectManager::Cull(const glm::mat4x4 &matViewProj) {
+    Frustum frustum = Frustum::FromMatrix(matViewProj);
+    size_t visibleCount = 0;
+    _cullingStatistics.usedSpatialIndex = _entries.size() >= kSpatialCullingThreshold;
+    if (!_cullingStatistics.usedSpatialIndex) {
+        visibleCount = FrustumCulling::Cull(frustum, _worldBounds, _visible.data());
+    } else {
+        // the tree tests the fat boxes, the visible set is slightly conservative
+        for (size_t i = 0; i < _entries.size(); ++i) {
+            bool unbounded = _entries[i].proxyID == DynamicAABBTree::kNullNode;
+            _visible[i] = static_cast<uint8_t>(unbounded);
+            visibleCount += static_cast<size_t>(unbounded);
+        }
+        _pSpatialIndex->QueryFrustum(frustum, [&](int32_t proxyID) {
+            auto *pMeshRenderer = static_cast<MeshRenderer *>(_pSpatialIndex->GetUserData(proxyID));
+            _visible[pMeshRenderer->_renderData.registrySlot] = 1;
+            ++visibleCount;
+            return true;
+        });
+    }
+
+    // the draw ranges of static batches and other meshes with several sub meshes
+    for (size_t i = 0; i < _entries.size(); ++i) {
+        if (_visible[i] && _entries[i].bucket != eHidden && !_entries[i].pMeshRenderer->CullSubMeshes(frustum)) {
+            _visible[i] = 0;
+            --visibleCount;
+        }
+    }
+    _cullingStatistics.testedCount = _entries.size();
+    _cullingStatistics.culledCount = _entries.size() - visibleCount;
+}
+
+void SceneRenderObjectManager::ApplyOcclusionCulling(OcclusionCuller *pCuller, bool reversedZ) {
+    pCuller->BeginFrame(_matViewProj, reversedZ);
+    for (size_t i = 0; i < _entries.size(); ++i) {
+        MeshRenderer *pMeshRenderer = _entries[i].pMeshRenderer;
+        if (_entries[i].bucket != eOpaque || !_visible[i] || !pMeshRenderer->IsOccluder()) {
+            continue;
+        }
+        const RenderObject &renderObject = pMeshRenderer->_renderData.renderObject;
+        ReadonlyArraySpan<glm::vec3> vertices = pMeshRenderer->GetOccluderVertices();
+        ReadonlyArraySpan<uint32_t> indices = renderObject.pMesh->GetIndices();
+        for (const SubMesh &subMesh : renderObject.pMesh->GetSubMeshes()) {
+            pCuller->AddOccluder(renderObject.cbPreObject.matWorld,
+                ReadonlyArraySpan<glm::vec3>(vertices.Data() + subMesh.baseVertexLocation,
+                    vertices.Count() - subMesh.baseVertexLocation),
+                ReadonlyArraySpan<uint32_t>(indices.Data() + subMesh.baseIndexLocation, subMesh.indexCount));
+        }
+    }
+    pCuller->RasterizeOccluders();
+
+    for (size_t bucket = 0; bucket < _unoccluded.size(); ++bucket) {
+        std::vector<RenderObject *> &renderObjects = _unoccluded[bucket];
+        renderObjects.clear();
+        for (RenderObject *pRenderObject : _buckets[bucket]) {
+            if (pCuller->IsVisible(pRenderObject->worldBounds)) {
+                renderObjects.push_back(pRenderObject);
             }
         }
-    };
+    }
+}
 
-    FetchRenderObject(_opaqueRenderObjects, &RenderGroup::IsOpaque);
-    FetchRenderObject(_alphaTestRenderObjects, &RenderGroup::IsAlphaTest);
-    FetchRenderObject(_transparentRenderObjects, &RenderGroup::IsTransparent);
+void SceneRenderObjectManager::SelectLods(const glm::mat4x4 &matViewProj) {
+    // the y row of the view projection is the y row of the view scaled by the projection, the w row is the view depth
+    float projScale = length(glm::vec3(matViewProj[0][1], matViewProj[1][1], matViewProj[2][1]));
+    glm::vec4 depthRow(matViewProj[0][3], matViewProj[1][3], matViewProj[2][3], matViewProj[3][3]);
+    for (size_t i = 0; i < _entries.size(); ++i) {
+        MeshRenderer *pMeshRenderer = _entries[i].pMeshRenderer;
+        const RenderObject &renderObject = pMeshRenderer->_renderData.renderObject;
+        if (_entries[i].bucket == eHidden || !_visible[i] || renderObject.pMesh->GetLodCount() <= 1 ||
+            !renderObject.worldBounds.IsValid()) {
+            continue;
+        }
+
+        // the nearest point of the bounding sphere decides, inside of it the finest level is kept
+        const AABB &worldBounds = renderObject.worldBounds;
+        float depth = dot(glm::vec3(depthRow), worldBounds.GetCenter()) + depthRow.w - length(worldBounds.GetExtents());
+        const glm::mat4x4 &matWorld = renderObject.cbPreObject.matWorld;
+        float worldScale = std::max({ length(glm::vec3(matWorld[0])),
+            length(glm::vec3(matWorld[1])),
+            length(glm::vec3(matWorld[2])) });
+        float screenScale = depth > Transform::kEpsilon ? 0.5f * projScale * worldScale / depth
+                                                        : std::numeric_limits<float>::max();
+        pMeshRenderer->SelectLod(screenScale, _lodScreenError);
+    }
 }
 
-std::strong_ordering operator<=>(const RenderObjectKey &lhs, const RenderObjectKey &rhs) {
-    if (std::strong_ordering cmp = lhs.key1 <=> rhs.key1; cmp != std::strong_ordering::equal) {
-        return cmp;
+void SceneRenderObjectManager::MarkBucketDirty(Bucket bucket) {
+    if (bucket < eBucketCount) {
+        _bucketDirty[bucket] = true;
     }
-    return lhs.key2 <=> rhs.key2;
 }
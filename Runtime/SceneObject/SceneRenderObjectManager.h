@@ -1,56 +1,158 @@
 #pragma once
+#include <array>
+#include <cstdint>
 #include <vector>
 #include "Foundation/NonCopyable.h"
 #include "Foundation/GlmStd.hpp"
+#include "Foundation/FrustumCulling.h"
+#include "Foundation/Memory/FrameArena.h"
 
+// Sort state of a render object, packed into a 64 bit radix sort key together with the quantized camera depth.
+// The layout follows the sort policy of the render group, from the most significant bits:
+//  eStateThenNearToFar: group offset 10 | priority 8 | pipeline 14 | material 12 | depth 20
+//  eFarToNear:          group offset 10 | priority 8 | inverted depth 24 | pipeline 14 | material 8
 class RenderObjectKey {
-	union {
-		uint64_t key1;
-		struct {
-			uint32_t pipelineID;
-			uint16_t priority;
-			uint16_t renderGroup;
-		};
-	};
-	union {
-		uint64_t key2;
-		double distanceSqr;
-	};
 public:
 	RenderObjectKey();
 	void SetRenderGroup(uint16_t renderGroup);
 	auto GetRenderGroup() const -> uint16_t;
 	void SetPriority(uint16_t priority);
 	auto GetPriority() const -> uint16_t;
-	void SetPipelineID(uint32_t variantID);
+	void SetPipelineID(uint32_t pipelineID);
 	auto GetPipelineID() const -> uint32_t;
-	void SetDepthSquare(double depthSqr);
-	auto GetDepthSquare() const -> double;
-	friend std::strong_ordering operator<=>(const RenderObjectKey &, const RenderObjectKey &);
+	// only used to keep objects of the same material together, different materials may share an id
+	void SetMaterialID(uint32_t materialID);
+	auto GetMaterialID() const -> uint32_t;
+	auto Pack(float depthSqr) const -> uint64_t;
+	// monotonic in depthSqr, keeps the highest bits of the float representation
+	static auto QuantizeDepth(float depthSqr, size_t bits) -> uint32_t;
+private:
+	// clang-format off
+	uint16_t	_renderGroup;
+	uint16_t	_priority;
+	uint32_t	_pipelineID;
+	uint32_t	_materialID;
+	// clang-format on
 };
 
 struct RenderObject;
+class MeshRenderer;
+class DynamicAABBTree;
+class OcclusionCuller;
+
+// Retained registry of the render objects of a scene.
+// Mesh renderers are registered while they are enabled, changes of the mesh, the material or the transform mark
+// their entry dirty, and only the buckets touched by a change (or all of them when the camera moved) are sorted again.
+// The world bounds are kept in structure of arrays form and in the spatial index of the scene, small registries are
+// frustum culled linearly and larger ones through the tree before the buckets are sorted.
 class SceneRenderObjectManager : private NonCopyable {
 public:
-	void AddRenderObject(RenderObject *pRenderObject) {
-		_renderObjects.push_back(pRenderObject);
-	}
-	void Reset() {
-		_renderObjects.clear();
+	static constexpr uint32_t kInvalidSlot = static_cast<uint32_t>(-1);
+	// below this count the linear SIMD test is faster than the tree traversal, see Benchmarks/SpatialQueryBenchmark
+	static constexpr size_t kSpatialCullingThreshold = 16 * 1024;
+	// largest projected simplification error of a mesh level of detail, about one pixel at 1080p
+	static constexpr float kDefaultLodScreenError = 1.f / 1080.f;
+	struct CullingStatistics {
+		size_t testedCount = 0;
+		size_t culledCount = 0;
+		// the culling went through the spatial index
+		bool usedSpatialIndex = false;
+	};
+public:
+	explicit SceneRenderObjectManager(DynamicAABBTree *pSpatialIndex);
+	~SceneRenderObjectManager();
+	void AddMeshRenderer(MeshRenderer *pMeshRenderer);
+	void RemoveMeshRenderer(MeshRenderer *pMeshRenderer);
+	// the mesh or the material changed, the sort key and the bucket are recomputed
+	void MarkDirty(MeshRenderer *pMeshRenderer);
+	// the world matrix changed, the depth of the bucket is stale
+	void MarkMoved(MeshRenderer *pMeshRenderer);
+	// the world bounds of the render object changed
+	void MarkBoundsDirty(MeshRenderer *pMeshRenderer);
+	// applies the pending world bounds changes to the culling data and the spatial index
+	void SyncWorldBounds();
+	// settles the motion vectors of the renderers that stopped moving, call before the moved transforms are applied
+	void OnPreRender();
+	auto GetRenderObjectCount() const -> size_t {
+		return _entries.size();
 	}
 	auto GetOpaqueRenderObjects() const -> const std::vector<RenderObject *> & {
-		return _opaqueRenderObjects;
+		return _buckets[eOpaque];
 	}
 	auto GetAlphaTestRenderObjects() const -> const std::vector<RenderObject *> & {
-		return _alphaTestRenderObjects;
+		return _buckets[eAlphaTest];
 	}
 	auto GetTransparentRenderObjects() const -> const std::vector<RenderObject *> & {
-		return _transparentRenderObjects;
+		return _buckets[eTransparent];
+	}
+	// culls, sorts and selects the mesh levels of detail of the visible render objects
+	void ClassifyRenderObjects(const glm::vec3 &worldCameraPos, const glm::mat4x4 &matViewProj);
+	// fraction of the screen height
+	void SetLodScreenError(float screenError) {
+		_lodScreenError = screenError;
 	}
-	void ClassifyRenderObjects(const glm::vec3 &worldCameraPos);
+	// result of the last frustum test
+	auto GetCullingStatistics() const -> const CullingStatistics & {
+		return _cullingStatistics;
+	}
+	// rasterizes the visible occluders and removes the opaque and alpha test objects hidden behind them from the
+	// unoccluded lists, which keep the order of the buckets. call after ClassifyRenderObjects
+	void ApplyOcclusionCulling(OcclusionCuller *pCuller, bool reversedZ);
+	auto GetUnoccludedOpaqueRenderObjects() const -> const std::vector<RenderObject *> & {
+		return _unoccluded[eOpaque];
+	}
+	auto GetUnoccludedAlphaTestRenderObjects() const -> const std::vector<RenderObject *> & {
+		return _unoccluded[eAlphaTest];
+	}
+private:
+	enum Bucket : uint8_t {
+		eOpaque,
+		eAlphaTest,
+		eTransparent,
+		eBucketCount,
+		eHidden = eBucketCount,
+	};
+	struct Entry {
+		MeshRenderer   *pMeshRenderer;
+		RenderObjectKey	key;
+		Bucket			bucket;
+		bool			dirty;
+		bool			boundsDirty;
+		int32_t			proxyID;
+		// version of the material when the entry was refreshed
+		uint64_t		materialVersion;
+	};
+	struct SortItem {
+		uint64_t		key;
+		RenderObject   *pRenderObject;
+	};
+	void RefreshEntry(Entry &entry);
+	// partitions the visible entries of the buckets to sort in one pass, then sorts every bucket on its own
+	void SortBuckets(const glm::vec3 &worldCameraPos, bool sortAll);
+	void SortBucket(Bucket bucket, FrameVector<SortItem> &items);
+	void MarkBucketDirty(Bucket bucket);
+	void SetWorldBounds(uint32_t slot, const AABB &bounds);
+	void Cull(const glm::mat4x4 &matViewProj);
+	void SelectLods(const glm::mat4x4 &matViewProj);
 private:
-	std::vector<RenderObject *> _renderObjects;
-	std::vector<RenderObject *>	_opaqueRenderObjects;
-	std::vector<RenderObject *> _alphaTestRenderObjects;
-	std::vector<RenderObject *>	_transparentRenderObjects;
+	// clang-format off
+	DynamicAABBTree									   *_pSpatialIndex;
+	std::vector<Entry>									_entries;
+	std::vector<MeshRenderer *>							_dirtyRenderers;
+	std::vector<MeshRenderer *>							_movedRenderers;
+	std::vector<MeshRenderer *>							_boundsDirtyRenderers;
+	AABBSoA												_worldBounds;
+	std::vector<uint8_t>								_visible;
+	CullingStatistics									_cullingStatistics;
+	std::array<std::vector<RenderObject *>, eBucketCount>	_buckets;
+	std::array<bool, eBucketCount>						_bucketDirty;
+	// the transparent bucket does not write depth and is never occlusion culled
+	std::array<std::vector<RenderObject *>, eTransparent>	_unoccluded;
+	glm::vec3											_cameraPos;
+	glm::mat4x4											_matViewProj;
+	bool												_cameraPosValid;
+	uint64_t											_materialVersion;
+	uint64_t											_meshVersion;
+	float												_lodScreenError;
+	// clang-format on
 };
@@ -0,0 +1,271 @@
+#include "StaticBatcher.h"
+#include <algorithm>
+#include <functional>
+#include "Components/MeshRenderer.h"
+#include "Components/Transform.h"
+#include "Foundation/Formatter.hpp"
+#include "Foundation/Logger.h"
+#include "Object/GameObject.h"
+#include "RenderObject/Material.h"
+#include "RenderObject/Mesh.h"
+#include "RenderObject/RenderGroup.hpp"
+#include "RenderObject/VertexSemantic.hpp"
+
+namespace {
+
+// spreads the lower 10 bits of value to every third bit
+auto ExpandBits(uint32_t value) -> uint32_t {
+    value = (value * 0x00010001u) & 0xFF0000FFu;
+    value = (value * 0x00000101u) & 0x0F00F00Fu;
+    value = (value * 0x00000011u) & 0xC30C30C3u;
+    value = (value * 0x00000005u) & 0x49249249u;
+    return value;
+}
+
+auto MortonCode(const glm::vec3 &point, const AABB &bounds) -> uint32_t {
+    glm::vec3 extents = glm::max(bounds.max - bounds.min, glm::vec3(1e-6f));
+    glm::vec3 coord = glm::clamp((point - bounds.min) / extents, glm::vec3(0.f), glm::vec3(1.f)) * 1023.f;
+    return (ExpandBits(static_cast<uint32_t>(coord.x)) << 2) | (ExpandBits(static_cast<uint32_t>(coord.y)) << 1) |
+           ExpandBits(static_cast<uint32_t>(coord.z));
+}
+
+}    // namespace
+
+void StaticBatcher::Build(GameObject *pRoot) {
+    _sources.clear();
+    _statistics = Statistics{};
+    CollectSources(pRoot, glm::identity<glm::mat4x4>());
+    LogSkippedRenderers();
+    if (_sources.empty()) {
+        return;
+    }
+
+    // the sources of a batch are ordered along a z-order curve, so the pieces inside the frustum tend to be
+    // neighbours in the index buffer and merge into few draw ranges
+    AABB sceneBounds;
+    for (const Source &source : _sources) {
+        sceneBounds.Merge(source.bounds);
+    }
+    for (Source &source : _sources) {
+        source.mortonCode = MortonCode(source.bounds.GetCenter(), sceneBounds);
+    }
+    std::ranges::sort(_sources, [](const Source &lhs, const Source &rhs) {
+        const Material *pLhsMaterial = lhs.pMeshRenderer->GetMaterial().get();
+        const Material *pRhsMaterial = rhs.pMeshRenderer->GetMaterial().get();
+        if (pLhsMaterial != pRhsMaterial) {
+            return std::less<const Material *>()(pLhsMaterial, pRhsMaterial);
+        }
+        SemanticMask lhsMask = lhs.pMeshRenderer->GetMesh()->GetSemanticMask();
+        SemanticMask rhsMask = rhs.pMeshRenderer->GetMesh()->GetSemanticMask();
+        if (lhsMask != rhsMask) {
+            return lhsMask < rhsMask;
+        }
+        return lhs.mortonCode < rhs.mortonCode;
+    });
+
+    size_t index = 0;
+    while (index < _sources.size()) {
+        const MeshRenderer *pFirst = _sources[index].pMeshRenderer;
+        size_t first = index;
+        size_t vertexCount = 0;
+        while (index < _sources.size()) {
+            const MeshRenderer *pMeshRenderer = _sources[index].pMeshRenderer;
+            if (pMeshRenderer->GetMaterial() != pFirst->GetMaterial() ||
+                pMeshRenderer->GetMesh()->GetSemanticMask() != pFirst->GetMesh()->GetSemanticMask() ||
+                vertexCount + pMeshRenderer->GetMesh()->GetVertexCount() > kMaxBatchVertexCount) {
+                break;
+            }
+            vertexCount += pMeshRenderer->GetMesh()->GetVertexCount();
+            ++index;
+        }
+        BuildBatch(pRoot, std::span<const Source>(_sources).subspan(first, index - first));
+    }
+
+    Logger::Info("StaticBatcher: {} renderers merged into {} batches, {} skipped, draw calls {} -> {}",
+        _statistics.sourceRendererCount,
+        _statistics.batchCount,
+        _statistics.skippedRendererCount,
+        _statistics.drawCountBefore,
+        _statistics.drawCountAfter);
+    _sources.clear();
+}
+
+void StaticBatcher::LogSkippedRenderers() const {
+    if (_statistics.skippedRendererCount == 0) {
+        return;
+    }
+    const std::array<size_t, eSkipReasonCount> &counts = _statistics.skippedCounts;
+    Logger::Info("StaticBatcher: {} renderers kept, {} not static, {} transparent, {} occluders, {} with levels of "
+                 "detail, {} unsupported",
+        _statistics.skippedRendererCount,
+        counts[eDynamic],
+        counts[eTransparent],
+        counts[eOccluder],
+        counts[eLevelOfDetail],
+        counts[eUnsupported]);
+    // a batch has a single level, merging would throw away the simplified levels of these meshes
+    if (counts[eLevelOfDetail] > 0) {
+        Logger::Info("StaticBatcher: {} meshes of {} or more triangles have levels of detail, they select their level "
+                     "per object and are drawn on their own",
+            counts[eLevelOfDetail],
+            _statistics.minLodTriangleCount);
+    }
+}
+
+auto StaticBatcher::GetSkipReason(const MeshRenderer *pMeshRenderer) -> SkipReason {
+    const Mesh *pMesh = pMeshRenderer->GetMesh().get();
+    const Material *pMaterial = pMeshRenderer->GetMaterial().get();
+    if (!pMeshRenderer->GetGameObject()->GetStatic()) {
+        return eDynamic;
+    }
+    if (pMesh == nullptr || pMaterial == nullptr) {
+        return eUnsupported;
+    }
+    if (pMeshRenderer->IsOccluder()) {
+        return eOccluder;
+    }
+    if (RenderGroup::IsTransparent(pMaterial->GetRenderGroup())) {
+        return eTransparent;
+    }
+    if (pMesh->GetLodCount() > 1) {
+        return eLevelOfDetail;
+    }
+    size_t vertexCount = pMesh->GetVertexCount();
+    if (vertexCount == 0 || vertexCount > kMaxBatchVertexCount || !pMesh->GetBounds().IsValid()) {
+        return eUnsupported;
+    }
+    // the batch is one indexed triangle list
+    bool triangleList = std::ranges::all_of(pMesh->GetSubMeshes(), [](const SubMesh &subMesh) {
+        return subMesh.indexCount > 0 && subMesh.indexCount % 3 == 0;
+    });
+    return triangleList ? eBatchable : eUnsupported;
+}
+
+void StaticBatcher::CollectSources(GameObject *pGameObject, const glm::mat4x4 &matRelative) {
+    if (!pGameObject->GetActive()) {
+        return;
+    }
+    if (MeshRenderer *pMeshRenderer = pGameObject->GetComponent<MeshRenderer>()) {
+        SkipReason skipReason = GetSkipReason(pMeshRenderer);
+        if (skipReason == eBatchable) {
+            AABB bounds = pMeshRenderer->GetMesh()->GetBounds().Transform(matRelative);
+            _sources.push_back(Source{pMeshRenderer, matRelative, bounds, 0});
+        } else {
+            ++_statistics.skippedRendererCount;
+            ++_statistics.skippedCounts[skipReason];
+        }
+        if (skipReason == eLevelOfDetail) {
+            // the index buffer holds every level, count the triangles of level 0
+            size_t triangleCount = 0;
+            for (const SubMesh &subMesh : pMeshRenderer->GetMesh()->GetSubMeshes()) {
+                triangleCount += subMesh.indexCount / 3;
+            }
+            size_t &minTriangleCount = _statistics.minLodTriangleCount;
+            minTriangleCount = minTriangleCount == 0 ? triangleCount : std::min(minTriangleCount, triangleCount);
+        }
+    }
+    for (const SharedPtr<GameObject> &pChild : pGameObject->GetChildren()) {
+        CollectSources(pChild.Get(), matRelative * pChild->GetTransform()->GetLocalMatrix());
+    }
+}
+
+void StaticBatcher::BuildBatch(GameObject *pRoot, std::span<const Source> sources) {
+    const MeshRenderer *pFirst = sources.front().pMeshRenderer;
+    SemanticMask mask = pFirst->GetMesh()->GetSemanticMask();
+
+    // the batch is placed at the center of its sources, the buckets sort it by that position
+    AABB bounds;
+    for (const Source &source : sources) {
+        bounds.Merge(source.bounds);
+    }
+    glm::vec3 origin = bounds.GetCenter();
+
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec4> tangents;
+    std::vector<glm::vec2> uv0;
+    std::vector<glm::vec4> colors;
+    std::vector<uint32_t> indices;
+    std::vector<SubMesh> subMeshes;
+    for (const Source &source : sources) {
+        const Mesh *pMesh = source.pMeshRenderer->GetMesh().get();
+        size_t vertexOffset = vertices.size();
+        const glm::mat4x4 &matRelative = source.matRelative;
+        glm::mat3x3 matNormal = glm::mat3x3(glm::AffineNormalMatrix(matRelative));
+        // a mirroring transform flips the winding and the handedness of the tangent frame
+        bool mirrored = glm::determinant(glm::mat3x3(matRelative)) < 0.f;
+
+        pMesh->GetVertices(vertices);
+        for (size_t i = vertexOffset; i < vertices.size(); ++i) {
+            vertices[i] = glm::vec3(matRelative * glm::vec4(vertices[i], 1.f)) - origin;
+        }
+        pMesh->GetNormals(normals);
+        for (size_t i = vertexOffset; i < normals.size(); ++i) {
+            normals[i] = glm::normalize(matNormal * normals[i]);
+        }
+        pMesh->GetTangents(tangents);
+        for (size_t i = vertexOffset; i < tangents.size(); ++i) {
+            glm::vec3 tangent = glm::normalize(glm::mat3x3(matRelative) * glm::vec3(tangents[i]));
+            tangents[i] = glm::vec4(tangent, mirrored ? -tangents[i].w : tangents[i].w);
+        }
+        pMesh->GetUV0(uv0);
+        pMesh->GetColors(colors);
+
+        // the indices become absolute, so neighbouring sub meshes can be drawn as one range
+        ReadonlyArraySpan<uint32_t> sourceIndices = pMesh->GetIndices();
+        for (const SubMesh &sourceSubMesh : pMesh->GetSubMeshes()) {
+            SubMesh subMesh = {};
+            subMesh.vertexCount = sourceSubMesh.vertexCount;
+            subMesh.indexCount = sourceSubMesh.indexCount;
+            subMesh.baseVertexLocation = 0;
+            subMesh.baseIndexLocation = indices.size();
+            size_t baseVertex = vertexOffset + sourceSubMesh.baseVertexLocation;
+            for (size_t i = 0; i < sourceSubMesh.indexCount; i += 3) {
+                const uint32_t *pTriangle = sourceIndices.Data() + sourceSubMesh.baseIndexLocation + i;
+                indices.push_back(static_cast<uint32_t>(baseVertex + pTriangle[0]));
+                indices.push_back(static_cast<uint32_t>(baseVertex + pTriangle[mirrored ? 2 : 1]));
+                indices.push_back(static_cast<uint32_t>(baseVertex + pTriangle[mirrored ? 1 : 2]));
+            }
+            subMeshes.push_back(subMesh);
+        }
+        _statistics.drawCountBefore += pMesh->GetSubMeshes().size();
+    }
+
+    std::string name = fmt::format("StaticBatch_{}", _statistics.batchCount);
+    std::shared_ptr<Mesh> pMesh = std::make_shared<Mesh>();
+    pMesh->SetName(name);
+    pMesh->Resize(mask, vertices.size(), indices.size());
+    pMesh->SetVertices(vertices);
+    if (HasFlag(mask, SemanticMask::eNormal)) {
+        pMesh->SetNormals(normals);
+    }
+    if (HasFlag(mask, SemanticMask::eTangent)) {
+        pMesh->SetTangents(tangents);
+    }
+    if (HasFlag(mask, SemanticMask::eColor)) {
+        pMesh->SetColors(colors);
+    }
+    if (HasFlag(mask, SemanticMask::eTexCoord0)) {
+        pMesh->SetUV0(uv0);
+    }
+    pMesh->SetIndices(indices);
+    pMesh->SetSubMeshes(std::move(subMeshes));
+    pMesh->UploadMeshData();
+
+    SharedPtr<MeshRenderer> pMeshRenderer = MakeShared<MeshRenderer>();
+    pMeshRenderer->SetMaterial(pFirst->GetMaterial());
+    pMeshRenderer->SetMesh(pMesh);
+    SharedPtr<GameObject> pBatchObject = GameObject::Create();
+    pBatchObject->SetName(name);
+    pBatchObject->SetStatic(true);
+    pBatchObject->GetTransform()->SetLocalPosition(origin);
+    pBatchObject->AddComponent(std::move(pMeshRenderer));
+    pRoot->AddChild(pBatchObject);
+
+    for (const Source &source : sources) {
+        source.pMeshRenderer->GetGameObject()->RemoveComponent<MeshRenderer>();
+    }
+    _statistics.sourceRendererCount += sources.size();
+    _statistics.drawCountAfter += 1;
+    ++_statistics.batchCount;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <array>
+#include <span>
+#include <vector>
+#include "Foundation/BoundingVolume.hpp"
+#include "Foundation/GlmStd.hpp"
+#include "Foundation/NonCopyable.h"
+
+class GameObject;
+class MeshRenderer;
+
+// Merges the static meshes of a hierarchy that share a material and a vertex layout into combined meshes.
+// The vertices are transformed into the space of the root and every source sub mesh becomes one sub mesh of the batch,
+// so the pieces are still culled by their own bounds and the visible neighbours are drawn with one draw call.
+// Only the renderers of static game objects are merged. Transparent objects are sorted one by one and meshes with
+// levels of detail select them per object, both are kept.
+class StaticBatcher : private NonCopyable {
+public:
+    // a batch is split beyond this, the indices are 32 bit but the upload and the culling loop should stay small
+    static constexpr size_t kMaxBatchVertexCount = 1 << 20;
+    // why a mesh renderer is kept as it is
+    enum SkipReason : uint8_t {
+        eBatchable,
+        eDynamic,
+        eTransparent,
+        eOccluder,
+        eLevelOfDetail,
+        eUnsupported,
+        eSkipReasonCount,
+    };
+    struct Statistics {
+        size_t sourceRendererCount = 0;
+        size_t skippedRendererCount = 0;
+        std::array<size_t, eSkipReasonCount> skippedCounts = {};
+        // the smallest mesh with levels of detail that was kept
+        size_t minLodTriangleCount = 0;
+        size_t batchCount = 0;
+        // draw calls when everything is inside the frustum
+        size_t drawCountBefore = 0;
+        size_t drawCountAfter = 0;
+    };
+public:
+    // the source mesh renderers are removed from their game objects and the batches are added as children of the root.
+    // the batched game objects must not move relative to the root afterwards
+    void Build(GameObject *pRoot);
+    auto GetStatistics() const -> const Statistics & {
+        return _statistics;
+    }
+private:
+    struct Source {
+        MeshRenderer *pMeshRenderer;
+        // the local to root matrix
+        glm::mat4x4 matRelative;
+        AABB bounds;
+        uint32_t mortonCode;
+    };
+    static auto GetSkipReason(const MeshRenderer *pMeshRenderer) -> SkipReason;
+    void CollectSources(GameObject *pGameObject, const glm::mat4x4 &matRelative);
+    void LogSkippedRenderers() const;
+    void BuildBatch(GameObject *pRoot, std::span<const Source> sources);
+private:
+    // clang-format off
+    std::vector<Source>         _sources;
+    Statistics                  _statistics;
+    // clang-format on
+};
@@ -0,0 +1,115 @@
+#include "TickRegistry.h"
+#include <bit>
+#include "Foundation/Exception.h"
+
+static constexpr size_t kNotInvoking = static_cast<size_t>(-1);
+
+TickRegistry::TickRegistry() : _invokingPhaseIndex(kNotInvoking) {
+}
+
+TickRegistry::~TickRegistry() {
+    for (PhaseList &phaseList : _phaseLists) {
+        for (Component *pComponent : phaseList.components) {
+            if (pComponent != nullptr) {
+                pComponent->_pTickRegistry = nullptr;
+            }
+        }
+    }
+}
+
+void TickRegistry::Register(Component *pComponent) {
+    Assert(pComponent->_pTickRegistry == nullptr);
+    // a component with eNone is still bound, so a later SetTickType can subscribe it
+    pComponent->_pTickRegistry = this;
+    Component::TickType tickType = pComponent->GetTickType();
+    for (size_t phaseIndex = 0; phaseIndex < Component::kTickPhaseCount; ++phaseIndex) {
+        auto phase = static_cast<Component::TickType>(1 << phaseIndex);
+        if (!HasFlag(tickType, phase)) {
+            continue;
+        }
+        std::vector<Component *> &components = _phaseLists[phaseIndex].components;
+        pComponent->_tickSlots[phaseIndex] = static_cast<uint32_t>(components.size());
+        components.push_back(pComponent);
+    }
+}
+
+void TickRegistry::Unregister(Component *pComponent) {
+    if (pComponent->_pTickRegistry != this) {
+        return;
+    }
+
+    pComponent->_pTickRegistry = nullptr;
+    Component::TickType tickType = pComponent->GetTickType();
+    for (size_t phaseIndex = 0; phaseIndex < Component::kTickPhaseCount; ++phaseIndex) {
+        auto phase = static_cast<Component::TickType>(1 << phaseIndex);
+        if (!HasFlag(tickType, phase)) {
+            continue;
+        }
+
+        PhaseList &phaseList = _phaseLists[phaseIndex];
+        uint32_t slot = pComponent->_tickSlots[phaseIndex];
+        Assert(phaseList.components[slot] == pComponent);
+        pComponent->_tickSlots[phaseIndex] = Component::kInvalidTickSlot;
+        if (phaseIndex == _invokingPhaseIndex) {
+            // the list is being iterated, leave a hole and compact after the invoke
+            phaseList.components[slot] = nullptr;
+            phaseList.hasRemoved = true;
+            continue;
+        }
+
+        Component *pLast = phaseList.components.back();
+        phaseList.components[slot] = pLast;
+        if (pLast != nullptr) {
+            pLast->_tickSlots[phaseIndex] = slot;
+        }
+        phaseList.components.pop_back();
+    }
+}
+
+void TickRegistry::Invoke(Component::TickType phase) {
+    // the tick functions are private to Component, the table has to live in a member of the friend class
+    using TickFunc = void (Component::*)();
+    static constexpr TickFunc sTickFuncs[Component::kTickPhaseCount] = {
+        &Component::InnerOnPreUpdate,
+        &Component::InnerOnUpdate,
+        &Component::InnerOnPostUpdate,
+        &Component::InnerOnPreRender,
+        &Component::InnerOnRender,
+        &Component::InnerOnPostRender,
+    };
+
+    size_t phaseIndex = GetPhaseIndex(phase);
+    PhaseList &phaseList = _phaseLists[phaseIndex];
+    TickFunc pTickFunc = sTickFuncs[phaseIndex];
+
+    _invokingPhaseIndex = phaseIndex;
+    size_t count = phaseList.components.size();
+    for (size_t i = 0; i < count; ++i) {
+        if (Component *pComponent = phaseList.components[i]) {
+            (pComponent->*pTickFunc)();
+        }
+    }
+    _invokingPhaseIndex = kNotInvoking;
+
+    if (phaseList.hasRemoved) {
+        CompactPhase(phaseIndex);
+    }
+}
+
+auto TickRegistry::GetTickCount(Component::TickType phase) const -> size_t {
+    return _phaseLists[GetPhaseIndex(phase)].components.size();
+}
+
+auto TickRegistry::GetPhaseIndex(Component::TickType phase) -> size_t {
+    Assert(std::has_single_bit(static_cast<uint32_t>(phase)));
+    return static_cast<size_t>(std::countr_zero(static_cast<uint32_t>(phase)));
+}
+
+void TickRegistry::CompactPhase(size_t phaseIndex) {
+    PhaseList &phaseList = _phaseLists[phaseIndex];
+    std::erase(phaseList.components, nullptr);
+    for (size_t i = 0; i < phaseList.components.size(); ++i) {
+        phaseList.components[i]->_tickSlots[phaseIndex] = static_cast<uint32_t>(i);
+    }
+    phaseList.hasRemoved = false;
+}
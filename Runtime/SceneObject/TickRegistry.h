@@ -0,0 +1,32 @@
+#pragma once
+#include <array>
+#include <vector>
+#include "Components/Component.h"
+#include "Foundation/NonCopyable.h"
+
+// Dense per phase lists of the components that tick in a scene.
+// A component is registered while it is in the scene and its game object is active in hierarchy,
+// so a phase only visits the subscribed components instead of walking the whole game object hierarchy.
+class TickRegistry : private NonCopyable {
+public:
+    TickRegistry();
+    ~TickRegistry();
+public:
+    void Register(Component *pComponent);
+    void Unregister(Component *pComponent);
+    // components registered during the invoke start ticking in the next phase
+    void Invoke(Component::TickType phase);
+    auto GetTickCount(Component::TickType phase) const -> size_t;
+private:
+    static auto GetPhaseIndex(Component::TickType phase) -> size_t;
+    void CompactPhase(size_t phaseIndex);
+private:
+    struct PhaseList {
+        std::vector<Component *> components;
+        bool hasRemoved = false;
+    };
+    // clang-format off
+    std::array<PhaseList, Component::kTickPhaseCount>   _phaseLists;
+    size_t                                              _invokingPhaseIndex;
+    // clang-format on
+};
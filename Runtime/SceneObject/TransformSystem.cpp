@@ -0,0 +1,165 @@
+#include "TransformSystem.h"
+#include <algorithm>
+#include "Components/Transform.h"
+#include "Foundation/Memory/FrameArena.h"
+
+TransformSystem::TransformSystem() : _updateStamp(0), _hierarchyDirty(false) {
+}
+
+TransformSystem::~TransformSystem() {
+    for (Transform *pTransform : _transforms) {
+        if (pTransform != nullptr) {
+            pTransform->_pTransformSystem = nullptr;
+            pTransform->_transformIndex = kInvalidIndex;
+        }
+    }
+}
+
+void TransformSystem::AddTransform(Transform *pTransform) {
+    Assert(pTransform->_pTransformSystem == nullptr);
+    pTransform->_pTransformSystem = this;
+    pTransform->_transformIndex = static_cast<uint32_t>(_transforms.size());
+    _transforms.push_back(pTransform);
+    _parentIndices.push_back(kInvalidIndex);
+    _localMatrices.push_back(glm::identity<glm::mat4x4>());
+    _worldMatrices.push_back(glm::identity<glm::mat4x4>());
+    _worldVersions.push_back(0);
+    _dirtyFlags.push_back(false);
+    _updateStamps.push_back(0);
+    _hierarchyDirty = true;
+}
+
+void TransformSystem::RemoveTransform(Transform *pTransform) {
+    Assert(pTransform->_pTransformSystem == this);
+    uint32_t index = pTransform->_transformIndex;
+    Assert(_transforms[index] == pTransform);
+    // the slot is compacted by the next rebuild, so the indices of other transforms stay valid until then
+    _transforms[index] = nullptr;
+    pTransform->_pTransformSystem = nullptr;
+    pTransform->_transformIndex = kInvalidIndex;
+    _hierarchyDirty = true;
+}
+
+void TransformSystem::MarkDirty(uint32_t index) {
+    if (!_dirtyFlags[index]) {
+        _dirtyFlags[index] = true;
+        _dirtyIndices.push_back(index);
+    }
+}
+
+void TransformSystem::MarkHierarchyDirty() {
+    _hierarchyDirty = true;
+}
+
+void TransformSystem::UpdateWorldMatrices() {
+    _changedTransforms.clear();
+    if (_hierarchyDirty) {
+        RebuildHierarchy();
+    }
+    if (_dirtyIndices.empty()) {
+        return;
+    }
+
+    // parents are stored before their children, so one forward sweep from the first dirty slot sees every parent
+    // before its descendants. a transform is recomputed when it is dirty or its parent was recomputed in this sweep,
+    // the loop only streams through the index arrays and never follows the child pointers of the transforms
+    ++_updateStamp;
+    size_t count = _transforms.size();
+    for (size_t i = std::ranges::min(_dirtyIndices); i < count; ++i) {
+        uint32_t parentIndex = _parentIndices[i];
+        bool parentUpdated = parentIndex != kInvalidIndex && _updateStamps[parentIndex] == _updateStamp;
+        if (_dirtyFlags[i] || parentUpdated) {
+            _dirtyFlags[i] = false;
+            UpdateWorldMatrix(static_cast<uint32_t>(i));
+        }
+    }
+    _dirtyIndices.clear();
+}
+
+void TransformSystem::UpdateWorldMatrix(uint32_t index) {
+    Transform *pTransform = _transforms[index];
+    uint32_t parentIndex = _parentIndices[index];
+    _localMatrices[index] = pTransform->GetLocalMatrix();
+    // the parent was updated before this node or did not change, its version is final
+    uint64_t parentVersion = 0;
+    if (parentIndex != kInvalidIndex) {
+        _worldMatrices[index] = glm::AffineMultiply(_worldMatrices[parentIndex], _localMatrices[index]);
+        parentVersion = _worldVersions[parentIndex];
+    } else if (Transform *pParent = pTransform->GetParent()) {
+        // the parent is not in this scene, fall back to the lazy path
+        _worldMatrices[index] = glm::AffineMultiply(pParent->GetWorldMatrix(), _localMatrices[index]);
+        parentVersion = pParent->GetWorldVersion();
+    } else {
+        _worldMatrices[index] = _localMatrices[index];
+    }
+    _worldVersions[index] = std::max(pTransform->GetLocalVersion(), parentVersion);
+    pTransform->ApplyWorldMatrix(_worldMatrices[index], _worldVersions[index]);
+    _updateStamps[index] = _updateStamp;
+    _changedTransforms.push_back(pTransform);
+}
+
+void TransformSystem::RebuildHierarchy() {
+    _hierarchyDirty = false;
+
+    FrameVector<Transform *> order;
+    order.reserve(_transforms.size());
+    for (Transform *pTransform : _transforms) {
+        if (pTransform == nullptr) {
+            continue;
+        }
+        Transform *pParent = pTransform->GetParent();
+        if (pParent == nullptr || pParent->_pTransformSystem != this) {
+            order.push_back(pTransform);
+        }
+    }
+
+    // breadth first, every level is appended after the previous one
+    for (size_t head = 0; head < order.size(); ++head) {
+        for (Transform *pChild : order[head]->GetChildren()) {
+            if (pChild->_pTransformSystem == this) {
+                order.push_back(pChild);
+            }
+        }
+    }
+
+    // the slots move, the world matrices and versions move with them. Only transforms that were never updated,
+    // have a pending change or hang below a different parent are recomputed, not the whole scene
+    size_t count = order.size();
+    FrameVector<uint32_t> oldIndices(count);
+    FrameVector<uint32_t> newIndices(_transforms.size(), kInvalidIndex);
+    for (size_t i = 0; i < count; ++i) {
+        oldIndices[i] = order[i]->_transformIndex;
+        newIndices[oldIndices[i]] = static_cast<uint32_t>(i);
+    }
+    FrameVector<uint32_t> oldParentIndices(_parentIndices.begin(), _parentIndices.end());
+    FrameVector<glm::mat4x4> oldWorldMatrices(_worldMatrices.begin(), _worldMatrices.end());
+    FrameVector<uint64_t> oldWorldVersions(_worldVersions.begin(), _worldVersions.end());
+    FrameVector<uint8_t> oldDirtyFlags(_dirtyFlags.begin(), _dirtyFlags.end());
+
+    _transforms.assign(order.begin(), order.end());
+    _parentIndices.resize(count);
+    _localMatrices.resize(count);
+    _worldMatrices.resize(count);
+    _worldVersions.resize(count);
+    _dirtyFlags.assign(count, false);
+    _updateStamps.assign(count, 0);
+    _dirtyIndices.clear();
+    for (size_t i = 0; i < count; ++i) {
+        _transforms[i]->_transformIndex = static_cast<uint32_t>(i);
+        _worldMatrices[i] = oldWorldMatrices[oldIndices[i]];
+        _worldVersions[i] = oldWorldVersions[oldIndices[i]];
+    }
+    for (size_t i = 0; i < count; ++i) {
+        Transform *pParent = _transforms[i]->GetParent();
+        bool inSystem = pParent != nullptr && pParent->_pTransformSystem == this;
+        _parentIndices[i] = inSystem ? pParent->_transformIndex : kInvalidIndex;
+
+        uint32_t oldParentIndex = oldParentIndices[oldIndices[i]];
+        uint32_t movedParentIndex = oldParentIndex != kInvalidIndex ? newIndices[oldParentIndex] : kInvalidIndex;
+        // a version of zero means the world matrix was never written
+        bool reparented = movedParentIndex != _parentIndices[i];
+        if (_worldVersions[i] == 0 || oldDirtyFlags[oldIndices[i]] || reparented) {
+            MarkDirty(static_cast<uint32_t>(i));
+        }
+    }
+}
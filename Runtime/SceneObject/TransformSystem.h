@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include "Foundation/GlmStd.hpp"
+#include "Foundation/NonCopyable.h"
+#include "Foundation/ReadonlyArraySpan.hpp"
+
+class Transform;
+
+// Keeps the hierarchy of all transforms in a scene as structure of arrays sorted parent before child.
+// Each frame sweeps the arrays once in index order, starting at the first dirty transform, and recomputes the dirty
+// transforms and their descendants. The transforms whose world matrix was recomputed are recorded in a change list
+// that downstream systems can consume instead of the whole scene.
+// Transform keeps its public interface and caches, the system writes the results back into them.
+class TransformSystem : private NonCopyable {
+public:
+    static constexpr uint32_t kInvalidIndex = static_cast<uint32_t>(-1);
+public:
+    TransformSystem();
+    ~TransformSystem();
+public:
+    void AddTransform(Transform *pTransform);
+    void RemoveTransform(Transform *pTransform);
+    void MarkDirty(uint32_t index);
+    void MarkHierarchyDirty();
+    void UpdateWorldMatrices();
+    auto GetTransformCount() const -> size_t {
+        return _transforms.size();
+    }
+    // true when every world matrix and world version reflects all changes made so far
+    bool IsUpToDate() const {
+        return _dirtyIndices.empty() && !_hierarchyDirty;
+    }
+    // written together with the world matrix, only meaningful while IsUpToDate()
+    auto GetWorldVersion(uint32_t index) const -> uint64_t {
+        return _worldVersions[index];
+    }
+    // the transforms moved by the last UpdateWorldMatrices, each one at most once, descendants included.
+    // changes made after the update are reported by the update of the next frame
+    auto GetChangedTransforms() const -> ReadonlyArraySpan<Transform *> {
+        return _changedTransforms;
+    }
+private:
+    void RebuildHierarchy();
+    void UpdateWorldMatrix(uint32_t index);
+private:
+    // clang-format off
+    std::vector<Transform *>    _transforms;
+    std::vector<uint32_t>       _parentIndices;
+    std::vector<glm::mat4x4>    _localMatrices;
+    std::vector<glm::mat4x4>    _worldMatrices;
+    std::vector<uint64_t>       _worldVersions;
+    std::vector<uint8_t>        _dirtyFlags;
+    std::vector<uint64_t>       _updateStamps;
+    std::vector<uint32_t>       _dirtyIndices;
+    std::vector<Transform *>    _changedTransforms;
+    uint64_t                    _updateStamp;
+    bool                        _hierarchyDirty;
+    // clang-format on
+};
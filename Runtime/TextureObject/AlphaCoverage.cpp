@@ -0,0 +1,72 @@
+#include "AlphaCoverage.h"
+#include <algorithm>
+#include <cmath>
+
+void AlphaCoverage::BuildHistogram(const uint8_t *pPixels, size_t pixelCount, Histogram &histogram) {
+    // four partial histograms, so neighbouring pixels with the same alpha do not wait on the same counter
+    uint32_t counts[4][256] = {};
+    size_t i = 0;
+    for (; i + 4 <= pixelCount; i += 4) {
+        const uint8_t *pQuad = pPixels + i * 4;
+        ++counts[0][pQuad[3]];
+        ++counts[1][pQuad[7]];
+        ++counts[2][pQuad[11]];
+        ++counts[3][pQuad[15]];
+    }
+    for (; i < pixelCount; ++i) {
+        ++counts[0][pPixels[i * 4 + 3]];
+    }
+    for (size_t alpha = 0; alpha < histogram.size(); ++alpha) {
+        histogram[alpha] = counts[0][alpha] + counts[1][alpha] + counts[2][alpha] + counts[3][alpha];
+    }
+}
+
+auto AlphaCoverage::GetCoverage(const Histogram &histogram, size_t pixelCount, float scale, int cutoff) -> float {
+    double val = 0;
+    for (size_t i = 0; i < histogram.size(); ++i) {
+        if (histogram[i] == 0) {
+            continue;
+        }
+        int alpha = static_cast<int>(scale * static_cast<float>(i));
+        if (alpha > 255) {
+            alpha = 255;
+        }
+        if (alpha <= cutoff) {
+            continue;
+        }
+        val += static_cast<double>(alpha) * histogram[i];
+    }
+    return static_cast<float>(val / (static_cast<double>(pixelCount) * 255));
+}
+
+auto AlphaCoverage::FindScale(const Histogram &histogram, size_t pixelCount, float targetCoverage, int cutoff)
+    -> float {
+    float ini = 0;
+    float fin = 10;
+    float mid = 0.f;
+    for (int iter = 0; iter < 50; iter++) {
+        mid = (ini + fin) / 2;
+        float alphaPercentage = GetCoverage(histogram, pixelCount, mid, cutoff);
+        if (std::fabs(alphaPercentage - targetCoverage) < .001) {
+            break;
+        }
+        if (alphaPercentage > targetCoverage) {
+            fin = mid;
+        }
+        if (alphaPercentage < targetCoverage) {
+            ini = mid;
+        }
+    }
+    return mid;
+}
+
+void AlphaCoverage::ScaleAlpha(uint8_t *pPixels, size_t pixelCount, float scale) {
+    uint8_t scaledAlpha[256];
+    for (int alpha = 0; alpha < 256; ++alpha) {
+        scaledAlpha[alpha] = static_cast<uint8_t>(std::min(static_cast<int>(scale * static_cast<float>(alpha)), 255));
+    }
+    for (size_t i = 0; i < pixelCount; ++i) {
+        uint8_t &alpha = pPixels[i * 4 + 3];
+        alpha = scaledAlpha[alpha];
+    }
+}
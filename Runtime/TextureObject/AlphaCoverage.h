@@ -0,0 +1,21 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Keeps the alpha test coverage of cutout textures over the mip chain, otherwise cutouts get thinner in the smaller
+// mips. The coverage of a scaled mip only depends on how many pixels have each alpha value, so the scale search
+// walks a 256 bin histogram instead of the pixels.
+// Credits: http://www.ludicon.com/castano/blog/articles/computing-alpha-mipmaps/
+class AlphaCoverage {
+public:
+    // the number of pixels of each alpha value
+    using Histogram = std::array<uint32_t, 256>;
+    // pPixels holds pixelCount tightly packed RGBA8 pixels
+    static void BuildHistogram(const uint8_t *pPixels, size_t pixelCount, Histogram &histogram);
+    // the mean of the scaled alpha values above cutoff, the others count as 0
+    static auto GetCoverage(const Histogram &histogram, size_t pixelCount, float scale, int cutoff) -> float;
+    // bisects the scale in [0, 10] until the coverage is within 0.001 of targetCoverage
+    static auto FindScale(const Histogram &histogram, size_t pixelCount, float targetCoverage, int cutoff) -> float;
+    static void ScaleAlpha(uint8_t *pPixels, size_t pixelCount, float scale);
+};
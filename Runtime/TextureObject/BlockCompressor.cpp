@@ -0,0 +1,972 @@
+#include "BlockCompressor.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "Foundation/Exception.h"
+#include "Foundation/JobSystem.h"
+#include "Foundation/NamespeceAlias.h"
+
+namespace {
+
+// blocks encoded by one job
+constexpr size_t kBlocksPerJob = 256;
+constexpr size_t kPixelsPerBlock = 16;
+constexpr int kPowerIterations = 8;
+// the endpoint search of eHigh stops after this many passes without reaching a local minimum
+constexpr int kMaxSearchPasses = 4;
+// weight of the second endpoint of each 4 bit BC7 index in 1/64
+constexpr std::array<int, 16> kBC7Weights = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+using BlockPixels = std::array<std::array<uint8_t, 4>, kPixelsPerBlock>;
+using BlockIndices = std::array<uint8_t, kPixelsPerBlock>;
+template<size_t N>
+using Vec = std::array<float, N>;
+
+auto GetRefineIterations(BlockCompressor::Quality quality) -> int {
+    switch (quality) {
+    case BlockCompressor::Quality::eFast:
+        return 0;
+    case BlockCompressor::Quality::eNormal:
+        return 2;
+    case BlockCompressor::Quality::eHigh:
+        return 8;
+    }
+    return 0;
+}
+
+auto GetChannelCount(BlockCompressor::Format format) -> size_t {
+    switch (format) {
+    case BlockCompressor::Format::eBC1:
+        return 3;
+    case BlockCompressor::Format::eBC4:
+        return 1;
+    case BlockCompressor::Format::eBC5:
+        return 2;
+    case BlockCompressor::Format::eBC3:
+    case BlockCompressor::Format::eBC7:
+        return 4;
+    }
+    return 0;
+}
+
+void LoadBlock(const uint8_t *pPixels,
+    uint32_t width,
+    uint32_t height,
+    uint32_t blockX,
+    uint32_t blockY,
+    BlockPixels &pixels) {
+
+    for (uint32_t y = 0; y < BlockCompressor::kBlockDim; ++y) {
+        uint32_t srcY = std::min(blockY * BlockCompressor::kBlockDim + y, height - 1);
+        for (uint32_t x = 0; x < BlockCompressor::kBlockDim; ++x) {
+            uint32_t srcX = std::min(blockX * BlockCompressor::kBlockDim + x, width - 1);
+            const uint8_t *pSrc = pPixels + (static_cast<size_t>(srcY) * width + srcX) * 4;
+            std::copy_n(pSrc, 4, pixels[y * BlockCompressor::kBlockDim + x].data());
+        }
+    }
+}
+
+// the segment along the principal axis of the points that covers all of them
+template<size_t N>
+void FitPrincipalAxis(const Vec<N> *pPoints, size_t count, Vec<N> &endpoint0, Vec<N> &endpoint1) {
+    Vec<N> mean = {};
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t c = 0; c < N; ++c) {
+            mean[c] += pPoints[i][c];
+        }
+    }
+    for (size_t c = 0; c < N; ++c) {
+        mean[c] /= static_cast<float>(count);
+    }
+
+    float covariance[N][N] = {};
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t a = 0; a < N; ++a) {
+            for (size_t b = 0; b < N; ++b) {
+                covariance[a][b] += (pPoints[i][a] - mean[a]) * (pPoints[i][b] - mean[b]);
+            }
+        }
+    }
+
+    // the power iteration starts from the column of the channel with the largest spread
+    size_t maxChannel = 0;
+    for (size_t c = 1; c < N; ++c) {
+        if (covariance[c][c] > covariance[maxChannel][maxChannel]) {
+            maxChannel = c;
+        }
+    }
+    if (covariance[maxChannel][maxChannel] <= std::numeric_limits<float>::epsilon()) {
+        endpoint0 = mean;
+        endpoint1 = mean;
+        return;
+    }
+
+    Vec<N> axis;
+    for (size_t c = 0; c < N; ++c) {
+        axis[c] = covariance[c][maxChannel];
+    }
+    for (int iter = 0; iter < kPowerIterations; ++iter) {
+        Vec<N> next = {};
+        float maxComponent = 0.f;
+        for (size_t a = 0; a < N; ++a) {
+            for (size_t b = 0; b < N; ++b) {
+                next[a] += covariance[a][b] * axis[b];
+            }
+            maxComponent = std::max(maxComponent, std::abs(next[a]));
+        }
+        if (maxComponent <= 0.f) {
+            break;
+        }
+        for (size_t c = 0; c < N; ++c) {
+            axis[c] = next[c] / maxComponent;
+        }
+    }
+
+    float length = 0.f;
+    for (size_t c = 0; c < N; ++c) {
+        length += axis[c] * axis[c];
+    }
+    length = std::sqrt(length);
+    for (size_t c = 0; c < N; ++c) {
+        axis[c] /= length;
+    }
+
+    float minT = std::numeric_limits<float>::max();
+    float maxT = std::numeric_limits<float>::lowest();
+    for (size_t i = 0; i < count; ++i) {
+        float t = 0.f;
+        for (size_t c = 0; c < N; ++c) {
+            t += (pPoints[i][c] - mean[c]) * axis[c];
+        }
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    for (size_t c = 0; c < N; ++c) {
+        endpoint0[c] = std::clamp(mean[c] + axis[c] * minT, 0.f, 255.f);
+        endpoint1[c] = std::clamp(mean[c] + axis[c] * maxT, 0.f, 255.f);
+    }
+}
+
+// the endpoints with the least squared error for fixed interpolation weights, weight is the share of endpoint1 of each
+// point. Returns false when the system is singular, e.g. all points use the same weight
+template<size_t N>
+bool SolveEndpoints(const Vec<N> *pPoints, const float *pWeights, size_t count, Vec<N> &endpoint0, Vec<N> &endpoint1) {
+    float aa = 0.f;
+    float bb = 0.f;
+    float ab = 0.f;
+    Vec<N> ax = {};
+    Vec<N> bx = {};
+    for (size_t i = 0; i < count; ++i) {
+        float b = pWeights[i];
+        float a = 1.f - b;
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+        for (size_t c = 0; c < N; ++c) {
+            ax[c] += a * pPoints[i][c];
+            bx[c] += b * pPoints[i][c];
+        }
+    }
+
+    float determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) <= std::numeric_limits<float>::epsilon()) {
+        return false;
+    }
+    for (size_t c = 0; c < N; ++c) {
+        endpoint0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.f, 255.f);
+        endpoint1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.f, 255.f);
+    }
+    return true;
+}
+
+class BitWriter {
+public:
+    explicit BitWriter(uint8_t *pDest) : _pDest(pDest), _offset(0) {
+    }
+    void Write(uint32_t value, uint32_t bitCount) {
+        for (uint32_t bit = 0; bit < bitCount; ++bit, ++_offset) {
+            if (((value >> bit) & 1) != 0) {
+                _pDest[_offset / 8] |= static_cast<uint8_t>(1 << (_offset % 8));
+            }
+        }
+    }
+private:
+    uint8_t *_pDest;
+    uint32_t _offset;
+};
+
+class BitReader {
+public:
+    explicit BitReader(const uint8_t *pSource) : _pSource(pSource), _offset(0) {
+    }
+    auto Read(uint32_t bitCount) -> uint32_t {
+        uint32_t value = 0;
+        for (uint32_t bit = 0; bit < bitCount; ++bit, ++_offset) {
+            value |= ((_pSource[_offset / 8] >> (_offset % 8)) & 1u) << bit;
+        }
+        return value;
+    }
+private:
+    const uint8_t *_pSource;
+    uint32_t _offset;
+};
+
+/////////////////////////////////////////////// BC1 color ///////////////////////////////////////////////
+
+using ColorPalette = std::array<std::array<int, 3>, 4>;
+
+struct ColorBlock {
+    uint16_t color0;
+    uint16_t color1;
+    BlockIndices indices;
+    uint32_t error;
+};
+
+auto QuantizeTo565(const Vec<3> &color) -> uint16_t {
+    int r = std::clamp(static_cast<int>(std::lround(color[0] * 31.f / 255.f)), 0, 31);
+    int g = std::clamp(static_cast<int>(std::lround(color[1] * 63.f / 255.f)), 0, 63);
+    int b = std::clamp(static_cast<int>(std::lround(color[2] * 31.f / 255.f)), 0, 31);
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+auto ExpandFrom565(uint16_t color) -> std::array<int, 3> {
+    int r = (color >> 11) & 31;
+    int g = (color >> 5) & 63;
+    int b = color & 31;
+    return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+}
+
+// the four color mode, the encoder never writes the three color mode
+void BuildColorPalette(uint16_t color0, uint16_t color1, ColorPalette &palette) {
+    palette[0] = ExpandFrom565(color0);
+    palette[1] = ExpandFrom565(color1);
+    for (size_t c = 0; c < 3; ++c) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+    }
+}
+
+void EvaluateColorBlock(const BlockPixels &pixels, ColorBlock &block) {
+    ColorPalette palette;
+    BuildColorPalette(block.color0, block.color1, palette);
+    block.error = 0;
+    for (size_t i = 0; i < kPixelsPerBlock; ++i) {
+        uint32_t bestError = std::numeric_limits<uint32_t>::max();
+        for (uint8_t index = 0; index < palette.size(); ++index) {
+            uint32_t error = 0;
+            for (size_t c = 0; c < 3; ++c) {
+                int diff = palette[index][c] - pixels[i][c];
+                error += static_cast<uint32_t>(diff * diff);
+            }
+            if (error < bestError) {
+                bestError = error;
+                block.indices[i] = index;
+            }
+        }
+        block.error += bestError;
+    }
+}
+
+auto MakeColorBlock(const BlockPixels &pixels, const Vec<3> &endpoint0, const Vec<3> &endpoint1) -> ColorBlock {
+    ColorBlock block;
+    block.color0 = QuantizeTo565(endpoint0);
+    block.color1 = QuantizeTo565(endpoint1);
+    EvaluateColorBlock(pixels, block);
+    return block;
+}
+
+// moves single 565 channels of the endpoints by one step while the error goes down
+void SearchColorEndpoints(const BlockPixels &pixels, ColorBlock &best) {
+    constexpr std::array<uint32_t, 3> kShifts = {11, 5, 0};
+    constexpr std::array<uint32_t, 3> kMaxValues = {31, 63, 31};
+    for (int pass = 0; pass < kMaxSearchPasses; ++pass) {
+        bool improved = false;
+        for (uint16_t ColorBlock::*pEndpoint : {&ColorBlock::color0, &ColorBlock::color1}) {
+            for (size_t c = 0; c < 3; ++c) {
+                for (int step : {-1, 1}) {
+                    ColorBlock candidate = best;
+                    uint16_t &endpoint = candidate.*pEndpoint;
+                    int value = static_cast<int>((endpoint >> kShifts[c]) & kMaxValues[c]) + step;
+                    if (value < 0 || value > static_cast<int>(kMaxValues[c])) {
+                        continue;
+                    }
+                    endpoint &= static_cast<uint16_t>(~(kMaxValues[c] << kShifts[c]));
+                    endpoint |= static_cast<uint16_t>(value << kShifts[c]);
+                    EvaluateColorBlock(pixels, candidate);
+                    if (candidate.error < best.error) {
+                        best = candidate;
+                        improved = true;
+                    }
+                }
+            }
+        }
+        if (!improved) {
+            break;
+        }
+    }
+}
+
+void WriteColorBlock(ColorBlock block, uint8_t *pDest) {
+    // the four color mode needs color0 > color1, equal endpoints give the same color for every index
+    if (block.color0 < block.color1) {
+        std::swap(block.color0, block.color1);
+        for (uint8_t &index : block.indices) {
+            index ^= 1;
+        }
+    } else if (block.color0 == block.color1) {
+        block.indices.fill(0);
+    }
+
+    uint32_t indexBits = 0;
+    for (size_t i = 0; i < kPixelsPerBlock; ++i) {
+        indexBits |= static_cast<uint32_t>(block.indices[i]) << (2 * i);
+    }
+    pDest[0] = static_cast<uint8_t>(block.color0 & 0xff);
+    pDest[1] = static_cast<uint8_t>(block.color0 >> 8);
+    pDest[2] = static_cast<uint8_t>(block.color1 & 0xff);
+    pDest[3] = static_cast<uint8_t>(block.color1 >> 8);
+    for (size_t i = 0; i < 4; ++i) {
+        pDest[4 + i] = static_cast<uint8_t>(indexBits >> (8 * i));
+    }
+}
+
+void EncodeColorBlock(const BlockPixels &pixels, BlockCompressor::Quality quality, uint8_t *pDest) {
+    std::array<Vec<3>, kPixelsPerBlock> points;
+    for (size_t i = 0; i < kPixelsPerBlock; ++i) {
+        for (size_t c = 0; c < 3; ++c) {
+            points[i][c] = static_cast<float>(pixels[i][c]);
+        }
+    }
+
+    Vec<3> endpoint0, endpoint1;
+    FitPrincipalAxis(points.data(), points.size(), endpoint0, endpoint1);
+    ColorBlock best = MakeColorBlock(pixels, endpoint0, endpoint1);
+
+    // the share of color1 of the four indices
+    constexpr std::array<float, 4> kIndexWeights = {0.f, 1.f, 1.f / 3.f, 2.f / 3.f};
+    int refineIterations = GetRefineIterations(quality);
+    for (int iter = 0; iter < refineIterations && best.error > 0; ++iter) {
+        std::array<float, kPixelsPerBlock> weights;
+        for (size_t i = 0; i < kPixelsPerBlock; ++i) {
+            weights[i] = kIndexWeights[best.indices[i]];
+        }
+        if (!SolveEndpoints(points.data(), weights.data(), points.size(), endpoint0, endpoint1)) {
+            break;
+        }
+        ColorBlock candidate = MakeColorBlock(pixels, endpoint0, endpoint1);
+        if (candidate.error >= best.error) {
+            break;
+        }
+        best = candidate;
+    }
+
+    if (quality == BlockCompressor::Quality::eHigh && best.error > 0) {
+        SearchColorEndpoints(pixels, best);
+    }
+    WriteColorBlock(best, pDest);
+}
+
+void DecodeColorBlock(const uint8_t *pBlock, BlockPixels &pixels) {
+    ColorPalette palette;
+    BuildColorPalette(static_cast<uint16_t>(pBlock[0] | (pBlock[1] << 8)),
+        static_cast<uint16_t>(pBlock[2] | (pBlock[3] << 8)),
+        palette);
+    uint32_t indexBits = pBlock[4] | (pBlock[5] << 8) | (pBlock[6] << 16) | (static_cast<uint32_t>(pBlock[7]) << 24);
+    for (size_t i = 0; i < kPixelsPerBlock; ++i) {
+        const std::array<int, 3> &color = palette[(indexBits >> (2 * i)) & 3];
+        for (size_t c = 0; c < 3; ++c) {
+            pixels[i][c] = static_cast<uint8_t>(color[c]);
+        }
+    }
+}
+
+/////////////////////////////////////////////// BC4 channel ///////////////////////////////////////////////
+
+using ChannelValues = std::array<uint8_t, kPixelsPerBlock>;
+using ChannelPalette = std::array<int, 8>;
+
+struct ChannelBlock {
+    uint8_t value0;
+    uint8_t value1;
+    BlockIndices indices;
+    uint32_t error;
+};
+
+// value0 > value1 interpolates 6 values, otherwise 4 values and the last two indices are 0 and 255
+void BuildChannelPalette(uint8_t value0, uint8_t value1, ChannelPalette &palette) {
+    palette[0] = value0;
+    palette[1] = value1;
+    if (value0 > value1) {
+        for (int i = 1; i <= 6; ++i) {
+            palette[i + 1] = ((7 - i) * value0 + i * value1 + 3) / 7;
+        }
+    } else {
+        for (int i = 1; i <= 4; ++i) {
+            palette[i + 1] = ((5 - i) * value0 + i * value1 + 2) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+void EvaluateChannelBlock(const ChannelValues &values, ChannelBlock &block) {
+    ChannelPalette palette;
+    BuildChannelPalette(block.value0, block.value1, palette);
+    block.error = 0;
+    for (size_t i = 0; i < kPixelsPerBlock; ++i) {
+        uint32_t bestError = std::numeric_limits<uint32_t>::max();
+        for (uint8_t index = 0; index < palette.size(); ++index) {
+            int diff = palette[index] - values[i];
+            uint32_t error = static_cast<uint32_t>(diff * diff);
+            if (error < bestError) {
+                bestError = error;
+                block.indices[i] = index;
+            }
+        }
+        block.error += bestError;
+    }
+}
+
+auto MakeChannelBlock(const ChannelValues &values, uint8_t value0, uint8_t value1) -> ChannelBlock {
+    ChannelBlock block;
+    block.value0 = value0;
+    block.value1 = value1;
+    EvaluateChannelBlock(values, block);
+    return block;
+}
+
+// least squares on the indices of the interpolating mode, the solved endpoints have to keep value0 > value1
+void RefineChannelBlock(const ChannelValues &values, int iterations, ChannelBlock &best) {
+    std::array<Vec<1>, kPixelsPerBlock> points;
+    for (size_t i = 0; i < kPixelsPerBlock; ++i) {
+        points[i][0] = static_cast<float>(values[i]);
+    }
+    for (int iter = 0; iter < iterations && best.error > 0; ++iter) {
+        std::array<float, kPixelsPerBlock> weights;
+        for (size_t i = 0; i < kPixelsPerBlock; ++i) {
+            uint8_t index = best.indices[i];
+            weights[i] = index <= 1 ? static_cast<float>(index) : static_cast<float>(index - 1) / 7.f;
+        }
+        Vec<1> endpoint0, endpoint1;
+        if (!SolveEndpoints(points.data(), weights.data(), points.size(), endpoint0, endpoint1)) {
+            break;
+        }
+        auto value0 = static_cast<uint8_t>(std::lround(endpoint0[0]));
+        auto value1 = static_cast<uint8_t>(std::lround(endpoint1[0]));
+        if (value0 <= value1) {
+            break;
+        }
+        ChannelBlock candidate = MakeChannelBlock(values, value0, value1);
+        if (candidate.error >= best.error) {
+            break;
+        }
+        best = candidate;
+    }
+}
+
+void SearchChannelEndpoints(const ChannelValues &values, ChannelBlock &best) {
+    for (int pass = 0; pass < kMaxSearchPasses; ++pass) {
+        bool improved = false;
+        for (uint8_t ChannelBlock::*pEndpoint : {&ChannelBlock::value0, &ChannelBlock::value1}) {
+            for (int step : {-1, 1}) {
+                ChannelBlock candidate = best;
+                int value = candidate.*pEndpoint + step;
+                if (value < 0 || value > 255) {
+                    continue;
+                }
+                candidate.*pEndpoint = static_cast<uint8_t>(value);
+                EvaluateChannelBlock(values, candidate);
+                if (candidate.error < best.error) {
+                    best = candidate;
+                    improved = true;
+                }
+            }
+        }
+        if (!improved) {
+            break;
+        }
+    }
+}
+
+void WriteChannelBlock(const ChannelBlock &block, uint8_t *pDest) {
+    uint64_t indexBits = 0;
+    for (size_t i = 0; i < kPixelsPerBlock; ++i) {
+        indexBits |= static_cast<uint64_t>(block.indices[i]) << (3 * i);
+    }
+    pDest[0] = block.value0;
+    pDest[1] = block.value1;
+    for (size_t i = 0; i < 6; ++i) {
+        pDest[2 + i] = static_cast<uint8_t>(indexBits >> (8 * i));
+    }
+}
+
+void EncodeChannelBlock(const BlockPixels &pixels, size_t channel, BlockCompressor::Quality quality, uint8_t *pDest) {
+    ChannelValues values;
+    for (size_t i = 0; i < kPixelsPerBlock; ++i) {
+        values[i] = pixels[i][channel];
+    }
+
+    auto [minIter, maxIter] = std::minmax_element(values.begin(), values.end());
+    ChannelBlock best = MakeChannelBlock(values, *maxIter, *minIter);
+    if (best.error > 0) {
+        RefineChannelBlock(values, GetRefineIterations(quality), best);
+    }
+
+    if (quality == BlockCompressor::Quality::eHigh && best.error > 0) {
+        // the 4 value mode has exact 0 and 255, so its endpoints only have to cover the values in between
+        uint8_t innerMin = 255;
+        uint8_t innerMax = 0;
+        for (uint8_t value : values) {
+            if (value != 0 && value != 255) {
+                innerMin = std::min(innerMin, value);
+                innerMax = std::max(innerMax, value);
+            }
+        }
+        if (innerMin <= innerMax) {
+            ChannelBlock candidate = MakeChannelBlock(values, innerMin, innerMax);
+            if (candidate.error < best.error) {
+                best = candidate;
+            }
+        }
+        SearchChannelEndpoints(values, best);
+    }
+    WriteChannelBlock(best, pDest);
+}
+
+void DecodeChannelBlock(const uint8_t *pBlock, size_t channel, BlockPixels &pixels) {
+    ChannelPalette palette;
+    BuildChannelPalette(pBlock[0], pBlock[1], palette);
+    uint64_t indexBits = 0;
+    for (size_t i = 0; i < 6; ++i) {
+        indexBits |= static_cast<uint64_t>(pBlock[2 + i]) << (8 * i);
+    }
+    for (size_t i = 0; i < kPixelsPerBlock; ++i) {
+        pixels[i][channel] = static_cast<uint8_t>(palette[(indexBits >> (3 * i)) & 7]);
+    }
+}
+
+/////////////////////////////////////////////// BC7 mode 6 ///////////////////////////////////////////////
+
+using BC7Endpoint = std::array<uint8_t, 4>;
+using BC7Palette = std::array<std::array<int, 4>, 16>;
+
+struct BC7Block {
+    // 7 bits per channel, the p-bit is the lowest bit of the 8 bit endpoint
+    BC7Endpoint endpoint0;
+    BC7Endpoint endpoint1;
+    uint8_t pBit0;
+    uint8_t pBit1;
+    BlockIndices indices;
+    uint32_t error;
+};
+
+void BuildBC7Palette(const BC7Endpoint &endpoint0,
+    uint8_t pBit0,
+    const BC7Endpoint &endpoint1,
+    uint8_t pBit1,
+    BC7Palette &palette) {
+
+    for (size_t c = 0; c < 4; ++c) {
+        int value0 = (endpoint0[c] << 1) | pBit0;
+        int value1 = (endpoint1[c] << 1) | pBit1;
+        for (size_t index = 0; index < palette.size(); ++index) {
+            palette[index][c] = ((64 - kBC7Weights[index]) * value0 + kBC7Weights[index] * value1 + 32) >> 6;
+        }
+    }
+}
+
+void EvaluateBC7Block(const BlockPixels &pixels, BC7Block &block) {
+    BC7Palette palette;
+    BuildBC7Palette(block.endpoint0, block.pBit0, block.endpoint1, block.pBit1, palette);
+
+    // the palette lies on the segment between the endpoints and the weights are close to uniform, so only the index of
+    // the projection of the pixel and its two neighbours are checked
+    std::array<float, 4> direction;
+    float lengthSquared = 0.f;
+    for (size_t c = 0; c < 4; ++c) {
+        direction[c] = static_cast<float>(palette.back()[c] - palette.front()[c]);
+        lengthSquared += direction[c] * direction[c];
+    }
+    float projectionScale = lengthSquared > 0.f ? static_cast<float>(palette.size() - 1) / lengthSquared : 0.f;
+
+    block.error = 0;
+    for (size_t i = 0; i < kPixelsPerBlock; ++i) {
+        float projection = 0.f;
+        for (size_t c = 0; c < 4; ++c) {
+            projection += static_cast<float>(pixels[i][c] - palette.front()[c]) * direction[c];
+        }
+        int center = std::clamp(static_cast<int>(std::lround(projection * projectionScale)),
+            0,
+            static_cast<int>(palette.size() - 1));
+        int first = std::max(center - 1, 0);
+        int last = std::min(center + 1, static_cast<int>(palette.size() - 1));
+
+        uint32_t bestError = std::numeric_limits<uint32_t>::max();
+        for (int index = first; index <= last; ++index) {
+            uint32_t error = 0;
+            for (size_t c = 0; c < 4; ++c) {
+                int diff = palette[index][c] - pixels[i][c];
+                error += static_cast<uint32_t>(diff * diff);
+            }
+            if (error < bestError) {
+                bestError = error;
+                block.indices[i] = static_cast<uint8_t>(index);
+            }
+        }
+        block.error += bestError;
+    }
+}
+
+auto QuantizeBC7Endpoint(const Vec<4> &endpoint, uint8_t pBit, BC7Endpoint &quantized) -> float {
+    float error = 0.f;
+    for (size_t c = 0; c < 4; ++c) {
+        float value = std::round((endpoint[c] - static_cast<float>(pBit)) * 0.5f);
+        quantized[c] = static_cast<uint8_t>(std::clamp(value, 0.f, 127.f));
+        float diff = endpoint[c] - static_cast<float>((quantized[c] << 1) | pBit);
+        error += diff * diff;
+    }
+    return error;
+}
+
+// searchPBits evaluates the block for all four p-bit pairs, otherwise each endpoint takes the p-bit that rounds it best
+auto MakeBC7Block(const BlockPixels &pixels, const Vec<4> &endpoint0, const Vec<4> &endpoint1, bool searchPBits)
+    -> BC7Block {
+    std::array<BC7Endpoint, 2> quantized0;
+    std::array<BC7Endpoint, 2> quantized1;
+    std::array<float, 2> error0;
+    std::array<float, 2> error1;
+    for (uint8_t pBit = 0; pBit < 2; ++pBit) {
+        error0[pBit] = QuantizeBC7Endpoint(endpoint0, pBit, quantized0[pBit]);
+        error1[pBit] = QuantizeBC7Endpoint(endpoint1, pBit, quantized1[pBit]);
+    }
+
+    BC7Block best;
+    best.error = std::numeric_limits<uint32_t>::max();
+    for (uint8_t pBit0 = 0; pBit0 < 2; ++pBit0) {
+        for (uint8_t pBit1 = 0; pBit1 < 2; ++pBit1) {
+            if (!searchPBits && (error0[pBit0] > error0[pBit0 ^ 1] || error1[pBit1] > error1[pBit1 ^ 1])) {
+                continue;
+            }
+            BC7Block candidate;
+            candidate.endpoint0 = quantized0[pBit0];
+            candidate.endpoint1 = quantized1[pBit1];
+            candidate.pBit0 = pBit0;
+            candidate.pBit1 = pBit1;
+            EvaluateBC7Block(pixels, candidate);
+            if (candidate.error < best.error) {
+                best = candidate;
+            }
+        }
+    }
+    return best;
+}
+
+// moves single 7 bit channels of the endpoints by one step while the error goes down
+void SearchBC7Endpoints(const BlockPixels &pixels, BC7Block &best) {
+    for (int pass = 0; pass < kMaxSearchPasses; ++pass) {
+        bool improved = false;
+        for (BC7Endpoint BC7Block::*pEndpoint : {&BC7Block::endpoint0, &BC7Block::endpoint1}) {
+            for (size_t c = 0; c < 4; ++c) {
+                for (int step : {-1, 1}) {
+                    BC7Block candidate = best;
+                    int value = (candidate.*pEndpoint)[c] + step;
+                    if (value < 0 || value > 127) {
+                        continue;
+                    }
+                    (candidate.*pEndpoint)[c] = static_cast<uint8_t>(value);
+                    EvaluateBC7Block(pixels, candidate);
+                    if (candidate.error < best.error) {
+                        best = candidate;
+                        improved = true;
+                    }
+                }
+            }
+        }
+        if (!improved) {
+            break;
+        }
+    }
+}
+
+void WriteBC7Block(BC7Block block, uint8_t *pDest) {
+    // the highest bit of the index of the first pixel is implied to be zero, mirroring the indices swaps the endpoints
+    if (block.indices[0] >= 8) {
+        std::swap(block.endpoint0, block.endpoint1);
+        std::swap(block.pBit0, block.pBit1);
+        for (uint8_t &index : block.indices) {
+            index = static_cast<uint8_t>(15 - index);
+        }
+    }
+
+    std::fill_n(pDest, 16, 0);
+    BitWriter writer(pDest);
+    writer.Write(1 << 6, 7);
+    for (size_t c = 0; c < 4; ++c) {
+        writer.Write(block.endpoint0[c], 7);
+        writer.Write(block.endpoint1[c], 7);
+    }
+    writer.Write(block.pBit0, 1);
+    writer.Write(block.pBit1, 1);
+    writer.Write(block.indices[0], 3);
+    for (size_t i = 1; i < kPixelsPerBlock; ++i) {
+        writer.Write(block.indices[i], 4);
+    }
+}
+
+void EncodeBC7Block(const BlockPixels &pixels, BlockCompressor::Quality quality, uint8_t *pDest) {
+    std::array<Vec<4>, kPixelsPerBlock> points;
+    for (size_t i = 0; i < kPixelsPerBlock; ++i) {
+        for (size_t c = 0; c < 4; ++c) {
+            points[i][c] = static_cast<float>(pixels[i][c]);
+        }
+    }
+
+    bool searchPBits = quality == BlockCompressor::Quality::eHigh;
+    Vec<4> endpoint0, endpoint1;
+    FitPrincipalAxis(points.data(), points.size(), endpoint0, endpoint1);
+    BC7Block best = MakeBC7Block(pixels, endpoint0, endpoint1, searchPBits);
+
+    int refineIterations = GetRefineIterations(quality);
+    for (int iter = 0; iter < refineIterations && best.error > 0; ++iter) {
+        std::array<float, kPixelsPerBlock> weights;
+        for (size_t i = 0; i < kPixelsPerBlock; ++i) {
+            weights[i] = static_cast<float>(kBC7Weights[best.indices[i]]) / 64.f;
+        }
+        if (!SolveEndpoints(points.data(), weights.data(), points.size(), endpoint0, endpoint1)) {
+            break;
+        }
+        BC7Block candidate = MakeBC7Block(pixels, endpoint0, endpoint1, searchPBits);
+        if (candidate.error >= best.error) {
+            break;
+        }
+        best = candidate;
+    }
+
+    if (quality == BlockCompressor::Quality::eHigh && best.error > 0) {
+        SearchBC7Endpoints(pixels, best);
+    }
+    WriteBC7Block(best, pDest);
+}
+
+void DecodeBC7Block(const uint8_t *pBlock, BlockPixels &pixels) {
+    BitReader reader(pBlock);
+    // the mode is a unary prefix, mode 6 is six zero bits followed by a one
+    uint32_t mode = reader.Read(7);
+    Assert(mode == (1 << 6));
+    BC7Endpoint endpoint0, endpoint1;
+    for (size_t c = 0; c < 4; ++c) {
+        endpoint0[c] = static_cast<uint8_t>(reader.Read(7));
+        endpoint1[c] = static_cast<uint8_t>(reader.Read(7));
+    }
+    auto pBit0 = static_cast<uint8_t>(reader.Read(1));
+    auto pBit1 = static_cast<uint8_t>(reader.Read(1));
+    BC7Palette palette;
+    BuildBC7Palette(endpoint0, pBit0, endpoint1, pBit1, palette);
+    for (size_t i = 0; i < kPixelsPerBlock; ++i) {
+        const std::array<int, 4> &color = palette[reader.Read(i == 0 ? 3 : 4)];
+        for (size_t c = 0; c < 4; ++c) {
+            pixels[i][c] = static_cast<uint8_t>(color[c]);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void EncodeBlock(BlockCompressor::Format format,
+    BlockCompressor::Quality quality,
+    const BlockPixels &pixels,
+    uint8_t *pDest) {
+
+    switch (format) {
+    case BlockCompressor::Format::eBC1:
+        EncodeColorBlock(pixels, quality, pDest);
+        break;
+    case BlockCompressor::Format::eBC3:
+        EncodeChannelBlock(pixels, 3, quality, pDest);
+        EncodeColorBlock(pixels, quality, pDest + 8);
+        break;
+    case BlockCompressor::Format::eBC4:
+        EncodeChannelBlock(pixels, 0, quality, pDest);
+        break;
+    case BlockCompressor::Format::eBC5:
+        EncodeChannelBlock(pixels, 0, quality, pDest);
+        EncodeChannelBlock(pixels, 1, quality, pDest + 8);
+        break;
+    case BlockCompressor::Format::eBC7:
+        EncodeBC7Block(pixels, quality, pDest);
+        break;
+    }
+}
+
+// fills the channels that the format stores
+void DecodeBlock(BlockCompressor::Format format, const uint8_t *pBlock, BlockPixels &pixels) {
+    switch (format) {
+    case BlockCompressor::Format::eBC1:
+        DecodeColorBlock(pBlock, pixels);
+        break;
+    case BlockCompressor::Format::eBC3:
+        DecodeChannelBlock(pBlock, 3, pixels);
+        DecodeColorBlock(pBlock + 8, pixels);
+        break;
+    case BlockCompressor::Format::eBC4:
+        DecodeChannelBlock(pBlock, 0, pixels);
+        break;
+    case BlockCompressor::Format::eBC5:
+        DecodeChannelBlock(pBlock, 0, pixels);
+        DecodeChannelBlock(pBlock + 8, 1, pixels);
+        break;
+    case BlockCompressor::Format::eBC7:
+        DecodeBC7Block(pBlock, pixels);
+        break;
+    }
+}
+
+}    // namespace
+
+void BlockCompressor::Statistics::Merge(const Statistics &other) {
+    squaredError += other.squaredError;
+    sampleCount += other.sampleCount;
+    pixelCount += other.pixelCount;
+    seconds += other.seconds;
+}
+
+auto BlockCompressor::Statistics::GetPSNR() const -> double {
+    if (squaredError <= 0.0 || sampleCount == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double meanSquaredError = squaredError / static_cast<double>(sampleCount);
+    return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
+
+auto BlockCompressor::Statistics::GetMegapixelsPerSecond() const -> double {
+    if (seconds <= 0.0) {
+        return 0.0;
+    }
+    return static_cast<double>(pixelCount) / seconds * 1e-6;
+}
+
+auto BlockCompressor::Compress(const uint8_t *pPixels,
+    uint32_t width,
+    uint32_t height,
+    Format format,
+    Quality quality,
+    uint8_t *pDest) -> Statistics {
+
+    Exception::CondThrow(width > 0 && height > 0, "BlockCompressor: invalid image size {}x{}", width, height);
+    auto beginTime = stdchrono::steady_clock::now();
+
+    uint32_t blocksX = GetBlockCount(width);
+    uint32_t blocksY = GetBlockCount(height);
+    size_t blockSize = GetBlockSize(format);
+    size_t rowPitch = GetRowPitch(format, width);
+    size_t channelCount = GetChannelCount(format);
+
+    // each block row sums its own error, so the total does not depend on the order of the jobs
+    std::vector<uint64_t> rowErrors(blocksY, 0);
+    auto encodeRows = [&](size_t begin, size_t end) {
+        BlockPixels pixels;
+        BlockPixels decoded;
+        for (size_t blockY = begin; blockY < end; ++blockY) {
+            uint8_t *pRow = pDest + blockY * rowPitch;
+            uint32_t validHeight = std::min(kBlockDim, height - static_cast<uint32_t>(blockY) * kBlockDim);
+            uint64_t rowError = 0;
+            for (uint32_t blockX = 0; blockX < blocksX; ++blockX) {
+                uint8_t *pBlock = pRow + blockX * blockSize;
+                LoadBlock(pPixels, width, height, blockX, static_cast<uint32_t>(blockY), pixels);
+                EncodeBlock(format, quality, pixels, pBlock);
+                DecodeBlock(format, pBlock, decoded);
+
+                uint32_t validWidth = std::min(kBlockDim, width - blockX * kBlockDim);
+                for (uint32_t y = 0; y < validHeight; ++y) {
+                    for (uint32_t x = 0; x < validWidth; ++x) {
+                        size_t i = y * kBlockDim + x;
+                        for (size_t c = 0; c < channelCount; ++c) {
+                            int diff = static_cast<int>(decoded[i][c]) - static_cast<int>(pixels[i][c]);
+                            rowError += static_cast<uint64_t>(diff * diff);
+                        }
+                    }
+                }
+            }
+            rowErrors[blockY] = rowError;
+        }
+    };
+
+    size_t rowsPerJob = std::max<size_t>(1, kBlocksPerJob / blocksX);
+    if (JobSystem *pJobSystem = JobSystem::GetInstance()) {
+        pJobSystem->ParallelFor(0, blocksY, rowsPerJob, encodeRows);
+    } else {
+        encodeRows(0, blocksY);
+    }
+
+    Statistics statistics;
+    for (uint64_t rowError : rowErrors) {
+        statistics.squaredError += static_cast<double>(rowError);
+    }
+    statistics.pixelCount = static_cast<size_t>(width) * height;
+    statistics.sampleCount = statistics.pixelCount * channelCount;
+    auto endTime = stdchrono::steady_clock::now();
+    statistics.seconds = stdchrono::duration<double>(endTime - beginTime).count();
+    return statistics;
+}
+
+void BlockCompressor::Decompress(const uint8_t *pBlocks,
+    uint32_t width,
+    uint32_t height,
+    Format format,
+    uint8_t *pDest) {
+
+    Exception::CondThrow(width > 0 && height > 0, "BlockCompressor: invalid image size {}x{}", width, height);
+    uint32_t blocksX = GetBlockCount(width);
+    uint32_t blocksY = GetBlockCount(height);
+    size_t blockSize = GetBlockSize(format);
+    size_t rowPitch = GetRowPitch(format, width);
+    BlockPixels pixels;
+    for (uint32_t blockY = 0; blockY < blocksY; ++blockY) {
+        for (uint32_t blockX = 0; blockX < blocksX; ++blockX) {
+            pixels.fill({0, 0, 0, 255});
+            DecodeBlock(format, pBlocks + blockY * rowPitch + blockX * blockSize, pixels);
+            // the padding pixels of the edge blocks are dropped
+            uint32_t validWidth = std::min(kBlockDim, width - blockX * kBlockDim);
+            uint32_t validHeight = std::min(kBlockDim, height - blockY * kBlockDim);
+            for (uint32_t y = 0; y < validHeight; ++y) {
+                size_t dstY = static_cast<size_t>(blockY) * kBlockDim + y;
+                uint8_t *pDstRow = pDest + (dstY * width + blockX * kBlockDim) * 4;
+                for (uint32_t x = 0; x < validWidth; ++x) {
+                    std::copy_n(pixels[y * kBlockDim + x].data(), 4, pDstRow + x * 4);
+                }
+            }
+        }
+    }
+}
+
+auto BlockCompressor::GetBlockSize(Format format) -> size_t {
+    switch (format) {
+    case Format::eBC1:
+    case Format::eBC4:
+        return 8;
+    case Format::eBC3:
+    case Format::eBC5:
+    case Format::eBC7:
+        return 16;
+    }
+    Exception::Throw("BlockCompressor: unknown format {}", static_cast<int>(format));
+    return 0;
+}
+
+auto BlockCompressor::GetFormatName(Format format) -> const char * {
+    switch (format) {
+    case Format::eBC1:
+        return "BC1";
+    case Format::eBC3:
+        return "BC3";
+    case Format::eBC4:
+        return "BC4";
+    case Format::eBC5:
+        return "BC5";
+    case Format::eBC7:
+        return "BC7";
+    }
+    return "Unknown";
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Encodes RGBA8 images into BC blocks on the CPU.
+// The blocks at the right and the bottom edge repeat the last column and row of the image. Every block is encoded on
+// its own with the same steps, so the output does not depend on how the block rows are split across the JobSystem
+// workers. BC7 only uses mode 6, one subset with 7 bit endpoints, a p-bit and 4 bit indices.
+class BlockCompressor {
+public:
+    enum class Format { eBC1, eBC3, eBC4, eBC5, eBC7 };
+    // eFast fits the endpoints to the principal axis once, eNormal refines them with least squares, eHigh also
+    // searches the neighbouring endpoints, the p-bits of BC7 and the 6 value mode of BC4
+    enum class Quality { eFast, eNormal, eHigh };
+    struct Statistics {
+        void Merge(const Statistics &other);
+        auto GetPSNR() const -> double;
+        auto GetMegapixelsPerSecond() const -> double;
+    public:
+        // squared error of the encoded channels of the decoded blocks in 8 bit units, padding pixels are skipped
+        double squaredError = 0.0;
+        size_t sampleCount = 0;
+        size_t pixelCount = 0;
+        double seconds = 0.0;
+    };
+    static constexpr uint32_t kBlockDim = 4;
+public:
+    // pPixels holds width * height tightly packed RGBA8 pixels, pDest receives GetCompressedSize bytes, the block rows
+    // are tightly packed
+    static auto Compress(const uint8_t *pPixels,
+        uint32_t width,
+        uint32_t height,
+        Format format,
+        Quality quality,
+        uint8_t *pDest) -> Statistics;
+    // decodes the blocks written by Compress into width * height tightly packed RGBA8 pixels, the channels the
+    // format does not store are 0, alpha is 255
+    static void Decompress(const uint8_t *pBlocks, uint32_t width, uint32_t height, Format format, uint8_t *pDest);
+    // the bytes of a 4x4 block
+    static auto GetBlockSize(Format format) -> size_t;
+    static auto GetBlockCount(uint32_t size) -> uint32_t {
+        return (size + kBlockDim - 1) / kBlockDim;
+    }
+    static auto GetRowPitch(Format format, uint32_t width) -> size_t {
+        return GetBlockCount(width) * GetBlockSize(format);
+    }
+    static auto GetCompressedSize(Format format, uint32_t width, uint32_t height) -> size_t {
+        return GetRowPitch(format, width) * GetBlockCount(height);
+    }
+    static auto GetFormatName(Format format) -> const char *;
+};
@@ -219,3 +219,44 @@ void MemoryDDSLoader::GetNextMipMapData(void *pDest, uint32_t stride, uint32_t w
         Assert(_pCurrent <= _pData + _dataSize);
     }
 }
+
+bool FileDDSWriter::Write(const stdfs::path &filePath,
+    const dx::ImageHeader &header,
+    const uint8_t *pData,
+    size_t dataSize) {
+
+    // caps, height, width, pixel format, mip map count and linear size
+    constexpr uint32_t kHeaderFlags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;
+    // complex, texture and mip map
+    constexpr uint32_t kSurfaceFlags = 0x8 | 0x1000 | 0x400000;
+    size_t topMipSize = static_cast<size_t>(dx::BitsPerPixel(header.format)) * header.width * header.height / 8;
+
+    DDS_HEADER ddsHeader = {};
+    ddsHeader.dwSize = sizeof(DDS_HEADER);
+    ddsHeader.dwHeaderFlags = kHeaderFlags;
+    ddsHeader.dwHeight = header.height;
+    ddsHeader.dwWidth = header.width;
+    ddsHeader.dwPitchOrLinearSize = static_cast<uint32_t>(topMipSize);
+    ddsHeader.dwMipMapCount = header.mipMapCount;
+    ddsHeader.ddspf.size = sizeof(DDS_PIXELFORMAT);
+    ddsHeader.ddspf.flags = 0x00000004;    //DDPF_FOURCC
+    ddsHeader.ddspf.fourCC = '01XD';
+    ddsHeader.ddspf.bitCount = header.bitCount;
+    ddsHeader.dwSurfaceFlags = kSurfaceFlags;
+
+    DDS_HEADER_DXT10 header10 = {};
+    header10.dxgiFormat = header.format;
+    header10.resourceDimension = RESOURCE_DIMENSION_TEXTURE2D;
+    header10.arraySize = 1;
+
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    uint32_t dwMagic = ' SDD';
+    file.write(reinterpret_cast<const char *>(&dwMagic), sizeof(dwMagic));
+    file.write(reinterpret_cast<const char *>(&ddsHeader), sizeof(ddsHeader));
+    file.write(reinterpret_cast<const char *>(&header10), sizeof(header10));
+    file.write(reinterpret_cast<const char *>(pData), static_cast<std::streamsize>(dataSize));
+    return file.good();
+}
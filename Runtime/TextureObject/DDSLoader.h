@@ -33,4 +33,10 @@ private:
 	size_t				_dataSize;
     dx::ImageHeader     _imageHeader;
 	// clang-format on
-};
\ No newline at end of file
+};
+
+class FileDDSWriter {
+public:
+	// writes a 2d texture with a DX10 header, pData holds every mip with tightly packed rows in the order the loaders read
+	static bool Write(const stdfs::path &filePath, const dx::ImageHeader &header, const uint8_t *pData, size_t dataSize);
+};
@@ -0,0 +1,425 @@
+#include "MipChainGenerator.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numbers>
+#include <glm/gtc/packing.hpp>
+#include "Foundation/Exception.h"
+#include "Foundation/GlmStd.hpp"
+#include "Foundation/JobSystem.h"
+
+namespace {
+
+// destination pixels of a band, a band is the unit of work of a job
+constexpr size_t kPixelsPerJob = 64 * 1024;
+constexpr float kKaiserAlpha = 4.f;
+
+auto SRGBToLinear(float value) -> float {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+// the sRGB code of a linear value is the number of thresholds at or below it, the thresholds are the linear values
+// halfway between two neighbouring codes, so the rounding happens in sRGB space
+struct SRGBTables {
+    static constexpr size_t kEncodeTableSize = 4096;
+    std::array<float, 256> decode;
+    std::array<float, 255> thresholds;
+    // the code of the lower end of each bucket of the linear range, the buckets are narrower than the distance of two
+    // thresholds, so at most one threshold has to be checked after the lookup
+    std::array<uint8_t, kEncodeTableSize> encode;
+};
+
+auto GetSRGBTables() -> const SRGBTables & {
+    static const SRGBTables sTables = [] {
+        SRGBTables tables = {};
+        for (size_t i = 0; i < tables.decode.size(); ++i) {
+            tables.decode[i] = SRGBToLinear(static_cast<float>(i) / 255.f);
+        }
+        for (size_t i = 0; i < tables.thresholds.size(); ++i) {
+            tables.thresholds[i] = SRGBToLinear((static_cast<float>(i) + 0.5f) / 255.f);
+        }
+        for (size_t i = 0; i < tables.encode.size(); ++i) {
+            float value = static_cast<float>(i) / static_cast<float>(SRGBTables::kEncodeTableSize - 1);
+            auto iter = std::upper_bound(tables.thresholds.begin(), tables.thresholds.end(), value);
+            tables.encode[i] = static_cast<uint8_t>(iter - tables.thresholds.begin());
+        }
+        return tables;
+    }();
+    return sTables;
+}
+
+// value is in [0, 1]
+auto LinearToSRGB8(const SRGBTables &tables, float value) -> uint8_t {
+    uint32_t code = tables.encode[static_cast<size_t>(value * static_cast<float>(SRGBTables::kEncodeTableSize - 1))];
+    if (code < tables.thresholds.size() && tables.thresholds[code] <= value) {
+        ++code;
+    }
+    return static_cast<uint8_t>(code);
+}
+
+auto Sinc(float x) -> float {
+    if (std::abs(x) < 1e-5f) {
+        return 1.f;
+    }
+    float px = std::numbers::pi_v<float> * x;
+    return std::sin(px) / px;
+}
+
+// modified bessel function of the first kind of order zero
+auto BesselI0(float x) -> float {
+    float sum = 1.f;
+    float term = 1.f;
+    float halfX = x * 0.5f;
+    for (int k = 1; k < 32; ++k) {
+        term *= halfX / static_cast<float>(k);
+        float termSquare = term * term;
+        sum += termSquare;
+        if (termSquare < sum * 1e-7f) {
+            break;
+        }
+    }
+    return sum;
+}
+
+// the radius of the kernel in destination pixels
+auto GetFilterRadius(MipChainGenerator::Filter filter) -> float {
+    switch (filter) {
+    case MipChainGenerator::Filter::eKaiser:
+    case MipChainGenerator::Filter::eLanczos:
+        return 3.f;
+    default:
+        return 0.5f;
+    }
+}
+
+auto EvaluateFilter(MipChainGenerator::Filter filter, float x) -> float {
+    float radius = GetFilterRadius(filter);
+    if (std::abs(x) >= radius) {
+        return 0.f;
+    }
+    switch (filter) {
+    case MipChainGenerator::Filter::eKaiser: {
+        float t = x / radius;
+        return Sinc(x) * BesselI0(kKaiserAlpha * std::sqrt(1.f - t * t)) / BesselI0(kKaiserAlpha);
+    }
+    case MipChainGenerator::Filter::eLanczos:
+        return Sinc(x) * Sinc(x / radius);
+    default:
+        return 1.f;
+    }
+}
+
+// one RGBA float pixel per destination pixel, the taps gather whole source pixels
+void FilterHorizontal(const float *pSrc,
+    const uint32_t *pIndices,
+    const float *pWeights,
+    uint32_t tapCount,
+    uint32_t width,
+    float *pDest) {
+
+    for (uint32_t x = 0; x < width; ++x) {
+        const uint32_t *pTapIndices = pIndices + x * tapCount;
+        const float *pTapWeights = pWeights + x * tapCount;
+#if GLM_STD_SSE
+        __m128 sum = _mm_setzero_ps();
+        for (uint32_t t = 0; t < tapCount; ++t) {
+            __m128 pixel = _mm_loadu_ps(pSrc + pTapIndices[t] * 4);
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(pTapWeights[t]), pixel));
+        }
+        _mm_storeu_ps(pDest + x * 4, sum);
+#else
+        float sum[4] = {0.f, 0.f, 0.f, 0.f};
+        for (uint32_t t = 0; t < tapCount; ++t) {
+            const float *pPixel = pSrc + pTapIndices[t] * 4;
+            for (size_t c = 0; c < 4; ++c) {
+                sum[c] += pTapWeights[t] * pPixel[c];
+            }
+        }
+        std::memcpy(pDest + x * 4, sum, sizeof(sum));
+#endif
+    }
+}
+
+// pDest += weight * pSrc over count floats
+void AccumulateRow(const float *pSrc, float weight, size_t count, float *pDest) {
+    size_t i = 0;
+#if GLM_STD_AVX
+    __m256 weight8 = _mm256_set1_ps(weight);
+    for (; i + 8 <= count; i += 8) {
+        __m256 sum = _mm256_add_ps(_mm256_loadu_ps(pDest + i), _mm256_mul_ps(weight8, _mm256_loadu_ps(pSrc + i)));
+        _mm256_storeu_ps(pDest + i, sum);
+    }
+#endif
+#if GLM_STD_SSE
+    __m128 weight4 = _mm_set1_ps(weight);
+    for (; i + 4 <= count; i += 4) {
+        __m128 sum = _mm_add_ps(_mm_loadu_ps(pDest + i), _mm_mul_ps(weight4, _mm_loadu_ps(pSrc + i)));
+        _mm_storeu_ps(pDest + i, sum);
+    }
+#endif
+    for (; i < count; ++i) {
+        pDest[i] += weight * pSrc[i];
+    }
+}
+
+// the negative lobes of the windowed sinc kernels may leave the valid range
+void ClampRow(float *pPixels, uint32_t width, float maxColor) {
+#if GLM_STD_SSE
+    __m128 lower = _mm_setzero_ps();
+    __m128 upper = _mm_setr_ps(maxColor, maxColor, maxColor, 1.f);
+    for (uint32_t x = 0; x < width; ++x) {
+        __m128 pixel = _mm_loadu_ps(pPixels + x * 4);
+        _mm_storeu_ps(pPixels + x * 4, _mm_min_ps(_mm_max_ps(pixel, lower), upper));
+    }
+#else
+    for (uint32_t x = 0; x < width; ++x) {
+        float *pPixel = pPixels + x * 4;
+        pPixel[0] = std::clamp(pPixel[0], 0.f, maxColor);
+        pPixel[1] = std::clamp(pPixel[1], 0.f, maxColor);
+        pPixel[2] = std::clamp(pPixel[2], 0.f, maxColor);
+        pPixel[3] = std::clamp(pPixel[3], 0.f, 1.f);
+    }
+#endif
+}
+
+}    // namespace
+
+void MipChainGenerator::Generate(const void *pSource, uint32_t width, uint32_t height, const Settings &settings) {
+    Exception::CondThrow(width > 0 && height > 0, "MipChainGenerator: invalid image size {}x{}", width, height);
+    Exception::CondThrow(!settings.sRGB || settings.format == Format::eRGBA8,
+        "MipChainGenerator: sRGB requires the eRGBA8 format");
+
+    _settings = settings;
+    uint32_t mipCount = GetFullMipCount(width, height);
+    if (settings.maxMipCount > 0) {
+        mipCount = std::min(mipCount, settings.maxMipCount);
+    }
+
+    size_t pixelSize = GetPixelSize(settings.format);
+    size_t dataSize = 0;
+    _mipLevels.clear();
+    for (uint32_t mip = 0; mip < mipCount; ++mip) {
+        _mipLevels.push_back(MipLevel{width, height, dataSize});
+        dataSize += static_cast<size_t>(width) * height * pixelSize;
+        width = std::max(width >> 1, 1u);
+        height = std::max(height >> 1, 1u);
+    }
+
+    _data.resize(dataSize);
+    std::memcpy(_data.data(), pSource, GetMipRowPitch(0) * _mipLevels[0].height);
+    for (uint32_t mip = 1; mip < mipCount; ++mip) {
+        Downsample(mip);
+        std::swap(_srcLevel, _dstLevel);
+    }
+
+    // the float levels are a lot larger than the output, they are not kept between two images
+    std::vector<float>().swap(_srcLevel);
+    std::vector<float>().swap(_dstLevel);
+}
+
+void MipChainGenerator::Clear() {
+    _mipLevels.clear();
+    std::vector<uint8_t>().swap(_data);
+    std::vector<float>().swap(_srcLevel);
+    std::vector<float>().swap(_dstLevel);
+}
+
+auto MipChainGenerator::GetPixelSize(Format format) -> size_t {
+    switch (format) {
+    case Format::eRGBA8:
+        return 4;
+    case Format::eRGBA16F:
+        return 8;
+    case Format::eRGBA32F:
+        return 16;
+    }
+    Exception::Throw("MipChainGenerator: unknown format");
+    return 0;
+}
+
+auto MipChainGenerator::GetFullMipCount(uint32_t width, uint32_t height) -> uint32_t {
+    uint32_t mipCount = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(width >> 1, 1u);
+        height = std::max(height >> 1, 1u);
+        ++mipCount;
+    }
+    return mipCount;
+}
+
+void MipChainGenerator::BuildKernel(Kernel &kernel, uint32_t srcSize, uint32_t dstSize) const {
+    // the footprint of a destination pixel is scale source pixels wide, 2 for even sizes and a bit more for odd ones
+    float scale = static_cast<float>(srcSize) / static_cast<float>(dstSize);
+    float radius = GetFilterRadius(_settings.filter) * scale;
+    kernel.tapCount = static_cast<uint32_t>(std::ceil(2.f * radius)) + 1;
+    kernel.indices.resize(static_cast<size_t>(dstSize) * kernel.tapCount);
+    kernel.weights.resize(static_cast<size_t>(dstSize) * kernel.tapCount);
+
+    for (uint32_t i = 0; i < dstSize; ++i) {
+        float center = (static_cast<float>(i) + 0.5f) * scale;
+        int first = static_cast<int>(std::floor(center - radius));
+        uint32_t *pIndices = kernel.indices.data() + i * kernel.tapCount;
+        float *pWeights = kernel.weights.data() + i * kernel.tapCount;
+        float weightSum = 0.f;
+        for (uint32_t t = 0; t < kernel.tapCount; ++t) {
+            int index = first + static_cast<int>(t);
+            float weight = 0.f;
+            if (_settings.filter == Filter::eBox) {
+                // the overlap of the source pixel with the footprint
+                float begin = std::max(static_cast<float>(index), center - radius);
+                float end = std::min(static_cast<float>(index + 1), center + radius);
+                weight = std::max(end - begin, 0.f);
+            } else {
+                weight = EvaluateFilter(_settings.filter, (static_cast<float>(index) + 0.5f - center) / scale);
+            }
+            // the edges are clamped
+            pIndices[t] = static_cast<uint32_t>(std::clamp(index, 0, static_cast<int>(srcSize) - 1));
+            pWeights[t] = weight;
+            weightSum += weight;
+        }
+        if (weightSum != 0.f) {
+            for (uint32_t t = 0; t < kernel.tapCount; ++t) {
+                pWeights[t] /= weightSum;
+            }
+        }
+    }
+}
+
+void MipChainGenerator::Downsample(uint32_t mip) {
+    const MipLevel &srcLevel = _mipLevels[mip - 1];
+    const MipLevel &dstLevel = _mipLevels[mip];
+    BuildKernel(_horizontalKernel, srcLevel.width, dstLevel.width);
+    BuildKernel(_verticalKernel, srcLevel.height, dstLevel.height);
+
+    // the last level is only encoded, the others are the source of the next level
+    bool keepFloatLevel = mip + 1 < GetMipCount();
+    size_t dstRowFloats = static_cast<size_t>(dstLevel.width) * 4;
+    _dstLevel.resize(keepFloatLevel ? dstRowFloats * dstLevel.height : 0);
+    float maxColor = _settings.format == Format::eRGBA8 ? 1.f : std::numeric_limits<float>::max();
+    uint8_t *pMipData = GetMipData(mip);
+    size_t dstRowPitch = GetMipRowPitch(mip);
+
+    size_t rowsPerBand = std::max<size_t>(kPixelsPerJob / dstLevel.width, 1);
+    auto filterRows = [&](size_t begin, size_t end) {
+        const Kernel &verticalKernel = _verticalKernel;
+        const Kernel &horizontalKernel = _horizontalKernel;
+        std::vector<float> band;
+        std::vector<float> decodedRow(mip == 1 ? static_cast<size_t>(srcLevel.width) * 4 : 0);
+        std::vector<float> dstRow(keepFloatLevel ? 0 : dstRowFloats);
+        // the rows are filtered in bands, so the horizontally filtered source rows of a band stay small
+        for (size_t bandBegin = begin; bandBegin < end; bandBegin += rowsPerBand) {
+            size_t bandEnd = std::min(bandBegin + rowsPerBand, end);
+            const uint32_t *pFirstTap = verticalKernel.indices.data() + bandBegin * verticalKernel.tapCount;
+            const uint32_t *pLastTap = verticalKernel.indices.data() + bandEnd * verticalKernel.tapCount;
+            uint32_t firstRow = *std::min_element(pFirstTap, pLastTap);
+            uint32_t lastRow = *std::max_element(pFirstTap, pLastTap);
+
+            // a source row at the edge of two bands is filtered by both
+            band.resize(static_cast<size_t>(lastRow - firstRow + 1) * dstRowFloats);
+            for (uint32_t y = firstRow; y <= lastRow; ++y) {
+                const float *pSrcRow = nullptr;
+                if (mip == 1) {
+                    DecodeRow(y, decodedRow.data());
+                    pSrcRow = decodedRow.data();
+                } else {
+                    pSrcRow = _srcLevel.data() + static_cast<size_t>(y) * srcLevel.width * 4;
+                }
+                FilterHorizontal(pSrcRow,
+                    horizontalKernel.indices.data(),
+                    horizontalKernel.weights.data(),
+                    horizontalKernel.tapCount,
+                    dstLevel.width,
+                    band.data() + (y - firstRow) * dstRowFloats);
+            }
+
+            for (size_t y = bandBegin; y < bandEnd; ++y) {
+                float *pDstRow = keepFloatLevel ? _dstLevel.data() + y * dstRowFloats : dstRow.data();
+                std::fill_n(pDstRow, dstRowFloats, 0.f);
+                const uint32_t *pIndices = verticalKernel.indices.data() + y * verticalKernel.tapCount;
+                const float *pWeights = verticalKernel.weights.data() + y * verticalKernel.tapCount;
+                for (uint32_t t = 0; t < verticalKernel.tapCount; ++t) {
+                    if (pWeights[t] != 0.f) {
+                        const float *pBandRow = band.data() + (pIndices[t] - firstRow) * dstRowFloats;
+                        AccumulateRow(pBandRow, pWeights[t], dstRowFloats, pDstRow);
+                    }
+                }
+                ClampRow(pDstRow, dstLevel.width, maxColor);
+                EncodeRow(pDstRow, dstLevel.width, pMipData + y * dstRowPitch);
+            }
+        }
+    };
+
+    if (JobSystem *pJobSystem = JobSystem::GetInstance()) {
+        pJobSystem->ParallelFor(0, dstLevel.height, rowsPerBand, filterRows);
+    } else {
+        filterRows(0, dstLevel.height);
+    }
+}
+
+void MipChainGenerator::DecodeRow(uint32_t y, float *pDest) const {
+    const MipLevel &level = _mipLevels[0];
+    const uint8_t *pRow = GetMipData(0) + y * GetMipRowPitch(0);
+    switch (_settings.format) {
+    case Format::eRGBA8:
+        if (_settings.sRGB) {
+            const std::array<float, 256> &decodeTable = GetSRGBTables().decode;
+            for (size_t x = 0; x < level.width; ++x) {
+                const uint8_t *pPixel = pRow + x * 4;
+                pDest[x * 4 + 0] = decodeTable[pPixel[0]];
+                pDest[x * 4 + 1] = decodeTable[pPixel[1]];
+                pDest[x * 4 + 2] = decodeTable[pPixel[2]];
+                pDest[x * 4 + 3] = static_cast<float>(pPixel[3]) * (1.f / 255.f);
+            }
+        } else {
+            for (size_t i = 0; i < level.width * 4; ++i) {
+                pDest[i] = static_cast<float>(pRow[i]) * (1.f / 255.f);
+            }
+        }
+        break;
+    case Format::eRGBA16F:
+        for (size_t x = 0; x < level.width; ++x) {
+            uint64_t packed = 0;
+            std::memcpy(&packed, pRow + x * sizeof(packed), sizeof(packed));
+            glm::vec4 pixel = glm::unpackHalf4x16(packed);
+            std::memcpy(pDest + x * 4, &pixel, sizeof(pixel));
+        }
+        break;
+    case Format::eRGBA32F:
+        std::memcpy(pDest, pRow, level.width * sizeof(float) * 4);
+        break;
+    }
+}
+
+void MipChainGenerator::EncodeRow(const float *pSource, uint32_t width, uint8_t *pDest) const {
+    switch (_settings.format) {
+    case Format::eRGBA8:
+        if (_settings.sRGB) {
+            const SRGBTables &tables = GetSRGBTables();
+            for (size_t x = 0; x < width; ++x) {
+                const float *pPixel = pSource + x * 4;
+                pDest[x * 4 + 0] = LinearToSRGB8(tables, pPixel[0]);
+                pDest[x * 4 + 1] = LinearToSRGB8(tables, pPixel[1]);
+                pDest[x * 4 + 2] = LinearToSRGB8(tables, pPixel[2]);
+                pDest[x * 4 + 3] = static_cast<uint8_t>(pPixel[3] * 255.f + 0.5f);
+            }
+        } else {
+            for (size_t i = 0; i < width * 4; ++i) {
+                pDest[i] = static_cast<uint8_t>(pSource[i] * 255.f + 0.5f);
+            }
+        }
+        break;
+    case Format::eRGBA16F:
+        for (size_t x = 0; x < width; ++x) {
+            glm::vec4 pixel;
+            std::memcpy(&pixel, pSource + x * 4, sizeof(pixel));
+            uint64_t packed = glm::packHalf4x16(pixel);
+            std::memcpy(pDest + x * sizeof(packed), &packed, sizeof(packed));
+        }
+        break;
+    case Format::eRGBA32F:
+        std::memcpy(pDest, pSource, width * sizeof(float) * 4);
+        break;
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Builds the full mip chain of a RGBA image on the CPU.
+// Every level is filtered from the previous one with a separable kernel whose footprint follows the real size ratio
+// of the two levels, so odd sizes (5 -> 2) are resampled instead of dropping the last row and column. The color of
+// sRGB images is filtered in linear space. The intermediate levels are kept as float RGBA, only the output is
+// converted back to the source format. The rows of a level are split across the JobSystem workers.
+class MipChainGenerator {
+public:
+    enum class Format { eRGBA8, eRGBA16F, eRGBA32F };
+    enum class Filter { eBox, eKaiser, eLanczos };
+    struct Settings {
+        Format format = Format::eRGBA8;
+        Filter filter = Filter::eBox;
+        // rgb of eRGBA8 is sRGB encoded, alpha is always linear
+        bool sRGB = false;
+        // 0 builds the chain down to 1x1
+        uint32_t maxMipCount = 0;
+    };
+    struct MipLevel {
+        uint32_t width;
+        uint32_t height;
+        // offset of the level in GetData, the rows are tightly packed
+        size_t offset;
+    };
+public:
+    // pSource holds width * height tightly packed pixels of settings.format, it is copied as level 0
+    void Generate(const void *pSource, uint32_t width, uint32_t height, const Settings &settings);
+    auto GetMipCount() const -> uint32_t {
+        return static_cast<uint32_t>(_mipLevels.size());
+    }
+    auto GetMipLevel(uint32_t mip) const -> const MipLevel & {
+        return _mipLevels[mip];
+    }
+    auto GetData() const -> const std::vector<uint8_t> & {
+        return _data;
+    }
+    auto GetMipData(uint32_t mip) -> uint8_t * {
+        return _data.data() + _mipLevels[mip].offset;
+    }
+    auto GetMipData(uint32_t mip) const -> const uint8_t * {
+        return _data.data() + _mipLevels[mip].offset;
+    }
+    auto GetMipRowPitch(uint32_t mip) const -> size_t {
+        return _mipLevels[mip].width * GetPixelSize(_settings.format);
+    }
+    auto GetSettings() const -> const Settings & {
+        return _settings;
+    }
+    // drops the levels and the scratch memory
+    void Clear();
+    static auto GetPixelSize(Format format) -> size_t;
+    // the number of levels of the full chain, the size of each level is max(1, size >> 1) of the previous one
+    static auto GetFullMipCount(uint32_t width, uint32_t height) -> uint32_t;
+private:
+    // the taps of one axis, every destination pixel has the same number of taps, unused taps have zero weight
+    struct Kernel {
+        uint32_t tapCount;
+        std::vector<uint32_t> indices;
+        std::vector<float> weights;
+    };
+    void BuildKernel(Kernel &kernel, uint32_t srcSize, uint32_t dstSize) const;
+    // filters mip - 1 into mip, the source rows are read from _srcLevel or for the first level from the level 0 data
+    void Downsample(uint32_t mip);
+    void DecodeRow(uint32_t y, float *pDest) const;
+    void EncodeRow(const float *pSource, uint32_t width, uint8_t *pDest) const;
+private:
+    // clang-format off
+    Settings                _settings;
+    std::vector<MipLevel>   _mipLevels;
+    std::vector<uint8_t>    _data;
+    // float RGBA of the previous and the current level, linear for sRGB
+    std::vector<float>      _srcLevel;
+    std::vector<float>      _dstLevel;
+    Kernel                  _horizontalKernel;
+    Kernel                  _verticalKernel;
+    // clang-format on
+};
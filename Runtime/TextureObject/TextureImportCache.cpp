@@ -0,0 +1,76 @@
+#include "TextureImportCache.h"
+#include <magic_enum.hpp>
+#include "DDSLoader.h"
+#include "WICLoader.h"
+#include "D3d12/FormatHelper.hpp"
+#include "Foundation/Formatter.hpp"
+#include "Foundation/Logger.h"
+#include "Foundation/UUID128.h"
+#include "Utils/AssetProjectSetting.h"
+#include <thread>
+
+static std::string_view sTextureCacheDirectory = "Texture";
+
+auto TextureImportCache::GetCachePath(const uint8_t *pData,
+    size_t dataSize,
+    const TextureImportSettings &settings,
+    float cutOff) -> stdfs::path {
+
+    UUID128 contentUUID = UUID128::New(std::string_view(reinterpret_cast<const char *>(pData), dataSize));
+    std::string keyString = fmt::format("{}_{}_{}_{}_{}_{}_{}",
+        kVersion,
+        contentUUID.ToString(),
+        settings.sRGB,
+        settings.compress,
+        magic_enum::enum_name(settings.usage),
+        magic_enum::enum_name(settings.quality),
+        cutOff);
+    stdfs::path cacheFileName = fmt::format("{}.dds", UUID128::New(keyString).ToString());
+    return AssetProjectSetting::ToCachePath(sTextureCacheDirectory / cacheFileName);
+}
+
+auto TextureImportCache::Load(const stdfs::path &cachePath) -> std::unique_ptr<FileDDSLoader> {
+    if (!stdfs::exists(cachePath)) {
+        return nullptr;
+    }
+    std::unique_ptr<FileDDSLoader> pLoader = std::make_unique<FileDDSLoader>();
+    if (!pLoader->Load(cachePath, 1.f)) {
+        Logger::Warning("TextureImportCache: can not parse '{}'", cachePath.string());
+        return nullptr;
+    }
+    return pLoader;
+}
+
+bool TextureImportCache::Store(const stdfs::path &cachePath,
+    const WICLoader &loader,
+    const TextureImportSettings &settings) {
+
+    stdfs::path directory = cachePath.parent_path();
+    std::error_code errorCode;
+    if (!stdfs::exists(directory)) {
+        stdfs::create_directories(directory, errorCode);
+    }
+
+    // the sRGB flag is stored in the format, so the entry does not depend on the caller
+    dx::ImageHeader header = loader.GetImageHeader();
+    if (settings.sRGB) {
+        header.format = dx::GetSRGBFormat(header.format);
+    }
+
+    // written under a name unique to the thread and moved into place, so a loader never sees a partial entry and two
+    // threads importing the same image do not write the same file
+    stdfs::path tempPath = cachePath;
+    tempPath += fmt::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    std::span<const uint8_t> mipChainData = loader.GetMipChainData();
+    if (!FileDDSWriter::Write(tempPath, header, mipChainData.data(), mipChainData.size())) {
+        stdfs::remove(tempPath, errorCode);
+        Logger::Warning("TextureImportCache: can not write '{}'", cachePath.string());
+        return false;
+    }
+    stdfs::rename(tempPath, cachePath, errorCode);
+    if (errorCode) {
+        stdfs::remove(tempPath, errorCode);
+        return false;
+    }
+    return true;
+}
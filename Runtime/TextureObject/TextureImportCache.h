@@ -0,0 +1,24 @@
+#pragma once
+#include <memory>
+#include "Foundation/NamespeceAlias.h"
+#include "TextureImportSettings.h"
+
+class FileDDSLoader;
+class WICLoader;
+
+// Keeps the textures built by WICLoader as dds files in the asset cache.
+// The file name is derived from the content of the source image, the import settings and the alpha test cutoff, so an
+// edited image misses the cache and the same image embedded in several models maps to one entry.
+class TextureImportCache {
+public:
+    // changes whenever the import produces different mips for the same input
+    static constexpr uint32_t kVersion = 1;
+public:
+    static auto GetCachePath(const uint8_t *pData,
+        size_t dataSize,
+        const TextureImportSettings &settings,
+        float cutOff) -> stdfs::path;
+    // nullptr when the entry does not exist or can not be parsed
+    static auto Load(const stdfs::path &cachePath) -> std::unique_ptr<FileDDSLoader>;
+    static bool Store(const stdfs::path &cachePath, const WICLoader &loader, const TextureImportSettings &settings);
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include "BlockCompressor.h"
+
+// what the channels of a texture hold, picks the block compression format
+enum class TextureUsage {
+    // rgb color and alpha, BC7, the fast preset uses BC1 or BC3 when the alpha is not opaque
+    eColor,
+    // tangent space xy in rg, BC5, the shader rebuilds z
+    eNormalMap,
+    // a single channel in r, BC4
+    eGrayscale,
+};
+
+// how WICLoader turns a decoded image into the mips of a texture
+struct TextureImportSettings {
+    // the color is sRGB encoded and the mips are filtered in linear space
+    bool sRGB = false;
+    // images whose size is not a multiple of the block size stay uncompressed
+    bool compress = false;
+    TextureUsage usage = TextureUsage::eColor;
+    BlockCompressor::Quality quality = BlockCompressor::Quality::eNormal;
+};
@@ -1,7 +1,10 @@
 #include "TextureLoader.h"
 #include "DDSLoader.h"
+#include "TextureImportCache.h"
 #include "WICLoader.h"
+#include <fstream>
 #include "Foundation/PathUtils.h"
+#include "Foundation/StreamUtil.h"
 #include "Foundation/StringUtil.h"
 #include "Utils/AssetProjectSetting.h"
 #include <d3d12.h>
@@ -13,7 +16,19 @@
 #include <ranges>
 #include "Renderer/GfxDevice.h"
 
+// the formats decoded by WICLoader
+static bool IsImageExtension(std::string_view extension) {
+    std::string_view supportExtensions[] = {".jpg", ".png", ".tga", ".bmp", ".psd", ".hdr", ".pic"};
+    return std::ranges::find(supportExtensions, extension) != std::end(supportExtensions);
+}
+
 auto TextureLoader::LoadFromFile(stdfs::path path, bool forceSRGB) -> SharedPtr<dx::Texture> {
+    TextureImportSettings settings;
+    settings.sRGB = forceSRGB;
+    return LoadFromFile(std::move(path), settings);
+}
+
+auto TextureLoader::LoadFromFile(stdfs::path path, const TextureImportSettings &settings) -> SharedPtr<dx::Texture> {
     if (!path.is_absolute()) {
         path = stdfs::absolute(path);
     }
@@ -31,30 +46,82 @@ auto TextureLoader::LoadFromFile(stdfs::path path, bool forceSRGB) -> SharedPtr<
         Exception::Throw("'path' must be under the project path");
     }
 
-    std::unique_ptr<dx::IFileImageLoader> pImageLoader;
     std::string extension = nstd::tolower(path.extension().string());
-    if (extension == ".dds") {
-        pImageLoader = std::make_unique<FileDDSLoader>();
-    } else {
-        std::string_view supportExtensions[] = {".jpg", ".png", ".tga", ".bmp", ".psd", ".hdr", ".pic"};
-        for (std::string_view targetExtension : supportExtensions) {
-            if (targetExtension == extension) {
-                pImageLoader = std::make_unique<WICLoader>();
-                break;
-            }
-        }
-    }
-
-    if (pImageLoader == nullptr) {
+    if (extension != ".dds" && !IsImageExtension(extension)) {
         Exception::Throw("Unsupported extended file formats: {}", extension);
     }
-    pImageLoader->Load(path, 1.f);
-    SharedPtr<dx::Texture> pTexture = UploadTexture(pImageLoader.get(), forceSRGB);
+    std::unique_ptr<dx::IImageLoader> pImageLoader = ImportFile(path, settings);
+    Exception::CondThrow(pImageLoader != nullptr, "can not load the image '{}'", path);
+    SharedPtr<dx::Texture> pTexture = UploadTexture(pImageLoader.get(), settings.sRGB);
     pTexture->SetName(path.string());
     _textureMap[path] = pTexture;
     return pTexture;
 }
 
+auto TextureLoader::LoadFromMemory(const uint8_t *pData,
+    size_t dataSize,
+    const TextureImportSettings &settings,
+    float cutOff) -> SharedPtr<dx::Texture> {
+
+    // images with the same content and settings share one texture and one cache entry
+    stdfs::path cachePath = TextureImportCache::GetCachePath(pData, dataSize, settings, cutOff);
+    if (auto iter = _importedTextureMap.find(cachePath); iter != _importedTextureMap.end()) {
+        return iter->second;
+    }
+
+    std::unique_ptr<dx::IImageLoader> pImageLoader = ImportImage(pData, dataSize, cachePath, settings, cutOff);
+    if (pImageLoader == nullptr) {
+        return nullptr;
+    }
+
+    SharedPtr<dx::Texture> pTexture = UploadTexture(pImageLoader.get(), settings.sRGB);
+    _importedTextureMap[cachePath] = pTexture;
+    return pTexture;
+}
+
+auto TextureLoader::ImportFile(const stdfs::path &path, const TextureImportSettings &settings)
+    -> std::unique_ptr<dx::IImageLoader> {
+
+    std::string extension = nstd::tolower(path.extension().string());
+    if (extension == ".dds") {
+        std::unique_ptr<FileDDSLoader> pDDSLoader = std::make_unique<FileDDSLoader>();
+        if (!pDDSLoader->Load(path, 1.f)) {
+            return nullptr;
+        }
+        return pDDSLoader;
+    }
+    if (!IsImageExtension(extension)) {
+        return nullptr;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+    std::vector<uint8_t> fileData(static_cast<size_t>(nstd::GetFileSize(file)));
+    file.read(reinterpret_cast<char *>(fileData.data()), static_cast<std::streamsize>(fileData.size()));
+    stdfs::path cachePath = TextureImportCache::GetCachePath(fileData.data(), fileData.size(), settings, 1.f);
+    return ImportImage(fileData.data(), fileData.size(), cachePath, settings, 1.f);
+}
+
+auto TextureLoader::ImportImage(const uint8_t *pData,
+    size_t dataSize,
+    const stdfs::path &cachePath,
+    const TextureImportSettings &settings,
+    float cutOff) -> std::unique_ptr<dx::IImageLoader> {
+
+    if (std::unique_ptr<FileDDSLoader> pDDSLoader = TextureImportCache::Load(cachePath)) {
+        return pDDSLoader;
+    }
+    std::unique_ptr<WICLoader> pWICLoader = std::make_unique<WICLoader>();
+    pWICLoader->SetImportSettings(settings);
+    if (!pWICLoader->Load(pData, dataSize, cutOff)) {
+        return nullptr;
+    }
+    TextureImportCache::Store(cachePath, *pWICLoader, settings);
+    return pWICLoader;
+}
+
 auto TextureLoader::GetSRV2D(const dx::Texture *pTexture) -> dx::SRV {
     auto iter = _srv2DMap.find(pTexture);
     if (iter != _srv2DMap.end()) {
@@ -1,8 +1,10 @@
 #pragma once
 #include "D3d12/DescriptorHandle.h"
+#include <memory>
 #include "Foundation/Singleton.hpp"
 #include "Foundation/NamespeceAlias.h"
 #include "Foundation/Memory/SharedPtr.hpp"
+#include "TextureImportSettings.h"
 
 namespace dx {
 class Texture;
@@ -13,17 +15,35 @@ class IImageLoader;
 class TextureLoader : public NonCopyable {
 public:
     auto LoadFromFile(stdfs::path path, bool forceSRGB = false) -> SharedPtr<dx::Texture>;
+    // the settings only apply to the images decoded by WICLoader, dds files are uploaded as they are
+    auto LoadFromFile(stdfs::path path, const TextureImportSettings &settings) -> SharedPtr<dx::Texture>;
+    // decodes an encoded image file in memory, the result is read from and written to the TextureImportCache.
+    // Returns nullptr when the data can not be decoded
+    auto LoadFromMemory(const uint8_t *pData, size_t dataSize, const TextureImportSettings &settings, float cutOff)
+        -> SharedPtr<dx::Texture>;
     auto GetSRV2D(const dx::Texture *pTexture) -> dx::SRV;
     auto GetSRVCube(const dx::Texture *pTexture) -> dx::SRV;
     static auto UploadTexture(dx::IImageLoader *pLoader, bool forceSRGB = false) -> SharedPtr<dx::Texture>;
+    // ImportFile and ImportImage only touch the file system and the TextureImportCache, they can run on the JobSystem
+    // workers and leave the upload to the main thread. Both return nullptr when the image can not be read or decoded
+    static auto ImportFile(const stdfs::path &path, const TextureImportSettings &settings)
+        -> std::unique_ptr<dx::IImageLoader>;
+    static auto ImportImage(const uint8_t *pData,
+        size_t dataSize,
+        const stdfs::path &cachePath,
+        const TextureImportSettings &settings,
+        float cutOff) -> std::unique_ptr<dx::IImageLoader>;
 private:
     using TextureMap = std::unordered_map<stdfs::path, SharedPtr<dx::Texture>>;
+    // keyed by the cache path of the image
+    using ImportedTextureMap = std::unordered_map<stdfs::path, SharedPtr<dx::Texture>>;
     using SRV2DMap = std::unordered_map<const dx::Texture *, dx::SRV>;
     using SRVCubeMap = std::unordered_map<const dx::Texture *, dx::SRV>;
 private:
     // clang-format off
-    TextureMap _textureMap;
-    SRV2DMap   _srv2DMap;
-    SRVCubeMap _srvCubeMap;
+    TextureMap          _textureMap;
+    ImportedTextureMap  _importedTextureMap;
+    SRV2DMap            _srv2DMap;
+    SRVCubeMap          _srvCubeMap;
     // clang-format on
 };
\ No newline at end of file
@@ -1,33 +1,54 @@
 #include "WICLoader.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
+#include <algorithm>
+#include "Foundation/Exception.h"
+#include "Foundation/Logger.h"
+
+static auto GetDxgiFormat(BlockCompressor::Format format) -> DXGI_FORMAT {
+    switch (format) {
+    case BlockCompressor::Format::eBC1:
+        return DXGI_FORMAT_BC1_UNORM;
+    case BlockCompressor::Format::eBC3:
+        return DXGI_FORMAT_BC3_UNORM;
+    case BlockCompressor::Format::eBC4:
+        return DXGI_FORMAT_BC4_UNORM;
+    case BlockCompressor::Format::eBC5:
+        return DXGI_FORMAT_BC5_UNORM;
+    case BlockCompressor::Format::eBC7:
+        return DXGI_FORMAT_BC7_UNORM;
+    }
+    return DXGI_FORMAT_UNKNOWN;
+}
 
 WICLoader::~WICLoader() {
-    if (_pData != nullptr) {
-        free(_pData);
-        _pData = nullptr;
-    }
+}
+
+void WICLoader::SetImportSettings(const TextureImportSettings &settings) {
+    _settings = settings;
 }
 
 bool WICLoader::Load(const stdfs::path &filePath, float cutOff) {
     int32_t width, height, channels;
-    _pData = reinterpret_cast<char *>(stbi_load(filePath.string().c_str(), &width, &height, &channels, STBI_rgb_alpha));
-    if (_pData == nullptr) {
+    uint8_t *pData = stbi_load(filePath.string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    if (pData == nullptr) {
 	    return false;
     }
 
-    LoadInternal(width, height, cutOff);
+    LoadInternal(pData, width, height, cutOff);
+    stbi_image_free(pData);
     return true;
 }
 
 bool WICLoader::Load(const uint8_t *pData, size_t dataSize, float cutOff) {
     int32_t width, height, channels;
-    _pData = reinterpret_cast<char *>(stbi_load_from_memory(pData, dataSize, &width, &height, &channels, STBI_rgb_alpha));
-    if (_pData == nullptr) {
+    uint8_t *pImage = stbi_load_from_memory(pData, dataSize, &width, &height, &channels, STBI_rgb_alpha);
+    if (pImage == nullptr) {
 	    return false;
     }
 
-    LoadInternal(width, height, cutOff);
+    LoadInternal(pImage, width, height, cutOff);
+    stbi_image_free(pImage);
     return true;
 }
 
@@ -36,26 +57,53 @@ auto WICLoader::GetImageHeader() const -> dx::ImageHeader {
 }
 
 void WICLoader::GetNextMipMapData(void *pDest, uint32_t stride, uint32_t width, uint32_t height) {
+    Assert(_mipIndex < _imageHeader.mipMapCount);
+    const uint8_t *pMipData = nullptr;
+    size_t rowPitch = 0;
+    if (!_compressedMips.empty()) {
+        // the rows are block rows
+        pMipData = _compressedData.data() + _compressedMips[_mipIndex].offset;
+        rowPitch = _compressedMips[_mipIndex].rowPitch;
+    } else {
+        pMipData = _mipChain.GetMipData(_mipIndex);
+        rowPitch = _mipChain.GetMipRowPitch(_mipIndex);
+    }
     for (uint32_t y = 0; y < height; y++) {
-        memcpy(static_cast<char *>(pDest) + y * stride, _pData + y * width, width);
+        memcpy(static_cast<char *>(pDest) + y * stride, pMipData + y * rowPitch, width);
     }
-    MipImage(width / 4, height);
+    ++_mipIndex;
 }
 
-void WICLoader::LoadInternal(int width, int height, float cutOff) {
-    uint32_t mipWidth = width;
-    uint32_t mipHeight = height;
-    uint32_t mipCount = 0;
-    while (true) {
-        mipCount++;
-        if (mipWidth > 1) {
-            mipWidth >>= 1;
-        }
-        if (mipHeight > 1) {
-            mipHeight >>= 1;
-        }
-        if (mipWidth == 1 && mipHeight == 1) {
-            break;
+auto WICLoader::GetMipChainData() const -> std::span<const uint8_t> {
+    if (!_compressedMips.empty()) {
+        return _compressedData;
+    }
+    return _mipChain.GetData();
+}
+
+void WICLoader::LoadInternal(const uint8_t *pData, int width, int height, float cutOff) {
+    _cutOff = cutOff;
+    if (_cutOff < 1.0f) {
+        size_t pixelCount = static_cast<size_t>(width) * height;
+        AlphaCoverage::Histogram histogram;
+        AlphaCoverage::BuildHistogram(pData, pixelCount, histogram);
+        _alphaTestCoverage = AlphaCoverage::GetCoverage(histogram, pixelCount, 1.0f, static_cast<int>(255 * _cutOff));
+    } else {
+        _alphaTestCoverage = 1.0f;
+    }
+
+    MipChainGenerator::Settings settings;
+    settings.format = MipChainGenerator::Format::eRGBA8;
+    settings.filter = MipChainGenerator::Filter::eBox;
+    settings.sRGB = _settings.sRGB;
+    _mipChain.Generate(pData, width, height, settings);
+    _mipIndex = 0;
+
+    // For cutouts we need to scale the alpha channel to match the coverage of the top MIP map
+    // otherwise cutouts seem to get thinner when smaller mips are used
+    if (_alphaTestCoverage < 1.0) {
+        for (uint32_t mip = 1; mip < _mipChain.GetMipCount(); ++mip) {
+            PreserveAlphaCoverage(mip);
         }
     }
 
@@ -64,96 +112,85 @@ void WICLoader::LoadInternal(int width, int height, float cutOff) {
     _imageHeader.width = width;
     _imageHeader.height = height;
     _imageHeader.depth = 1;
-    _imageHeader.mipMapCount = mipCount;
+    _imageHeader.mipMapCount = _mipChain.GetMipCount();
     _imageHeader.bitCount = 32;
     _imageHeader.format = DXGI_FORMAT_R8G8B8A8_UNORM;
 
-    _cutOff = cutOff;
-    if (_cutOff < 1.0f) {
-        _alphaTestCoverage = GetAlphaCoverage(width, height, 1.0f, static_cast<int>(255 * _cutOff));
-    } else {
-        _alphaTestCoverage = 1.0f;
+    // D3D12 only requires the size of the top mip to be a multiple of the block size
+    _compressedData.clear();
+    _compressedMips.clear();
+    if (_settings.compress && width % BlockCompressor::kBlockDim == 0 && height % BlockCompressor::kBlockDim == 0) {
+        CompressMips();
     }
 }
 
-void WICLoader::MipImage(uint32_t width, uint32_t height) {
-    //compute mip so next call gets the lower mip
-    int offsetsX[] = {0, 1, 0, 1};
-    int offsetsY[] = {0, 0, 1, 1};
-
-    uint32_t *pImg = reinterpret_cast<uint32_t *>(_pData);
-
-#define GetByte(color, component) (((color) >> (8 * (component))) & 0xff)
-#define GetColor(ptr, x, y) (ptr[(x) + (y)*width])
-#define SetColor(ptr, x, y, col) ptr[(x) + (y)*width / 2] = col;
-
-    for (uint32_t y = 0; y < height; y += 2) {
-        for (uint32_t x = 0; x < width; x += 2) {
-            uint32_t ccc = 0;
-            for (uint32_t c = 0; c < 4; c++) {
-                uint32_t cc = 0;
-                for (uint32_t i = 0; i < 4; i++) {
-                    cc += GetByte(GetColor(pImg, x + offsetsX[i], y + offsetsY[i]), 3 - c);
-                }
-                ccc = (ccc << 8) | (cc / 4);
-            }
-            SetColor(pImg, x / 2, y / 2, ccc);
-        }
+auto WICLoader::GetCompressFormat() const -> BlockCompressor::Format {
+    switch (_settings.usage) {
+    case TextureUsage::eNormalMap:
+        return BlockCompressor::Format::eBC5;
+    case TextureUsage::eGrayscale:
+        return BlockCompressor::Format::eBC4;
+    case TextureUsage::eColor:
+        break;
+    }
+    if (_settings.quality != BlockCompressor::Quality::eFast) {
+        return BlockCompressor::Format::eBC7;
     }
 
-    // For cutouts we need to scale the alpha channel to match the coverage of the top MIP map
-    // otherwise cutouts seem to get thinner when smaller mips are used
-    // Credits: http://www.ludicon.com/castano/blog/articles/computing-alpha-mipmaps/
-    if (_alphaTestCoverage < 1.0) {
-        float ini = 0;
-        float fin = 10;
-        float mid = 0.f;
-        for (int iter = 0; iter < 50; iter++) {
-            mid = (ini + fin) / 2;
-            float alphaPercentage = GetAlphaCoverage(width / 2, height / 2, mid, static_cast<int>(_cutOff * 255));
-            if (fabs(alphaPercentage - _alphaTestCoverage) < .001) {
-                break;
-            }
-            if (alphaPercentage > _alphaTestCoverage) {
-                fin = mid;
-            }
-            if (alphaPercentage < _alphaTestCoverage) {
-                ini = mid;
-            }
+    // BC1 has no alpha, the lower mips can only be as opaque as the top mip
+    const MipChainGenerator::MipLevel &level = _mipChain.GetMipLevel(0);
+    const uint8_t *pPixels = _mipChain.GetMipData(0);
+    size_t pixelCount = static_cast<size_t>(level.width) * level.height;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        if (pPixels[i * 4 + 3] != 255) {
+            return BlockCompressor::Format::eBC3;
         }
-        ScaleAlpha(width / 2, height / 2, mid);
     }
+    return BlockCompressor::Format::eBC1;
 }
 
-void WICLoader::ScaleAlpha(uint32_t width, uint32_t height, float scale) {
-    uint32_t *pImg = reinterpret_cast<uint32_t *>(_pData);
-    for (uint32_t y = 0; y < height; y++) {
-        for (uint32_t x = 0; x < width; x++) {
-            uint8_t *pPixel = reinterpret_cast<uint8_t *>(pImg++);
-            int alpha = static_cast<int>(scale * static_cast<float>(pPixel[3]));
-            if (alpha > 255) {
-                alpha = 255;
-            }
-            pPixel[3] = alpha;
-        }
+void WICLoader::CompressMips() {
+    BlockCompressor::Format format = GetCompressFormat();
+    size_t compressedSize = 0;
+    _compressedMips.resize(_mipChain.GetMipCount());
+    for (uint32_t mip = 0; mip < _mipChain.GetMipCount(); ++mip) {
+        const MipChainGenerator::MipLevel &level = _mipChain.GetMipLevel(mip);
+        _compressedMips[mip].offset = compressedSize;
+        _compressedMips[mip].rowPitch = BlockCompressor::GetRowPitch(format, level.width);
+        compressedSize += BlockCompressor::GetCompressedSize(format, level.width, level.height);
     }
-}
 
-auto WICLoader::GetAlphaCoverage(uint32_t width, uint32_t height, float scale, int cutoff) const -> float {
-    double val = 0;
-    uint32_t *pImg = reinterpret_cast<uint32_t *>(_pData);
-    for (uint32_t y = 0; y < height; y++) {
-        for (uint32_t x = 0; x < width; x++) {
-            uint8_t *pPixel = reinterpret_cast<uint8_t *>(pImg++);
-            int alpha = static_cast<int>(scale * static_cast<float>(pPixel[3]));
-            if (alpha > 255) {
-                alpha = 255;
-            }
-            if (alpha <= cutoff) {
-                continue;
-            }
-            val += alpha;
-        }
+    _compressedData.resize(compressedSize);
+    BlockCompressor::Statistics statistics;
+    for (uint32_t mip = 0; mip < _mipChain.GetMipCount(); ++mip) {
+        const MipChainGenerator::MipLevel &level = _mipChain.GetMipLevel(mip);
+        statistics.Merge(BlockCompressor::Compress(_mipChain.GetMipData(mip),
+            level.width,
+            level.height,
+            format,
+            _settings.quality,
+            _compressedData.data() + _compressedMips[mip].offset));
     }
-    return static_cast<float>(val / (height * width * 255));
+    _mipChain.Clear();
+
+    Logger::Debug("WICLoader: {} {}x{} {:.2f} dB, {:.1f} MPixel/s",
+        BlockCompressor::GetFormatName(format),
+        _imageHeader.width,
+        _imageHeader.height,
+        statistics.GetPSNR(),
+        statistics.GetMegapixelsPerSecond());
+
+    // 16 pixels per block
+    _imageHeader.bitCount = static_cast<uint32_t>(BlockCompressor::GetBlockSize(format) * 8 / 16);
+    _imageHeader.format = GetDxgiFormat(format);
 }
+
+void WICLoader::PreserveAlphaCoverage(uint32_t mip) {
+    const MipChainGenerator::MipLevel &level = _mipChain.GetMipLevel(mip);
+    uint8_t *pPixels = _mipChain.GetMipData(mip);
+    size_t pixelCount = static_cast<size_t>(level.width) * level.height;
+    AlphaCoverage::Histogram histogram;
+    AlphaCoverage::BuildHistogram(pPixels, pixelCount, histogram);
+    float scale = AlphaCoverage::FindScale(histogram, pixelCount, _alphaTestCoverage, static_cast<int>(_cutOff * 255));
+    AlphaCoverage::ScaleAlpha(pPixels, pixelCount, scale);
+}
\ No newline at end of file
@@ -1,25 +1,45 @@
 #pragma once
+#include <span>
+#include <vector>
+#include "AlphaCoverage.h"
 #include "D3d12/IImageLoader.h"
+#include "MipChainGenerator.h"
+#include "TextureImportSettings.h"
 
 class WICLoader : public dx::IFileImageLoader, public dx::IMemoryImageLoader {
 public:
     WICLoader() = default;
     ~WICLoader() override;
 public:
+    // call before Load
+    void SetImportSettings(const TextureImportSettings &settings);
     bool Load(const stdfs::path &filePath, float cutOff) override;
     bool Load(const uint8_t *pData, size_t dataSize, float cutOff) override;
     auto GetImageHeader() const -> dx::ImageHeader override;
+    // width is the size of a row in bytes
     void GetNextMipMapData(void *pDest, uint32_t stride, uint32_t width, uint32_t height) override;
+    // every mip after the other with tightly packed rows, the rows are block rows when the image is compressed
+    auto GetMipChainData() const -> std::span<const uint8_t>;
 private:
-    void LoadInternal(int width, int height, float cutOff);
-    void MipImage(uint32_t width, uint32_t height);
-    void ScaleAlpha(uint32_t width, uint32_t height, float scale);
-    auto GetAlphaCoverage(uint32_t width, uint32_t height, float scale, int cutoff) const -> float;
+    void LoadInternal(const uint8_t *pData, int width, int height, float cutOff);
+    void PreserveAlphaCoverage(uint32_t mip);
+    auto GetCompressFormat() const -> BlockCompressor::Format;
+    // encodes every mip and drops the mip chain
+    void CompressMips();
 private:
+    struct CompressedMip {
+        size_t offset;
+        size_t rowPitch;
+    };
     // clang-format off
-	char               *_pData              = nullptr;
-    float               _cutOff             = 0.f;
-    float               _alphaTestCoverage  = 0.f;
-    dx::ImageHeader     _imageHeader        = {};
+    TextureImportSettings       _settings;
+    float                       _cutOff             = 0.f;
+    float                       _alphaTestCoverage  = 0.f;
+    uint32_t                    _mipIndex           = 0;
+    dx::ImageHeader             _imageHeader        = {};
+    MipChainGenerator           _mipChain;
+    // the block rows of every mip, empty when the image is not compressed
+    std::vector<uint8_t>        _compressedData;
+    std::vector<CompressedMip>  _compressedMips;
     // clang-format on
 };
\ No newline at end of file
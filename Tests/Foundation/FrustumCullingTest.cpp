@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <random>
+#include "Foundation/FrustumCulling.h"
+
+// The batched test (AVX or SSE, depending on the build) against a double precision reference of the same
+// plane test. Boxes that touch a plane within the float rounding error may go either way and are skipped.
+
+namespace {
+
+constexpr double kBoundaryTolerance = 1e-3;
+
+auto MakeFrustum() -> Frustum {
+    glm::mat4x4 matView = glm::lookAt(glm::vec3(3.f, 5.f, -20.f), glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f));
+    glm::mat4x4 matProj = glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 100.f);
+    return Frustum::FromMatrix(matProj * matView);
+}
+
+// smallest signed plane distance of the box, negative when the box is outside of one plane
+auto ReferenceDistance(const Frustum &frustum, const AABB &bounds) -> double {
+    glm::vec3 center = bounds.GetCenter();
+    glm::vec3 extents = bounds.GetExtents();
+    double minDistance = std::numeric_limits<double>::max();
+    for (const glm::vec4 &plane : frustum.planes) {
+        double length = std::sqrt(double(plane.x) * plane.x + double(plane.y) * plane.y + double(plane.z) * plane.z);
+        double distance = double(plane.x) * center.x + double(plane.y) * center.y + double(plane.z) * center.z +
+                          plane.w + std::abs(double(plane.x)) * extents.x + std::abs(double(plane.y)) * extents.y +
+                          std::abs(double(plane.z)) * extents.z;
+        minDistance = std::min(minDistance, distance / length);
+    }
+    return minDistance;
+}
+
+auto MakeRandomBoxes(size_t count, uint32_t seed) -> std::vector<AABB> {
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> position(-120.f, 120.f);
+    std::uniform_real_distribution<float> size(0.f, 8.f);
+    std::vector<AABB> boxes(count);
+    for (AABB &bounds : boxes) {
+        glm::vec3 center(position(random), position(random), position(random));
+        glm::vec3 extents(size(random), size(random), size(random));
+        bounds = AABB{center - extents, center + extents};
+    }
+    return boxes;
+}
+
+auto MakeSoA(const std::vector<AABB> &boxes) -> AABBSoA {
+    AABBSoA soa;
+    soa.Resize(boxes.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        soa.Set(i, boxes[i]);
+    }
+    return soa;
+}
+
+}    // namespace
+
+TEST(FrustumCullingTest, MatchesScalarReference) {
+    Frustum frustum = MakeFrustum();
+    std::vector<AABB> boxes = MakeRandomBoxes(100 * 1000 + 5, 1);
+    AABBSoA soa = MakeSoA(boxes);
+    std::vector<uint8_t> visible(boxes.size(), 0xff);
+    size_t visibleCount = FrustumCulling::Cull(frustum, soa, visible.data());
+
+    size_t expectedVisibleCount = 0;
+    size_t comparedCount = 0;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        ASSERT_LE(visible[i], 1u) << "box " << i;
+        expectedVisibleCount += visible[i];
+        double distance = ReferenceDistance(frustum, boxes[i]);
+        if (std::abs(distance) < kBoundaryTolerance) {
+            continue;
+        }
+        EXPECT_EQ(visible[i] != 0, distance >= 0.0) << "box " << i;
+        ++comparedCount;
+    }
+    EXPECT_EQ(visibleCount, expectedVisibleCount);
+    // the random boxes have to exercise both outcomes
+    EXPECT_GT(visibleCount, 1000u);
+    EXPECT_LT(visibleCount, boxes.size() - 1000u);
+    EXPECT_GT(comparedCount, boxes.size() * 99 / 100);
+}
+
+TEST(FrustumCullingTest, EveryTailLength) {
+    Frustum frustum = MakeFrustum();
+    std::vector<AABB> allBoxes = MakeRandomBoxes(40, 2);
+    for (size_t count = 0; count <= allBoxes.size(); ++count) {
+        std::vector<AABB> boxes(allBoxes.begin(), allBoxes.begin() + count);
+        AABBSoA soa = MakeSoA(boxes);
+        std::vector<uint8_t> visible(count + 1, 0xff);
+        size_t visibleCount = FrustumCulling::Cull(frustum, soa, visible.data());
+        size_t expectedVisibleCount = 0;
+        for (size_t i = 0; i < count; ++i) {
+            EXPECT_EQ(visible[i] != 0, frustum.Intersects(boxes[i])) << "count " << count << " box " << i;
+            expectedVisibleCount += static_cast<size_t>(frustum.Intersects(boxes[i]));
+        }
+        EXPECT_EQ(visibleCount, expectedVisibleCount) << "count " << count;
+        EXPECT_EQ(visible[count], 0xff) << "count " << count;
+    }
+}
+
+TEST(FrustumCullingTest, UnboundedBoxesAreVisible) {
+    Frustum frustum = MakeFrustum();
+    AABBSoA soa;
+    soa.Resize(11);
+    for (size_t i = 0; i < 11; ++i) {
+        soa.Set(i, AABB{});
+    }
+    std::vector<uint8_t> visible(11, 0);
+    EXPECT_EQ(FrustumCulling::Cull(frustum, soa, visible.data()), 11u);
+    for (uint8_t value : visible) {
+        EXPECT_EQ(value, 1u);
+    }
+}
+
+TEST(FrustumCullingTest, TransformedFrustumMatchesWorldSpace) {
+    Frustum frustum = MakeFrustum();
+    glm::quat rotation = glm::angleAxis(glm::radians(35.f), glm::normalize(glm::vec3(1.f, 2.f, 0.5f)));
+    glm::mat4x4 matTranslate = glm::translate(glm::identity<glm::mat4x4>(), glm::vec3(4.f, -2.f, 10.f));
+    glm::mat4x4 matScale = glm::scale(glm::identity<glm::mat4x4>(), glm::vec3(2.f, 0.5f, 1.5f));
+    glm::mat4x4 matWorld = matTranslate * glm::mat4_cast(rotation) * matScale;
+    Frustum objectFrustum = frustum.Transform(matWorld);
+
+    // a point is a box without extents, it is inside in object space exactly when it is inside in world space
+    std::mt19937 random(4);
+    std::uniform_real_distribution<float> position(-60.f, 60.f);
+    size_t insideCount = 0;
+    for (size_t i = 0; i < 10 * 1000; ++i) {
+        glm::vec3 point(position(random), position(random), position(random));
+        AABB worldPoint = AABB{point, point}.Transform(matWorld);
+        if (std::abs(ReferenceDistance(frustum, worldPoint)) < kBoundaryTolerance) {
+            continue;
+        }
+        bool inside = frustum.Intersects(worldPoint);
+        EXPECT_EQ(objectFrustum.Intersects(AABB{point, point}), inside) << "point " << i;
+        insideCount += static_cast<size_t>(inside);
+    }
+    EXPECT_GT(insideCount, 100u);
+
+    // a box tested in object space is an oriented box in world space, inside the box around its corners
+    std::vector<AABB> boxes = MakeRandomBoxes(10 * 1000, 5);
+    std::vector<uint8_t> visible(boxes.size());
+    FrustumCulling::Cull(objectFrustum, MakeSoA(boxes), visible.data());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+        if (visible[i] != 0) {
+            EXPECT_TRUE(frustum.Intersects(boxes[i].Transform(matWorld))) << "box " << i;
+        }
+    }
+}
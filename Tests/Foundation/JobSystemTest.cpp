@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include "Foundation/JobSystem.h"
+
+namespace {
+
+class JobSystemTest : public testing::Test {
+protected:
+    void SetUp() override {
+        _pJobSystem = JobSystem::OnInstanceCreate();
+    }
+    void TearDown() override {
+        _release.store(true);
+        _pJobSystem->OnDestroy();
+        JobSystem::OnInstanceDestroy();
+    }
+    // occupies one worker with a background job until _release is set
+    void BlockWorker(JobCounter &counter) {
+        std::atomic<bool> started = false;
+        _pJobSystem->ScheduleBackground(
+            [&]() {
+                started.store(true);
+                while (!_release.load()) {
+                    std::this_thread::yield();
+                }
+            },
+            &counter);
+        while (!started.load()) {
+            std::this_thread::yield();
+        }
+    }
+protected:
+    JobSystem *_pJobSystem = nullptr;
+    std::atomic<bool> _release = false;
+};
+
+}    // namespace
+
+TEST_F(JobSystemTest, ParallelForDoesNotRunBackgroundJobs) {
+    _pJobSystem->OnCreate(1);
+    JobCounter counter;
+    BlockWorker(counter);
+
+    // queued before the chunks, a FIFO queue would hand it to the waiting main thread first
+    std::atomic<bool> backgroundDone = false;
+    std::thread::id backgroundThreadId;
+    _pJobSystem->ScheduleBackground(
+        [&]() {
+            backgroundThreadId = std::this_thread::get_id();
+            backgroundDone.store(true);
+        },
+        &counter);
+
+    // the only worker is busy, the main thread runs every chunk itself and must skip the background job
+    std::atomic<size_t> chunkCount = 0;
+    _pJobSystem->ParallelFor(0, 64, 1, [&](size_t, size_t) { chunkCount.fetch_add(1); });
+    EXPECT_EQ(chunkCount.load(), 64u);
+    EXPECT_FALSE(backgroundDone.load());
+
+    _release.store(true);
+    _pJobSystem->Wait(counter);
+    EXPECT_TRUE(backgroundDone.load());
+    EXPECT_NE(backgroundThreadId, std::this_thread::get_id());
+}
+
+TEST_F(JobSystemTest, ForegroundJobsRunBeforeBackgroundJobs) {
+    _pJobSystem->OnCreate(1);
+    JobCounter counter;
+    BlockWorker(counter);
+
+    std::atomic<int> step = 0;
+    int backgroundStep = -1;
+    int foregroundStep = -1;
+    _pJobSystem->ScheduleBackground([&]() { backgroundStep = step.fetch_add(1); }, &counter);
+    _pJobSystem->Schedule([&]() { foregroundStep = step.fetch_add(1); }, &counter);
+
+    _release.store(true);
+    _pJobSystem->Wait(counter);
+    EXPECT_EQ(foregroundStep, 0);
+    EXPECT_EQ(backgroundStep, 1);
+}
+
+TEST_F(JobSystemTest, BackgroundJobsRunInlineWithoutWorkers) {
+    _pJobSystem->OnCreate(0);
+    std::thread::id threadId;
+    _pJobSystem->ScheduleBackground([&]() { threadId = std::this_thread::get_id(); });
+    EXPECT_EQ(threadId, std::this_thread::get_id());
+}
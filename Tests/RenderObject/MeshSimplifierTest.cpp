@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <tuple>
+#include "RenderObject/MeshSimplifier.h"
+
+// The simplifier on a seam heavy unit sphere: a cube sphere whose six faces are split into 2x2 uv charts with
+// vertices of their own, so a quarter of all vertices sit on an attribute seam.
+
+namespace {
+
+constexpr size_t kGridSize = 16;
+constexpr size_t kChartCount = 2;
+
+struct TestMesh {
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+};
+
+auto MakeSeamSphere() -> TestMesh {
+    TestMesh mesh;
+    const glm::vec3 normals[6] = {
+        glm::vec3(1.f, 0.f, 0.f),
+        glm::vec3(-1.f, 0.f, 0.f),
+        glm::vec3(0.f, 1.f, 0.f),
+        glm::vec3(0.f, -1.f, 0.f),
+        glm::vec3(0.f, 0.f, 1.f),
+        glm::vec3(0.f, 0.f, -1.f),
+    };
+    size_t chartSize = kGridSize / kChartCount;
+    for (const glm::vec3 &normal : normals) {
+        glm::vec3 tangent = std::abs(normal.y) > 0.5f ? glm::vec3(1.f, 0.f, 0.f) : glm::vec3(0.f, 1.f, 0.f);
+        glm::vec3 bitangent = cross(normal, tangent);
+        for (size_t chartY = 0; chartY < kChartCount; ++chartY) {
+            for (size_t chartX = 0; chartX < kChartCount; ++chartX) {
+                auto baseVertex = static_cast<uint32_t>(mesh.positions.size());
+                for (size_t y = 0; y <= chartSize; ++y) {
+                    for (size_t x = 0; x <= chartSize; ++x) {
+                        float u = float(chartX * chartSize + x) / float(kGridSize) * 2.f - 1.f;
+                        float v = float(chartY * chartSize + y) / float(kGridSize) * 2.f - 1.f;
+                        mesh.positions.push_back(normalize(normal + tangent * u + bitangent * v));
+                    }
+                }
+                for (size_t y = 0; y < chartSize; ++y) {
+                    for (size_t x = 0; x < chartSize; ++x) {
+                        auto i0 = static_cast<uint32_t>(baseVertex + y * (chartSize + 1) + x);
+                        auto i1 = i0 + 1;
+                        auto i2 = static_cast<uint32_t>(i0 + chartSize + 1);
+                        auto i3 = i2 + 1;
+                        mesh.indices.insert(mesh.indices.end(), {i0, i2, i1, i1, i2, i3});
+                    }
+                }
+            }
+        }
+    }
+    // every triangle faces outwards
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+        const glm::vec3 &p0 = mesh.positions[mesh.indices[i + 0]];
+        const glm::vec3 &p1 = mesh.positions[mesh.indices[i + 1]];
+        const glm::vec3 &p2 = mesh.positions[mesh.indices[i + 2]];
+        if (dot(cross(p1 - p0, p2 - p0), p0 + p1 + p2) < 0.f) {
+            std::swap(mesh.indices[i + 1], mesh.indices[i + 2]);
+        }
+    }
+    return mesh;
+}
+
+// the vertices that share their position with another vertex
+auto FindSeamVertices(const TestMesh &mesh) -> std::vector<uint32_t> {
+    auto less = [](const glm::vec3 &lhs, const glm::vec3 &rhs) {
+        return std::tie(lhs.x, lhs.y, lhs.z) < std::tie(rhs.x, rhs.y, rhs.z);
+    };
+    std::map<glm::vec3, size_t, decltype(less)> positionCounts(less);
+    for (const glm::vec3 &position : mesh.positions) {
+        ++positionCounts[position];
+    }
+    std::vector<uint32_t> seamVertices;
+    for (size_t i = 0; i < mesh.positions.size(); ++i) {
+        if (positionCounts[mesh.positions[i]] > 1) {
+            seamVertices.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return seamVertices;
+}
+
+auto PointTriangleDistance(const glm::vec3 &p, const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c) -> float {
+    // See "Real-Time Collision Detection" (Ericson 2004) 5.1.5
+    glm::vec3 ab = b - a;
+    glm::vec3 ac = c - a;
+    glm::vec3 ap = p - a;
+    float d1 = dot(ab, ap);
+    float d2 = dot(ac, ap);
+    if (d1 <= 0.f && d2 <= 0.f) {
+        return length(p - a);
+    }
+    glm::vec3 bp = p - b;
+    float d3 = dot(ab, bp);
+    float d4 = dot(ac, bp);
+    if (d3 >= 0.f && d4 <= d3) {
+        return length(p - b);
+    }
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f) {
+        return length(p - (a + ab * (d1 / (d1 - d3))));
+    }
+    glm::vec3 cp = p - c;
+    float d5 = dot(ab, cp);
+    float d6 = dot(ac, cp);
+    if (d6 >= 0.f && d5 <= d6) {
+        return length(p - c);
+    }
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f) {
+        return length(p - (a + ac * (d2 / (d2 - d6))));
+    }
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f) {
+        return length(p - (b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)))));
+    }
+    float denom = 1.f / (va + vb + vc);
+    return length(p - (a + ab * (vb * denom) + ac * (vc * denom)));
+}
+
+// largest distance of a source vertex to the simplified surface
+auto MaxDeviation(const TestMesh &mesh, const std::vector<uint32_t> &indices) -> float {
+    float maxDistance = 0.f;
+    for (const glm::vec3 &position : mesh.positions) {
+        float distance = std::numeric_limits<float>::max();
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            distance = std::min(distance,
+                PointTriangleDistance(position,
+                    mesh.positions[indices[i + 0]],
+                    mesh.positions[indices[i + 1]],
+                    mesh.positions[indices[i + 2]]));
+        }
+        maxDistance = std::max(maxDistance, distance);
+    }
+    return maxDistance;
+}
+
+void ExpectValidTriangles(const TestMesh &mesh, const std::vector<uint32_t> &indices) {
+    ASSERT_EQ(indices.size() % 3, 0u);
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        uint32_t i0 = indices[i + 0];
+        uint32_t i1 = indices[i + 1];
+        uint32_t i2 = indices[i + 2];
+        ASSERT_LT(std::max({i0, i1, i2}), mesh.positions.size());
+        EXPECT_TRUE(i0 != i1 && i1 != i2 && i0 != i2) << "degenerate triangle " << i / 3;
+        // a collapse must not fold a triangle over, on the sphere every triangle keeps facing outwards.
+        // A sliver between three vertices of one cube edge lies in a plane through the center and faces sideways.
+        const glm::vec3 &p0 = mesh.positions[i0];
+        const glm::vec3 &p1 = mesh.positions[i1];
+        const glm::vec3 &p2 = mesh.positions[i2];
+        EXPECT_GT(dot(cross(p1 - p0, p2 - p0), p0 + p1 + p2), -1e-6f) << "flipped triangle " << i / 3;
+    }
+}
+
+}    // namespace
+
+TEST(MeshSimplifierTest, ReducesTrianglesWithinTheErrorBound) {
+    TestMesh mesh = MakeSeamSphere();
+    size_t sourceTriangleCount = mesh.indices.size() / 3;
+    float maxError = 0.05f;
+    MeshSimplifier::LodLevel level = MeshSimplifier::Simplify(mesh.positions,
+        mesh.indices,
+        mesh.indices.size() / 4,
+        maxError);
+
+    ExpectValidTriangles(mesh, level.indices);
+    size_t triangleCount = level.indices.size() / 3;
+    // the seams are locked, the interior of the charts carries the reduction
+    EXPECT_LE(triangleCount, sourceTriangleCount / 2);
+    EXPECT_GE(triangleCount, sourceTriangleCount / 4);
+    EXPECT_GT(level.error, 0.f);
+    EXPECT_LE(level.error, maxError);
+    // the reported error is a quadric distance, it bounds the measured deviation of the source vertices
+    EXPECT_LE(MaxDeviation(mesh, level.indices), maxError);
+}
+
+TEST(MeshSimplifierTest, KeepsSeamVertices) {
+    TestMesh mesh = MakeSeamSphere();
+    std::vector<uint32_t> seamVertices = FindSeamVertices(mesh);
+    ASSERT_GT(seamVertices.size(), mesh.positions.size() / 5);
+
+    MeshSimplifier::LodLevel level = MeshSimplifier::Simplify(mesh.positions, mesh.indices, 0, 1.f);
+    std::vector<bool> referenced(mesh.positions.size(), false);
+    for (uint32_t index : level.indices) {
+        referenced[index] = true;
+    }
+    for (uint32_t vertex : seamVertices) {
+        EXPECT_TRUE(referenced[vertex]) << "seam vertex " << vertex << " was collapsed";
+    }
+    ExpectValidTriangles(mesh, level.indices);
+}
+
+TEST(MeshSimplifierTest, StopsAtTheMaxError) {
+    TestMesh mesh = MakeSeamSphere();
+    // every collapse on the curved surface costs more than this
+    MeshSimplifier::LodLevel level = MeshSimplifier::Simplify(mesh.positions, mesh.indices, 0, 1e-5f);
+    EXPECT_EQ(level.indices.size(), mesh.indices.size());
+    EXPECT_LE(level.error, 1e-5f);
+
+    MeshSimplifier::LodLevel coarse = MeshSimplifier::Simplify(mesh.positions, mesh.indices, 0, 0.02f);
+    MeshSimplifier::LodLevel coarser = MeshSimplifier::Simplify(mesh.positions, mesh.indices, 0, 0.2f);
+    EXPECT_LE(coarse.error, 0.02f);
+    EXPECT_LE(coarser.error, 0.2f);
+    EXPECT_LT(coarser.indices.size(), coarse.indices.size());
+    EXPECT_LT(coarse.indices.size(), mesh.indices.size());
+}
+
+TEST(MeshSimplifierTest, LodChainIsMonotonic) {
+    TestMesh mesh = MakeSeamSphere();
+    float maxError = 0.1f;
+    std::vector<MeshSimplifier::LodLevel> levels = MeshSimplifier::GenerateLodChain(mesh.positions,
+        mesh.indices,
+        3,
+        0.5f,
+        maxError);
+    ASSERT_FALSE(levels.empty());
+    EXPECT_LE(levels.size(), 3u);
+    size_t previousIndexCount = mesh.indices.size();
+    float previousError = 0.f;
+    for (const MeshSimplifier::LodLevel &level : levels) {
+        ExpectValidTriangles(mesh, level.indices);
+        // every level removes at least 10% of the triangles of the previous one
+        EXPECT_LE(level.indices.size(), previousIndexCount * 9 / 10);
+        EXPECT_GE(level.error, previousError);
+        EXPECT_LE(level.error, maxError);
+        previousIndexCount = level.indices.size();
+        previousError = level.error;
+    }
+}
+
+TEST(MeshSimplifierTest, IsDeterministic) {
+    TestMesh mesh = MakeSeamSphere();
+    size_t targetIndexCount = mesh.indices.size() / 3;
+    MeshSimplifier::LodLevel first = MeshSimplifier::Simplify(mesh.positions, mesh.indices, targetIndexCount, 0.1f);
+    MeshSimplifier::LodLevel second = MeshSimplifier::Simplify(mesh.positions, mesh.indices, targetIndexCount, 0.1f);
+    EXPECT_EQ(first.indices, second.indices);
+    EXPECT_EQ(first.error, second.error);
+}
@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <unordered_map>
+#include "Foundation/Memory/HeapAllocationCounter.h"
+#include "Renderer/RenderUtils/GPUSceneTable.h"
+
+// Random allocations, frees, writes and defragmentations against a model of the owners, like the GPUScene drives the
+// table. Every owner keeps a value in its slot, the model checks that the values survive the moves and that every
+// write reaches the GPU copy through the dirty ranges.
+
+namespace {
+
+struct Element {
+    uint32_t owner;
+    uint32_t version;
+};
+
+class TableModel {
+public:
+    TableModel() : _table(sizeof(Element)) {
+    }
+    void Add(uint32_t owner) {
+        uint32_t slot = _table.Allocate();
+        ASSERT_FALSE(_slots.contains(owner));
+        _slots[owner] = slot;
+        Write(owner);
+    }
+    void Remove(uint32_t owner) {
+        _table.Free(_slots.at(owner));
+        _slots.erase(owner);
+    }
+    void Write(uint32_t owner) {
+        Element element = {owner, ++_versions[owner]};
+        _table.Write(_slots.at(owner), &element);
+    }
+    void Defragment() {
+        _moves.clear();
+        _table.Defragment(_moves);
+        std::unordered_map<uint32_t, uint32_t> owners;
+        for (const auto &[owner, slot] : _slots) {
+            owners[slot] = owner;
+        }
+        for (const GPUSceneTable::Move &move : _moves) {
+            ASSERT_TRUE(owners.contains(move.from)) << "moved a free slot " << move.from;
+            ASSERT_FALSE(owners.contains(move.to)) << "moved onto a used slot " << move.to;
+            uint32_t owner = owners[move.from];
+            owners.erase(move.from);
+            owners[move.to] = owner;
+            _slots[owner] = move.to;
+        }
+        // the used slots are dense afterwards
+        EXPECT_EQ(_table.GetSlotCount(), _slots.size());
+        EXPECT_EQ(_table.GetFragmentation(), 0.f);
+    }
+    // copies the dirty ranges into the GPU copy like GPUScene::Upload
+    void Upload(uint32_t maxGap) {
+        _ranges.clear();
+        _table.CollectDirtyRanges(_ranges, maxGap);
+        _table.ClearDirty();
+        _gpuCopy.resize(_table.GetSlotCount());
+        uint32_t previousEnd = 0;
+        for (const GPUSceneTable::Range &range : _ranges) {
+            ASSERT_GT(range.count, 0u);
+            ASSERT_LE(range.first + range.count, _table.GetSlotCount());
+            ASSERT_TRUE(previousEnd == 0 || range.first > previousEnd + maxGap) << "ranges not merged";
+            previousEnd = range.first + range.count;
+            for (uint32_t slot = range.first; slot < previousEnd; ++slot) {
+                std::memcpy(&_gpuCopy[slot], _table.GetData(slot), sizeof(Element));
+            }
+        }
+    }
+    void Check() const {
+        EXPECT_EQ(_table.GetUsedCount(), _slots.size());
+        EXPECT_GE(_table.GetSlotCount(), _table.GetUsedCount());
+        std::vector<bool> taken(_table.GetSlotCount(), false);
+        for (const auto &[owner, slot] : _slots) {
+            ASSERT_TRUE(_table.IsUsed(slot)) << "owner " << owner;
+            ASSERT_FALSE(taken[slot]) << "slot " << slot << " is shared";
+            taken[slot] = true;
+            Element element;
+            std::memcpy(&element, _table.GetData(slot), sizeof(Element));
+            EXPECT_EQ(element.owner, owner);
+            EXPECT_EQ(element.version, _versions.at(owner));
+        }
+        size_t usedCount = 0;
+        for (uint32_t slot = 0; slot < _table.GetSlotCount(); ++slot) {
+            usedCount += static_cast<size_t>(_table.IsUsed(slot));
+        }
+        EXPECT_EQ(usedCount, _slots.size());
+    }
+    // after an upload the GPU copy of every used slot holds the latest write
+    void CheckGpuCopy() const {
+        for (const auto &[owner, slot] : _slots) {
+            ASSERT_LT(slot, _gpuCopy.size());
+            EXPECT_EQ(_gpuCopy[slot].owner, owner) << "slot " << slot;
+            EXPECT_EQ(_gpuCopy[slot].version, _versions.at(owner)) << "slot " << slot;
+        }
+    }
+    auto GetOwners() const -> const std::unordered_map<uint32_t, uint32_t> & {
+        return _slots;
+    }
+    auto GetTable() const -> const GPUSceneTable & {
+        return _table;
+    }
+private:
+    GPUSceneTable _table;
+    std::unordered_map<uint32_t, uint32_t> _slots;
+    std::unordered_map<uint32_t, uint32_t> _versions;
+    std::vector<GPUSceneTable::Move> _moves;
+    std::vector<GPUSceneTable::Range> _ranges;
+    std::vector<Element> _gpuCopy;
+};
+
+auto PickOwner(const TableModel &model, std::mt19937 &random) -> uint32_t {
+    auto iter = model.GetOwners().begin();
+    std::advance(iter, random() % model.GetOwners().size());
+    return iter->first;
+}
+
+}    // namespace
+
+TEST(GPUSceneTableTest, AllocatesLowestSlotFirst) {
+    GPUSceneTable table(sizeof(Element));
+    EXPECT_EQ(table.Allocate(), 0u);
+    EXPECT_EQ(table.Allocate(), 1u);
+    EXPECT_EQ(table.Allocate(), 2u);
+    table.Free(0);
+    table.Free(1);
+    EXPECT_EQ(table.Allocate(), 0u);
+    EXPECT_EQ(table.Allocate(), 1u);
+    // the free slots at the end are cut off
+    table.Free(2);
+    EXPECT_EQ(table.GetSlotCount(), 2u);
+    EXPECT_EQ(table.Allocate(), 2u);
+}
+
+TEST(GPUSceneTableTest, MergesDirtyRangesWithinTheGap) {
+    GPUSceneTable table(sizeof(Element));
+    for (size_t i = 0; i < 16; ++i) {
+        table.Allocate();
+    }
+    table.ClearDirty();
+    Element element = {};
+    for (uint32_t slot : {1u, 2u, 5u, 12u}) {
+        table.Write(slot, &element);
+    }
+    std::vector<GPUSceneTable::Range> ranges;
+    table.CollectDirtyRanges(ranges, 2);
+    ASSERT_EQ(ranges.size(), 2u);
+    EXPECT_EQ(ranges[0].first, 1u);
+    EXPECT_EQ(ranges[0].count, 5u);
+    EXPECT_EQ(ranges[1].first, 12u);
+    EXPECT_EQ(ranges[1].count, 1u);
+}
+
+TEST(GPUSceneTableTest, RandomChurnKeepsOwnersAndData) {
+    std::mt19937 random(20);
+    TableModel model;
+    uint32_t nextOwner = 0;
+    for (size_t frame = 0; frame < 400; ++frame) {
+        // the population grows, then shrinks, so the frees leave holes and cut off the end
+        size_t targetCount = frame < 200 ? 50 + frame * 5 : 50 + (400 - frame) * 5;
+        for (size_t operation = 0; operation < 64; ++operation) {
+            uint32_t choice = random() % 100;
+            bool grow = model.GetOwners().size() < targetCount;
+            if (model.GetOwners().empty() || (grow && choice < 60) || (!grow && choice < 20)) {
+                model.Add(nextOwner++);
+            } else if (choice < 80) {
+                model.Remove(PickOwner(model, random));
+            } else {
+                model.Write(PickOwner(model, random));
+            }
+        }
+        model.Check();
+        if (model.GetTable().GetFragmentation() > 0.25f || frame % 97 == 0) {
+            model.Defragment();
+            model.Check();
+        }
+        model.Upload(frame % 5);
+        model.CheckGpuCopy();
+    }
+}
+
+TEST(GPUSceneTableTest, DefragmentMovesOnlyIntoHoles) {
+    TableModel model;
+    for (uint32_t owner = 0; owner < 100; ++owner) {
+        model.Add(owner);
+    }
+    for (uint32_t owner = 0; owner < 100; owner += 3) {
+        model.Remove(owner);
+    }
+    model.Upload(0);
+    model.Defragment();
+    model.Check();
+    // the moved slots are dirty, the upload brings the GPU copy up to date again
+    model.Upload(0);
+    model.CheckGpuCopy();
+}
+
+TEST(GPUSceneTableTest, SteadyStateUploadDoesNotAllocate) {
+    if (!HeapAllocationCounter::IsEnabled()) {
+        GTEST_SKIP() << "needs the heap_allocation_check option";
+    }
+    GPUSceneTable table(sizeof(Element));
+    for (size_t i = 0; i < 256; ++i) {
+        table.Allocate();
+    }
+    Element element = {};
+    std::vector<GPUSceneTable::Range> ranges;
+    // the first frames grow the dirty list and the ranges, later frames with the same writes reuse their capacity
+    for (size_t frame = 0; frame < 4; ++frame) {
+        ScopedNoHeapAllocationCheck check(frame > 0);
+        for (uint32_t slot = frame % 2; slot < 256; slot += 3) {
+            table.Write(slot, &element);
+        }
+        ranges.clear();
+        table.CollectDirtyRanges(ranges, 1);
+        table.ClearDirty();
+    }
+}
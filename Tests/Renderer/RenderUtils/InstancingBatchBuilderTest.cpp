@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <deque>
+#include "Renderer/RenderUtils/InstancingBatchBuilder.h"
+#include "RenderObject/RenderObject.h"
+
+namespace {
+
+// the builder only compares the mesh and material pointers, the tests use distinct addresses instead of real objects
+template<typename T>
+auto FakePointer(uintptr_t id) -> const T * {
+    return reinterpret_cast<const T *>(id * alignof(std::max_align_t));
+}
+
+class InstancingBatchBuilderTest : public testing::Test {
+protected:
+    auto AddObject(uintptr_t meshId, uintptr_t materialId, uint8_t lodIndex = 0) -> RenderObject * {
+        RenderObject &renderObject = _objects.emplace_back();
+        renderObject.pMesh = FakePointer<Mesh>(meshId);
+        renderObject.pMaterial = FakePointer<Material>(materialId);
+        renderObject.lodIndex = lodIndex;
+        renderObject.objectIndex = static_cast<uint32_t>(_objects.size() - 1);
+        _drawList.push_back(&renderObject);
+        return &renderObject;
+    }
+    void Build() {
+        _builder.Build(_drawList);
+    }
+    // the object indices of the instances of a batch
+    auto GetInstances(size_t batchIndex) const -> std::vector<uint32_t> {
+        const InstancingBatchBuilder::Batch &batch = _builder.GetBatches()[batchIndex];
+        const std::vector<uint32_t> &instances = _builder.GetInstances();
+        return std::vector<uint32_t>(instances.begin() + batch.firstInstance,
+            instances.begin() + batch.firstInstance + batch.instanceCount);
+    }
+protected:
+    std::deque<RenderObject> _objects;
+    std::vector<RenderObject *> _drawList;
+    SubMesh _subMesh = {};
+    InstancingBatchBuilder _builder;
+};
+
+}    // namespace
+
+TEST_F(InstancingBatchBuilderTest, EmptyListHasNoBatches) {
+    Build();
+    EXPECT_TRUE(_builder.GetBatches().empty());
+    EXPECT_TRUE(_builder.GetInstances().empty());
+}
+
+TEST_F(InstancingBatchBuilderTest, SameMeshAndMaterialShareOneDraw) {
+    for (size_t i = 0; i < 5; ++i) {
+        AddObject(1, 1);
+    }
+    Build();
+    ASSERT_EQ(_builder.GetBatches().size(), 1u);
+    EXPECT_EQ(_builder.GetBatches()[0].pRenderObject, _drawList[0]);
+    EXPECT_EQ(GetInstances(0), (std::vector<uint32_t>{0, 1, 2, 3, 4}));
+}
+
+TEST_F(InstancingBatchBuilderTest, SplitsByMeshLodAndMaterial) {
+    AddObject(1, 1, 0);
+    AddObject(1, 1, 1);
+    AddObject(2, 1, 0);
+    AddObject(1, 1, 0);
+    AddObject(1, 2, 0);
+    Build();
+    ASSERT_EQ(_builder.GetBatches().size(), 4u);
+    // inside a material run the batches keep the order of their first object
+    EXPECT_EQ(GetInstances(0), (std::vector<uint32_t>{0, 3}));
+    EXPECT_EQ(GetInstances(1), (std::vector<uint32_t>{1}));
+    EXPECT_EQ(GetInstances(2), (std::vector<uint32_t>{2}));
+    EXPECT_EQ(GetInstances(3), (std::vector<uint32_t>{4}));
+    EXPECT_EQ(_builder.GetInstances().size(), _drawList.size());
+}
+
+TEST_F(InstancingBatchBuilderTest, MaterialRunsAreNotMerged) {
+    // the same material in two runs of a sorted list stays two draws, the order between the runs is kept
+    AddObject(1, 1);
+    AddObject(1, 2);
+    AddObject(1, 1);
+    Build();
+    ASSERT_EQ(_builder.GetBatches().size(), 3u);
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(GetInstances(i), (std::vector<uint32_t>{static_cast<uint32_t>(i)}));
+    }
+}
+
+TEST_F(InstancingBatchBuilderTest, CulledSubMeshesDrawAlone) {
+    AddObject(1, 1);
+    AddObject(1, 1)->visibleSubMeshes = std::span(&_subMesh, 1);
+    AddObject(1, 1);
+    AddObject(1, 1)->visibleSubMeshes = std::span(&_subMesh, 1);
+    AddObject(1, 1)->visibleSubMeshes = std::span(&_subMesh, 1);
+    Build();
+    // the objects without culled ranges form one batch, the ones with culled ranges neither start nor join one
+    ASSERT_EQ(_builder.GetBatches().size(), 4u);
+    EXPECT_EQ(GetInstances(0), (std::vector<uint32_t>{0, 2}));
+    EXPECT_EQ(GetInstances(1), (std::vector<uint32_t>{1}));
+    EXPECT_EQ(GetInstances(2), (std::vector<uint32_t>{3}));
+    EXPECT_EQ(GetInstances(3), (std::vector<uint32_t>{4}));
+    for (size_t i = 1; i < 4; ++i) {
+        EXPECT_FALSE(_builder.GetBatches()[i].pRenderObject->visibleSubMeshes.empty());
+    }
+}
+
+TEST_F(InstancingBatchBuilderTest, LongRunKeepsTheDrawOrder) {
+    // long enough for the sort to reorder equal keys unless the draw order breaks the ties
+    for (size_t i = 0; i < 1000; ++i) {
+        AddObject(1 + (i * 7) % 5, 1, static_cast<uint8_t>(i % 3 == 0));
+    }
+    Build();
+    ASSERT_EQ(_builder.GetBatches().size(), 10u);
+    EXPECT_EQ(_builder.GetInstances().size(), _drawList.size());
+    uint32_t previousFirst = 0;
+    for (size_t i = 0; i < _builder.GetBatches().size(); ++i) {
+        std::vector<uint32_t> instances = GetInstances(i);
+        EXPECT_TRUE(std::ranges::is_sorted(instances));
+        EXPECT_EQ(_builder.GetBatches()[i].pRenderObject, _drawList[instances.front()]);
+        if (i > 0) {
+            EXPECT_LT(previousFirst, instances.front());
+        }
+        previousFirst = instances.front();
+    }
+}
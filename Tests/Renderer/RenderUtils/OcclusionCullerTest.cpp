@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <random>
+#include "Foundation/JobSystem.h"
+#include "Renderer/RenderUtils/OcclusionCuller.h"
+
+// Headless tests of the software rasterizer and the depth hierarchy of the OcclusionCuller.
+// The camera sits at the origin and looks down +z, the occluders are quads facing the camera.
+
+namespace {
+
+constexpr float kNear = 0.1f;
+constexpr float kFar = 100.f;
+
+auto MakeViewProj(bool reversedZ) -> glm::mat4x4 {
+    glm::mat4x4 matView = glm::lookAt(glm::vec3(0.f), glm::vec3(0.f, 0.f, 1.f), glm::vec3(0.f, 1.f, 0.f));
+    glm::mat4x4 matProj = glm::perspective(glm::radians(90.f), 5.f / 3.f, kNear, kFar);
+    if (reversedZ) {
+        // z' = w - z maps the near plane to 1 and the far plane to 0
+        glm::mat4x4 matReverse(1.f);
+        matReverse[2][2] = -1.f;
+        matReverse[3][2] = 1.f;
+        matProj = matReverse * matProj;
+    }
+    return matProj * matView;
+}
+
+// clip space depth of a point on the view axis at the distance z, 0 at the near plane
+auto ExpectedDepth(float z) -> float {
+    return kFar / (kFar - kNear) * (1.f - kNear / z);
+}
+
+struct Quad {
+    std::vector<glm::vec3> vertices;
+    std::vector<uint32_t> indices;
+};
+
+// a quad facing the camera at the distance z
+auto MakeQuad(float minX, float minY, float maxX, float maxY, float z) -> Quad {
+    Quad quad;
+    quad.vertices = {
+        glm::vec3(minX, minY, z),
+        glm::vec3(maxX, minY, z),
+        glm::vec3(maxX, maxY, z),
+        glm::vec3(minX, maxY, z),
+    };
+    quad.indices = {0, 1, 2, 0, 2, 3};
+    return quad;
+}
+
+auto MakeBox(const glm::vec3 &center, float extent) -> AABB {
+    return AABB{center - glm::vec3(extent), center + glm::vec3(extent)};
+}
+
+class OcclusionCullerTest : public testing::Test {
+protected:
+    void SetUp() override {
+        JobSystem::OnInstanceCreate();
+        JobSystem::GetInstance()->OnCreate(0);
+    }
+    void TearDown() override {
+        JobSystem::GetInstance()->OnDestroy();
+        JobSystem::OnInstanceDestroy();
+    }
+    void Rasterize(OcclusionCuller &culler, bool reversedZ, const std::vector<Quad> &quads) {
+        culler.BeginFrame(MakeViewProj(reversedZ), reversedZ);
+        for (const Quad &quad : quads) {
+            culler.AddOccluder(glm::mat4x4(1.f), quad.vertices, quad.indices);
+        }
+        culler.RasterizeOccluders();
+    }
+};
+
+}    // namespace
+
+TEST_F(OcclusionCullerTest, FullScreenQuadWritesPlaneDepth) {
+    for (bool reversedZ : {false, true}) {
+        OcclusionCuller culler;
+        Rasterize(culler, reversedZ, {MakeQuad(-100.f, -100.f, 100.f, 100.f, 10.f)});
+        float expectedDepth = ExpectedDepth(10.f);
+        for (float depth : culler.GetDepthBuffer()) {
+            ASSERT_NEAR(depth, expectedDepth, 1e-5f) << "reversedZ " << reversedZ;
+        }
+        EXPECT_EQ(culler.GetStatistics().occluderTriangleCount, 2u);
+    }
+}
+
+TEST_F(OcclusionCullerTest, CoverageMatchesPixelCenters) {
+    // the screen spans x in [-5/3 z, 5/3 z] and y in [-z, z], pixel (px, py) covers a 1/96 z square
+    OcclusionCuller culler;
+    float z = 10.f;
+    std::vector<glm::vec3> vertices = {glm::vec3(-7.3f, -4.1f, z), glm::vec3(9.2f, -1.7f, z), glm::vec3(1.3f, 8.8f, z)};
+    std::vector<uint32_t> indices = {0, 1, 2};
+    culler.BeginFrame(MakeViewProj(false), false);
+    culler.AddOccluder(glm::mat4x4(1.f), vertices, indices);
+    culler.RasterizeOccluders();
+
+    struct Point {
+        double x;
+        double y;
+    };
+    std::vector<Point> screen;
+    for (const glm::vec3 &vertex : vertices) {
+        double x = (vertex.x / (5.0 / 3.0 * z) * 0.5 + 0.5) * culler.GetWidth();
+        double y = (0.5 - vertex.y / z * 0.5) * culler.GetHeight();
+        screen.push_back(Point{x, y});
+    }
+    ReadonlyArraySpan<float> depthBuffer = culler.GetDepthBuffer();
+    size_t coveredCount = 0;
+    for (uint32_t y = 0; y < culler.GetHeight(); ++y) {
+        for (uint32_t x = 0; x < culler.GetWidth(); ++x) {
+            Point sample{x + 0.5, y + 0.5};
+            // signed distances in pixels to the three edges, positive inside for either winding
+            double minDistance = std::numeric_limits<double>::max();
+            double area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) -
+                          (screen[2].x - screen[0].x) * (screen[1].y - screen[0].y);
+            for (size_t i = 0; i < 3; ++i) {
+                Point a = screen[i];
+                Point b = screen[(i + 1) % 3];
+                double cross = (b.x - a.x) * (sample.y - a.y) - (b.y - a.y) * (sample.x - a.x);
+                double distance = (area > 0.0 ? cross : -cross) / std::hypot(b.x - a.x, b.y - a.y);
+                minDistance = std::min(minDistance, distance);
+            }
+            bool covered = depthBuffer[y * culler.GetWidth() + x] < 1.f;
+            coveredCount += static_cast<size_t>(covered);
+            if (std::abs(minDistance) > 1e-3) {
+                EXPECT_EQ(covered, minDistance > 0.0) << "pixel " << x << ", " << y;
+            }
+        }
+    }
+    EXPECT_GT(coveredCount, 1000u);
+}
+
+TEST_F(OcclusionCullerTest, BoxesBehindAnOccluderAreHidden) {
+    for (bool reversedZ : {false, true}) {
+        OcclusionCuller culler;
+        // covers the left half of the screen at z = 10
+        Rasterize(culler, reversedZ, {MakeQuad(-100.f, -100.f, 0.f, 100.f, 10.f)});
+
+        EXPECT_FALSE(culler.IsVisible(MakeBox(glm::vec3(-5.f, 0.f, 20.f), 1.f))) << "reversedZ " << reversedZ;
+        EXPECT_FALSE(culler.IsVisible(MakeBox(glm::vec3(-15.f, 5.f, 50.f), 4.f))) << "reversedZ " << reversedZ;
+        // in front of the occluder
+        EXPECT_TRUE(culler.IsVisible(MakeBox(glm::vec3(-3.f, 0.f, 5.f), 1.f))) << "reversedZ " << reversedZ;
+        // behind it, but reaching into the uncovered half
+        EXPECT_TRUE(culler.IsVisible(MakeBox(glm::vec3(0.f, 0.f, 20.f), 2.f))) << "reversedZ " << reversedZ;
+        EXPECT_TRUE(culler.IsVisible(MakeBox(glm::vec3(8.f, 0.f, 20.f), 1.f))) << "reversedZ " << reversedZ;
+        // crossing the near plane
+        EXPECT_TRUE(culler.IsVisible(MakeBox(glm::vec3(-1.f, 0.f, 0.f), 0.5f))) << "reversedZ " << reversedZ;
+        // invalid bounds are always visible
+        EXPECT_TRUE(culler.IsVisible(AABB{})) << "reversedZ " << reversedZ;
+        EXPECT_EQ(culler.GetStatistics().occludedCount, 2u);
+    }
+}
+
+TEST_F(OcclusionCullerTest, HierarchyIsConservative) {
+    // an occluded box must be behind the depth buffer in every pixel of its screen rectangle
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> position(-30.f, 30.f);
+    std::uniform_real_distribution<float> depth(5.f, 40.f);
+    std::uniform_real_distribution<float> size(0.5f, 12.f);
+    std::vector<Quad> quads;
+    for (size_t i = 0; i < 24; ++i) {
+        float x = position(random);
+        float y = position(random);
+        quads.push_back(MakeQuad(x, y, x + size(random), y + size(random), depth(random)));
+    }
+
+    OcclusionCuller culler;
+    Rasterize(culler, false, quads);
+    glm::mat4x4 matViewProj = MakeViewProj(false);
+    ReadonlyArraySpan<float> depthBuffer = culler.GetDepthBuffer();
+    size_t occludedCount = 0;
+    for (size_t i = 0; i < 2000; ++i) {
+        AABB bounds = MakeBox(glm::vec3(position(random), position(random), depth(random) + 5.f), size(random) * 0.2f);
+        if (culler.IsVisible(bounds)) {
+            continue;
+        }
+        ++occludedCount;
+
+        glm::vec2 screenMin(std::numeric_limits<float>::max());
+        glm::vec2 screenMax(std::numeric_limits<float>::lowest());
+        float nearestDepth = 1.f;
+        for (size_t corner = 0; corner < 8; ++corner) {
+            glm::vec3 point((corner & 1) ? bounds.max.x : bounds.min.x,
+                (corner & 2) ? bounds.max.y : bounds.min.y,
+                (corner & 4) ? bounds.max.z : bounds.min.z);
+            glm::vec4 clip = matViewProj * glm::vec4(point, 1.f);
+            glm::vec2 screen((clip.x / clip.w * 0.5f + 0.5f) * culler.GetWidth(),
+                (0.5f - clip.y / clip.w * 0.5f) * culler.GetHeight());
+            screenMin = glm::min(screenMin, screen);
+            screenMax = glm::max(screenMax, screen);
+            nearestDepth = std::min(nearestDepth, clip.z / clip.w);
+        }
+        uint32_t minX = static_cast<uint32_t>(std::max(std::floor(screenMin.x), 0.f));
+        uint32_t minY = static_cast<uint32_t>(std::max(std::floor(screenMin.y), 0.f));
+        uint32_t maxX = static_cast<uint32_t>(std::min(std::floor(screenMax.x), float(culler.GetWidth() - 1)));
+        uint32_t maxY = static_cast<uint32_t>(std::min(std::floor(screenMax.y), float(culler.GetHeight() - 1)));
+        for (uint32_t y = minY; y <= maxY; ++y) {
+            for (uint32_t x = minX; x <= maxX; ++x) {
+                ASSERT_LT(depthBuffer[y * culler.GetWidth() + x], nearestDepth) << "box " << i;
+            }
+        }
+    }
+    EXPECT_GT(occludedCount, 10u);
+    EXPECT_EQ(culler.GetStatistics().occludedCount, occludedCount);
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "TextureObject/AlphaCoverage.h"
+
+// The histogram search against the former per pixel bisection, which rescanned the mip for every step.
+// Both evaluate the same integer alpha values, so the scales and the scaled alpha agree up to the rounding of the
+// coverage sum, the tolerances only absorb that. The search quality itself is unchanged and not tested here.
+
+namespace {
+
+constexpr float kScaleTolerance = 1e-5f;
+constexpr float kCoverageTolerance = 1e-6f;
+constexpr int kAlphaTolerance = 1;
+
+auto ReferenceCoverage(const std::vector<uint8_t> &pixels, float scale, int cutoff) -> float {
+    size_t pixelCount = pixels.size() / 4;
+    double val = 0;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        int alpha = static_cast<int>(scale * static_cast<float>(pixels[i * 4 + 3]));
+        if (alpha > 255) {
+            alpha = 255;
+        }
+        if (alpha <= cutoff) {
+            continue;
+        }
+        val += alpha;
+    }
+    return static_cast<float>(val / (static_cast<double>(pixelCount) * 255));
+}
+
+auto ReferenceFindScale(const std::vector<uint8_t> &pixels, float targetCoverage, int cutoff) -> float {
+    float ini = 0;
+    float fin = 10;
+    float mid = 0.f;
+    for (int iter = 0; iter < 50; iter++) {
+        mid = (ini + fin) / 2;
+        float alphaPercentage = ReferenceCoverage(pixels, mid, cutoff);
+        if (std::fabs(alphaPercentage - targetCoverage) < .001) {
+            break;
+        }
+        if (alphaPercentage > targetCoverage) {
+            fin = mid;
+        }
+        if (alphaPercentage < targetCoverage) {
+            ini = mid;
+        }
+    }
+    return mid;
+}
+
+auto MaxAlphaDifference(const std::vector<uint8_t> &lhs, const std::vector<uint8_t> &rhs) -> int {
+    int maxDifference = 0;
+    for (size_t i = 3; i < lhs.size(); i += 4) {
+        maxDifference = std::max(maxDifference, std::abs(int(lhs[i]) - int(rhs[i])));
+    }
+    return maxDifference;
+}
+
+enum class AlphaPattern { eRandom, eBlocky, eSmooth };
+
+auto MakePixels(uint32_t size, AlphaPattern pattern, uint32_t seed) -> std::vector<uint8_t> {
+    std::mt19937 random(seed);
+    std::vector<uint8_t> pixels(size_t(size) * size * 4, 128);
+    for (uint32_t y = 0; y < size; ++y) {
+        for (uint32_t x = 0; x < size; ++x) {
+            uint8_t alpha = 0;
+            switch (pattern) {
+            case AlphaPattern::eRandom:
+                alpha = static_cast<uint8_t>(random());
+                break;
+            case AlphaPattern::eBlocky:
+                alpha = ((x / 8 + y / 8) % 3) == 0 ? 255 : 0;
+                break;
+            case AlphaPattern::eSmooth:
+                alpha = static_cast<uint8_t>(127.5f + 127.5f * std::sin(float(x) * 0.1f) * std::cos(float(y) * 0.07f));
+                break;
+            }
+            pixels[(size_t(y) * size + x) * 4 + 3] = alpha;
+        }
+    }
+    return pixels;
+}
+
+// a downsampled level blurs the alpha, which is what lowers the coverage of the cutout
+auto HalveAlpha(const std::vector<uint8_t> &pixels, uint32_t size) -> std::vector<uint8_t> {
+    uint32_t halfSize = size / 2;
+    std::vector<uint8_t> result(size_t(halfSize) * halfSize * 4, 128);
+    for (uint32_t y = 0; y < halfSize; ++y) {
+        for (uint32_t x = 0; x < halfSize; ++x) {
+            uint32_t sum = 0;
+            for (uint32_t i = 0; i < 4; ++i) {
+                sum += pixels[((size_t(y) * 2 + i / 2) * size + x * 2 + i % 2) * 4 + 3];
+            }
+            result[(size_t(y) * halfSize + x) * 4 + 3] = static_cast<uint8_t>(sum / 4);
+        }
+    }
+    return result;
+}
+
+}    // namespace
+
+TEST(AlphaCoverageTest, HistogramCountsEveryPixel) {
+    // 4097 pixels, so the tail after the groups of four is counted as well
+    std::vector<uint8_t> pixels = MakePixels(64, AlphaPattern::eRandom, 1);
+    pixels.insert(pixels.end(), {0, 0, 0, 77});
+    size_t pixelCount = pixels.size() / 4;
+    AlphaCoverage::Histogram histogram;
+    AlphaCoverage::BuildHistogram(pixels.data(), pixelCount, histogram);
+
+    AlphaCoverage::Histogram expected = {};
+    for (size_t i = 0; i < pixelCount; ++i) {
+        ++expected[pixels[i * 4 + 3]];
+    }
+    EXPECT_EQ(histogram, expected);
+}
+
+TEST(AlphaCoverageTest, CoverageMatchesPerPixelCoverage) {
+    for (AlphaPattern pattern : {AlphaPattern::eRandom, AlphaPattern::eBlocky, AlphaPattern::eSmooth}) {
+        std::vector<uint8_t> pixels = MakePixels(128, pattern, 2);
+        size_t pixelCount = pixels.size() / 4;
+        AlphaCoverage::Histogram histogram;
+        AlphaCoverage::BuildHistogram(pixels.data(), pixelCount, histogram);
+        for (int cutoff : {0, 64, 127, 229}) {
+            for (float scale : {0.25f, 1.f, 1.7f, 4.f}) {
+                EXPECT_NEAR(AlphaCoverage::GetCoverage(histogram, pixelCount, scale, cutoff),
+                    ReferenceCoverage(pixels, scale, cutoff),
+                    kCoverageTolerance)
+                    << "cutoff " << cutoff << " scale " << scale;
+            }
+        }
+    }
+}
+
+TEST(AlphaCoverageTest, ScaleMatchesPerPixelBisection) {
+    uint32_t seed = 3;
+    for (AlphaPattern pattern : {AlphaPattern::eRandom, AlphaPattern::eBlocky, AlphaPattern::eSmooth}) {
+        for (uint32_t size : {16u, 64u, 256u}) {
+            std::vector<uint8_t> level0 = MakePixels(size, pattern, ++seed);
+            std::vector<uint8_t> level1 = HalveAlpha(level0, size);
+            size_t pixelCount = level1.size() / 4;
+            for (float cutOff : {0.f, 0.3f, 0.5f, 0.9f}) {
+                int cutoff = static_cast<int>(cutOff * 255);
+                float targetCoverage = ReferenceCoverage(level0, 1.f, cutoff);
+
+                AlphaCoverage::Histogram histogram;
+                AlphaCoverage::BuildHistogram(level1.data(), pixelCount, histogram);
+                float scale = AlphaCoverage::FindScale(histogram, pixelCount, targetCoverage, cutoff);
+                float referenceScale = ReferenceFindScale(level1, targetCoverage, cutoff);
+                EXPECT_NEAR(scale, referenceScale, kScaleTolerance) << "size " << size << " cutoff " << cutoff;
+
+                std::vector<uint8_t> scaled = level1;
+                std::vector<uint8_t> referenceScaled = level1;
+                AlphaCoverage::ScaleAlpha(scaled.data(), pixelCount, scale);
+                AlphaCoverage::ScaleAlpha(referenceScaled.data(), pixelCount, referenceScale);
+                EXPECT_LE(MaxAlphaDifference(scaled, referenceScaled), kAlphaTolerance)
+                    << "size " << size << " cutoff " << cutoff;
+                EXPECT_NEAR(ReferenceCoverage(scaled, 1.f, cutoff),
+                    ReferenceCoverage(referenceScaled, 1.f, cutoff),
+                    kCoverageTolerance)
+                    << "size " << size << " cutoff " << cutoff;
+            }
+        }
+    }
+}
+
+TEST(AlphaCoverageTest, ScaleSaturatesAt255) {
+    std::vector<uint8_t> pixels = {0, 0, 0, 0, 0, 0, 0, 100, 0, 0, 0, 200, 0, 0, 0, 255};
+    AlphaCoverage::ScaleAlpha(pixels.data(), 4, 1.5f);
+    EXPECT_EQ(pixels[3], 0);
+    EXPECT_EQ(pixels[7], 150);
+    EXPECT_EQ(pixels[11], 255);
+    EXPECT_EQ(pixels[15], 255);
+}
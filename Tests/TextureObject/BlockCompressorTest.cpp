@@ -0,0 +1,237 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+#include "Foundation/JobSystem.h"
+#include "TextureObject/BlockCompressor.h"
+
+// Hand built blocks check the decoder against the format specifications, then every format and quality is encoded
+// and decoded again. The PSNR floors are about 1 dB below the measured values of the test image, so a regression of
+// the endpoint fit fails while small changes of the search pass.
+
+namespace {
+
+using Format = BlockCompressor::Format;
+using Quality = BlockCompressor::Quality;
+
+struct PsnrFloor {
+    Format format;
+    Quality quality;
+    double minPsnr;
+};
+
+constexpr PsnrFloor kPsnrFloors[] = {
+    {Format::eBC1, Quality::eFast, 32.0},
+    {Format::eBC1, Quality::eNormal, 32.5},
+    {Format::eBC1, Quality::eHigh, 32.5},
+    {Format::eBC3, Quality::eFast, 33.5},
+    {Format::eBC3, Quality::eNormal, 33.5},
+    {Format::eBC3, Quality::eHigh, 34.0},
+    {Format::eBC4, Quality::eFast, 48.5},
+    {Format::eBC4, Quality::eNormal, 49.0},
+    {Format::eBC4, Quality::eHigh, 49.5},
+    {Format::eBC5, Quality::eFast, 47.5},
+    {Format::eBC5, Quality::eNormal, 48.0},
+    {Format::eBC5, Quality::eHigh, 48.5},
+    {Format::eBC7, Quality::eFast, 33.5},
+    {Format::eBC7, Quality::eNormal, 33.5},
+    {Format::eBC7, Quality::eHigh, 33.5},
+};
+
+auto GetQualityName(Quality quality) -> const char * {
+    switch (quality) {
+    case Quality::eFast:
+        return "fast";
+    case Quality::eNormal:
+        return "normal";
+    case Quality::eHigh:
+        return "high";
+    }
+    return "unknown";
+}
+
+auto GetStoredChannelCount(Format format) -> size_t {
+    switch (format) {
+    case Format::eBC1:
+        return 3;
+    case Format::eBC4:
+        return 1;
+    case Format::eBC5:
+        return 2;
+    case Format::eBC3:
+    case Format::eBC7:
+        return 4;
+    }
+    return 0;
+}
+
+// smooth color and alpha gradients with noise and a few hard edges, the size is not a multiple of the block size
+auto MakeImage(uint32_t width, uint32_t height) -> std::vector<uint8_t> {
+    std::mt19937 random(23);
+    // the distributions of the standard library differ between implementations, the engine output does not
+    auto noise = [&random]() { return static_cast<float>(static_cast<int>(random() % 17) - 8); };
+    std::vector<uint8_t> pixels(size_t(width) * height * 4);
+    for (uint32_t y = 0; y < height; ++y) {
+        for (uint32_t x = 0; x < width; ++x) {
+            float u = float(x) / float(width);
+            float v = float(y) / float(height);
+            float edge = ((x / 16 + y / 16) % 2) == 0 ? 0.f : 60.f;
+            float channels[4] = {
+                255.f * u + noise(),
+                255.f * v + edge + noise(),
+                127.5f + 127.5f * std::sin(6.f * u + 4.f * v) + noise(),
+                255.f * (1.f - v) + noise(),
+            };
+            for (size_t c = 0; c < 4; ++c) {
+                pixels[(size_t(y) * width + x) * 4 + c] = static_cast<uint8_t>(std::clamp(channels[c], 0.f, 255.f));
+            }
+        }
+    }
+    return pixels;
+}
+
+auto ComputePsnr(const std::vector<uint8_t> &source, const std::vector<uint8_t> &decoded, size_t channelCount)
+    -> double {
+    double squaredError = 0.0;
+    size_t sampleCount = 0;
+    for (size_t i = 0; i < source.size(); i += 4) {
+        for (size_t c = 0; c < channelCount; ++c) {
+            double diff = double(source[i + c]) - double(decoded[i + c]);
+            squaredError += diff * diff;
+            ++sampleCount;
+        }
+    }
+    return 10.0 * std::log10(255.0 * 255.0 / (squaredError / double(sampleCount)));
+}
+
+// writes bit fields from the lowest bit of the first byte on, like the BC7 block layout
+class BlockBits {
+public:
+    void Write(uint32_t value, uint32_t bitCount) {
+        for (uint32_t i = 0; i < bitCount; ++i, ++_offset) {
+            bytes[_offset / 8] |= static_cast<uint8_t>(((value >> i) & 1) << (_offset % 8));
+        }
+    }
+public:
+    std::array<uint8_t, 16> bytes = {};
+private:
+    uint32_t _offset = 0;
+};
+
+}    // namespace
+
+TEST(BlockCompressorTest, DecodesBC1Block) {
+    // color0 is pure red, color1 pure blue, the four pixels of the first row use the indices 0 to 3
+    const uint8_t block[8] = {0x00, 0xf8, 0x1f, 0x00, 0b11100100, 0, 0, 0};
+    std::vector<uint8_t> pixels(4 * 4 * 4);
+    BlockCompressor::Decompress(block, 4, 4, Format::eBC1, pixels.data());
+    const uint8_t expected[4][4] = {{255, 0, 0, 255}, {0, 0, 255, 255}, {170, 0, 85, 255}, {85, 0, 170, 255}};
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t c = 0; c < 4; ++c) {
+            EXPECT_NEAR(pixels[i * 4 + c], expected[i][c], 1) << "pixel " << i << " channel " << c;
+        }
+    }
+    // index 0 everywhere else
+    EXPECT_EQ(pixels[15 * 4 + 0], 255);
+}
+
+TEST(BlockCompressorTest, DecodesBC4Block) {
+    // value0 > value1 interpolates six values, the first row uses the indices 0, 1, 2 and 7
+    BlockBits bits;
+    bits.Write(200, 8);
+    bits.Write(100, 8);
+    for (uint32_t index : {0u, 1u, 2u, 7u}) {
+        bits.Write(index, 3);
+    }
+    std::vector<uint8_t> pixels(4 * 4 * 4);
+    BlockCompressor::Decompress(bits.bytes.data(), 4, 4, Format::eBC4, pixels.data());
+    const int expected[4] = {200, 100, (6 * 200 + 1 * 100) / 7, (1 * 200 + 6 * 100) / 7};
+    for (size_t i = 0; i < 4; ++i) {
+        EXPECT_NEAR(pixels[i * 4], expected[i], 1) << "pixel " << i;
+    }
+    // the channels BC4 does not store
+    EXPECT_EQ(pixels[1], 0);
+    EXPECT_EQ(pixels[2], 0);
+    EXPECT_EQ(pixels[3], 255);
+}
+
+TEST(BlockCompressorTest, DecodesBC7Mode6Block) {
+    BlockBits bits;
+    bits.Write(1 << 6, 7);
+    // r 255 -> 0, g 0 -> 254, b 128 -> 128, a 255 -> 254, endpoint 0 has the p-bit 1, endpoint 1 has 0
+    const uint32_t endpoints[4][2] = {{127, 0}, {0, 127}, {64, 64}, {127, 127}};
+    for (const auto &channel : endpoints) {
+        bits.Write(channel[0], 7);
+        bits.Write(channel[1], 7);
+    }
+    bits.Write(1, 1);
+    bits.Write(0, 1);
+    // the first index has 3 bits, its top bit is implied 0
+    bits.Write(0, 3);
+    bits.Write(15, 4);
+    bits.Write(8, 4);
+    for (size_t i = 3; i < 16; ++i) {
+        bits.Write(0, 4);
+    }
+
+    std::vector<uint8_t> pixels(4 * 4 * 4);
+    BlockCompressor::Decompress(bits.bytes.data(), 4, 4, Format::eBC7, pixels.data());
+    // index 8 has the weight 34 of 64
+    const uint8_t expected[3][4] = {
+        {255, 1, 129, 255},
+        {0, 254, 128, 254},
+        {(30 * 255 + 34 * 0 + 32) >> 6, (30 * 1 + 34 * 254 + 32) >> 6, 128, (30 * 255 + 34 * 254 + 32) >> 6},
+    };
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t c = 0; c < 4; ++c) {
+            EXPECT_EQ(pixels[i * 4 + c], expected[i][c]) << "pixel " << i << " channel " << c;
+        }
+    }
+}
+
+TEST(BlockCompressorTest, RoundTripKeepsPsnrFloor) {
+    constexpr uint32_t kWidth = 70;
+    constexpr uint32_t kHeight = 45;
+    std::vector<uint8_t> source = MakeImage(kWidth, kHeight);
+    for (const PsnrFloor &floor : kPsnrFloors) {
+        std::vector<uint8_t> blocks(BlockCompressor::GetCompressedSize(floor.format, kWidth, kHeight));
+        BlockCompressor::Statistics statistics =
+            BlockCompressor::Compress(source.data(), kWidth, kHeight, floor.format, floor.quality, blocks.data());
+        std::vector<uint8_t> decoded(source.size());
+        BlockCompressor::Decompress(blocks.data(), kWidth, kHeight, floor.format, decoded.data());
+
+        double psnr = ComputePsnr(source, decoded, GetStoredChannelCount(floor.format));
+        const char *pFormatName = BlockCompressor::GetFormatName(floor.format);
+        EXPECT_GE(psnr, floor.minPsnr) << pFormatName << " " << GetQualityName(floor.quality);
+        // the statistics measure the same error without the padding pixels
+        EXPECT_NEAR(statistics.GetPSNR(), psnr, 1e-6) << pFormatName << " " << GetQualityName(floor.quality);
+    }
+}
+
+TEST(BlockCompressorTest, OutputIsBitExactAcrossRunsAndWorkers) {
+    constexpr uint32_t kWidth = 70;
+    constexpr uint32_t kHeight = 45;
+    std::vector<uint8_t> source = MakeImage(kWidth, kHeight);
+    auto compressAll = [&]() {
+        std::vector<std::vector<uint8_t>> results;
+        for (const PsnrFloor &floor : kPsnrFloors) {
+            std::vector<uint8_t> &blocks = results.emplace_back(
+                BlockCompressor::GetCompressedSize(floor.format, kWidth, kHeight));
+            BlockCompressor::Compress(source.data(), kWidth, kHeight, floor.format, floor.quality, blocks.data());
+        }
+        return results;
+    };
+
+    std::vector<std::vector<uint8_t>> serial = compressAll();
+    EXPECT_EQ(compressAll(), serial);
+
+    JobSystem::OnInstanceCreate();
+    JobSystem::GetInstance()->OnCreate(std::max<size_t>(std::thread::hardware_concurrency(), 4) - 1);
+    std::vector<std::vector<uint8_t>> parallel = compressAll();
+    JobSystem::GetInstance()->OnDestroy();
+    JobSystem::OnInstanceDestroy();
+    EXPECT_EQ(parallel, serial);
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <dxgiformat.h>
+#include <fstream>
+#include <random>
+#include "TextureObject/DDSLoader.h"
+#include "TextureObject/TextureImportCache.h"
+#include "TextureObject/WICLoader.h"
+
+// An imported image is stored in the cache and read back through FileDDSLoader, the entry must give the upload the
+// same header and the same bytes of every mip as the WICLoader that produced it.
+
+namespace {
+
+// 32 bit uncompressed TGA with a top left origin
+auto MakeTga(uint32_t width, uint32_t height) -> std::vector<uint8_t> {
+    std::vector<uint8_t> file(18 + size_t(width) * height * 4, 0);
+    file[2] = 2;
+    file[12] = static_cast<uint8_t>(width & 0xff);
+    file[13] = static_cast<uint8_t>(width >> 8);
+    file[14] = static_cast<uint8_t>(height & 0xff);
+    file[15] = static_cast<uint8_t>(height >> 8);
+    file[16] = 32;
+    file[17] = 0x28;
+    std::mt19937 random(24);
+    for (size_t i = 18; i < file.size(); ++i) {
+        file[i] = static_cast<uint8_t>(random());
+    }
+    return file;
+}
+
+// every mip with tightly packed rows, the rows of block compressed mips are block rows
+auto ReadMips(dx::IImageLoader &loader, bool compressed) -> std::vector<std::vector<uint8_t>> {
+    dx::ImageHeader header = loader.GetImageHeader();
+    std::vector<std::vector<uint8_t>> mips;
+    for (uint32_t mip = 0; mip < header.mipMapCount; ++mip) {
+        uint32_t width = std::max(header.width >> mip, 1u);
+        uint32_t height = std::max(header.height >> mip, 1u);
+        uint32_t rowCount = compressed ? BlockCompressor::GetBlockCount(height) : height;
+        // a block holds 16 pixels
+        uint32_t rowSize = compressed ? BlockCompressor::GetBlockCount(width) * header.bitCount * 2
+                                      : width * header.bitCount / 8;
+        std::vector<uint8_t> &data = mips.emplace_back(size_t(rowSize) * rowCount);
+        loader.GetNextMipMapData(data.data(), rowSize, rowSize, rowCount);
+    }
+    return mips;
+}
+
+class TextureImportCacheTest : public testing::Test {
+protected:
+    void SetUp() override {
+        _cacheDirectory = stdfs::temp_directory_path() / "TextureImportCacheTest";
+        stdfs::create_directories(_cacheDirectory);
+    }
+    void TearDown() override {
+        stdfs::remove_all(_cacheDirectory);
+    }
+    void ExpectRoundTrip(uint32_t width,
+        uint32_t height,
+        const TextureImportSettings &settings,
+        DXGI_FORMAT expectedFormat) {
+
+        std::vector<uint8_t> image = MakeTga(width, height);
+        WICLoader wicLoader;
+        wicLoader.SetImportSettings(settings);
+        ASSERT_TRUE(wicLoader.Load(image.data(), image.size(), 1.f));
+        stdfs::path cachePath = _cacheDirectory / "entry.dds";
+        ASSERT_TRUE(TextureImportCache::Store(cachePath, wicLoader, settings));
+
+        std::unique_ptr<FileDDSLoader> pCacheLoader = TextureImportCache::Load(cachePath);
+        ASSERT_NE(pCacheLoader, nullptr);
+        dx::ImageHeader wicHeader = wicLoader.GetImageHeader();
+        dx::ImageHeader cacheHeader = pCacheLoader->GetImageHeader();
+        EXPECT_EQ(cacheHeader.width, wicHeader.width);
+        EXPECT_EQ(cacheHeader.height, wicHeader.height);
+        EXPECT_EQ(cacheHeader.mipMapCount, wicHeader.mipMapCount);
+        EXPECT_EQ(cacheHeader.bitCount, wicHeader.bitCount);
+        // the sRGB flag is kept in the format of the entry
+        EXPECT_EQ(cacheHeader.format, expectedFormat);
+
+        bool compressed = wicHeader.bitCount < 32;
+        EXPECT_EQ(ReadMips(*pCacheLoader, compressed), ReadMips(wicLoader, compressed));
+    }
+protected:
+    stdfs::path _cacheDirectory;
+};
+
+}    // namespace
+
+TEST_F(TextureImportCacheTest, StoredEntryKeepsTheMips) {
+    TextureImportSettings settings;
+    settings.sRGB = true;
+    ExpectRoundTrip(64, 32, settings, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
+    // odd sizes resample every level
+    ExpectRoundTrip(37, 21, settings, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
+}
+
+TEST_F(TextureImportCacheTest, StoredEntryKeepsTheBlocks) {
+    TextureImportSettings settings;
+    settings.compress = true;
+    ExpectRoundTrip(64, 32, settings, DXGI_FORMAT_BC7_UNORM);
+    settings.sRGB = true;
+    ExpectRoundTrip(64, 32, settings, DXGI_FORMAT_BC7_UNORM_SRGB);
+    settings.sRGB = false;
+    settings.usage = TextureUsage::eNormalMap;
+    ExpectRoundTrip(64, 32, settings, DXGI_FORMAT_BC5_UNORM);
+}
+
+TEST_F(TextureImportCacheTest, MissingOrBrokenEntryIsNotLoaded) {
+    EXPECT_EQ(TextureImportCache::Load(_cacheDirectory / "missing.dds"), nullptr);
+    stdfs::path brokenPath = _cacheDirectory / "broken.dds";
+    {
+        std::ofstream file(brokenPath, std::ios::binary);
+        file << "DDS ";
+    }
+    EXPECT_EQ(TextureImportCache::Load(brokenPath), nullptr);
+}
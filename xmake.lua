@@ -35,6 +35,37 @@ includes("xmake/pix.lua")
 includes("xmake/RayTracingDenoiser.lua")
 includes("xmake/FidelityFX.lua")
 
+-- "xmake f --heap_allocation_check=y" replaces the global operator new with a counting one and asserts that
+-- steady state frames do not allocate. Use it with release builds, debug iterators allocate on their own
+option("heap_allocation_check")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Assert that steady state frames make no general purpose heap allocation")
+    add_defines("ENABLE_HEAP_ALLOCATION_COUNTER=1")
+option_end()
+
+-- AVX2 kernels in GlmStd.hpp, the frustum and occlusion culling and the mip generator.
+-- "xmake f --avx2=n" builds the SSE2 paths for cpus without AVX2
+option("avx2")
+    set_default(true)
+    set_showmenu(true)
+    set_description("Build the AVX2 code paths")
+option_end()
+
+-- GBufferPass draws runs of identical mesh and material with one instanced draw, see InstancingBatchBuilder.
+-- "xmake f --instancing=n" draws every render object on its own
+option("instancing")
+    set_default(true)
+    set_showmenu(true)
+    set_description("Draw identical mesh and material render objects with one instanced draw")
+    add_defines("ENABLE_INSTANCING=1")
+option_end()
+
+if has_config("avx2") then
+    add_vectorexts("avx2")
+    add_defines("GLM_STD_AVX=1")
+end
+
 add_requires("fmt 9.1.0")
 add_requires("spdlog v1.9.2") 
 add_requires("glm")
@@ -44,6 +75,7 @@ add_requires("magic_enum v0.9.0")
 add_requires("stb 2023.01.30")
 add_requires("assimp v5.3.1", {configs = {shared = false}})
 add_requires("imgui v1.90", {debug = isDebug, configs = {shared = false}})
+add_requires("gtest", {configs = {main = true}})
 
 -- local package
 add_requires("dxc")
@@ -53,12 +85,13 @@ add_requires("pix")
 add_requires("RayTracingDenoiser", {debug = isDebug, configs = {shared = false}})
 add_requires("FidelityFX", {debug = isDebug, configs = {shared = false}})
 
-target("RayTracing")
+-- everything but the entry point, shared by the application and the benchmarks
+target("Runtime")
     add_headerfiles("**.natvis")
 
     set_languages("c++latest")
     set_warnings("all")
-    set_kind("binary")
+    set_kind("static")
     add_headerfiles("Runtime/**.h")
     add_headerfiles("Runtime/**.hpp")
     add_headerfiles("Runtime/**.inc")
@@ -67,48 +100,86 @@ target("RayTracing")
     add_headerfiles("Bin/Assets/Shaders/**.hlsli")
 
     add_files("Runtime/**.cpp")
-    add_includedirs(RUNTIME_DIR)
-    add_defines("PLATFORM_WIN")
-    add_defines("_SILENCE_CXX17_CODECVT_HEADER_DEPRECATION_WARNING=1") 
-    add_defines("_SILENCE_ALL_CXX17_DEPRECATION_WARNINGS=1")
-
-    add_packages("fmt")
-    add_packages("spdlog")
-    add_packages("jsoncpp")
-    add_defines("GLM_FORCE_LEFT_HANDED=1")
-    add_defines("GLM_FORCE_DEPTH_ZERO_TO_ONE=1")
-    add_packages("glm")
-    add_packages("d3d12-memory-allocator")
-    add_packages("magic_enum")
-    add_packages("stb")
-    add_packages("assimp")
-    add_packages("imgui")
+    remove_files("Runtime/Main.cpp")
+    add_options("heap_allocation_check")
+    add_options("instancing")
+    add_includedirs(RUNTIME_DIR, {public = true})
+    add_defines("PLATFORM_WIN", {public = true})
+    add_defines("_SILENCE_CXX17_CODECVT_HEADER_DEPRECATION_WARNING=1", {public = true}) 
+    add_defines("_SILENCE_ALL_CXX17_DEPRECATION_WARNINGS=1", {public = true})
+
+    add_packages("fmt", {public = true})
+    add_packages("spdlog", {public = true})
+    add_packages("jsoncpp", {public = true})
+    add_defines("GLM_FORCE_LEFT_HANDED=1", {public = true})
+    add_defines("GLM_FORCE_DEPTH_ZERO_TO_ONE=1", {public = true})
+    add_packages("glm", {public = true})
+    add_packages("d3d12-memory-allocator", {public = true})
+    add_packages("magic_enum", {public = true})
+    add_packages("stb", {public = true})
+    add_packages("assimp", {public = true})
+    add_packages("imgui", {public = true})
 
     -- local packages
-    add_packages("stduuid")
+    add_packages("stduuid", {public = true})
     add_headerfiles("ThirdParty/stduuid/include/**.h")
 
-    add_packages("dxc")
+    add_packages("dxc", {public = true})
     add_headerfiles("ThirdParty/dxc/inc/**.h")
 
-    add_packages("renderdoc")
+    add_packages("renderdoc", {public = true})
     add_headerfiles("ThirdParty/renderdoc/inc/**.h")
 
-    add_packages("pix")
+    add_packages("pix", {public = true})
     add_headerfiles("ThirdParty/WinPixEventRuntime/Include/WinPixEventRuntime/**.h")
 
-    add_packages("RayTracingDenoiser")
+    add_packages("RayTracingDenoiser", {public = true})
     add_headerfiles("ThirdParty/RayTracingDenoiser/Include/**.h")
 
-    add_packages("FidelityFX")
+    add_packages("FidelityFX", {public = true})
     add_headerfiles("ThirdParty/FidelityFX-SDK/sdk/include/**.h")
 
+    add_syslinks("Advapi32", {public = true})
+    add_syslinks("d3dcompiler", {public = true})
+    add_syslinks("D3D12", {public = true})
+    add_syslinks("dxgi", {public = true})
+    add_syslinks("User32", {public = true})
+    add_syslinks("Shcore", {public = true})
+target_end()
+
+target("RayTracing")
+    set_languages("c++latest")
+    set_warnings("all")
+    set_kind("binary")
+    add_files("Runtime/Main.cpp")
+    add_deps("Runtime")
     set_targetdir(BINARY_DIR)
+target_end()
 
-    add_syslinks("Advapi32")
-    add_syslinks("d3dcompiler")
-    add_syslinks("D3D12")
-    add_syslinks("dxgi")
-    add_syslinks("User32")
-    add_syslinks("Shcore")
+-- unit tests of the platform independent runtime code, run them with "xmake test" or "xmake run UnitTests"
+target("UnitTests")
+    set_languages("c++latest")
+    set_warnings("all")
+    set_kind("binary")
+    set_default(false)
+    add_files("Tests/**.cpp")
+    add_deps("Runtime")
+    add_packages("gtest")
+    set_targetdir(BINARY_DIR)
+    add_tests("default")
 target_end()
+
+-- every Benchmarks/*Benchmark.cpp is a console program of its own, run it with "xmake run <FileName>"
+for _, file in ipairs(os.files(path.join(PROJECTION_DIR, "Benchmarks", "*Benchmark.cpp"))) do
+    target(path.basename(file))
+        set_languages("c++latest")
+        set_warnings("all")
+        set_kind("binary")
+        set_default(false)
+        set_group("Benchmarks")
+        add_files(file)
+        add_includedirs(path.join(PROJECTION_DIR, "Benchmarks"))
+        add_deps("Runtime")
+        set_targetdir(BINARY_DIR)
+    target_end()
+end